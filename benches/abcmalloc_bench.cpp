@@ -13,10 +13,14 @@
 //                    (alignment 64 and 4096) — all measured as round-trips.
 //     [pool]         batched: N allocations under measurement, batched
 //                    deallocations under a second measurement — exposes
-//                    free-list / tombstone-batching effects.
+//                    free-list / tombstone-batching effects. Repeated with
+//                    alloc_batch / dealloc_batch for the bulk API.
 //     [realloc]      alloc(small) -> realloc(big) -> realloc(small) -> free,
 //                    three sizes covering same-tier in-place and cross-tier
 //                    move paths.
+//     [realloc-large] realloc growth of a fully touched buffer at 1 MiB ..
+//                    1 GiB; dedicated mappings grow by mremap, so cost
+//                    should track page-table work rather than bytes.
 //     [queries]      cheap predicates / introspection: is_present, within,
 //                    query_size, musage.
 //
@@ -376,18 +380,18 @@ sweep_variants()
       auto kernel = [sz]() {
         void *p = abc::aligned_alloc(64, sz);
         clobber_p(p);
-        abc::aligned_free(p);
+        abc::free(p);
       };
-      print_cell(measure("aligned_alloc(64) + a_free", sz, 2, reps, nop_setup, kernel, nop_cleanup));
+      print_cell(measure("aligned_alloc(64) + free", sz, 2, reps, nop_setup, kernel, nop_cleanup));
     }
 
     if ( sz >= 4096 && (sz % 4096) == 0 ) {
       auto kernel = [sz]() {
         void *p = abc::aligned_alloc(4096, sz);
         clobber_p(p);
-        abc::aligned_free(p);
+        abc::free(p);
       };
-      print_cell(measure("aligned_alloc(4096) + a_free", sz, 2, reps, nop_setup, kernel, nop_cleanup));
+      print_cell(measure("aligned_alloc(4096) + free", sz, 2, reps, nop_setup, kernel, nop_cleanup));
     }
   }
 }
@@ -434,6 +438,37 @@ sweep_pool()
       auto cleanup = nop_cleanup;
       print_cell(measure("pool-roundtrip (a+f) x N", sz, 2 * batch, 1, setup, kernel, cleanup));
     }
+
+    {
+      auto setup = nop_setup;
+      auto kernel = [sz, batch]() {
+        (void)abc::alloc_batch(sz, batch, g_ptrs);
+        clobber_arr();
+      };
+      auto cleanup = [batch]() { (void)abc::dealloc_batch(g_ptrs, batch); };
+      print_cell(measure("pool-alloc_batch (N)", sz, batch, 1, setup, kernel, cleanup));
+    }
+
+    {
+      auto setup = [sz, batch]() { (void)abc::alloc_batch(sz, batch, g_ptrs); };
+      auto kernel = [batch]() {
+        (void)abc::dealloc_batch(g_ptrs, batch);
+        clobber_arr();
+      };
+      auto cleanup = nop_cleanup;
+      print_cell(measure("pool-dealloc_batch (N)", sz, batch, 1, setup, kernel, cleanup));
+    }
+
+    {
+      auto setup = nop_setup;
+      auto kernel = [sz, batch]() {
+        (void)abc::alloc_batch(sz, batch, g_ptrs);
+        clobber_arr();
+        (void)abc::dealloc_batch(g_ptrs, batch);
+      };
+      auto cleanup = nop_cleanup;
+      print_cell(measure("pool-roundtrip batch (a+f)", sz, 2 * batch, 1, setup, kernel, cleanup));
+    }
   }
 }
 
@@ -458,6 +493,32 @@ sweep_realloc()
   }
 }
 
+constexpr u64 LARGE_SIZES[] = {
+  1ULL << 20, 4ULL << 20, 16ULL << 20, 64ULL << 20, 256ULL << 20, 1ULL << 30,
+};
+
+void
+sweep_realloc_large()
+{
+  print_section("[realloc-large] touch(malloc(sz/2)) -> realloc(sz) -> free, 1 MiB .. 1 GiB");
+
+  for ( u64 big : LARGE_SIZES ) {
+    const u64 half = big >> 1;
+    void *p = nullptr;
+    auto setup = [&p, half]() {
+      p = abc::malloc(half);
+      // fault every page in, a copying realloc would have to move all of them
+      for ( u64 off = 0; off < half; off += 4096 ) static_cast<byte *>(p)[off] = static_cast<byte>(off);
+    };
+    auto kernel = [&p, big]() {
+      p = abc::realloc(p, big);
+      clobber_p(p);
+    };
+    auto cleanup = [&p]() { abc::free(p); };
+    print_cell(measure("realloc(sz/2 -> sz) touched", big, 1, 1, setup, kernel, cleanup));
+  }
+}
+
 void
 sweep_queries()
 {
@@ -528,12 +589,13 @@ main(void)
   micron::io::println("sizes: 16 B .. 16 MiB (spans precise -> gb tier)");
   micron::io::println("warmup: ", WARMUP_REPS, " kernel reps; ", K_MEASUREMENTS, " measurements per cell (median)");
   micron::io::println("perf events: cycles + instructions + branches + branch-misses (bbench 4-event group)");
-  micron::io::println("memory budget: peak live <= 32 MiB per cell; total RSS << 4 GiB");
+  micron::io::println("memory budget: peak live <= 32 MiB per cell (realloc-large: <= 512 MiB touched); total RSS << 4 GiB");
 
   sweep_round_trip();
   sweep_variants();
   sweep_pool();
   sweep_realloc();
+  sweep_realloc_large();
   sweep_queries();
 
   micron::io::println("");
@@ -0,0 +1,455 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// Multi-threaded scaling benchmark: the same workloads swept over thread
+// counts, so "near-linear scaling" is a number rather than a claim.
+//
+// Workloads:
+//   churn      every thread allocs and frees its own blocks (16 B - 1 KiB,
+//              a ring of CHURN_WINDOW live), never touching another arena;
+//              the owning-thread fast path, the one that should scale
+//   remote     producer/consumer pairs: producers alloc, consumers free,
+//              every free is cross-thread (__route_dealloc -> the
+//              producer's __mpsc_free_channel ring / chain)
+//   spawn      lanes that each start SPAWN_CHILDREN short-lived threads in
+//              turn; a child's first alloc claims an arena slot
+//              (__claim_arena_slow) and its exit hands the slot back
+//   overflow   __max_arenas + OVERFLOW_EXTRA threads held alive together,
+//              so the last ones run on overflow arenas (__arena_node)
+//
+// Per cell:
+//   Mops/s     allocator ops (allocs + frees) per wall-clock second,
+//              summed over threads; spawn reports threads/s instead
+//   p50/p99/p99.9
+//              per-op latency in TSC ticks, from a log-linear histogram of
+//              every timed op (3 significant bits); remote times the
+//              consumer's frees, spawn a child's first alloc
+//   cyc/op     per-thread core cycles per op (bbench event group, summed
+//              over threads / total ops)
+//   IPC        instructions / cycles over the same threads
+//
+// Latency timing wraps every op in two TSC reads, so cyc/op carries that
+// overhead too; compare cells against each other, not against the
+// single-threaded benches. Counts past the core count oversubscribe.
+
+#include "../external/bbench/bench.hpp"
+
+#include <micron/atomic/atomic.hpp>
+#include <micron/bits/__pause.hpp>
+#include <micron/io/console.hpp>
+#include <micron/io/stdout.hpp>
+#include <micron/std.hpp>
+#include <micron/thread/threads.hpp>
+
+namespace
+{
+
+using mem_events = bbench::event_group<bbench::hardware_cycles, bbench::hardware_instructions>;
+using wall = bbench::system_clock<bbench::system_clocks::monotonic>;
+using T = micron::thread<>;
+
+constexpr u32 THREADS[] = { 1u, 2u, 4u, 8u, 16u, 32u };
+constexpr u32 PAIRS[] = { 1u, 2u, 4u, 8u, 16u };
+constexpr u32 SPAWN_LANES[] = { 1u, 4u, 16u };
+constexpr u32 OVERFLOW_EXTRA = 16;
+constexpr u32 MAX_WORKERS = abc::__max_arenas + OVERFLOW_EXTRA > 32u ? abc::__max_arenas + OVERFLOW_EXTRA : 32u;
+
+constexpr u64 CHURN_OPS = 1'000'000ULL;      // alloc/free pairs per thread
+constexpr u32 CHURN_WINDOW = 256;
+constexpr u64 REMOTE_OBJECTS = 256'000ULL;      // per pair
+constexpr u64 HANDOFF_BLOCK = 256ULL;
+constexpr u32 SPAWN_CHILDREN = 256;      // per lane
+constexpr u32 SPAWN_CHILD_OPS = 64;
+
+[[gnu::always_inline]] inline u64
+tsc(void) noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return static_cast<u64>(wall::now() * 1e9);
+#endif
+}
+
+// log-linear: 8 sub-buckets per power of two, exact below 8
+struct lat_hist {
+  static constexpr u32 BUCKETS = 8 + 61 * 8;
+  u64 b[BUCKETS];
+  u64 n;
+
+  void
+  clear(void) noexcept
+  {
+    micron::memset(this, 0, sizeof(*this));
+  }
+
+  [[gnu::always_inline]] inline void
+  add(u64 v) noexcept
+  {
+    u32 i;
+    if ( v < 8 ) {
+      i = static_cast<u32>(v);
+    } else {
+      const u32 e = 63u - static_cast<u32>(__builtin_clzll(v));
+      i = 8 + (e - 3) * 8 + static_cast<u32>((v >> (e - 3)) & 7);
+    }
+    ++b[i];
+    ++n;
+  }
+
+  void
+  merge(const lat_hist &o) noexcept
+  {
+    for ( u32 i = 0; i < BUCKETS; ++i ) b[i] += o.b[i];
+    n += o.n;
+  }
+
+  // lower bound of the bucket holding quantile q (in thousandths)
+  u64
+  at(u64 q_x1000) const noexcept
+  {
+    if ( n == 0 ) return 0;
+    const u64 want = (n * q_x1000 + 999) / 1000;
+    u64 acc = 0;
+    for ( u32 i = 0; i < BUCKETS; ++i ) {
+      acc += b[i];
+      if ( acc >= want ) {
+        if ( i < 8 ) return i;
+        const u32 e = (i - 8) / 8 + 3;
+        return (static_cast<u64>(8 + (i - 8) % 8)) << (e - 3);
+      }
+    }
+    return 0;
+  }
+};
+
+struct alignas(64) worker {
+  u32 idx;
+  u32 seed;
+  u64 ops;
+  u64 cycles;
+  u64 instructions;
+  lat_hist h;
+  // remote pairs
+  micron::atomic_token<u64> published{ 0 };
+};
+
+static worker g_w[MAX_WORKERS];
+alignas(64) static byte *g_handoff[16][REMOTE_OBJECTS];
+
+alignas(64) static micron::atomic_token<u32> g_arrived{ 0 };
+alignas(64) static micron::atomic_token<u32> g_hold{ 0 };
+static u32 g_expected = 0;
+
+void
+barrier(void) noexcept
+{
+  g_arrived.fetch_add(1, micron::memory_order_acq_rel);
+  while ( g_arrived.get(micron::memory_order_acquire) < g_expected ) __cpu_pause();
+}
+
+[[gnu::always_inline]] inline u32
+next_rand(u32 &s) noexcept
+{
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+struct counters {
+  mem_events evs{ bbench::quiet{} };
+
+  void
+  begin(void)
+  {
+    evs.open();
+    evs.begin();
+  }
+
+  void
+  end(worker *w)
+  {
+    evs.end();
+    w->cycles = static_cast<u64>(evs.get<bbench::hardware_cycles>().retrieve());
+    w->instructions = static_cast<u64>(evs.get<bbench::hardware_instructions>().retrieve());
+  }
+};
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// workloads
+
+void
+churn_body(worker *w) noexcept
+{
+  byte *ring[CHURN_WINDOW] = {};
+  u32 s = w->seed;
+  for ( u64 i = 0; i < CHURN_OPS; ++i ) {
+    const u32 slot = static_cast<u32>(i % CHURN_WINDOW);
+    if ( ring[slot] ) {
+      const u64 t0 = tsc();
+      abc::dealloc(ring[slot]);
+      w->h.add(tsc() - t0);
+      ++w->ops;
+    }
+    const usize sz = 16 + (next_rand(s) % 1009);
+    const u64 t0 = tsc();
+    byte *p = abc::alloc(sz);
+    w->h.add(tsc() - t0);
+    ++w->ops;
+    p[0] = static_cast<byte>(i);
+    ring[slot] = p;
+  }
+  for ( byte *p : ring )
+    if ( p ) {
+      abc::dealloc(p);
+      ++w->ops;
+    }
+}
+
+void
+churn(worker *w)
+{
+  // first touch claims the arena before anyone is timed
+  abc::dealloc(abc::alloc(16));
+  barrier();
+  counters c;
+  c.begin();
+  churn_body(w);
+  c.end(w);
+}
+
+// overflow: every thread holds its arena until all of them have one, so the pool is exhausted concurrently
+void
+overflow(worker *w)
+{
+  byte *pin = abc::alloc(64);
+  barrier();
+  while ( g_hold.get(micron::memory_order_acquire) == 0 ) __cpu_pause();
+  counters c;
+  c.begin();
+  churn_body(w);
+  c.end(w);
+  abc::dealloc(pin);
+}
+
+void
+producer(worker *w)
+{
+  byte **out = g_handoff[w->idx / 2];
+  worker *cons = &g_w[w->idx + 1];
+  barrier();
+  for ( u64 i = 0; i < REMOTE_OBJECTS; ++i ) {
+    byte *p = abc::alloc(16 + (i % 1009));
+    p[0] = static_cast<byte>(i);
+    out[i] = p;
+    if ( ((i + 1) % HANDOFF_BLOCK) == 0 ) cons->published.store(i + 1, micron::memory_order_release);
+  }
+  cons->published.store(REMOTE_OBJECTS, micron::memory_order_release);
+  // keep touching the arena so it drains what the consumer publishes
+  abc::dealloc(abc::alloc(16));
+  w->ops = REMOTE_OBJECTS;
+}
+
+void
+consumer(worker *w)
+{
+  byte **in = g_handoff[w->idx / 2];
+  barrier();
+  counters c;
+  c.begin();
+  u64 done = 0;
+  while ( done < REMOTE_OBJECTS ) {
+    const u64 avail = w->published.get(micron::memory_order_acquire);
+    if ( avail == done ) {
+      __cpu_pause();
+      continue;
+    }
+    for ( ; done < avail; ++done ) {
+      const u64 t0 = tsc();
+      abc::dealloc(in[done]);
+      w->h.add(tsc() - t0);
+    }
+  }
+  abc::flush_remote();
+  c.end(w);
+  w->ops = REMOTE_OBJECTS;
+}
+
+void
+spawn_child(worker *w)
+{
+  const u64 t0 = tsc();
+  byte *first = abc::alloc(64);
+  w->h.add(tsc() - t0);
+  byte *blk[SPAWN_CHILD_OPS];
+  for ( u32 i = 0; i < SPAWN_CHILD_OPS; ++i ) blk[i] = abc::alloc(16 + i * 8);
+  for ( u32 i = 0; i < SPAWN_CHILD_OPS; ++i ) abc::dealloc(blk[i]);
+  abc::dealloc(first);
+  ++w->ops;
+}
+
+void
+spawn_lane(worker *w)
+{
+  barrier();
+  for ( u32 i = 0; i < SPAWN_CHILDREN; ++i ) {
+    T child{ spawn_child, w };
+    child.join();
+  }
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// driver
+
+struct cell {
+  u32 threads;
+  u64 ops;
+  f64 secs;
+  u64 cycles;
+  u64 instructions;
+  lat_hist h;
+};
+
+static cell g_cell;
+
+void
+reset_workers(u32 n) noexcept
+{
+  for ( u32 i = 0; i < n; ++i ) {
+    g_w[i].idx = i;
+    g_w[i].seed = 0x9E3779B9u ^ (i * 0x85EBCA6Bu) ^ 1u;
+    g_w[i].ops = g_w[i].cycles = g_w[i].instructions = 0;
+    g_w[i].h.clear();
+    g_w[i].published.store(0, micron::memory_order_relaxed);
+  }
+  g_arrived.store(0, micron::memory_order_relaxed);
+  g_hold.store(0, micron::memory_order_relaxed);
+  g_expected = n;
+}
+
+template<typename Fn>
+const cell &
+run(u32 n, Fn body, bool hold = false)
+{
+  reset_workers(n);
+  alignas(T) static byte buf[MAX_WORKERS * sizeof(T)];
+  T *pool = reinterpret_cast<T *>(buf);
+  const f64 t0 = wall::now();
+  for ( u32 i = 0; i < n; ++i ) ::new (static_cast<void *>(pool + i)) T{ body, &g_w[i] };
+  if ( hold ) {
+    while ( g_arrived.get(micron::memory_order_acquire) < n ) __cpu_pause();
+    g_hold.store(1, micron::memory_order_release);
+  }
+  for ( u32 i = 0; i < n; ++i ) {
+    pool[i].join();
+    pool[i].~T();
+  }
+  g_cell.secs = wall::now() - t0;
+  g_cell.threads = n;
+  g_cell.ops = g_cell.cycles = g_cell.instructions = 0;
+  g_cell.h.clear();
+  for ( u32 i = 0; i < n; ++i ) {
+    g_cell.ops += g_w[i].ops;
+    g_cell.cycles += g_w[i].cycles;
+    g_cell.instructions += g_w[i].instructions;
+    g_cell.h.merge(g_w[i].h);
+  }
+  return g_cell;
+}
+
+void
+remote_body(worker *w)
+{
+  if ( w->idx & 1 )
+    consumer(w);
+  else
+    producer(w);
+}
+
+// x100 fixed point, two decimals
+struct fixed2 {
+  char s[32];
+
+  explicit fixed2(f64 v) noexcept
+  {
+    u64 x = static_cast<u64>(v * 100.0 + 0.5);
+    char tmp[32];
+    u32 k = 0;
+    tmp[k++] = static_cast<char>('0' + x % 10);
+    x /= 10;
+    tmp[k++] = static_cast<char>('0' + x % 10);
+    x /= 10;
+    tmp[k++] = '.';
+    do {
+      tmp[k++] = static_cast<char>('0' + x % 10);
+      x /= 10;
+    } while ( x );
+    for ( u32 i = 0; i < k; ++i ) s[i] = tmp[k - 1 - i];
+    s[k] = 0;
+  }
+};
+
+[[gnu::cold]] void
+print_cell(const char *unit, const cell &c, u64 timed_ops)
+{
+  const f64 rate = c.secs > 0.0 ? static_cast<f64>(c.ops) / c.secs : 0.0;
+  const f64 cyc = timed_ops ? static_cast<f64>(c.cycles) / static_cast<f64>(timed_ops) : 0.0;
+  const f64 ipc = c.cycles ? static_cast<f64>(c.instructions) / static_cast<f64>(c.cycles) : 0.0;
+  micron::io::println("threads ", c.threads, "  ", fixed2(rate / 1e6).s, " ", unit, "  p50 ", c.h.at(500), "  p99 ", c.h.at(990),
+                      "  p99.9 ", c.h.at(999), "  cyc/op ", fixed2(cyc).s, "  IPC ", fixed2(ipc).s);
+}
+
+u32
+overflow_arenas(void) noexcept
+{
+  u32 n = 0;
+  for ( abc::__arena_node *nd = abc::__overflow_head.get(micron::memory_order_acquire); nd != nullptr; nd = nd->next ) ++n;
+  return n;
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  micron::io::println("=== abcmalloc multi-threaded scaling benchmark ===");
+  micron::io::println("latency in TSC ticks (per op, log-linear buckets); cyc/op and IPC from per-thread counters");
+
+  micron::io::println("");
+  micron::io::println("[churn: thread-local alloc/free, 16 B - 1 KiB, ", CHURN_WINDOW, " live, ", CHURN_OPS, " pairs per thread]");
+  for ( u32 n : THREADS ) {
+    const cell &c = run(n, churn);
+    print_cell("Mops/s", c, c.ops);
+  }
+
+  micron::io::println("");
+  micron::io::println("[remote: producer allocs, consumer frees, ", REMOTE_OBJECTS, " objects per pair; latency is the consumer's free]");
+  for ( u32 p : PAIRS ) {
+    const cell &c = run(2 * p, remote_body);
+    print_cell("Mops/s", c, c.h.n);
+  }
+
+  micron::io::println("");
+  micron::io::println("[spawn: ", SPAWN_CHILDREN, " short-lived threads per lane; latency is a child's first alloc (arena claim)]");
+  for ( u32 l : SPAWN_LANES ) {
+    const cell &c = run(l, spawn_lane);
+    const f64 kps = c.secs > 0.0 ? static_cast<f64>(c.ops) / c.secs / 1e3 : 0.0;
+    micron::io::println("lanes ", l, "  ", fixed2(kps).s, " kthreads/s  p50 ", c.h.at(500), "  p99 ", c.h.at(990), "  p99.9 ", c.h.at(999));
+  }
+
+  micron::io::println("");
+  micron::io::println("[overflow: ", abc::__max_arenas + OVERFLOW_EXTRA, " threads alive at once, ", abc::__max_arenas, " pool slots]");
+  {
+    const cell &c = run(abc::__max_arenas + OVERFLOW_EXTRA, overflow, true);
+    print_cell("Mops/s", c, c.ops);
+    micron::io::println("overflow arenas in use: ", overflow_arenas());
+  }
+
+  micron::io::println("");
+  micron::io::println("=== done ===");
+  return 0;
+}
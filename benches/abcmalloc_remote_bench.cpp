@@ -0,0 +1,188 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// Producer/consumer benchmark for the cross-thread free path.
+//
+// Each pair is one producer thread that allocates and one consumer thread
+// that frees: every free the consumer issues lands on the producer's arena
+// and goes through __route_dealloc's remote branch. Pointers are handed
+// over through a per-pair SPSC array published in blocks of HANDOFF_BLOCK,
+// so producer and consumer overlap the way a real pipeline does.
+//
+// Per cell we report, summed over all consumers:
+//   frees        remote frees routed (abc::remote_stats().frees)
+//   CAS          atomic publishes onto producer arenas
+//                (abc::remote_stats().publishes); without batching this
+//                equals `frees`, with batching it is ~frees / batch depth
+//   CAS/free     the ratio; the headline number of this bench
+//   cyc/free     consumer-thread cycles per free (bbench, per-thread event)
+//
+// Cells: pairs in { 1, 4 } x sizes spanning precise / small / medium.
+//
+// Memory: each pair holds at most OBJECTS_PER_PAIR live objects of the
+// cell's size (4 pairs x 4 KiB x 256k worst case); consumers free while
+// producers allocate, so the real peak is a small fraction of that.
+
+#include "../external/bbench/bench.hpp"
+
+#include <micron/atomic/atomic.hpp>
+#include <micron/bits/__pause.hpp>
+#include <micron/io/console.hpp>
+#include <micron/io/stdout.hpp>
+#include <micron/std.hpp>
+#include <micron/thread/threads.hpp>
+
+namespace
+{
+
+using mem_events = bbench::event_group<bbench::hardware_cycles, bbench::hardware_instructions>;
+
+constexpr u32 K_MEASUREMENTS = 3;
+constexpr u64 OBJECTS_PER_PAIR = 256'000ULL;
+constexpr u64 HANDOFF_BLOCK = 256ULL;
+constexpr u32 MAX_PAIRS = 4;
+
+constexpr u32 PAIRS[] = { 1u, 4u };
+constexpr usize SIZES[] = { 16, 64, 256, 1024, 4096 };
+
+alignas(64) static byte *g_handoff[MAX_PAIRS][OBJECTS_PER_PAIR];
+
+struct alignas(64) pair_ctx {
+  u32 idx;
+  usize size;
+  micron::atomic_token<u64> published{ 0 };
+  // consumer-side results
+  u64 frees;
+  u64 publishes;
+  u64 cycles;
+};
+
+static pair_ctx g_pairs[MAX_PAIRS];
+
+void
+producer(pair_ctx *c)
+{
+  byte **out = g_handoff[c->idx];
+  for ( u64 i = 0; i < OBJECTS_PER_PAIR; ++i ) {
+    byte *p = abc::alloc(c->size);
+    p[0] = static_cast<byte>(i);
+    out[i] = p;
+    if ( ((i + 1) % HANDOFF_BLOCK) == 0 ) c->published.store(i + 1, micron::memory_order_release);
+  }
+  c->published.store(OBJECTS_PER_PAIR, micron::memory_order_release);
+  // keep touching the arena so it drains what the consumer publishes
+  byte *w = abc::alloc(c->size);
+  abc::dealloc(w);
+}
+
+void
+consumer(pair_ctx *c)
+{
+  byte **in = g_handoff[c->idx];
+  const abc::remote_free_stats before = abc::remote_stats();
+  mem_events evs{ bbench::quiet{} };
+  evs.open();
+  evs.begin();
+  u64 done = 0;
+  while ( done < OBJECTS_PER_PAIR ) {
+    const u64 avail = c->published.get(micron::memory_order_acquire);
+    if ( avail == done ) {
+      __cpu_pause();
+      continue;
+    }
+    for ( ; done < avail; ++done ) abc::dealloc(in[done]);
+  }
+  abc::flush_remote();
+  evs.end();
+  const abc::remote_free_stats after = abc::remote_stats();
+  c->frees = after.frees - before.frees;
+  c->publishes = after.publishes - before.publishes;
+  c->cycles = static_cast<u64>(evs.get<bbench::hardware_cycles>().retrieve());
+}
+
+struct cell {
+  u32 pairs;
+  usize size;
+  u64 frees;
+  u64 publishes;
+  f64 cyc_per_free;
+};
+
+cell
+run_cell(u32 pairs, usize size) noexcept
+{
+  using T = micron::thread<>;
+  f64 cpf[K_MEASUREMENTS];
+  u64 frees = 0, publishes = 0;
+  for ( u32 m = 0; m < K_MEASUREMENTS; ++m ) {
+    for ( u32 i = 0; i < pairs; ++i ) {
+      g_pairs[i].idx = i;
+      g_pairs[i].size = size;
+      g_pairs[i].published.store(0, micron::memory_order_relaxed);
+    }
+    alignas(T) byte buf[2 * MAX_PAIRS * sizeof(T)];
+    T *pool = reinterpret_cast<T *>(buf);
+    for ( u32 i = 0; i < pairs; ++i ) {
+      ::new (static_cast<void *>(pool + 2 * i)) T{ producer, &g_pairs[i] };
+      ::new (static_cast<void *>(pool + 2 * i + 1)) T{ consumer, &g_pairs[i] };
+    }
+    for ( u32 i = 0; i < 2 * pairs; ++i ) {
+      pool[i].join();
+      pool[i].~T();
+    }
+    u64 cyc = 0;
+    frees = publishes = 0;
+    for ( u32 i = 0; i < pairs; ++i ) {
+      cyc += g_pairs[i].cycles;
+      frees += g_pairs[i].frees;
+      publishes += g_pairs[i].publishes;
+    }
+    cpf[m] = frees ? static_cast<f64>(cyc) / static_cast<f64>(frees) : 0.0;
+  }
+  for ( u32 i = 1; i < K_MEASUREMENTS; ++i ) {
+    const f64 key = cpf[i];
+    u32 j = i;
+    while ( j > 0 && cpf[j - 1] > key ) {
+      cpf[j] = cpf[j - 1];
+      --j;
+    }
+    cpf[j] = key;
+  }
+  return cell{ pairs, size, frees, publishes, cpf[K_MEASUREMENTS / 2] };
+}
+
+[[gnu::cold]] void
+print_cell(const cell &c)
+{
+  const f64 ratio = c.frees ? static_cast<f64>(c.publishes) / static_cast<f64>(c.frees) : 0.0;
+  const u64 r_x1000 = static_cast<u64>(ratio * 1000.0 + 0.5);
+  const u64 cpf_x100 = static_cast<u64>(c.cyc_per_free * 100.0 + 0.5);
+  micron::io::println("pairs ", c.pairs, "  size ", c.size, " B  frees ", c.frees, "  CAS ", c.publishes, "  CAS/free ", r_x1000 / 1000, ".",
+                      (r_x1000 % 1000) / 100, (r_x1000 % 100) / 10, r_x1000 % 10, "  cyc/free ", cpf_x100 / 100, ".", (cpf_x100 % 100) / 10,
+                      cpf_x100 % 10);
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  micron::io::println("=== abcmalloc producer/consumer remote-free benchmark ===");
+  micron::io::println("producers alloc, consumers free: every free is cross-thread");
+  micron::io::println(OBJECTS_PER_PAIR, " objects per pair, handed over in blocks of ", HANDOFF_BLOCK, "; ", K_MEASUREMENTS,
+                      " runs per cell (median cyc/free)");
+  micron::io::println("CAS/free == 1.000 is the unbatched one-CAS-per-object baseline");
+
+  for ( u32 pairs : PAIRS ) {
+    micron::io::println("");
+    micron::io::println("[pairs ", pairs, "]");
+    for ( usize sz : SIZES ) print_cell(run_cell(pairs, sz));
+  }
+
+  micron::io::println("");
+  micron::io::println("=== done ===");
+  return 0;
+}
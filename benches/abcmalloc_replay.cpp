@@ -0,0 +1,416 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// Offline replay of an allocation trace recorded with abc::trace_start()
+// (src/trace.hpp, a MICRON_ABC_TRACE build).
+//
+//   bbench_replay <trace> [rounds]         against abcmalloc
+//   bbench_replay_libc <trace> [rounds]    the same trace against libc malloc
+//
+// Load: records are sorted by their ticket, which rebuilds one consistent
+// history, and every block gets a dense id: an alloc opens one, a free or
+// realloc looks its address up and closes or moves it. Frees of blocks
+// allocated before the trace started are dropped, so are reallocs whose
+// block the trace never saw (those replay as plain allocs). Each traced
+// thread becomes one replay thread running its own ops in order.
+//
+// Replay: every op on a block waits until the block has seen all the ops
+// that came before it in the trace (a per-id step count), so a block freed
+// on another thread is never freed before it exists, and everything else
+// runs as fast as the allocator lets it. Threads all start at once; a
+// thread that was spawned late in the original run just waits on its first
+// foreign block. Blocks still live at the end of the trace are freed after
+// the clock stops.
+//
+// Per round: wall time, ops/s over all threads, peak RSS. The loader keeps
+// its tables in anonymous mappings so they stay out of the measured heap.
+
+#include "abcmalloc_stress.hpp"
+
+#include <micron/memory/allocation/kmemory.hpp>
+
+namespace
+{
+
+// layout of abc::trace_record / abc::trace_header (src/trace.hpp), kept here because the benches build against the
+// installed allocator, not src/
+struct record {
+  u64 ts;
+  u64 ptr;
+  u64 size;
+  u32 tid;
+  u32 op;
+};
+
+struct header {
+  char magic[8];
+  u32 version;
+  u32 record_size;
+};
+
+enum : u32 { op_alloc, op_free, op_resize_from, op_resize_to };
+
+enum : u32 { do_alloc, do_free, do_resize };
+
+constexpr u32 MAX_REPLAY_THREADS = 256;
+constexpr u32 NO_ID = ~0u;
+constexpr u32 DEFAULT_ROUNDS = 3;
+
+struct op {
+  u64 size;
+  u32 id;
+  u32 need;      // steps the block must have taken before this op
+  u32 kind;
+  u32 thread;
+};
+
+struct trace {
+  op *ops;      // grouped by thread, trace order within a thread
+  u64 n_ops;
+  u64 first[MAX_REPLAY_THREADS + 1];      // thread t runs ops[first[t], first[t + 1])
+  u32 threads;
+  u32 ids;
+  u64 records;
+  u64 skipped;
+};
+
+template<typename T>
+T *
+map_array(u64 n)
+{
+  if ( n == 0 ) n = 1;
+  addr_t *m = micron::map_normal(nullptr, n * sizeof(T));
+  if ( reinterpret_cast<uintptr_t>(m) >= ~static_cast<uintptr_t>(0xfff) ) return nullptr;
+  return reinterpret_cast<T *>(m);
+}
+
+template<typename T>
+void
+unmap_array(T *p, u64 n)
+{
+  if ( p ) micron::munmap(reinterpret_cast<addr_t *>(p), (n ? n : 1) * sizeof(T));
+}
+
+// the file, mapped private and writable so the records sort in place
+record *
+load(const char *path, u64 &n, u64 &map_len)
+{
+  const int fd = static_cast<int>(micron::syscall(SYS_open, path, 0 /*O_RDONLY*/, 0));
+  if ( fd < 0 ) return nullptr;
+  const long len = static_cast<long>(micron::syscall(SYS_lseek, fd, 0, 2 /*SEEK_END*/));
+  if ( len < static_cast<long>(sizeof(header)) ) {
+    micron::syscall(SYS_close, fd);
+    return nullptr;
+  }
+  // PROT_READ | PROT_WRITE, MAP_PRIVATE
+  void *m = reinterpret_cast<void *>(micron::syscall(SYS_mmap, nullptr, static_cast<usize>(len), 3, 2, fd, 0));
+  micron::syscall(SYS_close, fd);
+  if ( reinterpret_cast<uintptr_t>(m) >= ~static_cast<uintptr_t>(0xfff) ) return nullptr;
+  const header *h = reinterpret_cast<const header *>(m);
+  const char magic[8] = { 'A', 'B', 'C', 'T', 'R', 'A', 'C', 'E' };
+  if ( __builtin_memcmp(h->magic, magic, sizeof(magic)) != 0 or h->version != 1 or h->record_size != sizeof(record) ) {
+    micron::syscall(SYS_munmap, m, static_cast<usize>(len));
+    return nullptr;
+  }
+  map_len = static_cast<u64>(len);
+  n = (map_len - sizeof(header)) / sizeof(record);
+  return reinterpret_cast<record *>(reinterpret_cast<byte *>(m) + sizeof(header));
+}
+
+// bottom-up merge sort on ts; stable, so a thread's records keep their order
+void
+sort_by_ts(record *r, u64 n)
+{
+  record *tmp = map_array<record>(n);
+  record *src = r, *dst = tmp;
+  for ( u64 w = 1; w < n; w *= 2 ) {
+    for ( u64 lo = 0; lo < n; lo += 2 * w ) {
+      const u64 mid = lo + w < n ? lo + w : n;
+      const u64 hi = lo + 2 * w < n ? lo + 2 * w : n;
+      u64 i = lo, j = mid, k = lo;
+      while ( i < mid and j < hi ) dst[k++] = src[j].ts < src[i].ts ? src[j++] : src[i++];
+      while ( i < mid ) dst[k++] = src[i++];
+      while ( j < hi ) dst[k++] = src[j++];
+    }
+    record *t = src;
+    src = dst;
+    dst = t;
+  }
+  if ( src != r )
+    for ( u64 i = 0; i < n; ++i ) r[i] = src[i];
+  unmap_array(tmp, n);
+}
+
+// live address -> block id; linear probing with backward-shift deletion
+struct addr_map {
+  u64 *keys;
+  u32 *vals;
+  u64 mask;
+
+  bool
+  init(u64 n)
+  {
+    u64 cap = 16;
+    while ( cap < 2 * n ) cap *= 2;
+    keys = map_array<u64>(cap);
+    vals = map_array<u32>(cap);
+    mask = cap - 1;
+    return keys and vals;
+  }
+
+  void
+  release(void)
+  {
+    unmap_array(keys, mask + 1);
+    unmap_array(vals, mask + 1);
+  }
+
+  u64
+  home(u64 k) const
+  {
+    return ((k >> 4) * 0x9E3779B97F4A7C15ull) & mask;
+  }
+
+  void
+  put(u64 k, u32 v)
+  {
+    u64 i = home(k);
+    while ( keys[i] != 0 and keys[i] != k ) i = (i + 1) & mask;
+    keys[i] = k;
+    vals[i] = v;
+  }
+
+  // removes k and returns its id, NO_ID if it isn't there
+  u32
+  take(u64 k)
+  {
+    u64 i = home(k);
+    while ( keys[i] != k ) {
+      if ( keys[i] == 0 ) return NO_ID;
+      i = (i + 1) & mask;
+    }
+    const u32 v = vals[i];
+    u64 hole = i;
+    for ( u64 j = (i + 1) & mask; keys[j] != 0; j = (j + 1) & mask ) {
+      const u64 h = home(keys[j]);
+      // j's entry may move into the hole unless its home lies cyclically in (hole, j]
+      if ( ((j - h) & mask) >= ((j - hole) & mask) ) {
+        keys[hole] = keys[j];
+        vals[hole] = vals[j];
+        hole = j;
+      }
+    }
+    keys[hole] = 0;
+    return v;
+  }
+};
+
+bool
+build(record *r, u64 n, trace &t)
+{
+  t = trace{};
+  t.records = n;
+  op *seq = map_array<op>(n);
+  u32 *steps = map_array<u32>(n);
+  addr_map live{};
+  if ( !seq or !steps or !live.init(n) ) return false;
+  u32 tids[MAX_REPLAY_THREADS];
+  u32 pending[MAX_REPLAY_THREADS];
+  u64 n_seq = 0;
+
+  for ( u64 i = 0; i < n; ++i ) {
+    const record &rec = r[i];
+    u32 th = 0;
+    while ( th < t.threads and tids[th] != rec.tid ) ++th;
+    if ( th == t.threads ) {
+      if ( t.threads == MAX_REPLAY_THREADS ) {
+        ++t.skipped;
+        continue;
+      }
+      tids[t.threads] = rec.tid;
+      pending[t.threads++] = NO_ID;
+    }
+    switch ( rec.op ) {
+    case op_alloc: {
+      const u32 id = t.ids++;
+      live.put(rec.ptr, id);
+      seq[n_seq++] = op{ rec.size, id, 0, do_alloc, th };
+      steps[id] = 1;
+      break;
+    }
+    case op_free: {
+      const u32 id = live.take(rec.ptr);
+      if ( id == NO_ID ) {
+        ++t.skipped;
+        break;
+      }
+      seq[n_seq++] = op{ 0, id, steps[id]++, do_free, th };
+      break;
+    }
+    case op_resize_from:
+      pending[th] = live.take(rec.ptr);
+      break;
+    case op_resize_to: {
+      const u32 id = pending[th];
+      pending[th] = NO_ID;
+      if ( rec.size == 0 ) {      // the realloc failed, the block stayed where it was
+        if ( id != NO_ID ) live.put(rec.ptr, id);
+        break;
+      }
+      if ( id == NO_ID ) {      // a block from before the trace: replay what the program got, a fresh one
+        const u32 fresh = t.ids++;
+        live.put(rec.ptr, fresh);
+        seq[n_seq++] = op{ rec.size, fresh, 0, do_alloc, th };
+        steps[fresh] = 1;
+        break;
+      }
+      live.put(rec.ptr, id);
+      seq[n_seq++] = op{ rec.size, id, steps[id]++, do_resize, th };
+      break;
+    }
+    default:
+      ++t.skipped;
+    }
+  }
+
+  // counting sort by thread keeps each thread's ops in trace order
+  t.ops = map_array<op>(n_seq);
+  if ( !t.ops ) return false;
+  u64 count[MAX_REPLAY_THREADS + 1] = {};
+  for ( u64 i = 0; i < n_seq; ++i ) ++count[seq[i].thread + 1];
+  for ( u32 th = 0; th < t.threads; ++th ) count[th + 1] += count[th];
+  for ( u32 th = 0; th <= t.threads; ++th ) t.first[th] = count[th];
+  for ( u64 i = 0; i < n_seq; ++i ) t.ops[count[seq[i].thread]++] = seq[i];
+  t.n_ops = n_seq;
+
+  live.release();
+  unmap_array(steps, n);
+  unmap_array(seq, n);
+  return true;
+}
+
+struct alignas(64) lane {
+  const op *ops;
+  u64 n;
+};
+
+static lane g_lanes[MAX_REPLAY_THREADS];
+static byte **g_ptr = nullptr;      // block id -> current address
+static u32 *g_step = nullptr;       // block id -> ops it has taken, published with release
+
+[[gnu::always_inline]] inline void
+wait_for(u32 id, u32 need)
+{
+  for ( u32 spins = 0; __atomic_load_n(&g_step[id], __ATOMIC_ACQUIRE) != need; ++spins ) {
+    if ( spins < 1024 )
+      __cpu_pause();
+    else
+      micron::syscall(SYS_sched_yield);
+  }
+}
+
+void
+replay_lane(lane *l)
+{
+  for ( u64 i = 0; i < l->n; ++i ) {
+    const op &o = l->ops[i];
+    switch ( o.kind ) {
+    case do_alloc: {
+      byte *p = reinterpret_cast<byte *>(sx::alloc(o.size ? o.size : 1));
+      if ( p ) p[0] = 1;
+      g_ptr[o.id] = p;
+      __atomic_store_n(&g_step[o.id], 1u, __ATOMIC_RELEASE);
+      break;
+    }
+    case do_free:
+      wait_for(o.id, o.need);
+      sx::dealloc(g_ptr[o.id]);
+      g_ptr[o.id] = nullptr;
+      __atomic_store_n(&g_step[o.id], o.need + 1, __ATOMIC_RELEASE);
+      break;
+    case do_resize:
+      wait_for(o.id, o.need);
+      if ( g_ptr[o.id] ) g_ptr[o.id] = reinterpret_cast<byte *>(sx::resize(g_ptr[o.id], o.size));
+      __atomic_store_n(&g_step[o.id], o.need + 1, __ATOMIC_RELEASE);
+      break;
+    }
+  }
+}
+
+f64
+replay(const trace &t)
+{
+  for ( u32 i = 0; i < t.ids; ++i ) {
+    g_ptr[i] = nullptr;
+    g_step[i] = 0;
+  }
+  for ( u32 th = 0; th < t.threads; ++th ) g_lanes[th] = lane{ t.ops + t.first[th], t.first[th + 1] - t.first[th] };
+  alignas(sx::thread_t) static byte buf[MAX_REPLAY_THREADS * sizeof(sx::thread_t)];
+  sx::thread_t *pool = reinterpret_cast<sx::thread_t *>(buf);
+  const f64 t0 = sx::wall::now();
+  for ( u32 th = 0; th < t.threads; ++th ) ::new (static_cast<void *>(pool + th)) sx::thread_t{ replay_lane, g_lanes + th };
+  for ( u32 th = 0; th < t.threads; ++th ) {
+    pool[th].join();
+    pool[th].~thread_t();
+  }
+  const f64 secs = sx::wall::now() - t0;
+  for ( u32 i = 0; i < t.ids; ++i )
+    if ( g_ptr[i] ) sx::dealloc(g_ptr[i]);
+  return secs;
+}
+
+u32
+parse_u32(const char *s, u32 fallback)
+{
+  if ( s == nullptr or *s == 0 ) return fallback;
+  u32 v = 0;
+  for ( ; *s; ++s ) {
+    if ( *s < '0' or *s > '9' ) return fallback;
+    v = v * 10 + static_cast<u32>(*s - '0');
+  }
+  return v ? v : fallback;
+}
+
+};      // namespace
+
+int
+main(int argc, char **argv)
+{
+  if ( argc < 2 ) {
+    micron::io::println("usage: ", argc ? argv[0] : "bbench_replay", " <trace> [rounds]");
+    return 1;
+  }
+  const u32 rounds = parse_u32(argc > 2 ? argv[2] : nullptr, DEFAULT_ROUNDS);
+  u64 n = 0, map_len = 0;
+  record *r = load(argv[1], n, map_len);
+  if ( !r ) {
+    micron::io::println("replay: cannot read ", argv[1], " as an abcmalloc trace");
+    return 1;
+  }
+  sort_by_ts(r, n);
+  trace t{};
+  if ( !build(r, n, t) ) {
+    micron::io::println("replay: out of memory building the op list");
+    return 1;
+  }
+  micron::syscall(SYS_munmap, reinterpret_cast<byte *>(r) - sizeof(header), static_cast<usize>(map_len));
+  g_ptr = map_array<byte *>(t.ids);
+  g_step = map_array<u32>(t.ids);
+  if ( !g_ptr or !g_step ) {
+    micron::io::println("replay: out of memory for the block table");
+    return 1;
+  }
+
+  sx::header("replay", argv[1]);
+  micron::io::println("records ", t.records, "  ops ", t.n_ops, "  blocks ", t.ids, "  threads ", t.threads, "  skipped ", t.skipped);
+  for ( u32 i = 0; i < rounds; ++i ) {
+    sx::reset_peak_rss();
+    const f64 secs = replay(t);
+    sx::report(t.threads, secs, t.n_ops, "ops/s");
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
@@ -0,0 +1,222 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// Shared scaffolding for the classic allocator stress ports
+// (abcmalloc_stress_*.cpp: larson, cache-scratch, cache-thrash,
+// xmalloc-test, mstress, rptest, alloc-test) and the trace replayer
+// (abcmalloc_replay.cpp).
+//
+// Every port allocates through sx::alloc / sx::dealloc / sx::resize:
+// abcmalloc by default, the C library's malloc / free / realloc when built
+// with -DABCMALLOC_DISABLE (the *_libc ninja targets, glibc on a stock
+// system), so one source gives like-for-like numbers.
+//
+// A cell reports wall time and peak RSS. The peak is VmHWM from
+// /proc/self/status, reset before every cell through /proc/self/clear_refs,
+// so each cell gets its own high-water mark; it is process wide and
+// includes whatever earlier cells left mapped.
+
+#pragma once
+
+#include "../external/bbench/bench.hpp"
+
+#include <micron/atomic/atomic.hpp>
+#include <micron/bits/__pause.hpp>
+#include <micron/io/console.hpp>
+#include <micron/io/stdout.hpp>
+#include <micron/std.hpp>
+#include <micron/syscall.hpp>
+#include <micron/thread/threads.hpp>
+
+namespace sx
+{
+
+#if defined(ABCMALLOC_DISABLE)
+constexpr const char *ALLOCATOR = "libc";
+
+[[gnu::always_inline]] inline void *
+alloc(usize n) noexcept
+{
+  return ::malloc(n);
+}
+
+[[gnu::always_inline]] inline void
+dealloc(void *p) noexcept
+{
+  ::free(p);
+}
+
+[[gnu::always_inline]] inline void *
+resize(void *p, usize n) noexcept
+{
+  return ::realloc(p, n);
+}
+#else
+constexpr const char *ALLOCATOR = "abcmalloc";
+
+[[gnu::always_inline]] inline void *
+alloc(usize n) noexcept
+{
+  return abc::alloc(n);
+}
+
+[[gnu::always_inline]] inline void
+dealloc(void *p) noexcept
+{
+  abc::dealloc(reinterpret_cast<byte *>(p));
+}
+
+[[gnu::always_inline]] inline void *
+resize(void *p, usize n) noexcept
+{
+  return abc::realloc(p, n);
+}
+#endif
+
+using wall = bbench::system_clock<bbench::system_clocks::monotonic>;
+using thread_t = micron::thread<>;
+
+constexpr u32 MAX_THREADS = 64;
+constexpr u32 THREADS[] = { 1u, 4u, 16u };
+
+// lran2 from the original larson / xmalloc sources, so the sequences match theirs
+struct lran2 {
+  static constexpr i64 LRAN2_MAX = 714025;
+  static constexpr i64 IA = 1366;
+  static constexpr i64 IC = 150889;
+  i64 x;
+  i64 y;
+  i64 v[97];
+
+  explicit lran2(i64 seed) noexcept
+  {
+    x = (IC - seed) % LRAN2_MAX;
+    if ( x < 0 ) x = -x;
+    for ( u32 j = 0; j < 97; ++j ) {
+      x = (IA * x + IC) % LRAN2_MAX;
+      v[j] = x;
+    }
+    x = (IA * x + IC) % LRAN2_MAX;
+    y = x;
+  }
+
+  [[gnu::always_inline]] inline u64
+  next(void) noexcept
+  {
+    const i64 j = y % 97;
+    y = v[j];
+    x = (IA * x + IC) % LRAN2_MAX;
+    v[j] = x;
+    return static_cast<u64>(y);
+  }
+};
+
+// xorshift for the ports that don't prescribe a generator
+[[gnu::always_inline]] inline u64
+xrand(u64 &s) noexcept
+{
+  s ^= s << 13;
+  s ^= s >> 7;
+  s ^= s << 17;
+  return s;
+}
+
+inline void
+sleep_ms(u32 ms)
+{
+  bbench::__impl::__sleep_ms(ms);
+}
+
+inline void
+reset_peak_rss(void) noexcept
+{
+  const int fd = static_cast<int>(micron::syscall(SYS_open, "/proc/self/clear_refs", 01 /*O_WRONLY*/, 0));
+  if ( fd < 0 ) return;
+  micron::syscall(SYS_write, fd, "5", 1);
+  micron::syscall(SYS_close, fd);
+}
+
+// VmHWM in KiB, 0 if /proc isn't there
+inline u64
+peak_rss_kib(void) noexcept
+{
+  char buf[4096];
+  const int fd = static_cast<int>(micron::syscall(SYS_open, "/proc/self/status", 0 /*O_RDONLY*/, 0));
+  if ( fd < 0 ) return 0;
+  const long n = static_cast<long>(micron::syscall(SYS_read, fd, buf, sizeof(buf) - 1));
+  micron::syscall(SYS_close, fd);
+  if ( n <= 0 ) return 0;
+  buf[n] = 0;
+  for ( long i = 0; i + 6 < n; ++i ) {
+    if ( buf[i] != 'V' or buf[i + 1] != 'm' or buf[i + 2] != 'H' or buf[i + 3] != 'W' or buf[i + 4] != 'M' or buf[i + 5] != ':' ) continue;
+    u64 v = 0;
+    for ( long k = i + 6; k < n and buf[k] != '\n'; ++k )
+      if ( buf[k] >= '0' and buf[k] <= '9' ) v = v * 10 + static_cast<u64>(buf[k] - '0');
+    return v;
+  }
+  return 0;
+}
+
+// runs fn(ctx + i) on n threads and joins them; returns the wall time in seconds
+template<typename Ctx>
+f64
+run_threads(u32 n, void (*fn)(Ctx *), Ctx *ctx)
+{
+  alignas(thread_t) static byte buf[MAX_THREADS * sizeof(thread_t)];
+  thread_t *pool = reinterpret_cast<thread_t *>(buf);
+  const f64 t0 = wall::now();
+  for ( u32 i = 0; i < n; ++i ) ::new (static_cast<void *>(pool + i)) thread_t{ fn, ctx + i };
+  for ( u32 i = 0; i < n; ++i ) {
+    pool[i].join();
+    pool[i].~thread_t();
+  }
+  return wall::now() - t0;
+}
+
+// x1000 fixed point, three decimals
+struct fixed3 {
+  char s[32];
+
+  explicit fixed3(f64 v) noexcept
+  {
+    u64 x = static_cast<u64>(v * 1000.0 + 0.5);
+    char tmp[32];
+    u32 k = 0;
+    for ( u32 d = 0; d < 3; ++d ) {
+      tmp[k++] = static_cast<char>('0' + x % 10);
+      x /= 10;
+    }
+    tmp[k++] = '.';
+    do {
+      tmp[k++] = static_cast<char>('0' + x % 10);
+      x /= 10;
+    } while ( x );
+    for ( u32 i = 0; i < k; ++i ) s[i] = tmp[k - 1 - i];
+    s[k] = 0;
+  }
+};
+
+inline void
+header(const char *name, const char *what)
+{
+  micron::io::println("=== ", name, " (", ALLOCATOR, ") ===");
+  micron::io::println(what);
+}
+
+// one result line; rate_unit == nullptr leaves the rate column out
+inline void
+report(u32 threads, f64 secs, u64 ops, const char *rate_unit)
+{
+  if ( rate_unit ) {
+    const f64 rate = secs > 0.0 ? static_cast<f64>(ops) / secs / 1e6 : 0.0;
+    micron::io::println("threads ", threads, "  time ", fixed3(secs).s, " s  ", fixed3(rate).s, " M", rate_unit, "  peak rss ",
+                        peak_rss_kib(), " KiB");
+  } else {
+    micron::io::println("threads ", threads, "  time ", fixed3(secs).s, " s  peak rss ", peak_rss_kib(), " KiB");
+  }
+}
+
+};      // namespace sx
@@ -0,0 +1,89 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// alloc-test: random working-set churn (OLDS/ithare alloc-test), as run by
+// mimalloc-bench with `alloc-test N`; the op count is cut to keep a cell
+// short.
+//
+// Every thread owns SLOTS slots and for OPS steps picks a random one: an
+// occupied slot is freed, an empty one is filled. The working set hovers
+// around half the slots and the pick order keeps it cold, so the cost of
+// finding and returning memory shows, not just the hot free-list pop. Sizes
+// follow a power law: the class is the number of trailing zero bits of a
+// random draw (half the blocks in the first, a quarter in the next, ...),
+// from MIN_SIZE up to MAX_SIZE, with a random offset inside the class.
+// Reports ops (allocs + frees) per second.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 SLOTS = 1u << 16;
+constexpr u64 OPS = 4'000'000ULL;
+constexpr u32 MIN_SHIFT = 3;      // 8 B
+constexpr u32 MAX_SHIFT = 10;      // 1 KiB
+
+struct alignas(64) worker {
+  u64 seed;
+  u64 allocs;
+  u64 frees;
+  byte **slots;
+};
+
+static worker g_w[sx::MAX_THREADS];
+
+usize
+power_law_size(u64 &s)
+{
+  const u64 r = sx::xrand(s);
+  u32 k = static_cast<u32>(__builtin_ctzll(r | (1ULL << 63)));
+  if ( k > MAX_SHIFT - MIN_SHIFT ) k = MAX_SHIFT - MIN_SHIFT;
+  const usize lo = static_cast<usize>(1) << (MIN_SHIFT + k);
+  return lo + static_cast<usize>((r >> 40) % lo);
+}
+
+void
+body(worker *w)
+{
+  for ( u64 i = 0; i < OPS; ++i ) {
+    byte *&s = w->slots[sx::xrand(w->seed) & (SLOTS - 1)];
+    if ( s ) {
+      sx::dealloc(s);
+      s = nullptr;
+      ++w->frees;
+    } else {
+      const usize sz = power_law_size(w->seed);
+      s = reinterpret_cast<byte *>(sx::alloc(sz));
+      s[0] = static_cast<byte>(i);
+      ++w->allocs;
+    }
+  }
+  for ( u32 i = 0; i < SLOTS; ++i ) {
+    if ( w->slots[i] == nullptr ) continue;
+    sx::dealloc(w->slots[i]);
+    w->slots[i] = nullptr;
+  }
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("alloc-test", "random alloc/free over a per-thread working set of 64K slots, power-law sizes 8 B - 2 KiB");
+  static byte *slots[sx::MAX_THREADS * SLOTS];
+  for ( u32 n : sx::THREADS ) {
+    sx::reset_peak_rss();
+    for ( u32 i = 0; i < n; ++i ) g_w[i] = worker{ 0x853c49e6748fea9bULL * (i + 1), 0, 0, slots + static_cast<usize>(i) * SLOTS };
+    const f64 secs = sx::run_threads(n, body, g_w);
+    u64 ops = 0;
+    for ( u32 i = 0; i < n; ++i ) ops += g_w[i].allocs + g_w[i].frees;
+    sx::report(n, secs, ops, "ops/s");
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
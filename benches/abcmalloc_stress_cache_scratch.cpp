@@ -0,0 +1,64 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// cache-scratch: passive false sharing (Hoard, Berger et al.), as run by
+// mimalloc-bench with `cache-scratch N 1000 1 2000000 N`; REPETITIONS is cut
+// by 10x to keep a cell short.
+//
+// The main thread allocates one OBJ_SIZE object per worker back to back,
+// so they share cache lines, and hands one to each worker. A worker frees
+// it, then ITERATIONS times allocates an OBJ_SIZE object and writes it
+// REPETITIONS times. An allocator that gives the freed neighbour slot back
+// to a different thread puts two writers on one line, and the time grows
+// with the thread count; the work per thread is fixed, so ideal is flat.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 ITERATIONS = 1000;
+constexpr usize OBJ_SIZE = 1;
+constexpr u32 REPETITIONS = 200000;
+
+struct alignas(64) worker {
+  byte *object;
+};
+
+static worker g_w[sx::MAX_THREADS];
+
+void
+scratch(worker *w)
+{
+  sx::dealloc(w->object);
+  for ( u32 i = 0; i < ITERATIONS; ++i ) {
+    volatile byte *a = reinterpret_cast<volatile byte *>(sx::alloc(OBJ_SIZE));
+    for ( u32 j = 0; j < REPETITIONS; ++j ) {
+      for ( usize k = 0; k < OBJ_SIZE; ++k ) {
+        a[k] = static_cast<byte>(i);
+        byte ch = a[k];
+        a[k] = static_cast<byte>(ch + 1);
+      }
+    }
+    sx::dealloc(const_cast<byte *>(a));
+  }
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("cache-scratch", "passive false sharing: workers free neighbouring objects from main, then write fresh ones");
+  for ( u32 n : sx::THREADS ) {
+    sx::reset_peak_rss();
+    for ( u32 i = 0; i < n; ++i ) g_w[i].object = reinterpret_cast<byte *>(sx::alloc(OBJ_SIZE));
+    const f64 secs = sx::run_threads(n, scratch, g_w);
+    sx::report(n, secs, 0, nullptr);
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
@@ -0,0 +1,61 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// cache-thrash: active false sharing (Hoard, Berger et al.), as run by
+// mimalloc-bench with `cache-thrash N 1000 1 2000000 N`; REPETITIONS is cut
+// by 10x to keep a cell short.
+//
+// Every worker ITERATIONS times allocates an OBJ_SIZE object, writes it
+// REPETITIONS times and frees it. Workers allocate at the same moment, so
+// an allocator that carves their objects from one shared line makes them
+// fight over it; the work per thread is fixed, so ideal is flat.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 ITERATIONS = 1000;
+constexpr usize OBJ_SIZE = 1;
+constexpr u32 REPETITIONS = 200000;
+
+struct alignas(64) worker {
+  u32 idx;
+};
+
+static worker g_w[sx::MAX_THREADS];
+
+void
+thrash(worker *)
+{
+  for ( u32 i = 0; i < ITERATIONS; ++i ) {
+    volatile byte *a = reinterpret_cast<volatile byte *>(sx::alloc(OBJ_SIZE));
+    for ( u32 j = 0; j < REPETITIONS; ++j ) {
+      for ( usize k = 0; k < OBJ_SIZE; ++k ) {
+        a[k] = static_cast<byte>(i);
+        byte ch = a[k];
+        a[k] = static_cast<byte>(ch + 1);
+      }
+    }
+    sx::dealloc(const_cast<byte *>(a));
+  }
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("cache-thrash", "active false sharing: workers allocate and write small objects at the same time");
+  for ( u32 n : sx::THREADS ) {
+    sx::reset_peak_rss();
+    for ( u32 i = 0; i < n; ++i ) g_w[i].idx = i;
+    const f64 secs = sx::run_threads(n, thrash, g_w);
+    sx::report(n, secs, 0, nullptr);
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
@@ -0,0 +1,108 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// larson: server-style churn (Larson & Krishnan, "Memory Allocation for
+// Long-Running Server Applications"), as run by mimalloc-bench with
+// `larson 5 8 1000 5000 100 4141 N`, shortened to LARSON_SECS.
+//
+// Each thread owns CHUNKS random-sized blocks (MIN_SIZE..MAX_SIZE) and for
+// ROUNDS * CHUNKS steps frees a random one and allocates a replacement.
+// When its steps are done the thread exits and a fresh thread takes over
+// the same blocks, so every generation frees what a dead thread allocated:
+// the cross-thread and thread-exit paths carry the load, not just the hot
+// path. The original has the exiting thread spawn its successor; here a
+// lane thread starts and joins the generations in turn, which leaves the
+// same alloc/free pattern. Reports ops (allocs + frees) per second.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 LARSON_SECS = 3;
+constexpr usize MIN_SIZE = 8;
+constexpr usize MAX_SIZE = 1000;
+constexpr u32 CHUNKS = 5000;
+constexpr u32 ROUNDS = 100;
+constexpr i64 SEED = 4141;
+
+struct alignas(64) lane {
+  byte **blocks;
+  sx::lran2 rgen{ SEED };
+  u64 allocs;
+  u64 frees;
+  u32 generations;
+};
+
+static lane g_lanes[sx::MAX_THREADS];
+static byte *g_blocks[sx::MAX_THREADS * CHUNKS];
+alignas(64) static micron::atomic_token<u32> g_stop{ 0 };
+
+void
+generation(lane *l)
+{
+  const usize range = MAX_SIZE - MIN_SIZE;
+  for ( u64 i = 0; i < static_cast<u64>(ROUNDS) * CHUNKS; ++i ) {
+    const u32 victim = static_cast<u32>(l->rgen.next() % CHUNKS);
+    sx::dealloc(l->blocks[victim]);
+    ++l->frees;
+    const usize sz = MIN_SIZE + static_cast<usize>(l->rgen.next() % range);
+    byte *p = reinterpret_cast<byte *>(sx::alloc(sz));
+    p[0] = 'a';
+    p[sz - 1] = 'b';
+    l->blocks[victim] = p;
+    ++l->allocs;
+    if ( (i & 1023) == 0 and g_stop.get(micron::memory_order_relaxed) ) break;
+  }
+}
+
+void
+lane_body(lane *l)
+{
+  while ( !g_stop.get(micron::memory_order_acquire) ) {
+    sx::thread_t next{ generation, l };
+    next.join();
+    ++l->generations;
+  }
+}
+
+// the lanes run until the timer stops them; the driver thread only sleeps
+void
+timer(lane *)
+{
+  sx::sleep_ms(LARSON_SECS * 1000);
+  g_stop.store(1, micron::memory_order_release);
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("larson", "server churn: random free + realloc over per-thread blocks, each generation on a new thread");
+  for ( u32 n : sx::THREADS ) {
+    sx::reset_peak_rss();
+    g_stop.store(0, micron::memory_order_relaxed);
+    sx::lran2 warm{ SEED };
+    for ( u32 i = 0; i < n * CHUNKS; ++i )
+      g_blocks[i] = reinterpret_cast<byte *>(sx::alloc(MIN_SIZE + static_cast<usize>(warm.next() % (MAX_SIZE - MIN_SIZE))));
+    for ( u32 i = 0; i < n; ++i ) {
+      g_lanes[i] = lane{};
+      g_lanes[i].blocks = g_blocks + static_cast<usize>(i) * CHUNKS;
+      g_lanes[i].rgen = sx::lran2{ SEED + i };
+    }
+    lane stopper{};
+    sx::thread_t t{ timer, &stopper };
+    const f64 secs = sx::run_threads(n, lane_body, g_lanes);
+    t.join();
+    u64 ops = 0;
+    for ( u32 i = 0; i < n; ++i ) ops += g_lanes[i].allocs + g_lanes[i].frees;
+    sx::report(n, secs, ops, "ops/s");
+    for ( u32 i = 0; i < n * CHUNKS; ++i ) sx::dealloc(g_blocks[i]);
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
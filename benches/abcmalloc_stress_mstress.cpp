@@ -0,0 +1,152 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// mstress: mimalloc's test-stress, as run by mimalloc-bench with
+// `mstress N 50 25`; ITER is cut to 10 rounds to keep a cell short.
+//
+// Every round each thread runs 100 * SCALE * (tid % 8 + 1) steps over two
+// arrays: `data`, which it frees at random as it goes (66%), and
+// `retained`, which it keeps until the round ends. Items are mostly a few
+// words, with rare large (1%), huge (0.1%) and giant (0.01%) ones, so every
+// tier sees traffic. At 25% a step swaps one of its live items with a
+// random slot of a process-wide transfer array; whatever it gets back was
+// allocated on another thread, possibly in an earlier round, and is freed
+// here later. Items carry a cookie pattern that is checked on free, so a
+// block handed out twice shows up as a corrupt word. Reports wall time.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 SCALE = 50;
+constexpr u32 ITER = 10;
+constexpr u32 TRANSFERS = 1000;
+constexpr u64 COOKIE = 0xbf58476d1ce4e5b9ULL;
+
+struct alignas(64) worker {
+  u32 tid;
+  u64 corrupt;
+};
+
+static worker g_w[sx::MAX_THREADS];
+static micron::atomic_token<u64 *> g_transfer[TRANSFERS];
+
+// percent chance
+[[gnu::always_inline]] inline bool
+chance(u64 perc, u64 &r)
+{
+  return sx::xrand(r) % 100 <= perc;
+}
+
+u64 *
+alloc_items(usize items, u64 &r)
+{
+  if ( chance(1, r) ) {
+    if ( chance(1, r) )
+      items *= 10000;      // giant
+    else if ( chance(10, r) )
+      items *= 1000;      // huge
+    else
+      items *= 100;      // large
+  }
+  if ( items == 40 ) ++items;      // pthreads uses that size for stack allocations
+  u64 *p = reinterpret_cast<u64 *>(sx::alloc(items * sizeof(u64)));
+  if ( p != nullptr )
+    for ( usize i = 0; i < items; ++i ) p[i] = (items - i) ^ COOKIE;
+  return p;
+}
+
+void
+free_items(u64 *p, worker *w)
+{
+  if ( p == nullptr ) return;
+  const u64 items = p[0] ^ COOKIE;
+  for ( u64 i = 0; i < items; ++i ) {
+    if ( (p[i] ^ COOKIE) != items - i ) {
+      ++w->corrupt;
+      break;
+    }
+  }
+  sx::dealloc(p);
+}
+
+// grows a pointer array; no realloc so both allocators run the same path
+u64 **
+grow(u64 **old, usize used, usize cap)
+{
+  u64 **fresh = reinterpret_cast<u64 **>(sx::alloc(cap * sizeof(u64 *)));
+  for ( usize i = 0; i < used; ++i ) fresh[i] = old[i];
+  for ( usize i = used; i < cap; ++i ) fresh[i] = nullptr;
+  if ( old ) sx::dealloc(old);
+  return fresh;
+}
+
+void
+stress(worker *w)
+{
+  u64 r = (static_cast<u64>(w->tid) + 1) * 43;
+  constexpr u32 max_item_shift = 5;      // 128 B
+  constexpr u32 max_item_retained_shift = max_item_shift + 2;
+  usize allocs = 100 * static_cast<usize>(SCALE) * (w->tid % 8 + 1);
+  usize retain = allocs / 2;
+  u64 **data = nullptr;
+  usize data_size = 0, data_top = 0;
+  u64 **retained = grow(nullptr, 0, retain);
+  usize retain_top = 0;
+
+  while ( allocs > 0 or retain > 0 ) {
+    if ( retain == 0 or (chance(50, r) and allocs > 0) ) {
+      --allocs;
+      if ( data_top >= data_size ) {
+        const usize cap = data_size == 0 ? 1000 : data_size * 2;
+        data = grow(data, data_top, cap);
+        data_size = cap;
+      }
+      data[data_top++] = alloc_items(static_cast<usize>(1) << (sx::xrand(r) % max_item_shift), r);
+    } else {
+      retained[retain_top++] = alloc_items(static_cast<usize>(1) << (sx::xrand(r) % max_item_retained_shift), r);
+      --retain;
+    }
+    if ( chance(66, r) and data_top > 0 ) {
+      const usize idx = sx::xrand(r) % data_top;
+      free_items(data[idx], w);
+      data[idx] = nullptr;
+    }
+    if ( chance(25, r) and data_top > 0 ) {
+      const usize idx = sx::xrand(r) % TRANSFERS;
+      const usize data_idx = sx::xrand(r) % data_top;
+      data[data_idx] = g_transfer[idx].swap(data[data_idx], micron::memory_order::acq_rel);
+    }
+  }
+  for ( usize i = 0; i < retain_top; ++i ) free_items(retained[i], w);
+  for ( usize i = 0; i < data_top; ++i ) free_items(data[i], w);
+  sx::dealloc(retained);
+  if ( data ) sx::dealloc(data);
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("mstress", "mixed lifetimes and sizes with cross-thread hand-off through a shared transfer array");
+  u64 corrupt = 0;
+  for ( u32 n : sx::THREADS ) {
+    sx::reset_peak_rss();
+    for ( u32 i = 0; i < n; ++i ) g_w[i] = worker{ i, 0 };
+    f64 secs = 0.0;
+    for ( u32 round = 0; round < ITER; ++round ) secs += sx::run_threads(n, stress, g_w);
+    worker tail{};
+    for ( u32 i = 0; i < TRANSFERS; ++i ) free_items(g_transfer[i].swap(nullptr, micron::memory_order::acq_rel), &tail);
+    sx::report(n, secs, 0, nullptr);
+    corrupt += tail.corrupt;
+    for ( u32 i = 0; i < n; ++i ) corrupt += g_w[i].corrupt;
+  }
+  if ( corrupt ) micron::io::println("!!! ", corrupt, " corrupt items");
+  micron::io::println("=== done ===");
+  return corrupt ? 1 : 0;
+}
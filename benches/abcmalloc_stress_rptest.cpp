@@ -0,0 +1,151 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// rptest: rpmalloc's benchmark workload (mixed lifetimes, skewed sizes,
+// cross-thread frees), as run by mimalloc-bench in its rptest configuration;
+// loop counts are cut to keep a cell short.
+//
+// Every thread keeps WORKING_SET slots. A slot holds a block that lives a
+// random number of loops (1..MAX_LIFE); when it expires it is freed, or one
+// time in CROSS_RATE it is pushed onto the next thread's inbox for that
+// thread to free, and the slot is refilled. Sizes are log-skewed: the
+// shift is the smaller of two draws over 16 B..32 KiB, so small blocks
+// dominate and the larger classes stay warm. Inboxes are lock-free stacks
+// threaded through the blocks themselves and are drained at the top of
+// every loop. Reports ops (allocs + frees) per second.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 WORKING_SET = 4000;
+constexpr u32 LOOPS = 200;
+constexpr u32 MAX_LIFE = 16;
+constexpr u32 CROSS_RATE = 8;
+constexpr u32 MIN_SHIFT = 4;      // 16 B, room for an inbox link
+constexpr u32 SHIFTS = 12;      // up to 32 KiB
+
+struct node {
+  node *next;
+};
+
+struct slot {
+  byte *ptr;
+  u32 expire;
+};
+
+struct alignas(64) worker {
+  u32 idx;
+  u32 peers;
+  u64 seed;
+  u64 allocs;
+  u64 frees;
+  slot *slots;
+  alignas(64) micron::atomic_token<node *> inbox{ nullptr };
+};
+
+static worker g_w[sx::MAX_THREADS];
+alignas(64) static micron::atomic_token<u32> g_done{ 0 };
+
+usize
+skewed_size(u64 &s)
+{
+  const u32 a = static_cast<u32>(sx::xrand(s) % SHIFTS);
+  const u32 b = static_cast<u32>(sx::xrand(s) % SHIFTS);
+  const u32 shift = MIN_SHIFT + (a < b ? a : b);
+  const usize lo = static_cast<usize>(1) << shift;
+  return lo + static_cast<usize>(sx::xrand(s) % lo);
+}
+
+void
+push(worker *to, byte *p)
+{
+  node *n = reinterpret_cast<node *>(p);
+  n->next = to->inbox.get(micron::memory_order_relaxed);
+  while ( !to->inbox.compare_exchange_weak(n->next, n, micron::memory_order_release, micron::memory_order_relaxed) ) {
+  }
+}
+
+void
+drain(worker *w)
+{
+  node *n = w->inbox.swap(nullptr, micron::memory_order::acq_rel);
+  while ( n ) {
+    node *next = n->next;
+    sx::dealloc(n);
+    ++w->frees;
+    n = next;
+  }
+}
+
+void
+fill(worker *w, slot &s, u32 loop)
+{
+  const usize sz = skewed_size(w->seed);
+  s.ptr = reinterpret_cast<byte *>(sx::alloc(sz));
+  s.ptr[0] = static_cast<byte>(loop);
+  s.ptr[sz - 1] = static_cast<byte>(loop);
+  s.expire = loop + 1 + static_cast<u32>(sx::xrand(w->seed) % MAX_LIFE);
+  ++w->allocs;
+}
+
+void
+body(worker *w)
+{
+  worker *next = &g_w[(w->idx + 1) % w->peers];
+  for ( u32 i = 0; i < WORKING_SET; ++i ) fill(w, w->slots[i], 0);
+  for ( u32 loop = 1; loop <= LOOPS; ++loop ) {
+    drain(w);
+    for ( u32 i = 0; i < WORKING_SET; ++i ) {
+      slot &s = w->slots[i];
+      if ( s.expire > loop ) continue;
+      if ( w->peers > 1 and sx::xrand(w->seed) % CROSS_RATE == 0 ) {
+        push(next, s.ptr);
+      } else {
+        sx::dealloc(s.ptr);
+        ++w->frees;
+      }
+      fill(w, s, loop);
+    }
+  }
+  for ( u32 i = 0; i < WORKING_SET; ++i ) {
+    sx::dealloc(w->slots[i].ptr);
+    ++w->frees;
+  }
+  // nobody pushes once every thread is past its loops
+  g_done.fetch_add(1, micron::memory_order_acq_rel);
+  while ( g_done.get(micron::memory_order_acquire) < w->peers ) __cpu_pause();
+  drain(w);
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("rptest", "mixed lifetimes, log-skewed sizes, 1/8 of expiring blocks freed by the next thread");
+  static slot slots[sx::MAX_THREADS * WORKING_SET];
+  for ( u32 n : sx::THREADS ) {
+    sx::reset_peak_rss();
+    g_done.store(0, micron::memory_order_relaxed);
+    for ( u32 i = 0; i < n; ++i ) {
+      g_w[i].idx = i;
+      g_w[i].peers = n;
+      g_w[i].seed = 0x2545f4914f6cdd1dULL * (i + 1);
+      g_w[i].allocs = 0;
+      g_w[i].frees = 0;
+      g_w[i].slots = slots + static_cast<usize>(i) * WORKING_SET;
+      g_w[i].inbox.store(nullptr, micron::memory_order_relaxed);
+    }
+    const f64 secs = sx::run_threads(n, body, g_w);
+    u64 ops = 0;
+    for ( u32 i = 0; i < n; ++i ) ops += g_w[i].allocs + g_w[i].frees;
+    sx::report(n, secs, ops, "ops/s");
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
@@ -0,0 +1,182 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// xmalloc-test: producer/consumer with a shared batch stack (Lever & Boreham,
+// "malloc() Performance in a Multithreaded Linux Environment"), as run by
+// mimalloc-bench with `xmalloc-test -w N -t 5 -s 64`, shortened to XM_SECS.
+//
+// Half the threads are writers: they allocate BATCH_SIZE blocks of random
+// size up to MAX_SIZE, push the filled batch onto a lock-guarded stack and
+// start another. The other half are readers: they pop a batch and free all
+// of it. Nearly every free is therefore remote, and the allocator has to
+// move memory from the consumers back to the producers. Writers back off
+// when MAX_BATCHES are outstanding so memory stays bounded. Reports frees
+// per second.
+
+#include "abcmalloc_stress.hpp"
+
+namespace
+{
+
+constexpr u32 XM_SECS = 3;
+constexpr usize MAX_SIZE = 64;
+constexpr u32 BATCH_SIZE = 4096;
+constexpr u32 MAX_BATCHES = 512;
+
+struct batch {
+  batch *next;
+  u32 n;
+  void *ptrs[BATCH_SIZE];
+};
+
+struct alignas(64) worker {
+  u64 seed;
+  u64 allocs;
+  u64 frees;
+  bool writer;
+};
+
+static worker g_w[sx::MAX_THREADS];
+alignas(64) static micron::atomic_token<u32> g_lock{ 0 };
+static batch *g_stack = nullptr;
+static u32 g_depth = 0;
+alignas(64) static micron::atomic_token<u32> g_stop{ 0 };
+
+void
+lock(void)
+{
+  for ( ;; ) {
+    u32 expect = 0;
+    if ( g_lock.compare_exchange_weak(expect, 1, micron::memory_order_acquire, micron::memory_order_relaxed) ) return;
+    while ( g_lock.get(micron::memory_order_relaxed) ) __cpu_pause();
+  }
+}
+
+void
+unlock(void)
+{
+  g_lock.store(0, micron::memory_order_release);
+}
+
+bool
+push(batch *b)
+{
+  lock();
+  if ( g_depth >= MAX_BATCHES ) {
+    unlock();
+    return false;
+  }
+  b->next = g_stack;
+  g_stack = b;
+  ++g_depth;
+  unlock();
+  return true;
+}
+
+batch *
+pop(void)
+{
+  lock();
+  batch *b = g_stack;
+  if ( b ) {
+    g_stack = b->next;
+    --g_depth;
+  }
+  unlock();
+  return b;
+}
+
+void
+release(batch *b, worker *w)
+{
+  for ( u32 i = 0; i < b->n; ++i ) sx::dealloc(b->ptrs[i]);
+  w->frees += b->n;
+  sx::dealloc(b);
+}
+
+void
+writer(worker *w)
+{
+  while ( !g_stop.get(micron::memory_order_relaxed) ) {
+    batch *b = reinterpret_cast<batch *>(sx::alloc(sizeof(batch)));
+    b->n = BATCH_SIZE;
+    for ( u32 i = 0; i < BATCH_SIZE; ++i ) {
+      const usize sz = 1 + static_cast<usize>(sx::xrand(w->seed) % MAX_SIZE);
+      byte *p = reinterpret_cast<byte *>(sx::alloc(sz));
+      p[0] = static_cast<byte>(i);
+      b->ptrs[i] = p;
+    }
+    w->allocs += BATCH_SIZE;
+    while ( !push(b) ) {
+      if ( g_stop.get(micron::memory_order_relaxed) ) {
+        release(b, w);
+        return;
+      }
+      __cpu_pause();
+    }
+  }
+}
+
+void
+reader(worker *w)
+{
+  for ( ;; ) {
+    batch *b = pop();
+    if ( b ) {
+      release(b, w);
+      continue;
+    }
+    if ( g_stop.get(micron::memory_order_acquire) ) return;
+    __cpu_pause();
+  }
+}
+
+void
+body(worker *w)
+{
+  if ( w->writer )
+    writer(w);
+  else
+    reader(w);
+}
+
+void
+timer(worker *)
+{
+  sx::sleep_ms(XM_SECS * 1000);
+  g_stop.store(1, micron::memory_order_release);
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  sx::header("xmalloc-test", "producer/consumer: writers fill batches of small blocks, readers free them on other threads");
+  for ( u32 n : sx::THREADS ) {
+    // one writer and one reader at minimum, else nothing is ever freed
+    const u32 threads = n < 2 ? 2 : n;
+    sx::reset_peak_rss();
+    g_stop.store(0, micron::memory_order_relaxed);
+    for ( u32 i = 0; i < threads; ++i ) {
+      g_w[i] = worker{};
+      g_w[i].seed = 0x9e3779b97f4a7c15ULL * (i + 1);
+      g_w[i].writer = (i & 1) == 0;
+    }
+    worker stopper{};
+    sx::thread_t t{ timer, &stopper };
+    const f64 secs = sx::run_threads(threads, body, g_w);
+    t.join();
+    // readers have exited; whatever the writers left on the stack is freed here and not counted
+    worker tail{};
+    while ( batch *b = pop() ) release(b, &tail);
+    u64 frees = 0;
+    for ( u32 i = 0; i < threads; ++i ) frees += g_w[i].frees;
+    sx::report(threads, secs, frees, "frees/s");
+  }
+  micron::io::println("=== done ===");
+  return 0;
+}
@@ -0,0 +1,154 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// dTLB pressure benchmark for hot-tier sheet backing.
+//
+// Builds one singly linked list per cell out of allocator-provided nodes,
+// linked in a shuffled order, and chases it. Every hop is a dependent load
+// to an effectively random address inside the hot tiers, which is exactly
+// the pattern that transparent huge pages (MICRON_ABC_THP) are meant to
+// help: with 4 KiB pages nearly every hop needs a fresh dTLB entry, with
+// 2 MiB pages one entry covers 512x more of the heap.
+//
+// Build the micron allocator once with and once without MICRON_ABC_THP=1
+// and compare the two runs.
+//
+// Per cell we report, over the chase only (allocation is not measured):
+//   dTLB miss/hop   dtlb_miss / hops, the headline number of this bench
+//   dTLB miss %     dtlb_miss / dtlb_access
+//   cyc/hop         hardware cycles per hop
+//
+// Cells: node sizes spanning precise / small / medium; each cell's list is
+// capped at FOOTPRINT bytes of nodes so the working set is far past the
+// dTLB reach of small pages on every current core.
+
+#include "../external/bbench/bench.hpp"
+
+#include <micron/io/console.hpp>
+#include <micron/io/stdout.hpp>
+#include <micron/std.hpp>
+
+namespace
+{
+
+using tlb_events = bbench::event_group<bbench::hardware_cycles, bbench::hardware_instructions, bbench::dtlb_access, bbench::dtlb_miss>;
+
+constexpr u32 K_MEASUREMENTS = 3;
+constexpr usize FOOTPRINT = 256ULL << 20;
+constexpr u64 MAX_NODES = 1ULL << 21;
+constexpr u64 HOPS = 1ULL << 24;
+
+constexpr usize SIZES[] = { 32, 128, 256, 1024, 4096, 16384 };
+
+struct chase_node {
+  chase_node *next;
+};
+
+u64
+xorshift(u64 &s) noexcept
+{
+  s ^= s << 13;
+  s ^= s >> 7;
+  s ^= s << 17;
+  return s;
+}
+
+struct cell {
+  usize size;
+  u64 nodes;
+  f64 miss_per_hop;
+  f64 miss_rate;
+  f64 cyc_per_hop;
+};
+
+void
+sort_runs(f64 *v) noexcept
+{
+  for ( u32 i = 1; i < K_MEASUREMENTS; ++i ) {
+    const f64 key = v[i];
+    u32 j = i;
+    while ( j > 0 && v[j - 1] > key ) {
+      v[j] = v[j - 1];
+      --j;
+    }
+    v[j] = key;
+  }
+}
+
+cell
+run_cell(usize size) noexcept
+{
+  u64 n = FOOTPRINT / size;
+  if ( n > MAX_NODES ) n = MAX_NODES;
+
+  chase_node **nodes = reinterpret_cast<chase_node **>(abc::alloc(n * sizeof(chase_node *)));
+  for ( u64 i = 0; i < n; ++i ) nodes[i] = reinterpret_cast<chase_node *>(abc::alloc(size));
+
+  // Fisher-Yates over the allocation order, then link into one cycle
+  u64 seed = 0x9E3779B97F4A7C15ULL ^ size;
+  for ( u64 i = n - 1; i > 0; --i ) {
+    const u64 j = xorshift(seed) % (i + 1);
+    chase_node *t = nodes[i];
+    nodes[i] = nodes[j];
+    nodes[j] = t;
+  }
+  for ( u64 i = 0; i < n; ++i ) nodes[i]->next = nodes[(i + 1) % n];
+
+  f64 mph[K_MEASUREMENTS], rate[K_MEASUREMENTS], cph[K_MEASUREMENTS];
+  for ( u32 m = 0; m < K_MEASUREMENTS; ++m ) {
+    tlb_events evs{ bbench::quiet{} };
+    evs.open();
+    const chase_node *volatile sink = nullptr;
+    const chase_node *p = nodes[0];
+    evs.begin();
+    for ( u64 h = 0; h < HOPS; ++h ) p = p->next;
+    evs.end();
+    sink = p;
+    (void)sink;
+    const f64 acc = static_cast<f64>(evs.get<bbench::dtlb_access>().retrieve());
+    const f64 miss = static_cast<f64>(evs.get<bbench::dtlb_miss>().retrieve());
+    const f64 cyc = static_cast<f64>(evs.get<bbench::hardware_cycles>().retrieve());
+    mph[m] = miss / static_cast<f64>(HOPS);
+    rate[m] = acc > 0.0 ? miss / acc : 0.0;
+    cph[m] = cyc / static_cast<f64>(HOPS);
+  }
+  sort_runs(mph);
+  sort_runs(rate);
+  sort_runs(cph);
+
+  for ( u64 i = 0; i < n; ++i ) abc::dealloc(reinterpret_cast<byte *>(nodes[i]));
+  abc::dealloc(reinterpret_cast<byte *>(nodes));
+  return cell{ size, n, mph[K_MEASUREMENTS / 2], rate[K_MEASUREMENTS / 2], cph[K_MEASUREMENTS / 2] };
+}
+
+[[gnu::cold]] void
+print_cell(const cell &c)
+{
+  const u64 mph_x1000 = static_cast<u64>(c.miss_per_hop * 1000.0 + 0.5);
+  const u64 rate_x100 = static_cast<u64>(c.miss_rate * 10000.0 + 0.5);
+  const u64 cph_x100 = static_cast<u64>(c.cyc_per_hop * 100.0 + 0.5);
+  micron::io::println("size ", c.size, " B  nodes ", c.nodes, "  dTLB miss/hop ", mph_x1000 / 1000, ".", (mph_x1000 % 1000) / 100,
+                      (mph_x1000 % 100) / 10, mph_x1000 % 10, "  dTLB miss % ", rate_x100 / 100, ".", (rate_x100 % 100) / 10, rate_x100 % 10,
+                      "  cyc/hop ", cph_x100 / 100, ".", (cph_x100 % 100) / 10, cph_x100 % 10);
+}
+
+};      // namespace
+
+int
+main(void)
+{
+  micron::io::println("=== abcmalloc dTLB pointer-chase benchmark ===");
+  micron::io::println("shuffled singly linked list over allocator nodes, ", HOPS, " dependent hops per run; ", K_MEASUREMENTS,
+                      " runs per cell (medians)");
+  micron::io::println("node footprint per cell capped at ", FOOTPRINT >> 20, " MiB / ", MAX_NODES, " nodes");
+  micron::io::println("");
+
+  for ( usize sz : SIZES ) print_cell(run_cell(sz));
+
+  micron::io::println("");
+  micron::io::println("=== done ===");
+  return 0;
+}
@@ -36,9 +36,11 @@
 #include "cache.hpp"
 #include "config.hpp"
 #include "harden.hpp"
+#include "heap_profile.hpp"
 #include "hooks.hpp"
 #include "mpsc_free.hpp"
 #include "oom.hpp"
+#include "purge.hpp"
 #include "stats.hpp"
 #include "tcache.hpp"
 
@@ -98,6 +100,49 @@ __prealloc_share(u64 total)
   }
 }
 
+static_assert(__prealloc_draws >= 1, "abcmalloc: __prealloc_draws must be at least 1.");
+
+// process-wide eager budget (totalram * __default_prealloc_factor), sized once by the first arena
+inline micron::atomic_token<u64> __prealloc_budget{ 0 };
+inline u64 __prealloc_draw_size = 0;
+inline micron::atomic_token<u32> __prealloc_budget_state{ 0 };      // 0 unsized, 1 sizing, 2 ready
+
+// claims one arena's share of the eager budget; 0 once it is spent (the arena then starts at the lazy minimum)
+static inline u64
+__prealloc_draw(void) noexcept
+{
+  if ( __prealloc_budget_state.get(micron::memory_order_acquire) != 2 ) [[unlikely]] {
+    u32 expect = 0;
+    if ( __prealloc_budget_state.compare_exchange_strong(expect, 1, micron::memory_order_acq_rel, micron::memory_order_acquire) ) {
+      micron::sysinfo info;
+      const u64 totalram = static_cast<u64>(info.totalram) * static_cast<u64>(info.mem_unit ? info.mem_unit : 1u);
+      const u64 total = micron::math::floor<u64>(static_cast<f32>(totalram) * __default_prealloc_factor);
+      __debug_print("__prealloc_draw(): total system RAM: ", totalram);
+      __debug_print("__prealloc_draw(): shared eager budget: ", total);
+      __prealloc_draw_size = total / __prealloc_draws;
+      __prealloc_budget.store(total, micron::memory_order_relaxed);
+      __prealloc_budget_state.store(2, micron::memory_order_release);
+    } else {
+      while ( __prealloc_budget_state.get(micron::memory_order_acquire) != 2 ) __cpu_pause();
+    }
+  }
+  u64 left = __prealloc_budget.get(micron::memory_order_relaxed);
+  u64 take;
+  do {
+    if ( left == 0 ) return 0;
+    take = left < __prealloc_draw_size ? left : __prealloc_draw_size;
+  } while ( !__prealloc_budget.compare_exchange_weak(left, left - take, micron::memory_order_relaxed, micron::memory_order_relaxed) );
+  return take;
+}
+
+// hot tiers commit on first touch; cold tiers are sized to what was asked for and stay eager
+template<u64 Sz>
+consteval bool
+__lazy_commit_for(void) noexcept
+{
+  return __default_lazy_commit and Sz <= __class_medium;
+}
+
 template<u64 Sz>
 consteval bool
 tomb_for(void) noexcept
@@ -116,6 +161,37 @@ tomb_for(void) noexcept
     return __tombstone_huge;
 }
 
+// granule-binding tag of a tier's sheet class; the arena metadata tier is bound too, so its lookups skip the scan
+template<u64 Sz>
+consteval uintptr_t
+__sheet_tier_of(void) noexcept
+{
+  if constexpr ( Sz == __class_precise )
+    return __sheet_tier_precise;
+  else if constexpr ( Sz == __class_small )
+    return __sheet_tier_small;
+  else if constexpr ( Sz == __class_medium )
+    return __sheet_tier_medium;
+  else if constexpr ( Sz == __class_large )
+    return __sheet_tier_large;
+  else if constexpr ( Sz == __class_huge )
+    return __sheet_tier_huge;
+  else if constexpr ( Sz == __direct_map_threshold )
+    return __sheet_tier_mapped;
+  else if constexpr ( Sz == __class_arena_internal )
+    return __sheet_tier_arena;
+  else
+    return __sheet_tier_none;
+}
+
+static_assert(__direct_map_threshold > __class_huge, "abcmalloc: __direct_map_threshold must sit above the huge tier's class.");
+
+// alignment every block already has (slab classes are multiples of 16), and the most push_aligned() serves natively:
+// buddy and mapped blocks are aligned to their own size up to the alignment of the sheet they were carved from, page
+// runs are placed on the boundary asked for
+constexpr static const usize __block_align_min = 16;
+constexpr static const usize __block_align_max = __sheet_align;
+
 static inline __attribute__((always_inline)) usize
 __page_round(usize sz)
 {
@@ -153,97 +229,108 @@ class __arena: private cache
     T *nd;
     node<T> *prev;
     node<T> *nxt;
+    u32 pos;      // slot in the owning tier's directory, fixed from register_sheet to unregister
   };
 
-  template<typename sheet_type, u32 MaxSheets = 64, u32 CacheSlots = 0, typename Cache = __tier_tcache<CacheSlots>>
+  // a tier's sheet index is a two-level directory: slots live in leaves of __leaf_slots ranges, the first leaf inline
+  // in the arena and further ones mapped as the tier grows, so a tier has no sheet cap and a small heap never maps
+  // anything past the inline leaf. a sheet keeps its slot for life (insert pops a free slot, remove pushes it back, both O(1));
+  // address lookup goes through the granule binding; a scan is only the fallback for a sheet the table couldn't record
+  template<typename sheet_type, u32 LeafSlots = 64, u32 CacheSlots = 0, typename Cache = __tier_tcache<CacheSlots>>
   struct alignas(64) __tier {
     using sheet_t = sheet_type;
-    static constexpr u32 __max_sheets = MaxSheets;
-    static constexpr u32 __no_hit = __max_sheets;
-    static constexpr u32 __detail_words = (MaxSheets + 63) / 64;
+    static constexpr u32 __leaf_slots = LeafSlots < 64 ? 64 : LeafSlots;
+    static constexpr u32 __leaf_shift = static_cast<u32>(__builtin_ctz(__leaf_slots));
+    static constexpr u32 __leaf_words = __leaf_slots / 64;
+    static constexpr u32 __leaf_word_shift = __leaf_shift - 6;
+    static constexpr u32 __dir_inline = 4;      // leaves addressable before the directory itself is mapped
+    static constexpr u32 __no_slot = ~static_cast<u32>(0);
+    static constexpr u32 __no_hit = __no_slot;
     static constexpr u32 __cache_slots = Cache::__cache_slots;
+    static constexpr uintptr_t __bind_tag = __sheet_tier_of<sheet_type::__size_class>();
+    static constexpr bool __redzoned = sheet_type::__size_class <= __class_small;      // hot tiers carry redzones
 
-    static_assert(MaxSheets > 0, "__tier MaxSheets must be > 0");
+    static_assert((__leaf_slots & (__leaf_slots - 1)) == 0, "__tier LeafSlots must be a power of two");
 
     struct __range {
       addr_t *lo;
-      addr_t *hi;
+      addr_t *hi;      // free slot: lo == nullptr, hi holds the next free slot + 1
       node<sheet_type> *nd;
     };
 
+    struct __leaf {
+      __range r[__leaf_slots];
+      u64 space[__leaf_words];      // bit set iff the slot's sheet has space
+    };
+
     node<sheet_type> head;
     node<sheet_type> *tail;
 
     // alloc-hot block
-    __range __idx[__max_sheets];
-    u32 __count;
-    u64 __space_mask[__detail_words];      // bit pos set iff __idx[pos] has space
+    __leaf **__dir;
+    u32 __slots;        // slots ever handed out; every scan stops here
+    u32 __count;        // live sheets
+    u32 __free_slot;    // LIFO of released slots, __no_slot when empty
     u32 __last_hit;
+    u32 __leaves;
+    u32 __dir_cap;
 
     alignas(64) u32 __dealloc_count;
 
+    __tier_counters __stats;      // this tier's shard, written by the arena's holder only (stats.hpp)
+
     Cache __cache;
 
-    // multi-word bitmap helpers
-    inline __attribute__((always_inline)) bool
-    __mask_get(u32 pos) const noexcept
+    __leaf *__dir_first[__dir_inline];
+    __leaf __leaf0;
+
+    inline __attribute__((always_inline)) __range &
+    __at(u32 pos) noexcept
     {
-      return (__space_mask[pos >> 6] >> (pos & 63)) & 1ULL;
+      return __dir[pos >> __leaf_shift]->r[pos & (__leaf_slots - 1)];
     }
 
-    inline __attribute__((always_inline)) void
-    __mask_set(u32 pos) noexcept
+    inline __attribute__((always_inline)) const __range &
+    __at(u32 pos) const noexcept
     {
-      __space_mask[pos >> 6] |= (1ULL << (pos & 63));
+      return __dir[pos >> __leaf_shift]->r[pos & (__leaf_slots - 1)];
     }
 
-    inline __attribute__((always_inline)) void
-    __mask_clear(u32 pos) noexcept
+    // availability bitmap, 64 slots per word, words numbered across leaves
+    inline __attribute__((always_inline)) u32
+    __words(void) const noexcept
     {
-      __space_mask[pos >> 6] &= ~(1ULL << (pos & 63));
+      return (__slots + 63) >> 6;
     }
 
-    inline __attribute__((always_inline)) void
-    __mask_insert(u32 pos, bool value) noexcept
+    inline __attribute__((always_inline)) u64 &
+    __space_word(u32 w) noexcept
     {
-      const u32 word = pos >> 6;
-      const u32 bit = pos & 63;
-      const u64 w = __space_mask[word];
-      const u64 carry = (w >> 63) & 1ULL;      // bit 63 carries into next-higher word
+      return __dir[w >> __leaf_word_shift]->space[w & (__leaf_words - 1)];
+    }
 
-      const u64 lo_mask = (bit == 0) ? 0ULL : ((1ULL << bit) - 1);
-      const u64 lo = w & lo_mask;
-      const u64 hi_keep_mask = (bit == 63) ? 0ULL : ~((1ULL << (bit + 1)) - 1);      // covers [bit+1..63]
-      const u64 hi = (w << 1) & hi_keep_mask;
-      __space_mask[word] = lo | hi | ((value ? 1ULL : 0ULL) << bit);
+    inline __attribute__((always_inline)) u64
+    __space_word(u32 w) const noexcept
+    {
+      return __dir[w >> __leaf_word_shift]->space[w & (__leaf_words - 1)];
+    }
 
-      u64 c = carry;
-      for ( u32 i = word + 1; i < __detail_words; ++i ) {
-        const u64 nc = (__space_mask[i] >> 63) & 1ULL;
-        __space_mask[i] = (__space_mask[i] << 1) | c;
-        c = nc;
-      }
+    inline __attribute__((always_inline)) bool
+    __mask_get(u32 pos) const noexcept
+    {
+      return (__space_word(pos >> 6) >> (pos & 63)) & 1ULL;
     }
 
     inline __attribute__((always_inline)) void
-    __mask_remove(u32 pos) noexcept
+    __mask_set(u32 pos) noexcept
     {
-      const u32 word = pos >> 6;
-      const u32 bit = pos & 63;
-
-      const u64 carry_in = (word + 1 < __detail_words) ? (__space_mask[word + 1] & 1ULL) : 0ULL;
-      const u64 w = __space_mask[word];
-
-      const u64 lo_mask = (bit == 0) ? 0ULL : ((1ULL << bit) - 1);
-      const u64 lo = w & lo_mask;
-      const u64 hi_keep_mask = (bit == 0) ? ((1ULL << 63) - 1) : (((1ULL << 63) - 1) & ~((1ULL << bit) - 1));
-      const u64 hi = (w >> 1) & hi_keep_mask;
-      __space_mask[word] = lo | hi | (carry_in << 63);
+      __space_word(pos >> 6) |= (1ULL << (pos & 63));
+    }
 
-      for ( u32 i = word + 1; i < __detail_words; ++i ) {
-        const u64 next_carry = (i + 1 < __detail_words) ? (__space_mask[i + 1] & 1ULL) : 0ULL;
-        __space_mask[i] = (__space_mask[i] >> 1) | (next_carry << 63);
-      }
+    inline __attribute__((always_inline)) void
+    __mask_clear(u32 pos) noexcept
+    {
+      __space_word(pos >> 6) &= ~(1ULL << (pos & 63));
     }
 
     void
@@ -253,12 +340,55 @@ class __arena: private cache
       head.prev = nullptr;
       head.nxt = nullptr;
       tail = nullptr;
+      for ( u32 i = 0; i < __dir_inline; ++i ) __dir_first[i] = nullptr;
+      for ( u32 i = 0; i < __leaf_words; ++i ) __leaf0.space[i] = 0;
+      __dir_first[0] = &__leaf0;
+      __dir = __dir_first;
+      __leaves = 1;
+      __dir_cap = __dir_inline;
+      __slots = 0;
       __count = 0;
-      for ( u32 i = 0; i < __detail_words; ++i ) __space_mask[i] = 0;
+      __free_slot = __no_slot;
       __last_hit = __no_hit;
       __dealloc_count = 0;
     }
 
+    // one more leaf; the directory doubles when it is full. leaves are never given back while the arena lives
+    [[gnu::cold, gnu::noinline]] bool
+    __grow_directory(void)
+    {
+      if ( __leaves == __dir_cap ) {
+        const u32 cap = __dir_cap << 1;
+        if ( cap <= __dir_cap or (static_cast<u64>(cap) << __leaf_shift) > __no_slot ) [[unlikely]]
+          return false;
+        auto **d = reinterpret_cast<__leaf **>(micron::sys_allocator<byte>::alloc(cap * sizeof(__leaf *)));
+        if ( d == nullptr ) [[unlikely]]
+          return false;
+        for ( u32 i = 0; i < __leaves; ++i ) d[i] = __dir[i];
+        if ( __dir != __dir_first ) micron::sys_allocator<byte>::dealloc(reinterpret_cast<byte *>(__dir), __dir_cap * sizeof(__leaf *));
+        __dir = d;
+        __dir_cap = cap;
+      }
+      auto *lf = reinterpret_cast<__leaf *>(micron::sys_allocator<byte>::alloc(sizeof(__leaf)));
+      if ( lf == nullptr ) [[unlikely]]
+        return false;
+      for ( u32 i = 0; i < __leaf_words; ++i ) lf->space[i] = 0;
+      __dir[__leaves++] = lf;
+      return true;
+    }
+
+    // unmaps the grown part of the directory; the tier is empty afterwards
+    void
+    release_directory(void)
+    {
+      for ( u32 i = 1; i < __leaves; ++i ) micron::sys_allocator<byte>::dealloc(reinterpret_cast<byte *>(__dir[i]), sizeof(__leaf));
+      if ( __dir != __dir_first ) micron::sys_allocator<byte>::dealloc(reinterpret_cast<byte *>(__dir), __dir_cap * sizeof(__leaf *));
+      init();
+      __stats.clear<tier_stat::sheets>();
+      __stats.clear<tier_stat::bytes_committed>();
+      __stats.clear<tier_stat::bytes_live>();
+    }
+
     inline __attribute__((always_inline)) void
     link_at_tail(node<sheet_type> *nd)
     {
@@ -276,65 +406,67 @@ class __arena: private cache
       if ( nd == tail ) tail = nd->prev;
     }
 
+    // returns the sheet's slot, or __no_slot if the directory could not grow
     u32
     register_sheet(node<sheet_type> *nd)
     {
-      if ( __count >= __max_sheets ) [[unlikely]]
-        return __max_sheets;      // sentinel
+      u32 pos;
+      if ( __free_slot != __no_slot ) {
+        pos = __free_slot;
+        __free_slot = static_cast<u32>(reinterpret_cast<uintptr_t>(__at(pos).hi)) - 1;
+      } else {
+        if ( (__slots >> __leaf_shift) == __leaves and !__grow_directory() ) [[unlikely]]
+          return __no_slot;
+        pos = __slots++;
+      }
 
       addr_t *lo = nd->nd->addr();
       addr_t *hi = nd->nd->addr_end();
-
-      u32 pos = 0;
-      while ( pos < __count and __idx[pos].lo < lo ) ++pos;
-
-      // shift entries right
-      for ( u32 i = __count; i > pos; --i ) __idx[i] = __idx[i - 1];
-
-      __idx[pos] = { lo, hi, nd };
-
-      // insert availability bit at pos, shifting bits >= pos up by one
-      __mask_insert(pos, true);
-
-      if ( __last_hit != __no_hit and pos <= __last_hit and __last_hit + 1 < __max_sheets ) ++__last_hit;
-
+      __at(pos) = { lo, hi, nd };
+      nd->pos = pos;
+      __mask_set(pos);
       ++__count;
+      __stats.gauge<tier_stat::sheets>(1);
+      __stats.gauge<tier_stat::bytes_committed>(nd->nd->allocated());
+      if constexpr ( __bind_tag != __sheet_tier_none ) __sheet_bind(lo, hi, __bind_tag, nd);
       return pos;
     }
 
     void
     unregister(u32 pos)
     {
-      if ( pos >= __count ) return;
+      if ( pos >= __slots or __at(pos).nd == nullptr ) return;
 
-      // shift entries left
-      for ( u32 i = pos; i + 1 < __count; ++i ) __idx[i] = __idx[i + 1];
-
-      // remove bit at pos, shift upper bits down
-      __mask_remove(pos);
-
-      if ( __last_hit != __no_hit ) {
-        if ( pos == __last_hit )
-          __last_hit = __no_hit;
-        else if ( pos < __last_hit )
-          --__last_hit;
-      }
+      if constexpr ( __bind_tag != __sheet_tier_none ) __sheet_unbind(__at(pos).lo, __at(pos).hi);
+      __stats.gauge<tier_stat::sheets>(0 - u64{ 1 });
+      __stats.gauge<tier_stat::bytes_committed>(0 - static_cast<u64>(__at(pos).nd->nd->allocated()));
 
+      __at(pos) = { nullptr, reinterpret_cast<addr_t *>(static_cast<uintptr_t>(__free_slot) + 1), nullptr };
+      __free_slot = pos;
+      __mask_clear(pos);
+      if ( __last_hit == pos ) __last_hit = __no_hit;
       --__count;
     }
 
+    // slot of addr, or -1. every sheet of a bound tier is in the granule table, so the granule answers; a granule
+    // with no table leaf (its register couldn't map one) and the unbound case fall back to a scan of the live slots
     i32
     find_range(addr_t *addr) const
     {
-      i32 lo = 0, hi = static_cast<i32>(__count) - 1;
-      while ( lo <= hi ) {
-        i32 mid = lo + ((hi - lo) >> 1);
-        if ( addr < __idx[mid].lo )
-          hi = mid - 1;
-        else if ( addr >= __idx[mid].hi )
-          lo = mid + 1;
-        else
-          return mid;
+      if constexpr ( __bind_tag != __sheet_tier_none ) {
+        if ( const __granule_entry *g = __granule_of(addr); g ) [[likely]] {
+          const uintptr_t b = __atomic_load_n(&g->sheet, __ATOMIC_ACQUIRE);
+          if ( (b & __sheet_tier_mask) != __bind_tag ) return -1;
+          const u32 pos = reinterpret_cast<const node<sheet_type> *>(b & ~__sheet_tier_mask)->pos;
+          if ( pos < __slots and __at(pos).nd == reinterpret_cast<const node<sheet_type> *>(b & ~__sheet_tier_mask) and addr >= __at(pos).lo
+               and addr < __at(pos).hi )
+            return static_cast<i32>(pos);
+          return -1;
+        }
+      }
+      for ( u32 i = 0; i < __slots; ++i ) {
+        const __range &r = __at(i);
+        if ( r.nd != nullptr and addr >= r.lo and addr < r.hi ) return static_cast<i32>(i);
       }
       return -1;
     }
@@ -354,8 +486,8 @@ class __arena: private cache
     bool
     has_space(void) const
     {
-      for ( u32 i = 0; i < __detail_words; ++i ) {
-        if ( __space_mask[i] != 0 ) return true;
+      for ( u32 w = 0; w < __words(); ++w ) {
+        if ( __space_word(w) != 0 ) return true;
       }
       return false;
     }
@@ -384,8 +516,8 @@ class __arena: private cache
     {
       using Rt = micron::lambda_return_t<decltype(fn)>;
       Rt ret{};
-      for ( u32 i = 0; i < __count; ++i ) {
-        if ( __idx[i].nd and __idx[i].nd->nd ) ret += fn(__idx[i].nd->nd);
+      for ( u32 i = 0; i < __slots; ++i ) {
+        if ( __at(i).nd and __at(i).nd->nd ) ret += fn(__at(i).nd->nd);
       }
       return ret;
     }
@@ -394,8 +526,8 @@ class __arena: private cache
     void
     for_each_void(Fn fn) const
     {
-      for ( u32 i = 0; i < __count; ++i ) {
-        if ( __idx[i].nd and __idx[i].nd->nd ) fn(__idx[i].nd->nd);
+      for ( u32 i = 0; i < __slots; ++i ) {
+        if ( __at(i).nd and __at(i).nd->nd ) fn(__at(i).nd->nd);
       }
     }
   };
@@ -403,27 +535,37 @@ class __arena: private cache
   alloc_predictor __predict;
   sheet<__class_arena_internal> _arena_memory;
 
-  // tlsf-backed tiers; they use the linear-scan LIFO __tier_tcache
-  __tier<tlsf_sheet<__class_precise>, __max_sheets_precise, __cache_slots_precise> _precise;
-  __tier<tlsf_sheet<__class_small>, __max_sheets_small, __cache_slots_small> _small;
+  // hot tiers; they use the linear-scan LIFO __tier_tcache
+  __tier<slab_sheet<__class_precise>, __max_sheets_precise, __cache_slots_precise> _precise;      // headerless slab, <= 256 B
+  __tier<tlsf_sheet<__class_small>, __max_sheets_small, __cache_slots_small> _small;              // tlsf, 257 B - 4 KiB
 
-  // buddy-backed tiers
+  // buddy-backed tiers; medium and large are exact page runs instead when __default_page_runs is set
   __tier<sheet<__class_arena_internal>, __max_sheets_arena_internal> _arena_tier;      // internal metadata
-  __tier<sheet<__class_medium>, __max_sheets_medium, __cache_slots_medium> _medium;
-  __tier<sheet<__class_large>, __max_sheets_large, __cache_slots_large> _large;
+  __tier<__page_sheet_t<__class_medium>, __max_sheets_medium, __cache_slots_medium> _medium;      // 4 KiB - 32 KiB
+  __tier<__page_sheet_t<__class_large>, __max_sheets_large, __cache_slots_large> _large;          // 32 KiB - 256 KiB
   __tier<sheet<__class_huge>, __max_sheets_huge, __cache_slots_huge> _huge;
 
-  // 64 slots * 64 B  = ~4 KiB per arena
-  __mpsc_free_queue<64> __remote_free;
+  // dedicated mappings, one block per sheet; never linked through head so every sheet is reclaimable
+  __tier<map_sheet, __max_sheets_mapped> _mapped;
 
-  // remote-free: the ring above is bounded and only drained when the owner thread touches its arena;
-  // compute/poll-bound owner that never allocates starves it, and a freeing thread that spins on a full ring livelocks
-  struct __remote_ovf_node {
-    __remote_ovf_node *next;
-    usize sz;      // 0 == size-unknown (route through __vmap_remove_at)
-  };
+  // remote-free: frees from other threads, drained only when the owner touches its arena. a compute/poll-bound owner that
+  // never allocates can't be allowed to stall a freeing thread, so nothing here blocks: the ring is mapped lazily and grown
+  // on spill (mpsc_free.hpp), overflow and batched frees (tapi.hpp __remote_batch_push) land on the channel's chain
+  __mpsc_free_channel __remote;
 
-  micron::atomic_token<__remote_ovf_node *> __remote_ovf{ nullptr };
+  // decay purge (__default_purge): clock of this arena's last pass, frees since the last clock read, and a pass posted
+  // by abc::purge() from another thread while the owner held the arena
+  u64 __purge_last = 0;
+  u32 __purge_frees = 0;
+  micron::atomic_token<u32> __purge_req{ 0 };
+
+  // zero elision (__default_zero_elide): set only around push(sz, zeroed); the sheet path then records the block it
+  // carved if the sheet vouches it never left zero state, cache hits never do
+  bool __zero_probe = false;
+  byte *__zero_hint = nullptr;
+
+  // sampled heap profiler (heap_profile.hpp): byte countdown and the live-sample table, both owner-only
+  __heap_sampler __prof;
 
   micron::atomic_flag __struct_mtx{};
 
@@ -458,7 +600,7 @@ class __arena: private cache
       __debug_print_addr("__unmark_from_arena(): WARNING address not found: ", addr);
       return;
     }
-    auto &sh = *_arena_tier.__idx[idx].nd->nd;
+    auto &sh = *_arena_tier.__at(idx).nd->nd;
     if ( sh.try_unmark(micron::__chunk<byte>(addr, sz)) ) {
       _arena_tier.mark_available(idx);
       __debug_print("__unmark_from_arena(): unmark succeeded, sheet used: ", sh.used());
@@ -529,55 +671,58 @@ class __arena: private cache
     }
     nd->nxt = nullptr;
     _arena_tier.link_at_tail(nd);
-    if ( _arena_tier.register_sheet(nd) == _arena_tier.__max_sheets ) [[unlikely]] {
-      __debug_print("__expand_arena_tier()!!!: arena tier index full", 0);
+    if ( _arena_tier.register_sheet(nd) == _arena_tier.__no_slot ) [[unlikely]] {
+      __debug_print("__expand_arena_tier()!!!: arena tier directory could not grow", 0);
       abort_state();
     }
+    _arena_tier.__stats.add<tier_stat::expansions>();
     __debug_print("__expand_arena_tier(): new arena node allocated, size: ", sz);
   }
 
+  // hot tiers (slab + tlsf); the sheet type comes from the tier
   template<u64 Sz, typename TierT>
   void
-  __init_tlsf(TierT &tier, usize n)
+  __init_hot(TierT &tier, usize n)
   {
+    using Sh = typename TierT::sheet_t;
     if ( n == __default_magic_size ) n = __calculate_space_small(Sz);
     n = __page_round(n);
-    __debug_print("__init_tlsf(): class size: ", Sz);
-    __debug_print("__init_tlsf(): backing region size: ", n);
-    micron::__chunk<byte> buf = _arena_memory.try_mark(sizeof(tlsf_sheet<Sz>));
+    __debug_print("__init_hot(): class size: ", Sz);
+    __debug_print("__init_hot(): backing region size: ", n);
+    micron::__chunk<byte> buf = _arena_memory.try_mark(sizeof(Sh));
     if ( buf.failed_allocation() ) [[unlikely]] {
-      __debug_print("__init_tlsf()!!!: no arena metadata for tlsf header, class: ", Sz);
+      __debug_print("__init_hot()!!!: no arena metadata for sheet header, class: ", Sz);
       abort_state();
     }
-    tier.head.nd = new (buf.ptr) tlsf_sheet<Sz>(this, __get_kernel_chunk<micron::__chunk<byte>>(n));
+    tier.head.nd = new (buf.ptr) Sh(this, __get_kernel_chunk<micron::__chunk<byte>>(n, __lazy_commit_for<Sz>(), __thp_for<Sz>()));
     tier.head.prev = nullptr;
     tier.head.nxt = nullptr;
     tier.tail = &tier.head;
     if ( tier.head.nd->empty() ) [[unlikely]] {
-      __debug_print("__init_tlsf()!!!: kernel chunk returned empty for class: ", Sz);
+      __debug_print("__init_hot()!!!: kernel chunk returned empty for class: ", Sz);
       abort_state();
     }
     tier.register_sheet(&tier.head);
-    __debug_print("__init_tlsf(): initialised successfully for class: ", Sz);
+    __debug_print("__init_hot(): initialised successfully for class: ", Sz);
   }
 
   template<u64 Sz, typename TierT>
   inline __attribute__((always_inline)) bool
-  __expand_tlsf(TierT &tier, usize sz)
+  __expand_hot(TierT &tier, usize sz)
   {
     auto __g = __struct_guard();
-    __debug_print("__expand_tlsf(): class size: ", Sz);
-    __debug_print("__expand_tlsf(): requested backing region: ", sz);
-    using Nd = node<tlsf_sheet<Sz>>;
-    using Sh = tlsf_sheet<Sz>;
+    __debug_print("__expand_hot(): class size: ", Sz);
+    __debug_print("__expand_hot(): requested backing region: ", sz);
+    using Sh = typename TierT::sheet_t;
+    using Nd = node<Sh>;
     usize pair_sz = sizeof(Nd) + sizeof(Sh);
     micron::__chunk<byte> buf = __mark_arena(pair_sz);
     byte *p = buf.ptr;
     usize aligned_sz = __page_round(sz);
-    auto chnk = __get_kernel_chunk<micron::__chunk<byte>>(aligned_sz);
+    auto chnk = __get_kernel_chunk<micron::__chunk<byte>>(aligned_sz, __lazy_commit_for<Sz>(), __thp_for<Sz>());
     if ( !__kernel_chunk_valid(chnk) ) [[unlikely]] {
-      __debug_print("__expand_tlsf(): mmap failed for tlsf expansion, class: ", Sz);
-      __debug_print("__expand_tlsf(): requested size: ", aligned_sz);
+      __debug_print("__expand_hot(): mmap failed for hot tier expansion, class: ", Sz);
+      __debug_print("__expand_hot(): requested size: ", aligned_sz);
       __unmark_from_arena(buf.ptr, pair_sz);
       return false;
     }
@@ -585,7 +730,7 @@ class __arena: private cache
     p += sizeof(Nd);
     nd->nd = new (p) Sh(this, chnk);
     if ( nd->nd->empty() ) [[unlikely]] {
-      __debug_print("__expand_tlsf(): sheet construction failed, class: ", Sz);
+      __debug_print("__expand_hot(): sheet construction failed, class: ", Sz);
       nd->nd->release();
       __unmark_from_arena(buf.ptr, pair_sz);
       return false;
@@ -593,14 +738,15 @@ class __arena: private cache
     nd->nxt = nullptr;
     tier.link_at_tail(nd);
     u32 pos = tier.register_sheet(nd);
-    if ( pos == tier.__max_sheets ) [[unlikely]] {
-      __debug_print("__expand_tlsf(): tier full (__max_sheets reached), class: ", Sz);
+    if ( pos == tier.__no_slot ) [[unlikely]] {
+      __debug_print("__expand_hot(): tier directory could not grow, class: ", Sz);
       tier.unlink_node(nd);
       nd->nd->release();
       __unmark_from_arena(buf.ptr, pair_sz);
       return false;
     }
-    __debug_print("__expand_tlsf(): new tlsf node ready, backing size: ", aligned_sz);
+    tier.__stats.template add<tier_stat::expansions>();
+    __debug_print("__expand_hot(): new hot tier node ready, backing size: ", aligned_sz);
     return true;
   }
 
@@ -621,12 +767,13 @@ class __arena: private cache
     }
     __debug_print("__init_buddy(): class size: ", Sz);
     __debug_print("__init_buddy(): backing region size: ", n);
-    micron::__chunk<byte> buf = _arena_memory.try_mark(sizeof(sheet<Sz>));
+    using Sh = typename TierT::sheet_t;
+    micron::__chunk<byte> buf = _arena_memory.try_mark(sizeof(Sh));
     if ( buf.failed_allocation() ) [[unlikely]] {
       __debug_print("__init_buddy()!!!: no arena metadata for buddy header, class: ", Sz);
       abort_state();
     }
-    tier.head.nd = new (buf.ptr) sheet<Sz>(this, __get_kernel_chunk<micron::__chunk<byte>>(n));
+    tier.head.nd = new (buf.ptr) Sh(this, __get_kernel_chunk<micron::__chunk<byte>>(n, __lazy_commit_for<Sz>(), __thp_for<Sz>()));
     tier.head.prev = nullptr;
     tier.head.nxt = nullptr;
     tier.tail = &tier.head;
@@ -645,8 +792,8 @@ class __arena: private cache
     auto __g = __struct_guard();
     __debug_print("__expand_buddy(): class size: ", Sz);
     __debug_print("__expand_buddy(): requested expansion size: ", sz);
-    using Nd = node<sheet<Sz>>;
-    using Sh = sheet<Sz>;
+    using Sh = typename TierT::sheet_t;
+    using Nd = node<Sh>;
     usize pair_sz = sizeof(Nd) + sizeof(Sh);
     micron::__chunk<byte> buf = __mark_arena(pair_sz);
     byte *p = buf.ptr;
@@ -654,7 +801,7 @@ class __arena: private cache
     micron::__chunk<byte> chnk;
     if constexpr ( __default_insert_guard_pages ) {
       __debug_print("__expand_buddy(): inserting guard page for class: ", Sz);
-      chnk = __get_kernel_chunk<micron::__chunk<byte>>(sz + __system_pagesize);
+      chnk = __get_kernel_chunk<micron::__chunk<byte>>(sz + __system_pagesize, __lazy_commit_for<Sz>(), __thp_for<Sz>());
       if ( !__kernel_chunk_valid(chnk) ) [[unlikely]] {
         __debug_print("__expand_buddy(): mmap failed for buddy expansion, class: ", Sz);
         __unmark_from_arena(buf.ptr, pair_sz);
@@ -662,7 +809,7 @@ class __arena: private cache
       }
       __make_guard(chnk);
     } else {
-      chnk = __get_kernel_chunk<micron::__chunk<byte>>(sz);
+      chnk = __get_kernel_chunk<micron::__chunk<byte>>(sz, __lazy_commit_for<Sz>(), __thp_for<Sz>());
       if ( !__kernel_chunk_valid(chnk) ) [[unlikely]] {
         __debug_print("__expand_buddy(): mmap failed for buddy expansion, class: ", Sz);
         __unmark_from_arena(buf.ptr, pair_sz);
@@ -686,13 +833,14 @@ class __arena: private cache
     nd->nxt = nullptr;
     tier.link_at_tail(nd);
     u32 pos = tier.register_sheet(nd);
-    if ( pos == tier.__max_sheets ) [[unlikely]] {
-      __debug_print("__expand_buddy(): tier full (__max_sheets reached), class: ", Sz);
+    if ( pos == tier.__no_slot ) [[unlikely]] {
+      __debug_print("__expand_buddy(): tier directory could not grow, class: ", Sz);
       tier.unlink_node(nd);
       nd->nd->release();
       __unmark_from_arena(buf.ptr, pair_sz);
       return false;
     }
+    tier.__stats.template add<tier_stat::expansions>();
     __debug_print("__expand_buddy(): new buddy node ready for class: ", Sz);
     return true;
   }
@@ -714,9 +862,9 @@ class __arena: private cache
     __debug_print("__buf_expand_exact(): routing class_sz: ", class_sz);
     __debug_print("__buf_expand_exact(): target expansion exact_sz: ", exact_sz);
 
-    if ( class_sz <= __class_small ) {
-      __debug_print("__buf_expand_exact(): routed to precise/tlsf tier", 0);
-      return __expand_tlsf<__class_precise>(_precise, exact_sz);
+    if ( class_sz <= __class_precise ) {
+      __debug_print("__buf_expand_exact(): routed to precise/slab tier", 0);
+      return __expand_hot<__class_precise>(_precise, exact_sz);
     }
 
     if ( class_sz < __class_medium ) [[likely]] {
@@ -724,13 +872,13 @@ class __arena: private cache
       if constexpr ( __default_lazy_construct and !__default_eager_hot_tiers ) {
         if ( _small.empty() ) [[unlikely]] {
           __debug_print("__buf_expand_exact(): lazy-constructing small bucket", 0);
-          __init_tlsf<__class_small>(_small, __calculate_space_small(__class_small));
+          __init_hot<__class_small>(_small, __calculate_space_small(__class_small));
           return true;      // __init aborts on failure, reaching here means success
         } else {
-          return __expand_tlsf<__class_small>(_small, exact_sz);
+          return __expand_hot<__class_small>(_small, exact_sz);
         }
       } else {
-        return __expand_tlsf<__class_small>(_small, exact_sz);
+        return __expand_hot<__class_small>(_small, exact_sz);
       }
     }
 
@@ -770,32 +918,68 @@ class __arena: private cache
     }
   }
 
+  template<typename Sh>
+  inline __attribute__((always_inline)) void
+  __note_zero(const Sh &sh, const micron::__chunk<byte> &mem)
+  {
+    if constexpr ( __default_zero_elide ) {
+      if ( __zero_probe ) [[unlikely]]
+        __zero_hint = sh.known_zero(mem.ptr) ? mem.ptr : nullptr;
+    }
+  }
+
+  // per-tier stats around a sheet op (stats.hpp): the sheet's own byte count is what bytes_live follows, so a block
+  // is charged exactly what its sheet charges for it. both compile to nothing without __default_collect_stats
+  template<typename Sh>
+  static inline __attribute__((always_inline)) usize
+  __stat_used(const Sh &sh)
+  {
+    if constexpr ( __default_collect_stats )
+      return sh.used();
+    else
+      return 0;
+  }
+
+  template<tier_stat S, typename TierT, typename Sh>
+  static inline __attribute__((always_inline)) void
+  __stat_sheet_op(TierT &tier, const Sh &sh, usize used_before, u64 blocks = 1)
+  {
+    tier.__stats.template add<S>(blocks);
+    tier.__stats.template add<tier_stat::bytes_live>(__stat_used(sh) - used_before);
+  }
+
   template<typename TierT>
   inline __attribute__((always_inline)) micron::__chunk<byte>
   __bucket_insert(TierT &tier, const usize sz)
   {
     // mru cache opt
     u32 lh = tier.__last_hit;
-    if ( lh < tier.__count and tier.__mask_get(lh) ) {
-      auto &sh = *tier.__idx[lh].nd->nd;
+    if ( lh < tier.__slots and tier.__mask_get(lh) ) {
+      auto &sh = *tier.__at(lh).nd->nd;
+      const usize u0 = __stat_used(sh);
       micron::__chunk<byte> mem;
       if constexpr ( __default_launder ) {
         mem = sh.temporal_mark(sz);
       } else {
         mem = sh.mark(sz);
       }
-      if ( !mem.zero() ) return mem;
+      if ( !mem.zero() ) {
+        __stat_sheet_op<tier_stat::allocs>(tier, sh, u0);
+        __note_zero(sh, mem);
+        return mem;
+      }
       tier.mark_exhausted(lh);
     }
 
     // bitmap scan fallback: walk each detail word, pop bits via ctz
-    for ( u32 w = 0; w < TierT::__detail_words; ++w ) {
-      u64 mask = tier.__space_mask[w];
+    for ( u32 w = 0, nw = tier.__words(); w < nw; ++w ) {
+      u64 mask = tier.__space_word(w);
       while ( mask ) {
         const u32 bit = __builtin_ctzll(mask);
         const u32 pos = (w << 6) | bit;
-        if ( pos >= tier.__count ) break;      // shouldn't trip
-        auto &sh = *tier.__idx[pos].nd->nd;
+        if ( pos >= tier.__slots ) break;      // shouldn't trip
+        auto &sh = *tier.__at(pos).nd->nd;
+        const usize u0 = __stat_used(sh);
         micron::__chunk<byte> mem;
         if constexpr ( __default_launder ) {
           mem = sh.temporal_mark(sz);
@@ -804,6 +988,8 @@ class __arena: private cache
         }
         if ( !mem.zero() ) {
           tier.__last_hit = pos;
+          __stat_sheet_op<tier_stat::allocs>(tier, sh, u0);
+          __note_zero(sh, mem);
           return mem;
         }
         // sheet exhausted for this size, clear bit
@@ -820,22 +1006,29 @@ class __arena: private cache
   {
     // mru cache opt
     u32 lh = tier.__last_hit;
-    if ( lh < tier.__count and tier.__mask_get(lh) ) {
-      micron::__chunk<byte> mem = tier.__idx[lh].nd->nd->temporal_mark(sz);
-      if ( !mem.zero() ) return mem;
+    if ( lh < tier.__slots and tier.__mask_get(lh) ) {
+      auto &sh = *tier.__at(lh).nd->nd;
+      const usize u0 = __stat_used(sh);
+      micron::__chunk<byte> mem = sh.temporal_mark(sz);
+      if ( !mem.zero() ) {
+        __stat_sheet_op<tier_stat::allocs>(tier, sh, u0);
+        return mem;
+      }
       tier.mark_exhausted(lh);
     }
 
-    for ( u32 w = 0; w < TierT::__detail_words; ++w ) {
-      u64 mask = tier.__space_mask[w];
+    for ( u32 w = 0, nw = tier.__words(); w < nw; ++w ) {
+      u64 mask = tier.__space_word(w);
       while ( mask ) {
         const u32 bit = __builtin_ctzll(mask);
         const u32 pos = (w << 6) | bit;
-        if ( pos >= tier.__count ) break;
-        auto &sh = *tier.__idx[pos].nd->nd;
+        if ( pos >= tier.__slots ) break;
+        auto &sh = *tier.__at(pos).nd->nd;
+        const usize u0 = __stat_used(sh);
         micron::__chunk<byte> mem = sh.temporal_mark(sz);
         if ( !mem.zero() ) {
           tier.__last_hit = pos;
+          __stat_sheet_op<tier_stat::allocs>(tier, sh, u0);
           return mem;
         }
         tier.mark_exhausted(pos);
@@ -845,6 +1038,110 @@ class __arena: private cache
     return { nullptr, 0 };
   }
 
+  // tlsf and page-run tiers only: the per-class cache is bypassed, a cached block is on no particular boundary
+  template<typename TierT>
+  micron::__chunk<byte>
+  __bucket_insert_aligned(TierT &tier, const usize sz, const usize al)
+  {
+    u32 lh = tier.__last_hit;
+    if ( lh < tier.__slots and tier.__mask_get(lh) ) {
+      auto &sh = *tier.__at(lh).nd->nd;
+      const usize u0 = __stat_used(sh);
+      micron::__chunk<byte> mem = sh.mark_aligned(sz, al);
+      if ( !mem.zero() ) {
+        __stat_sheet_op<tier_stat::allocs>(tier, sh, u0);
+        return mem;
+      }
+      // no mark_exhausted: the sheet may still serve unaligned requests of this size
+    }
+    for ( u32 w = 0, nw = tier.__words(); w < nw; ++w ) {
+      u64 mask = tier.__space_word(w);
+      while ( mask ) {
+        const u32 pos = (w << 6) | static_cast<u32>(__builtin_ctzll(mask));
+        if ( pos >= tier.__slots ) break;
+        auto &sh = *tier.__at(pos).nd->nd;
+        const usize u0 = __stat_used(sh);
+        micron::__chunk<byte> mem = sh.mark_aligned(sz, al);
+        if ( !mem.zero() ) {
+          tier.__last_hit = pos;
+          __stat_sheet_op<tier_stat::allocs>(tier, sh, u0);
+          return mem;
+        }
+        mask &= mask - 1;
+      }
+    }
+    return { nullptr, 0 };
+  }
+
+  // batch carve: per-class cache hits first, then the MRU sheet until it runs dry, then the bitmap scan, holding one
+  // sheet across as many blocks as it has; returns how many of out[0..n) were filled
+  template<typename TierT>
+  usize
+  __bucket_insert_n(TierT &tier, const usize sz, usize n, byte **out)
+  {
+    usize k = 0;
+    if constexpr ( __default_per_class_free_cache && TierT::__cache_slots > 0 ) {
+      while ( k < n ) {
+        i32 hit;
+        if constexpr ( TierT::sheet_t::__exact_classes )
+          hit = tier.__cache.probe(static_cast<u32>(TierT::sheet_t::round_request(sz)));
+        else
+          hit = tier.__cache.probe_ge(static_cast<u32>(sz));
+        if ( hit < 0 ) break;
+        out[k++] = tier.__cache.pop_at(static_cast<u32>(hit)).ptr;
+      }
+      tier.__stats.template add<tier_stat::allocs>(k);
+      tier.__stats.template add<tier_stat::cache_hits>(k);
+    }
+    u32 lh = tier.__last_hit;
+    if ( k < n and lh < tier.__slots and tier.__mask_get(lh) ) {
+      auto &sh = *tier.__at(lh).nd->nd;
+      const usize u0 = __stat_used(sh);
+      const usize k0 = k;
+      while ( k < n ) {
+        micron::__chunk<byte> mem = sh.mark(sz);
+        if ( mem.zero() ) {
+          tier.mark_exhausted(lh);
+          break;
+        }
+        out[k++] = mem.ptr;
+      }
+      __stat_sheet_op<tier_stat::allocs>(tier, sh, u0, k - k0);
+    }
+    for ( u32 w = 0, nw = tier.__words(); w < nw and k < n; ++w ) {
+      u64 mask = tier.__space_word(w);
+      while ( mask and k < n ) {
+        const u32 pos = (w << 6) | static_cast<u32>(__builtin_ctzll(mask));
+        if ( pos >= tier.__slots ) break;
+        auto &sh = *tier.__at(pos).nd->nd;
+        const usize u0 = __stat_used(sh);
+        const usize k0 = k;
+        while ( k < n ) {
+          micron::__chunk<byte> mem = sh.mark(sz);
+          if ( mem.zero() ) {
+            tier.mark_exhausted(pos);
+            break;
+          }
+          out[k++] = mem.ptr;
+          tier.__last_hit = pos;
+        }
+        __stat_sheet_op<tier_stat::allocs>(tier, sh, u0, k - k0);
+        mask &= mask - 1;
+      }
+    }
+    return k;
+  }
+
+  usize
+  __vmap_alloc_n(const usize sz, usize n, byte **out)
+  {
+    if ( sz <= __class_precise ) return __bucket_insert_n(_precise, sz, n, out);
+    if ( sz < __class_medium ) return __bucket_insert_n(_small, sz, n, out);
+    if ( sz <= __class_large ) return __bucket_insert_n(_medium, sz, n, out);
+    if ( sz <= __class_huge ) return __bucket_insert_n(_large, sz, n, out);
+    return __bucket_insert_n(_huge, sz, n, out);
+  }
+
   // inflate allocation size for redzones; only if inflated stays in TLSF territory
   static inline __attribute__((always_inline)) usize
   __rz_inflate(usize sz)
@@ -883,22 +1180,101 @@ class __arena: private cache
     // if caching is disabled behavior is identical to without it, comped out
     if constexpr ( __default_per_class_free_cache && TierT::__cache_slots > 0 && !__default_launder ) {
       i32 hit;
-      if constexpr ( __default_redzone ) {
+      if constexpr ( TierT::sheet_t::__exact_classes ) {
+        // class-exact reuse; a larger cached object would undo the slab's density
+        hit = tier.__cache.probe(static_cast<u32>(TierT::sheet_t::round_request(sz)));
+      } else if constexpr ( __default_redzone ) {
         hit = tier.__cache.probe(static_cast<u32>(sz));
       } else {
         hit = tier.__cache.probe_ge(static_cast<u32>(sz));
       }
       if ( hit >= 0 ) [[likely]] {
         __tcache_chunk c = tier.__cache.pop_at(static_cast<u32>(hit));
+        tier.__stats.template add<tier_stat::allocs>();
+        tier.__stats.template add<tier_stat::cache_hits>();
         return { c.ptr, static_cast<usize>(c.size) };
       }
+      tier.__stats.template add<tier_stat::cache_misses>();
     }
     return __bucket_insert(tier, sz);
   }
 
+  // one dedicated mapping per block
+  micron::__chunk<byte>
+  __map_insert(const usize sz)
+  {
+    auto __g = __struct_guard();
+    using Nd = node<map_sheet>;
+    usize pair_sz = sizeof(Nd) + sizeof(map_sheet);
+    micron::__chunk<byte> buf = __mark_arena(pair_sz);
+    auto chnk = __get_kernel_chunk<micron::__chunk<byte>>(__page_round(sz));
+    if ( !__kernel_chunk_valid(chnk) ) [[unlikely]] {
+      __debug_print("__map_insert(): mmap failed for dedicated mapping, req: ", sz);
+      __unmark_from_arena(buf.ptr, pair_sz);
+      return { nullptr, 0 };
+    }
+    byte *p = buf.ptr;
+    auto *nd = new (p) Nd();
+    p += sizeof(Nd);
+    nd->nd = new (p) map_sheet(this, chnk);
+    nd->nxt = nullptr;
+    _mapped.link_at_tail(nd);
+    if ( _mapped.register_sheet(nd) == _mapped.__no_slot ) [[unlikely]] {
+      __debug_print("__map_insert(): mapped tier directory could not grow", 0);
+      _mapped.unlink_node(nd);
+      nd->nd->release();
+      __unmark_from_arena(buf.ptr, pair_sz);
+      return { nullptr, 0 };
+    }
+    micron::__chunk<byte> mem = nd->nd->mark(sz);
+    _mapped.__stats.add<tier_stat::expansions>();
+    __stat_sheet_op<tier_stat::allocs>(_mapped, *nd->nd, 0);
+    __note_zero(*nd->nd, mem);
+    return mem;
+  }
+
+  // resize a dedicated mapping in place or by moving its page tables; nullptr if ptr isn't a live mapped
+  // block or the kernel refused (the block is then untouched)
+  byte *
+  __map_resize(byte *ptr, usize new_sz)
+  {
+    if constexpr ( __default_direct_map ) {
+      const uintptr_t b = __sheet_binding_of(this, ptr);
+      i32 idx = ((b & __sheet_tier_mask) == __sheet_tier_mapped) ? __bound_range(_mapped, b, reinterpret_cast<addr_t *>(ptr))
+                                                                   : _mapped.find_range(reinterpret_cast<addr_t *>(ptr));
+      if ( idx < 0 ) return nullptr;
+      auto __g = __struct_guard();
+      auto *nd = _mapped.__at(idx).nd;
+      if ( !nd->nd->is_block_allocated(ptr) ) [[unlikely]]
+        return nullptr;
+      const usize u0 = __stat_used(*nd->nd);
+      _mapped.unregister(static_cast<u32>(idx));
+      const bool ok = nd->nd->remap(this, __page_round(new_sz));
+      _mapped.register_sheet(nd);
+      _mapped.__stats.add<tier_stat::bytes_live>(__stat_used(*nd->nd) - u0);
+      if ( !ok ) [[unlikely]] {
+        __debug_print("__map_resize(): mremap refused, falling back to copy, req: ", new_sz);
+        return nullptr;
+      }
+      return reinterpret_cast<byte *>(nd->nd->addr());
+    } else {
+      (void)ptr;
+      (void)new_sz;
+      return nullptr;
+    }
+  }
+
   hot_fn(micron::__chunk<byte>) __vmap_alloc(const usize sz)
   {
-    if ( sz <= __class_small ) {
+    if constexpr ( __default_direct_map ) {
+      if ( sz >= __direct_map_threshold ) [[unlikely]] {
+        __debug_print("__vmap_alloc(): tier=mapped, sz: ", sz);
+        if ( micron::__chunk<byte> m = __map_insert(sz); !m.zero() ) [[likely]]
+          return m;
+        // tier full or mmap refused, the huge buddy tier still serves it
+      }
+    }
+    if ( sz <= __class_precise ) {
       __debug_print("__vmap_alloc(): tier=precise, sz: ", sz);
       return __cache_pop_or_insert(_precise, sz);
     }
@@ -918,6 +1294,46 @@ class __arena: private cache
     return __cache_pop_or_insert(_huge, sz);
   }
 
+  // al in (__block_align_min, __block_align_max]. slab objects of a class that is a multiple of al sit on an al
+  // boundary (runs are 16 KiB aligned), tlsf blocks are split at one, page runs start on one, and a buddy block whose
+  // order size reaches al is aligned to it, so the request is only ever grown to the block the alignment needs. cls
+  // is the size the tier was picked on, for the expansion ladder
+  micron::__chunk<byte>
+  __vmap_alloc_aligned(const usize sz, const usize al, usize &cls)
+  {
+    if constexpr ( !__default_redzone ) {
+      // redzoned tiers hand out block + __default_redzone_size, never aligned past it
+      const usize r = (sz + al - 1) & ~(al - 1);
+      if ( r <= __class_precise ) {
+        cls = r;
+        return __cache_pop_or_insert(_precise, r);
+      }
+      if ( r < __class_medium ) {
+        cls = r;
+        return __bucket_insert_aligned(_small, sz, al);
+      }
+    }
+    if constexpr ( __default_page_runs ) {
+      // page runs start on a page, past that the run list looks for an aligned start itself
+      if ( sz <= __class_huge and al <= __class_huge ) {
+        if ( sz <= __class_large ) {
+          cls = sz < __class_medium ? __class_medium : sz;
+          return al <= __system_pagesize ? __cache_pop_or_insert(_medium, cls) : __bucket_insert_aligned(_medium, cls, al);
+        }
+        cls = sz;
+        return al <= __system_pagesize ? __cache_pop_or_insert(_large, sz) : __bucket_insert_aligned(_large, sz, al);
+      }
+    }
+    // smallest request whose order size is at least al
+    const usize b = sz > al ? sz : al;
+    if ( b < __class_medium ) {
+      cls = __class_medium;
+      return __cache_pop_or_insert(_medium, b);
+    }
+    cls = b;
+    return __vmap_alloc(b);
+  }
+
   micron::__chunk<byte>
   __vmap_launder(const usize sz)
   {
@@ -927,30 +1343,74 @@ class __arena: private cache
     return __bucket_insert_temporal(_huge, sz);
   }
 
+  // range slot of addr inside tier via its granule binding; a stale binding degrades to find_range
+  template<typename TierT>
+  static inline __attribute__((always_inline)) i32
+  __bound_range(const TierT &tier, uintptr_t binding, addr_t *addr)
+  {
+    const auto *nd = reinterpret_cast<const node<typename TierT::sheet_t> *>(binding & ~__sheet_tier_mask);
+    const u32 pos = nd->pos;
+    if ( pos < tier.__slots and tier.__at(pos).nd == nd and addr >= tier.__at(pos).lo and addr < tier.__at(pos).hi ) [[likely]]
+      return static_cast<i32>(pos);
+    return tier.find_range(addr);
+  }
+
+  template<typename TierT, typename Fn>
+  static inline __attribute__((always_inline)) bool
+  __dispatch_bound(TierT &tier, uintptr_t binding, addr_t *addr, Fn &fn)
+  {
+    const i32 idx = __bound_range(tier, binding, addr);
+    return idx >= 0 ? fn(tier, idx) : false;
+  }
+
+  // address -> (tier, range slot): one granule-table lookup for any address, reservation or not; the per-tier
+  // find_range scans only run for a sheet the table couldn't record
+  template<typename Self, typename Fn>
+  static inline __attribute__((always_inline)) bool
+  __dispatch_addr_impl(Self &self, addr_t *addr, Fn &fn)
+  {
+    if ( const uintptr_t b = __sheet_binding_of(&self, addr); b != 0 ) [[likely]] {
+      switch ( b & __sheet_tier_mask ) {
+      case __sheet_tier_precise :
+        return __dispatch_bound(self._precise, b, addr, fn);
+      case __sheet_tier_small :
+        return __dispatch_bound(self._small, b, addr, fn);
+      case __sheet_tier_medium :
+        return __dispatch_bound(self._medium, b, addr, fn);
+      case __sheet_tier_large :
+        return __dispatch_bound(self._large, b, addr, fn);
+      case __sheet_tier_huge :
+        return __dispatch_bound(self._huge, b, addr, fn);
+      case __sheet_tier_mapped :
+        return __dispatch_bound(self._mapped, b, addr, fn);
+      case __sheet_tier_arena :
+        return false;      // allocator metadata, never a user block
+      default :
+        break;
+      }
+    }
+    i32 idx;
+    if ( (idx = self._precise.find_range(addr)) >= 0 ) return fn(self._precise, idx);
+    if ( (idx = self._small.find_range(addr)) >= 0 ) return fn(self._small, idx);
+    if ( (idx = self._medium.find_range(addr)) >= 0 ) return fn(self._medium, idx);
+    if ( (idx = self._large.find_range(addr)) >= 0 ) return fn(self._large, idx);
+    if ( (idx = self._huge.find_range(addr)) >= 0 ) return fn(self._huge, idx);
+    if ( (idx = self._mapped.find_range(addr)) >= 0 ) return fn(self._mapped, idx);
+    return false;
+  }
+
   template<typename Fn>
   inline __attribute__((always_inline)) bool
   __dispatch_addr(addr_t *addr, Fn &&fn)
   {
-    i32 idx;
-    if ( (idx = _precise.find_range(addr)) >= 0 ) return fn(_precise, idx);
-    if ( (idx = _small.find_range(addr)) >= 0 ) return fn(_small, idx);
-    if ( (idx = _medium.find_range(addr)) >= 0 ) return fn(_medium, idx);
-    if ( (idx = _large.find_range(addr)) >= 0 ) return fn(_large, idx);
-    if ( (idx = _huge.find_range(addr)) >= 0 ) return fn(_huge, idx);
-    return false;
+    return __dispatch_addr_impl(*this, addr, fn);
   }
 
   template<typename Fn>
   inline __attribute__((always_inline)) bool
   __dispatch_addr(addr_t *addr, Fn &&fn) const
   {
-    i32 idx;
-    if ( (idx = _precise.find_range(addr)) >= 0 ) return fn(_precise, idx);
-    if ( (idx = _small.find_range(addr)) >= 0 ) return fn(_small, idx);
-    if ( (idx = _medium.find_range(addr)) >= 0 ) return fn(_medium, idx);
-    if ( (idx = _large.find_range(addr)) >= 0 ) return fn(_large, idx);
-    if ( (idx = _huge.find_range(addr)) >= 0 ) return fn(_huge, idx);
-    return false;
+    return __dispatch_addr_impl(*this, addr, fn);
   }
 
   template<typename TierT>
@@ -961,8 +1421,8 @@ class __arena: private cache
     auto __g = __struct_guard();
     __debug_print("__sweep_tier_tombstones(): sweeping tier, sheet count: ", tier.__count);
     tier.__dealloc_count = 0;
-    for ( i32 i = static_cast<i32>(tier.__count) - 1; i >= 0; --i ) {
-      auto *nd = tier.__idx[i].nd;
+    for ( i32 i = static_cast<i32>(tier.__slots) - 1; i >= 0; --i ) {
+      auto *nd = tier.__at(i).nd;
       if ( !nd or !nd->nd or nd == &tier.head ) continue;
       auto &sh = *nd->nd;
       if ( sh.used() != 0 ) continue;
@@ -973,9 +1433,9 @@ class __arena: private cache
       if ( ts > (ft >> 1) ) {
         if constexpr ( !__default_persistent_mode ) {
           __debug_print("__sweep_tier_tombstones(): reclaiming sheet at idx: ", (usize)i);
+          tier.unregister(static_cast<u32>(i));      // unbind before the VA can be re-carved
           sh.reset();
           tier.unlink_node(nd);
-          tier.unregister(static_cast<u32>(i));
           __unmark_from_arena(reinterpret_cast<byte *>(nd), sizeof(node<sheet_t>) + sizeof(sheet_t));
         }
       }
@@ -991,9 +1451,9 @@ class __arena: private cache
       if constexpr ( !__default_persistent_mode ) {
         auto __g = __struct_guard();
         __debug_print("__try_reclaim_empty(): sheet fully drained, unlinking and resetting", 0);
+        tier.unregister(range_idx);      // unbind before the VA can be re-carved
         nd->nd->reset();
         tier.unlink_node(nd);
-        tier.unregister(range_idx);
         __unmark_from_arena(reinterpret_cast<byte *>(nd), sizeof(node<sheet_t>) + sizeof(sheet_t));
       }
     }
@@ -1012,9 +1472,9 @@ class __arena: private cache
       if ( (ts > (ft >> 1)) and sh.used() == 0 and nd != &tier.head ) {
         if constexpr ( !__default_persistent_mode ) {
           __debug_print("__tombstone_accounting(): threshold crossed, compacting sheet", 0);
+          tier.unregister(range_idx);      // unbind before the VA can be re-carved
           sh.reset();
           tier.unlink_node(nd);
-          tier.unregister(range_idx);
           __unmark_from_arena(reinterpret_cast<byte *>(nd), sizeof(node<typename TierT::sheet_t>) + sizeof(typename TierT::sheet_t));
         }
       }
@@ -1032,9 +1492,9 @@ class __arena: private cache
             __debug_print("__tombstone_accounting(): drained + ratio met, immediate reclaim", 0);
             __debug_print("__tombstone_accounting(): tombstoned: ", ts);
             __debug_print("__tombstone_accounting(): ftotal: ", ft);
+            tier.unregister(range_idx);      // unbind before the VA can be re-carved
             nd->nd->reset();
             tier.unlink_node(nd);
-            tier.unregister(range_idx);
             __unmark_from_arena(reinterpret_cast<byte *>(nd), sizeof(node<typename TierT::sheet_t>) + sizeof(typename TierT::sheet_t));
             return;
           }
@@ -1049,15 +1509,19 @@ class __arena: private cache
   inline bool
   __tier_remove_impl(TierT &tier, i32 range_idx, byte *addr, const micron::__chunk<byte> &memory)
   {
-    auto *nd = tier.__idx[range_idx].nd;
+    auto *nd = tier.__at(range_idx).nd;
     auto &sh = *nd->nd;
     __debug_print_addr("__tier_remove_impl(): found in sheet at addr: ", addr);
+    __purge_tick();
+    // the sheet may be reclaimed below, so its byte count is read right after the op
+    const usize u0 = __stat_used(sh);
 
     if constexpr ( ForceTombstone ) {
       if constexpr ( HasSize )
         sh.try_tombstone(memory);
       else
         sh.try_tombstone_no_size(addr);
+      __stat_sheet_op<tier_stat::frees>(tier, sh, u0);
       tier.mark_available(range_idx);
       __debug_print("__tier_remove_impl(): force tombstone set", 0);
       __tombstone_accounting(tier, range_idx, nd);
@@ -1074,6 +1538,7 @@ class __arena: private cache
         else
           ok = sh.try_unmark_no_size(addr);
         if ( ok ) {
+          __stat_sheet_op<tier_stat::frees>(tier, sh, u0);
           tier.mark_available(range_idx);
           __debug_print("__tier_remove_impl(): unmark succeeded, sheet used: ", sh.used());
           __try_reclaim_empty(tier, range_idx, nd);
@@ -1085,6 +1550,7 @@ class __arena: private cache
         else
           ok = sh.try_tombstone_no_size(addr);
         if ( ok ) {
+          __stat_sheet_op<tier_stat::frees>(tier, sh, u0);
           tier.mark_available(range_idx);
           __debug_print("__tier_remove_impl(): tombstone set", 0);
           __tombstone_accounting(tier, range_idx, nd);
@@ -1107,7 +1573,7 @@ class __arena: private cache
   inline bool
   __tier_remove_at(TierT &tier, i32 range_idx, byte *addr)
   {
-    [[maybe_unused]] auto &sh = *tier.__idx[range_idx].nd->nd;
+    [[maybe_unused]] auto &sh = *tier.__at(range_idx).nd->nd;
     // NOTE: block-validity guard on EVERY tier
     if constexpr ( !__default_redzone ) {
       if ( !sh.is_block_allocated(addr) ) [[unlikely]]
@@ -1119,10 +1585,13 @@ class __arena: private cache
       if ( tier.__cache.contains(addr) ) [[unlikely]]
         return handle_double_free(addr);
       if ( !sh.is_temporal_block(addr) ) {
+        constexpr usize ovh = TierT::sheet_t::__block_overhead;
         const usize bsz = sh.block_size_of(addr);
-        if ( bsz > __hdr_offset ) {
-          if ( tier.__cache.push(addr, static_cast<u32>(bsz - __hdr_offset)) ) [[likely]]
+        if ( bsz > ovh ) {
+          if ( tier.__cache.push(addr, static_cast<u32>(bsz - ovh)) ) [[likely]] {
+            tier.__stats.template add<tier_stat::frees>();
             return true;
+          }
         }
       }
     }
@@ -1149,163 +1618,169 @@ class __arena: private cache
   {
     if constexpr ( __default_per_class_free_cache && TierT::__cache_slots > 0 && !__default_launder ) {
       // double / bogus free guard
-      auto &sh = *tier.__idx[range_idx].nd->nd;
+      auto &sh = *tier.__at(range_idx).nd->nd;
       if ( !sh.is_block_allocated(chunk.ptr) || tier.__cache.contains(chunk.ptr) ) [[unlikely]]
         return handle_double_free(chunk.ptr);
+      // the cached length is the caller's, rounded to its class on exact-class sheets, and clamped to what the block
+      // holds: a sized free may name less than the block but never more, or the slot would be handed out as a bigger
+      // class than it is
+      constexpr usize ovh = TierT::sheet_t::__block_overhead;
       const usize bsz = sh.block_size_of(chunk.ptr);
-      if ( bsz > __hdr_offset ) [[likely]] {
-        const usize cap = bsz - __hdr_offset;
-        const usize clen = (chunk.len > cap) ? cap : chunk.len;
-        if ( tier.__cache.push(chunk.ptr, static_cast<u32>(clen)) ) [[likely]]
+      const usize cap = bsz > ovh ? bsz - ovh : 0;
+      usize clen;
+      if constexpr ( TierT::sheet_t::__exact_classes ) {
+        clen = TierT::sheet_t::round_request(chunk.len);
+      } else {
+        clen = chunk.len;
+      }
+      if ( clen > cap ) [[unlikely]]
+        clen = cap;
+      if ( clen > 0 ) [[likely]] {
+        if ( tier.__cache.push(chunk.ptr, static_cast<u32>(clen)) ) [[likely]] {
+          tier.__stats.template add<tier_stat::frees>();
           return true;
+        }
       }
     }
     return __tier_remove(tier, range_idx, chunk);
   }
 
-  bool
-  __vmap_remove(const micron::__chunk<byte> &m)
+  // sizeless frees of a run of blocks that all sit in sheet range_idx: the lookup happened once for the run, and the
+  // purge tick, the availability bit and the reclaim/tombstone accounting run once after it; returns blocks freed
+  template<typename TierT>
+  usize
+  __tier_remove_run(TierT &tier, i32 range_idx, byte *const *ptrs, usize n)
   {
-    if constexpr ( __default_redzone ) {
-      i32 idx;
-      if ( (idx = _precise.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) {
-        if ( !verify_redzone(m.ptr, m.len) ) [[unlikely]] {
-          __debug_print_addr("__vmap_remove(): redzone corruption detected at: ", m.ptr);
-          return fail_state();
+    using sheet_t = typename TierT::sheet_t;
+    constexpr bool tomb = tomb_for<sheet_t::__size_class>();
+    auto *nd = tier.__at(range_idx).nd;
+    auto &sh = *nd->nd;
+    __purge_tick();
+    const usize u0 = __stat_used(sh);
+    usize freed = 0, unmarked = 0;
+    for ( usize i = 0; i < n; ++i ) {
+      byte *p = ptrs[i];
+      if ( !check_ptr_valid(p) or !check_alignment(p) ) [[unlikely]] {
+        (void)fail_state();
+        continue;
+      }
+      // the sheet-local block check stands in for __free_admit's per-object provenance lookup
+      if ( !sh.is_block_allocated(p) ) [[unlikely]] {
+        (void)handle_double_free(p);
+        continue;
+      }
+      collect_stats<stat_type::dealloc>();
+      __free_scrub(p, 0);
+      __prof.on_free(p);
+      ABC_DOCTOR(doctor::record_free(p, 0);)
+      ++freed;
+      if constexpr ( __default_per_class_free_cache && TierT::__cache_slots > 0 && !__default_launder ) {
+        if ( tier.__cache.contains(p) ) [[unlikely]] {
+          --freed;
+          (void)handle_double_free(p);
+          continue;
         }
-        micron::__chunk<byte> adj = { m.ptr - __default_redzone_size, m.len + 2 * __default_redzone_size };
-        return __cache_push_or_remove(_precise, idx, adj);
+        if ( !sh.is_temporal_block(p) ) {
+          constexpr usize ovh = sheet_t::__block_overhead;
+          const usize bsz = sh.block_size_of(p);
+          if ( bsz > ovh and tier.__cache.push(p, static_cast<u32>(bsz - ovh)) ) [[likely]]
+            continue;
+        }
+      }
+      bool ok;
+      if constexpr ( tomb )
+        ok = sh.try_tombstone_no_size(p);
+      else
+        ok = sh.try_unmark_no_size(p);
+      if ( !ok ) [[unlikely]] {
+        --freed;
+        (void)handle_double_free(p);
+        continue;
       }
-      if ( (idx = _small.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) {
+      ++unmarked;
+    }
+    __stat_sheet_op<tier_stat::frees>(tier, sh, u0, freed);
+    if ( unmarked ) {
+      tier.mark_available(range_idx);
+      if constexpr ( tomb )
+        __tombstone_accounting(tier, range_idx, nd);
+      else
+        __try_reclaim_empty(tier, range_idx, nd);
+    }
+    return freed;
+  }
+
+  bool
+  __vmap_remove(const micron::__chunk<byte> &m)
+  {
+    bool ok = __dispatch_addr(reinterpret_cast<addr_t *>(m.ptr), [&]<typename TierT>(TierT &tier, i32 idx) {
+      if constexpr ( __default_redzone && TierT::__redzoned ) {
         if ( !verify_redzone(m.ptr, m.len) ) [[unlikely]] {
           __debug_print_addr("__vmap_remove(): redzone corruption detected at: ", m.ptr);
           return fail_state();
         }
         micron::__chunk<byte> adj = { m.ptr - __default_redzone_size, m.len + 2 * __default_redzone_size };
-        return __cache_push_or_remove(_small, idx, adj);
+        return __cache_push_or_remove(tier, idx, adj);
       }
-      if ( (idx = _medium.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) return __cache_push_or_remove(_medium, idx, m);
-      if ( (idx = _large.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) return __cache_push_or_remove(_large, idx, m);
-      if ( (idx = _huge.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) return __cache_push_or_remove(_huge, idx, m);
+      return __cache_push_or_remove(tier, idx, m);
+    });
+    if ( !ok ) [[unlikely]]
       __debug_print_addr("__vmap_remove(): WARNING address not found in any tier: ", m.ptr);
-      return false;
-    }
-    addr_t *p = reinterpret_cast<addr_t *>(m.ptr);
-    i32 idx;
-    if ( (idx = _precise.find_range(p)) >= 0 ) [[likely]]
-      return __cache_push_or_remove(_precise, idx, m);
-    if ( (idx = _small.find_range(p)) >= 0 ) return __cache_push_or_remove(_small, idx, m);
-    if ( (idx = _medium.find_range(p)) >= 0 ) return __cache_push_or_remove(_medium, idx, m);
-    if ( (idx = _large.find_range(p)) >= 0 ) return __cache_push_or_remove(_large, idx, m);
-    if ( (idx = _huge.find_range(p)) >= 0 ) return __cache_push_or_remove(_huge, idx, m);
-    __debug_print_addr("__vmap_remove(): WARNING address not found in any tier: ", m.ptr);
-    return false;
+    return ok;
   }
 
   bool
   __vmap_remove_at(byte *addr)
   {
-    if constexpr ( __default_redzone ) {
-      i32 idx;
-      if ( (idx = _precise.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) {
+    bool ok = __dispatch_addr(reinterpret_cast<addr_t *>(addr), [&]<typename TierT>(TierT &tier, i32 idx) {
+      if constexpr ( __default_redzone && TierT::__redzoned ) {
         if ( !verify_redzone_leading(addr) ) [[unlikely]] {
           __debug_print_addr("__vmap_remove_at(): leading redzone corrupted at: ", addr);
           return fail_state();
         }
-        return __tier_remove_at(_precise, idx, addr - __default_redzone_size);
+        return __tier_remove_at(tier, idx, addr - __default_redzone_size);
       }
-      if ( (idx = _small.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) {
-        if ( !verify_redzone_leading(addr) ) [[unlikely]] {
-          __debug_print_addr("__vmap_remove_at(): leading redzone corrupted at: ", addr);
-          return fail_state();
-        }
-        return __tier_remove_at(_small, idx, addr - __default_redzone_size);
-      }
-      if ( (idx = _medium.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) return __tier_remove_at(_medium, idx, addr);
-      if ( (idx = _large.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) return __tier_remove_at(_large, idx, addr);
-      if ( (idx = _huge.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) return __tier_remove_at(_huge, idx, addr);
+      return __tier_remove_at(tier, idx, addr);
+    });
+    if ( !ok ) [[unlikely]]
       __debug_print_addr("__vmap_remove_at(): WARNING address not found in any tier: ", addr);
-      return false;
-    }
-    addr_t *p = reinterpret_cast<addr_t *>(addr);
-    i32 idx;
-    if ( (idx = _precise.find_range(p)) >= 0 ) [[likely]]
-      return __tier_remove_at(_precise, idx, addr);
-    if ( (idx = _small.find_range(p)) >= 0 ) return __tier_remove_at(_small, idx, addr);
-    if ( (idx = _medium.find_range(p)) >= 0 ) return __tier_remove_at(_medium, idx, addr);
-    if ( (idx = _large.find_range(p)) >= 0 ) return __tier_remove_at(_large, idx, addr);
-    if ( (idx = _huge.find_range(p)) >= 0 ) return __tier_remove_at(_huge, idx, addr);
-    __debug_print_addr("__vmap_remove_at(): WARNING address not found in any tier: ", addr);
-    return false;
+    return ok;
   }
 
   bool
   __vmap_tombstone(const micron::__chunk<byte> &m)
   {
     // NOTE: always tombstones regardless of __default_tombstone
-    if constexpr ( __default_redzone ) {
-      i32 idx;
-      if ( (idx = _precise.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) {
+    bool ok = __dispatch_addr(reinterpret_cast<addr_t *>(m.ptr), [&]<typename TierT>(TierT &tier, i32 idx) {
+      if constexpr ( __default_redzone && TierT::__redzoned ) {
         if ( !verify_redzone(m.ptr, m.len) ) [[unlikely]] {
           __debug_print_addr("__vmap_tombstone(): redzone corruption detected at: ", m.ptr);
           return fail_state();
         }
         micron::__chunk<byte> adj = { m.ptr - __default_redzone_size, m.len + 2 * __default_redzone_size };
-        return __tier_tombstone(_precise, idx, adj);
+        return __tier_tombstone(tier, idx, adj);
       }
-      if ( (idx = _small.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) {
-        if ( !verify_redzone(m.ptr, m.len) ) [[unlikely]] {
-          __debug_print_addr("__vmap_tombstone(): redzone corruption detected at: ", m.ptr);
-          return fail_state();
-        }
-        micron::__chunk<byte> adj = { m.ptr - __default_redzone_size, m.len + 2 * __default_redzone_size };
-        return __tier_tombstone(_small, idx, adj);
-      }
-      if ( (idx = _medium.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) return __tier_tombstone(_medium, idx, m);
-      if ( (idx = _large.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) return __tier_tombstone(_large, idx, m);
-      if ( (idx = _huge.find_range(reinterpret_cast<addr_t *>(m.ptr))) >= 0 ) return __tier_tombstone(_huge, idx, m);
+      return __tier_tombstone(tier, idx, m);
+    });
+    if ( !ok ) [[unlikely]]
       __debug_print_addr("__vmap_tombstone(): WARNING address not found in any tier: ", m.ptr);
-      return false;
-    }
-    addr_t *p = reinterpret_cast<addr_t *>(m.ptr);
-    i32 idx;
-    if ( (idx = _precise.find_range(p)) >= 0 ) [[likely]]
-      return __tier_tombstone(_precise, idx, m);
-    if ( (idx = _small.find_range(p)) >= 0 ) return __tier_tombstone(_small, idx, m);
-    if ( (idx = _medium.find_range(p)) >= 0 ) return __tier_tombstone(_medium, idx, m);
-    if ( (idx = _large.find_range(p)) >= 0 ) return __tier_tombstone(_large, idx, m);
-    if ( (idx = _huge.find_range(p)) >= 0 ) return __tier_tombstone(_huge, idx, m);
-    __debug_print_addr("__vmap_tombstone(): WARNING address not found in any tier: ", m.ptr);
-    return false;
+    return ok;
   }
 
   bool
   __vmap_tombstone_at(byte *addr)
   {
     // NOTE: always tombstones regardless of __default_tombstone
-    if constexpr ( __default_redzone ) {
-      i32 idx;
-      if ( (idx = _precise.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) {
+    bool ok = __dispatch_addr(reinterpret_cast<addr_t *>(addr), [&]<typename TierT>(TierT &tier, i32 idx) {
+      if constexpr ( __default_redzone && TierT::__redzoned ) {
         if ( !verify_redzone_leading(addr) ) [[unlikely]] {
           __debug_print_addr("__vmap_tombstone_at(): leading redzone corrupted at: ", addr);
           return fail_state();
         }
-        return __tier_tombstone_at(_precise, idx, addr - __default_redzone_size);
+        return __tier_tombstone_at(tier, idx, addr - __default_redzone_size);
       }
-      if ( (idx = _small.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) {
-        if ( !verify_redzone_leading(addr) ) [[unlikely]] {
-          __debug_print_addr("__vmap_tombstone_at(): leading redzone corrupted at: ", addr);
-          return fail_state();
-        }
-        return __tier_tombstone_at(_small, idx, addr - __default_redzone_size);
-      }
-      if ( (idx = _medium.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) return __tier_tombstone_at(_medium, idx, addr);
-      if ( (idx = _large.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) return __tier_tombstone_at(_large, idx, addr);
-      if ( (idx = _huge.find_range(reinterpret_cast<addr_t *>(addr))) >= 0 ) return __tier_tombstone_at(_huge, idx, addr);
-      __debug_print_addr("__vmap_tombstone_at(): WARNING address not found in any tier: ", addr);
-      return false;
-    }
-    bool ok = __dispatch_addr(reinterpret_cast<addr_t *>(addr), [&](auto &tier, i32 idx) { return __tier_tombstone_at(tier, idx, addr); });
+      return __tier_tombstone_at(tier, idx, addr);
+    });
     if ( !ok ) [[unlikely]]
       __debug_print_addr("__vmap_tombstone_at(): WARNING address not found in any tier: ", addr);
     return ok;
@@ -1321,37 +1796,22 @@ class __arena: private cache
   __vmap_valid_block(addr_t *addr) const
   {
     // proper validity check
-    if constexpr ( __default_redzone ) {
-      i32 idx;
-      if ( (idx = _precise.find_range(addr)) >= 0 )
-        return _precise.__idx[idx].nd->nd->is_block_allocated(reinterpret_cast<byte *>(addr) - __default_redzone_size);
-      if ( (idx = _small.find_range(addr)) >= 0 )
-        return _small.__idx[idx].nd->nd->is_block_allocated(reinterpret_cast<byte *>(addr) - __default_redzone_size);
-      if ( (idx = _medium.find_range(addr)) >= 0 ) return _medium.__idx[idx].nd->nd->is_block_allocated(reinterpret_cast<byte *>(addr));
-      if ( (idx = _large.find_range(addr)) >= 0 ) return _large.__idx[idx].nd->nd->is_block_allocated(reinterpret_cast<byte *>(addr));
-      if ( (idx = _huge.find_range(addr)) >= 0 ) return _huge.__idx[idx].nd->nd->is_block_allocated(reinterpret_cast<byte *>(addr));
-      return false;
-    }
-    return __dispatch_addr(
-        addr, [&](const auto &tier, i32 idx) { return tier.__idx[idx].nd->nd->is_block_allocated(reinterpret_cast<byte *>(addr)); });
+    return __dispatch_addr(addr, [&]<typename TierT>(const TierT &tier, i32 idx) {
+      byte *blk = reinterpret_cast<byte *>(addr);
+      if constexpr ( __default_redzone && TierT::__redzoned ) blk -= __default_redzone_size;
+      return tier.__at(idx).nd->nd->is_block_allocated(blk);
+    });
   }
 
   bool
   __vmap_locate_at(addr_t *addr) const
   {
-    if constexpr ( __default_redzone ) {
-      i32 idx;
-      // NOTE: for TLSF adjust pointer before calling find
-      if ( (idx = _precise.find_range(addr)) >= 0 )
-        return _precise.__idx[idx].nd->nd->find(reinterpret_cast<byte *>(addr) - __default_redzone_size);
-      if ( (idx = _small.find_range(addr)) >= 0 )
-        return _small.__idx[idx].nd->nd->find(reinterpret_cast<byte *>(addr) - __default_redzone_size);
-      if ( (idx = _medium.find_range(addr)) >= 0 ) return _medium.__idx[idx].nd->nd->find(reinterpret_cast<byte *>(addr));
-      if ( (idx = _large.find_range(addr)) >= 0 ) return _large.__idx[idx].nd->nd->find(reinterpret_cast<byte *>(addr));
-      if ( (idx = _huge.find_range(addr)) >= 0 ) return _huge.__idx[idx].nd->nd->find(reinterpret_cast<byte *>(addr));
-      return false;
-    }
-    return __dispatch_addr(addr, [&](const auto &tier, i32 idx) { return tier.__idx[idx].nd->nd->find(reinterpret_cast<byte *>(addr)); });
+    // NOTE: for TLSF adjust pointer before calling find
+    return __dispatch_addr(addr, [&]<typename TierT>(const TierT &tier, i32 idx) {
+      byte *blk = reinterpret_cast<byte *>(addr);
+      if constexpr ( __default_redzone && TierT::__redzoned ) blk -= __default_redzone_size;
+      return tier.__at(idx).nd->nd->find(blk);
+    });
   }
 
   bool
@@ -1361,8 +1821,8 @@ class __arena: private cache
     return __dispatch_addr(reinterpret_cast<addr_t *>(memory.ptr), [&](auto &tier, i32 idx) {
       __debug_print_addr("__vmap_freeze(): freezing sheet containing addr: ", memory.ptr);
       // drop any cached blocks belonging to this sheet
-      tier.__cache.invalidate_range(reinterpret_cast<const byte *>(tier.__idx[idx].lo), reinterpret_cast<const byte *>(tier.__idx[idx].hi));
-      bool ok = tier.__idx[idx].nd->nd->freeze();
+      tier.__cache.invalidate_range(reinterpret_cast<const byte *>(tier.__at(idx).lo), reinterpret_cast<const byte *>(tier.__at(idx).hi));
+      bool ok = tier.__at(idx).nd->nd->freeze();
       __debug_print("__vmap_freeze(): freeze result: ", (usize)ok);
       return ok;
     });
@@ -1374,8 +1834,8 @@ class __arena: private cache
     auto __g = __struct_guard();
     return __dispatch_addr(reinterpret_cast<addr_t *>(addr), [&](auto &tier, i32 idx) {
       __debug_print_addr("__vmap_freeze_at(): freezing sheet containing: ", addr);
-      tier.__cache.invalidate_range(reinterpret_cast<const byte *>(tier.__idx[idx].lo), reinterpret_cast<const byte *>(tier.__idx[idx].hi));
-      bool ok = tier.__idx[idx].nd->nd->freeze();
+      tier.__cache.invalidate_range(reinterpret_cast<const byte *>(tier.__at(idx).lo), reinterpret_cast<const byte *>(tier.__at(idx).hi));
+      bool ok = tier.__at(idx).nd->nd->freeze();
       __debug_print("__vmap_freeze_at(): freeze result: ", (usize)ok);
       return ok;
     });
@@ -1390,6 +1850,13 @@ class __arena: private cache
       if ( nd->nd ) nd->nd->release();
       nd = nd->nxt;
     }
+    tier.release_directory();
+  }
+
+  [[gnu::always_inline]] inline bool
+  __in_redzoned_tier(addr_t *addr) const
+  {
+    return __dispatch_addr(addr, []<typename TierT>(const TierT &, i32) { return TierT::__redzoned; });
   }
 
   // user pointer -> allocator block pointer
@@ -1397,8 +1864,7 @@ class __arena: private cache
   __block_ptr_of(byte *user) const
   {
     if constexpr ( __default_redzone ) {
-      addr_t *a = reinterpret_cast<addr_t *>(user);
-      if ( _precise.find_range(a) >= 0 or _small.find_range(a) >= 0 ) return user - __default_redzone_size;
+      if ( __in_redzoned_tier(reinterpret_cast<addr_t *>(user)) ) return user - __default_redzone_size;
     }
     return user;
   }
@@ -1454,19 +1920,22 @@ public:
       (void)sz;
       return true;
     } else {
-      if ( __remote_free.push(p, sz) ) [[likely]]
-        return true;
-      // ring full (owner not draining)
-      __remote_ovf_node *nd = reinterpret_cast<__remote_ovf_node *>(p);
-      nd->sz = sz;
-      __remote_ovf_node *head = __remote_ovf.get(micron::memory_order_relaxed);
-      do {
-        nd->next = head;
-      } while ( !__remote_ovf.compare_exchange_weak(head, nd, micron::memory_order_release, micron::memory_order_relaxed) );
+      __remote.push(p, sz);
       return true;
     }
   }
 
+  // publishes a whole thread-local batch with a single CAS
+  [[gnu::always_inline]] inline void
+  __remote_push_chain(__mpsc_free_batch &b) noexcept
+  {
+    if constexpr ( !__default_multithread_safe ) {
+      (void)b;
+    } else {
+      __remote.push_chain(b);
+    }
+  }
+
   void
   __remote_release(byte *p, usize sz) noexcept
   {
@@ -1474,7 +1943,9 @@ public:
       if ( !__free_admit<false>(p, sz) ) return;
     }
     __free_scrub(p, sz);
+    __prof.on_free(p);
     collect_stats<stat_type::dealloc>();
+    collect_stats<stat_type::remote_free>();
     collect_stats<stat_type::total_memory_freed>(sz);
     const bool ok = sz ? __vmap_remove({ p, sz }) : __vmap_remove_at(p);
     ABC_DOCTOR(if ( !ok ) doctor::on_free_result(p, ok, __FILE__, __LINE__);)
@@ -1487,21 +1958,7 @@ public:
     if constexpr ( !__default_multithread_safe ) {
       return 0;
     } else {
-      u32 n = __remote_free.drain([this](byte *p, usize sz) { this->__remote_release(p, sz); });
-      if ( __remote_ovf.get(micron::memory_order_relaxed) != nullptr ) {
-        // take-all: producers only push, so swapping the head detaches a consistent list
-        __remote_ovf_node *nd = __remote_ovf.swap(nullptr, micron::memory_order::acq_rel);
-        while ( nd != nullptr ) {
-          __remote_ovf_node *nx = nd->next;      // read the embedded node before the map free recycles it
-          const usize sz = nd->sz;
-          byte *p = reinterpret_cast<byte *>(nd);
-          // NOTE: nx/sz are read out first
-          __remote_release(p, sz);
-          ++n;
-          nd = nx;
-        }
-      }
-      return n;
+      return __remote.drain([this](byte *p, usize sz) { this->__remote_release(p, sz); });
     }
   }
 
@@ -1509,8 +1966,58 @@ public:
   __maybe_drain(void) noexcept
   {
     if constexpr ( !__default_multithread_safe ) return;
-    if ( __remote_free.maybe_nonempty() || __remote_ovf.get(micron::memory_order_relaxed) != nullptr ) [[unlikely]]
+    if ( __remote.maybe_nonempty() ) [[unlikely]]
       (void)__remote_drain();
+    if constexpr ( __default_purge ) {
+      if ( __purge_req.get(micron::memory_order_relaxed) ) [[unlikely]] {
+        __purge_req.store(0, micron::memory_order_relaxed);
+        (void)__purge_pass(__purge_now_ms());
+      }
+    }
+  }
+
+  // one decay pass over every buddy/tlsf sheet; the slab tier has no multi-page free runs, mapped sheets are unmapped on free
+  // caller owns the arena. returns the bytes advised
+  [[gnu::cold]] usize
+  __purge_pass(u64 now) noexcept
+  {
+    if constexpr ( !__default_purge ) {
+      (void)now;
+      return 0;
+    } else {
+      __purge_last = now;
+      usize n = 0;
+      usize t;
+      n += t = _small.for_each([now](tlsf_sheet<__class_small> *v) -> usize { return v->purge(now); });
+      _small.__stats.add<tier_stat::purged>(t);
+      n += t = _medium.for_each([now](__page_sheet_t<__class_medium> *v) -> usize { return v->purge(now); });
+      _medium.__stats.add<tier_stat::purged>(t);
+      n += t = _large.for_each([now](__page_sheet_t<__class_large> *v) -> usize { return v->purge(now); });
+      _large.__stats.add<tier_stat::purged>(t);
+      n += t = _huge.for_each([now](sheet<__class_huge> *v) -> usize { return v->purge(now); });
+      _huge.__stats.add<tier_stat::purged>(t);
+      return n;
+    }
+  }
+
+  // rate limited: a pass only runs once a quarter of the decay time has gone by since the last one
+  [[gnu::cold]] usize
+  __maybe_purge(void) noexcept
+  {
+    const u64 now = __purge_now_ms();
+    if ( now - __purge_last < (__purge_decay_ms >> 2) ) return 0;
+    return __purge_pass(now);
+  }
+
+  [[gnu::always_inline]] inline void
+  __purge_tick(void) noexcept
+  {
+    if constexpr ( __default_purge ) {
+      if ( ++__purge_frees >= __purge_check_interval ) [[unlikely]] {
+        __purge_frees = 0;
+        (void)__maybe_purge();
+      }
+    }
   }
 
   class __struct_guard_t
@@ -1566,8 +2073,12 @@ public:
       __release_tier(_medium);
       __release_tier(_large);
       __release_tier(_huge);
+      _mapped.for_each_void([](map_sheet *const v) { v->release(); });
+      _mapped.release_directory();
       __release_tier(_arena_tier);
       _arena_memory.release();
+      __prof.release();
+      __remote.release();
       __debug_print("~__arena(): all buckets released", 0);
     }
   }
@@ -1585,27 +2096,25 @@ public:
     _medium.init();
     _large.init();
     _huge.init();
+    _mapped.init();
 
     constexpr bool __wants_prealloc = __default_eager_hot_tiers or !__default_lazy_construct;
     u64 prealloc_size = 0;
     if constexpr ( __wants_prealloc ) {
-      micron::sysinfo info;
-      const u64 totalram = static_cast<u64>(info.totalram) * static_cast<u64>(info.mem_unit ? info.mem_unit : 1u);
-      prealloc_size = micron::math::floor<u64>(static_cast<f32>(totalram) * __default_prealloc_factor);
-      __debug_print("__arena(): total system RAM: ", totalram);
-      __debug_print("__arena(): prealloc_factor target bytes: ", prealloc_size);
+      prealloc_size = __prealloc_draw();
+      __debug_print("__arena(): eager budget drawn: ", prealloc_size);
     }
     __debug_print("__arena(): arena metadata buf size: ", __default_arena_page_buf * __system_pagesize);
 
     __init_arena_tier(__default_arena_page_buf * __system_pagesize);
-    __init_tlsf<__class_precise>(_precise, __default_cache_size_factor * __class_precise);
+    __init_hot<__class_precise>(_precise, __default_cache_size_factor * __class_precise);
 
     if constexpr ( __default_eager_hot_tiers or !__default_lazy_construct ) {
       u64 share_small = __prealloc_share<__class_small>(prealloc_size);
       u64 share_medium = __prealloc_share<__class_medium>(prealloc_size);
       __debug_print("__arena(): prealloc share small: ", share_small);
       __debug_print("__arena(): prealloc share medium: ", share_medium);
-      __init_tlsf<__class_small>(_small, share_small);
+      __init_hot<__class_small>(_small, share_small);
       __init_buddy<__class_medium>(_medium, share_medium);
     }
 
@@ -1634,6 +2143,65 @@ public:
   __arena &operator=(const __arena &) = delete;
   __arena &operator=(__arena &&) = delete;
 
+  // one expansion ladder for every profile, keyed on the (inflated) request size
+  bool
+  __expand_for(const usize alloc_sz)
+  {
+    bool expanded = false;
+
+    if ( alloc_sz <= __class_precise ) {
+      usize __next_sz = __calculate_space_cache(__default_cache_step);
+      __debug_print("__expand_for(): precise/slab path, expanding by: ", __next_sz);
+      expanded = __buf_expand_exact(alloc_sz, __next_sz);
+    } else if ( alloc_sz < __class_medium ) {
+      // small tier
+      usize __next_sz = __calculate_space_small(alloc_sz) * __default_overcommit;
+      __predict += __next_sz;
+      usize predicted = __predict.predict_size(__next_sz);
+      __debug_print("__expand_for(): small path, next_sz: ", __next_sz);
+      __debug_print("__expand_for(): predictor suggested: ", predicted);
+      expanded = __buf_expand_exact(alloc_sz, predicted);
+    } else if ( alloc_sz <= __class_large ) {
+      // medium tier
+      usize __next_sz = __calculate_space_medium(alloc_sz) * __default_overcommit;
+      __predict += __next_sz;
+      usize predicted = __predict.predict_size(__next_sz);
+      __debug_print("__expand_for(): medium path, next_sz: ", __next_sz);
+      __debug_print("__expand_for(): predictor suggested: ", predicted);
+      expanded = __buf_expand_exact(alloc_sz, predicted);
+    } else if ( alloc_sz <= __class_huge ) {
+      // large tier; gets 2x medium now
+      usize __next_sz = __calculate_space_large(alloc_sz) * __default_overcommit;
+      __predict += __next_sz;
+      usize predicted = __predict.predict_size(__next_sz);
+      __debug_print("__expand_for(): large path, next_sz: ", __next_sz);
+      __debug_print("__expand_for(): predictor suggested: ", predicted);
+      expanded = __buf_expand_exact(alloc_sz, predicted);
+    } else if ( alloc_sz < __class_gb ) {
+      // huge tier; new growth fn, more aggressive low allocs with tapered high allocs
+      // now multivariate, grows more rapidly the more sheets are in use
+      usize __base = __calculate_space_huge(alloc_sz) * __default_overcommit;
+      usize __mult = (alloc_sz >= __class_1mb) ? 1ULL : (1ULL + static_cast<usize>(_huge.__count));
+      usize __next_sz = __base * __mult;
+      // WARNING: off-by-one safeguard; our buddy requires that the chunk to strictly exceed 2 * alloc_sz due to the tag table
+      usize __min_huge = (alloc_sz << 1) + __class_huge;
+      if ( __next_sz < __min_huge ) __next_sz = __min_huge;
+      __predict += __next_sz;
+      usize predicted = __predict.predict_size(__next_sz);
+      __debug_print("__expand_for(): huge path, next_sz: ", __next_sz);
+      __debug_print("__expand_for(): predictor suggested: ", predicted);
+      expanded = __buf_expand_exact(alloc_sz, predicted);
+    } else {
+      // bulk; same off-by-one safeguard
+      usize bulk = __calculate_space_bulk(alloc_sz);
+      usize __min_bulk = (alloc_sz << 1) + __class_huge;
+      if ( bulk < __min_bulk ) bulk = __min_bulk;
+      __debug_print("__expand_for(): bulk (>=gb) path, bulk_sz: ", bulk);
+      expanded = __buf_expand_exact(alloc_sz, bulk);
+    }
+    return expanded;
+  }
+
   hot_fn(micron::__chunk<byte>) push(const usize sz)
   {
     __debug_print("push(): requested size: ", sz);
@@ -1665,68 +2233,16 @@ public:
         sanitize_on_alloc(memory.ptr, memory.len);
         collect_stats<stat_type::total_memory_throughput>(memory.len);
         ABC_DOCTOR(doctor::record_alloc(memory.ptr, sz);)
+        __prof.on_alloc(memory.ptr, sz);
         return memory;
       }
       if ( i == __default_max_retries ) break;
 
       __debug_print("push(): alloc failed, retry: ", i);
       __debug_print("push(): expanding for alloc_sz: ", alloc_sz);
+      if constexpr ( __default_purge ) (void)__maybe_purge();
 
-      // one ladder for every profile
-      bool expanded = false;
-
-      if ( alloc_sz <= __class_small ) {
-        usize __next_sz = __calculate_space_cache(__default_cache_step);
-        __debug_print("push(): precise/small path, expanding by: ", __next_sz);
-        expanded = __buf_expand_exact(alloc_sz, __next_sz);
-      } else if ( alloc_sz < __class_medium ) {
-        // small tier
-        usize __next_sz = __calculate_space_small(alloc_sz) * __default_overcommit;
-        __predict += __next_sz;
-        usize predicted = __predict.predict_size(__next_sz);
-        __debug_print("push(): small path, next_sz: ", __next_sz);
-        __debug_print("push(): predictor suggested: ", predicted);
-        expanded = __buf_expand_exact(alloc_sz, predicted);
-      } else if ( alloc_sz <= __class_large ) {
-        // medium tier
-        usize __next_sz = __calculate_space_medium(alloc_sz) * __default_overcommit;
-        __predict += __next_sz;
-        usize predicted = __predict.predict_size(__next_sz);
-        __debug_print("push(): medium path, next_sz: ", __next_sz);
-        __debug_print("push(): predictor suggested: ", predicted);
-        expanded = __buf_expand_exact(alloc_sz, predicted);
-      } else if ( alloc_sz <= __class_huge ) {
-        // large tier; gets 2x medium now
-        usize __next_sz = __calculate_space_large(alloc_sz) * __default_overcommit;
-        __predict += __next_sz;
-        usize predicted = __predict.predict_size(__next_sz);
-        __debug_print("push(): large path, next_sz: ", __next_sz);
-        __debug_print("push(): predictor suggested: ", predicted);
-        expanded = __buf_expand_exact(alloc_sz, predicted);
-      } else if ( alloc_sz < __class_gb ) {
-        // huge tier; new growth fn, more aggressive low allocs with tapered high allocs
-        // now multivariate, grows more rapidly the more sheets are in use
-        usize __base = __calculate_space_huge(alloc_sz) * __default_overcommit;
-        usize __mult = (alloc_sz >= __class_1mb) ? 1ULL : (1ULL + static_cast<usize>(_huge.__count));
-        usize __next_sz = __base * __mult;
-        // WARNING: off-by-one safeguard; our buddy requires that the chunk to strictly exceed 2 * alloc_sz due to __hdr_offsets
-        usize __min_huge = (alloc_sz << 1) + __class_huge;
-        if ( __next_sz < __min_huge ) __next_sz = __min_huge;
-        __predict += __next_sz;
-        usize predicted = __predict.predict_size(__next_sz);
-        __debug_print("push(): huge path, next_sz: ", __next_sz);
-        __debug_print("push(): predictor suggested: ", predicted);
-        expanded = __buf_expand_exact(alloc_sz, predicted);
-      } else {
-        // bulk; same off-by-one safeguard
-        usize bulk = __calculate_space_bulk(alloc_sz);
-        usize __min_bulk = (alloc_sz << 1) + __class_huge;
-        if ( bulk < __min_bulk ) bulk = __min_bulk;
-        __debug_print("push(): bulk (>=gb) path, bulk_sz: ", bulk);
-        expanded = __buf_expand_exact(alloc_sz, bulk);
-      }
-
-      if ( !expanded ) [[unlikely]] {
+      if ( !__expand_for(alloc_sz) ) [[unlikely]] {
         __debug_print("push(): expansion failed (mmap OOM or tier full), giving up", 0);
         break;
       }
@@ -1736,6 +2252,109 @@ public:
     return { (byte *)-1, micron::numeric_limits<usize>::max() };
   }
 
+  // push() for calloc/salloc; zeroed reports that the block already reads as zero, so the caller can skip its memset.
+  // only blocks of __zero_elide_min and up are probed, and sanitize's fill pattern always rules it out
+  micron::__chunk<byte>
+  push(const usize sz, bool &zeroed)
+  {
+    if constexpr ( __default_zero_on_alloc ) {
+      zeroed = true;
+      return push(sz);
+    } else if constexpr ( !__default_zero_elide or __default_sanitize ) {
+      zeroed = false;
+      return push(sz);
+    } else {
+      if ( sz < __zero_elide_min ) {
+        zeroed = false;
+        return push(sz);
+      }
+      __zero_probe = true;
+      __zero_hint = nullptr;
+      micron::__chunk<byte> memory = push(sz);
+      __zero_probe = false;
+      zeroed = __zero_hint != nullptr and memory.ptr == __zero_hint;
+      return memory;
+    }
+  }
+
+  // al-aligned block of at least sz, a real block start that pop() frees like any other; al must be a power of two.
+  // alignments up to __block_align_min are plain push(), past __block_align_max there is nothing to serve them from
+  micron::__chunk<byte>
+  push_aligned(const usize sz, const usize al)
+  {
+    if ( al <= __block_align_min ) return push(sz);
+    if ( al > __block_align_max ) [[unlikely]]
+      return { nullptr, 0 };
+    __debug_print("push_aligned(): requested size: ", sz);
+    collect_stats<stat_type::alloc>();
+    collect_stats<stat_type::total_memory_req>(sz);
+
+    if ( check_constraint(sz) ) [[unlikely]]
+      abort_state();
+    if ( check_oom() ) [[unlikely]]
+      abort_state();
+
+    micron::__chunk<byte> memory;
+    usize cls = sz;
+    for ( u64 i = 0; i <= __default_max_retries; ++i ) {
+      if ( memory = __vmap_alloc_aligned(sz, al, cls); !memory.zero() ) [[likely]] {
+        // every kernel chunk is granule aligned, so this only fires for a sheet that broke its own alignment
+        if ( (reinterpret_cast<uintptr_t>(memory.ptr) & (al - 1)) != 0 ) [[unlikely]] {
+          __debug_print_addr("push_aligned()!!!: block off its alignment: ", memory.ptr);
+          (void)pop(memory.ptr);
+          return { nullptr, 0 };
+        }
+        zero_on_alloc(memory.ptr, memory.len);
+        sanitize_on_alloc(memory.ptr, memory.len);
+        collect_stats<stat_type::total_memory_throughput>(memory.len);
+        ABC_DOCTOR(doctor::record_alloc(memory.ptr, sz);)
+        __prof.on_alloc(memory.ptr, sz);
+        return memory;
+      }
+      if ( i == __default_max_retries ) break;
+      if constexpr ( __default_purge ) (void)__maybe_purge();
+      if ( !__expand_for(cls) ) [[unlikely]]
+        break;
+    }
+    __debug_print("push_aligned()!!!: all retries exhausted for size: ", sz);
+    return { nullptr, 0 };
+  }
+
+  // n blocks of sz in one pass: the tier is resolved and the limits checked once, sheets are carved back to back, and
+  // only what they can't cover goes through push()'s expansion ladder; returns how many of out[0..n) were filled
+  usize
+  push_batch(const usize sz, usize n, byte **out)
+  {
+    usize k = 0;
+    if constexpr ( !__default_redzone and !__default_launder ) {
+      const bool mapped = __default_direct_map and sz >= __direct_map_threshold;
+      if ( !mapped and n > 1 ) {
+        if ( check_constraint(sz) ) [[unlikely]]
+          abort_state();
+        if ( check_oom() ) [[unlikely]]
+          abort_state();
+        k = __vmap_alloc_n(sz, n, out);
+        for ( usize i = 0; i < k; ++i ) {
+          collect_stats<stat_type::alloc>();
+          collect_stats<stat_type::total_memory_req>(sz);
+          zero_on_alloc(out[i], sz);
+          sanitize_on_alloc(out[i], sz);
+          collect_stats<stat_type::total_memory_throughput>(sz);
+          ABC_DOCTOR(doctor::record_alloc(out[i], sz);)
+          __prof.on_alloc(out[i], sz);
+        }
+      }
+    }
+    // the rest (or everything, where each block needs its own treatment) one at a time
+    for ( ; k < n; ++k ) {
+      micron::__chunk<byte> m = push(sz);
+      if ( m.ptr == (byte *)-1 or m.zero() ) [[unlikely]]
+        break;
+      out[k] = m.ptr;
+    }
+    return k;
+  }
+
   micron::__chunk<byte>
   launder(const usize sz)
   {
@@ -1764,6 +2383,7 @@ public:
         sanitize_on_alloc(memory.ptr, memory.len);
         collect_stats<stat_type::total_memory_throughput>(memory.len);
         ABC_DOCTOR(doctor::record_alloc(memory.ptr, sz);)
+        __prof.on_alloc(memory.ptr, sz);
         return memory;
       }
       if ( i == __default_max_retries ) break;
@@ -1816,6 +2436,7 @@ public:
     collect_stats<stat_type::dealloc>();
     collect_stats<stat_type::total_memory_freed>(mem.len);
     __free_scrub(mem.ptr, mem.len);
+    __prof.on_free(mem.ptr);
     bool ok = __vmap_remove(mem);
     // record the free only after it succeeds
     ABC_DOCTOR(if ( ok ) doctor::record_free(mem.ptr, mem.len); else doctor::on_free_result(mem.ptr, false, __FILE__, __LINE__);)
@@ -1832,6 +2453,7 @@ public:
       return false;
     collect_stats<stat_type::dealloc>();
     __free_scrub(mem, 0);
+    __prof.on_free(mem);
     bool ok = __vmap_remove_at(mem);
     ABC_DOCTOR(if ( ok ) doctor::record_free(mem, 0); else doctor::on_free_result(mem, false, __FILE__, __LINE__);)
     __debug_print("pop() addr: removal result: ", (usize)ok);
@@ -1875,12 +2497,51 @@ public:
       return false;
     collect_stats<stat_type::total_memory_freed>(len);
     __free_scrub(mem, len);
+    __prof.on_free(mem);
     bool ok = __vmap_remove({ mem, len });
     ABC_DOCTOR(if ( ok ) doctor::record_free(mem, len); else doctor::on_free_result(mem, false, __FILE__, __LINE__);)
     __debug_print("pop(len): removal result: ", (usize)ok);
     return ok;
   }
 
+  // frees ptrs[0..n), nullptrs skipped: consecutive pointers inside one sheet (what push_batch hands out) share a
+  // single lookup and one round of sheet accounting; any order is correct, grouped input is just cheaper
+  usize
+  pop_batch(byte *const *ptrs, usize n)
+  {
+    usize freed = 0;
+    if constexpr ( __default_redzone ) {
+      // every block carries its own canaries to verify
+      for ( usize i = 0; i < n; ++i )
+        if ( ptrs[i] and pop(ptrs[i]) ) ++freed;
+      return freed;
+    }
+    usize i = 0;
+    while ( i < n ) {
+      byte *p = ptrs[i];
+      usize run = 1;
+      if ( p == nullptr ) {
+        ++i;
+        continue;
+      }
+      const bool ok = __dispatch_addr(reinterpret_cast<addr_t *>(p), [&]<typename TierT>(TierT &tier, i32 idx) {
+        addr_t *lo = tier.__at(idx).lo;
+        addr_t *hi = tier.__at(idx).hi;
+        while ( i + run < n ) {
+          addr_t *q = reinterpret_cast<addr_t *>(ptrs[i + run]);
+          if ( q < lo or q >= hi ) break;
+          ++run;
+        }
+        freed += __tier_remove_run(tier, idx, ptrs + i, run);
+        return true;
+      });
+      if ( !ok ) [[unlikely]]
+        __debug_print_addr("pop_batch(): WARNING address not found in any tier: ", p);
+      i += run;
+    }
+    return freed;
+  }
+
   bool
   ts_pop(const micron::__chunk<byte> &mem)
   {
@@ -1890,6 +2551,7 @@ public:
     collect_stats<stat_type::dealloc>();
     collect_stats<stat_type::total_memory_freed>(mem.len);
     __free_scrub(mem.ptr, mem.len);
+    __prof.on_free(mem.ptr);
     bool ok = __vmap_tombstone(mem);
     ABC_DOCTOR(if ( ok ) doctor::record_tombstone(mem.ptr, mem.len); else doctor::on_free_result(mem.ptr, false, __FILE__, __LINE__);)
     __debug_print("ts_pop(): tombstone result: ", (usize)ok);
@@ -1904,6 +2566,7 @@ public:
       return false;
     collect_stats<stat_type::dealloc>();
     __free_scrub(mem, 0);
+    __prof.on_free(mem);
     bool ok = __vmap_tombstone_at(mem);
     ABC_DOCTOR(if ( ok ) doctor::record_tombstone(mem, 0); else doctor::on_free_result(mem, false, __FILE__, __LINE__);)
     __debug_print("ts_pop() addr: tombstone result: ", (usize)ok);
@@ -1918,6 +2581,7 @@ public:
       return false;
     collect_stats<stat_type::total_memory_freed>(len);
     __free_scrub(mem, len);
+    __prof.on_free(mem);
     bool ok = __vmap_tombstone({ mem, len });
     ABC_DOCTOR(if ( ok ) doctor::record_tombstone(mem, len); else doctor::on_free_result(mem, false, __FILE__, __LINE__);)
     __debug_print("ts_pop(len): tombstone result: ", (usize)ok);
@@ -1955,15 +2619,17 @@ public:
     return __vmap_freeze({ mem, len });
   }
 
+  // committed bytes of the user tiers; a read of the per-tier gauges, no sheet walk
   usize
   total_usage(void) const
   {
     usize t = 0;
-    t += _precise.for_each([](tlsf_sheet<__class_precise> *const v) -> usize { return v->allocated(); });
-    t += _small.for_each([](tlsf_sheet<__class_small> *const v) -> usize { return v->allocated(); });
-    t += _medium.for_each([](sheet<__class_medium> *const v) -> usize { return v->allocated(); });
-    t += _large.for_each([](sheet<__class_large> *const v) -> usize { return v->allocated(); });
-    t += _huge.for_each([](sheet<__class_huge> *const v) -> usize { return v->allocated(); });
+    t += _precise.__stats.get(tier_stat::bytes_committed);
+    t += _small.__stats.get(tier_stat::bytes_committed);
+    t += _medium.__stats.get(tier_stat::bytes_committed);
+    t += _large.__stats.get(tier_stat::bytes_committed);
+    t += _huge.__stats.get(tier_stat::bytes_committed);
+    t += _mapped.__stats.get(tier_stat::bytes_committed);
     __debug_print("total_usage(): aggregate allocated bytes: ", t);
     return t;
   }
@@ -1973,18 +2639,49 @@ public:
   total_usage_of_class(void) const
   {
     if constexpr ( Sz == __class_precise )
-      return _precise.for_each([](tlsf_sheet<__class_precise> *const v) -> usize { return v->allocated(); });
+      return _precise.__stats.get(tier_stat::bytes_committed);
     else if constexpr ( Sz == __class_small )
-      return _small.for_each([](tlsf_sheet<__class_small> *const v) -> usize { return v->allocated(); });
+      return _small.__stats.get(tier_stat::bytes_committed);
     else if constexpr ( Sz == __class_medium )
-      return _medium.for_each([](sheet<__class_medium> *const v) -> usize { return v->allocated(); });
+      return _medium.__stats.get(tier_stat::bytes_committed);
     else if constexpr ( Sz == __class_large )
-      return _large.for_each([](sheet<__class_large> *const v) -> usize { return v->allocated(); });
+      return _large.__stats.get(tier_stat::bytes_committed);
     else if constexpr ( Sz == __class_huge )
-      return _huge.for_each([](sheet<__class_huge> *const v) -> usize { return v->allocated(); });
+      return _huge.__stats.get(tier_stat::bytes_committed);
     return 0;
   }
 
+  // adds this arena's shard into s (stats.hpp); relaxed reads, safe while the owner keeps running
+  void
+  stats_into(stats_t &s) const
+  {
+    __stats_add_arena(s, __counters);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::precise)], _precise.__stats);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::small)], _small.__stats);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::medium)], _medium.__stats);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::large)], _large.__stats);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::huge)], _huge.__stats);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::mapped)], _mapped.__stats);
+    __stats_add_tier(s.tiers[static_cast<usize>(stat_tier::metadata)], _arena_tier.__stats);
+    __remote.stats_into(s.remote_drain);
+  }
+
+  stats_t
+  stats(void) const
+  {
+    stats_t s = {};
+    stats_into(s);
+    __stats_finish(s);
+    return s;
+  }
+
+  // this arena's sampled heap profile; readable from any thread (heap_profile.hpp)
+  const __heap_sampler &
+  heap_profile(void) const noexcept
+  {
+    return __prof;
+  }
+
   void
   reset_page(byte *ptr)
   {
@@ -1996,15 +2693,19 @@ public:
     }
     auto __g = __struct_guard();
     __debug_print_addr("reset_page(): resetting sheet containing: ", ptr);
-    // binary search each tier for the sheet whose range covers the address
+    // ask each tier for the sheet whose range covers the address
     addr_t *addr = reinterpret_cast<addr_t *>(ptr);
     auto do_reset = [&](auto &tier) {
       i32 idx = tier.find_range(addr);
       if ( idx >= 0 ) {
         // drop any cached blocks belonging to this sheet first
-        tier.__cache.invalidate_range(reinterpret_cast<const byte *>(tier.__idx[idx].lo),
-                                      reinterpret_cast<const byte *>(tier.__idx[idx].hi));
-        tier.__idx[idx].nd->nd->reset();
+        tier.__cache.invalidate_range(reinterpret_cast<const byte *>(tier.__at(idx).lo),
+                                      reinterpret_cast<const byte *>(tier.__at(idx).hi));
+        __prof.forget_range(reinterpret_cast<const byte *>(tier.__at(idx).lo), reinterpret_cast<const byte *>(tier.__at(idx).hi));
+        auto &sh = *tier.__at(idx).nd->nd;
+        const usize u0 = __stat_used(sh);
+        sh.reset();
+        tier.__stats.template add<tier_stat::bytes_live>(__stat_used(sh) - u0);
       }
     };
     do_reset(_precise);
@@ -2034,10 +2735,32 @@ public:
       // caller may now legally write, so re-lay it at the new bound. new_sz <= old_size ==
       // bs - hdr - 2 * rz guarantees ptr + new_sz + rz <= block end
       if constexpr ( __default_redzone ) {
-        if ( _precise.find_range(reinterpret_cast<addr_t *>(ptr)) >= 0 or _small.find_range(reinterpret_cast<addr_t *>(ptr)) >= 0 )
-          write_redzone(ptr, new_sz);
+        if ( __in_redzoned_tier(reinterpret_cast<addr_t *>(ptr)) ) write_redzone(ptr, new_sz);
       }
       ABC_DOCTOR(doctor::record_realloc(ptr, new_sz);)
+      __prof.on_resize(ptr, ptr, new_sz);
+      return ptr;
+    }
+    // dedicated mappings move page tables, never bytes
+    if ( new_sz >= __direct_map_threshold ) {
+      if ( byte *moved = __map_resize(ptr, new_sz); moved ) {
+        ABC_DOCTOR(if ( moved == ptr ) doctor::record_realloc(ptr, new_sz); else {
+          doctor::record_free(ptr, 0);
+          doctor::record_alloc(moved, new_sz);
+        })
+        __prof.on_resize(ptr, moved, new_sz);
+        return moved;
+      }
+    }
+    // in-place growth, absorbing the free physical successor
+    if ( new_sz > old_size and __grow_in_place(ptr, new_sz) ) {
+      if constexpr ( __default_redzone ) {
+        if ( __in_redzoned_tier(reinterpret_cast<addr_t *>(ptr)) ) write_redzone(ptr, new_sz);
+      }
+      zero_on_alloc(ptr + old_size, new_sz - old_size);
+      sanitize_on_alloc(ptr + old_size, new_sz - old_size);
+      ABC_DOCTOR(doctor::record_realloc(ptr, new_sz);)
+      __prof.on_resize(ptr, ptr, new_sz);
       return ptr;
     }
 
@@ -2051,6 +2774,39 @@ public:
     return fresh.ptr;
   }
 
+  // grow a live block without moving it; false if the block's tier can't grow in place or its
+  // neighbours aren't free. tlsf blocks absorb their physical successor, buddy blocks are promoted
+  // over their free right buddies. with redzones a tlsf block must stay redzoned. bytes_live takes
+  // the growth, the free of the grown block later takes it all back
+  bool
+  __grow_in_place(byte *ptr, usize new_sz)
+  {
+    bool grown = false;
+    (void)__dispatch_addr(reinterpret_cast<addr_t *>(ptr), [&]<typename TierT>([[maybe_unused]] TierT &tier, [[maybe_unused]] i32 idx) {
+      if constexpr ( TierT::__redzoned and !TierT::sheet_t::__exact_classes ) {
+        byte *blk = ptr;
+        if constexpr ( __default_redzone ) {
+          if ( !__rz_active(new_sz) ) return true;
+          blk -= static_cast<usize>(__default_redzone_size);
+        }
+        auto &sh = *tier.__at(idx).nd->nd;
+        const usize u0 = __stat_used(sh);
+        grown = !sh.try_grow(blk, __rz_inflate(new_sz)).zero();
+        tier.__stats.template add<tier_stat::bytes_live>(__stat_used(sh) - u0);
+      } else if constexpr ( !TierT::__redzoned ) {
+        // stay inside the tier's routing band, the per-class cache expects like-sized blocks
+        constexpr usize class_sz = TierT::sheet_t::__size_class;
+        if ( (class_sz == __class_medium and new_sz > __class_large) or (class_sz == __class_large and new_sz > __class_huge) ) return true;
+        auto &sh = *tier.__at(idx).nd->nd;
+        const usize u0 = __stat_used(sh);
+        grown = !sh.try_grow(ptr, new_sz).zero();
+        tier.__stats.template add<tier_stat::bytes_live>(__stat_used(sh) - u0);
+      }
+      return true;
+    });
+    return grown;
+  }
+
   static inline bool
   __is_sentinel_chunk(const micron::__chunk<byte> &c) noexcept
   {
@@ -2060,55 +2816,37 @@ public:
   usize
   __size_of_alloc(addr_t *addr) const
   {
-    i32 idx;
-
-    // tlsf classes: block header at ptr - __hdr_offset, first u32 is bsize
-    // with redzones: user ptr is shifted by __default_redzone_size from the
-    // TLSF return pointer, so the header is at ptr - rz_size - __hdr_offset
-    {
-      byte *tlsf_user = reinterpret_cast<byte *>(addr);
-      usize tlsf_overhead = __hdr_offset;
-      if constexpr ( __default_redzone ) {
-        tlsf_user -= static_cast<usize>(__default_redzone_size);
-        tlsf_overhead = __hdr_offset + 2 * static_cast<usize>(__default_redzone_size);
-      }
-      if ( (idx = _precise.find_range(addr)) >= 0 ) {
-        const usize bs = _precise.__idx[idx].nd->nd->block_size_of(tlsf_user);
-        const usize recovered = (bs > tlsf_overhead) ? bs - tlsf_overhead : 0;
-        __debug_print("__size_of_alloc(): precise tlsf user size: ", recovered);
-        return recovered;
-      }
-      if ( (idx = _small.find_range(addr)) >= 0 ) {
-        const usize bs = _small.__idx[idx].nd->nd->block_size_of(tlsf_user);
-        const usize recovered = (bs > tlsf_overhead) ? bs - tlsf_overhead : 0;
-        __debug_print("__size_of_alloc(): small tlsf user size: ", recovered);
-        return recovered;
+    usize recovered = 0;
+    bool found = __dispatch_addr(addr, [&]<typename TierT>(const TierT &tier, i32 idx) {
+      const auto &sh = *tier.__at(idx).nd->nd;
+      if constexpr ( TierT::__redzoned ) {
+        // tlsf classes: block header at ptr - __hdr_offset, first u32 is bsize
+        // slab classes: headerless, the object size is the run's class
+        // with redzones: user ptr is shifted by __default_redzone_size from the
+        // block pointer, so the block sits at ptr - rz_size
+        byte *hot_user = reinterpret_cast<byte *>(addr);
+        usize hot_overhead = TierT::sheet_t::__block_overhead;
+        if constexpr ( __default_redzone ) {
+          hot_user -= static_cast<usize>(__default_redzone_size);
+          hot_overhead += 2 * static_cast<usize>(__default_redzone_size);
+        }
+        const usize bs = sh.block_size_of(hot_user);
+        recovered = (bs > hot_overhead) ? bs - hot_overhead : 0;
+        __debug_print("__size_of_alloc(): hot tier user size: ", recovered);
+      } else {
+        // buddy classes: the AUTHORITATIVE order lives in the buddy's block_tags
+        // (one tag per min-block, rewritten on every (de)allocation, split and merge)
+        // mapped blocks: headerless, the whole mapping is usable
+        constexpr usize ovh = TierT::sheet_t::__block_overhead;
+        const usize bs = sh.block_size_of(reinterpret_cast<byte *>(addr));
+        recovered = (bs > ovh) ? bs - ovh : 0;
+        __debug_print("__size_of_alloc(): buddy user size: ", recovered);
       }
-    }
-
-    // buddy classes: the AUTHORITATIVE order lives in the buddy's block_tags
-    // (one tag per min-block, rewritten on every (de)allocation, split and merge)
-    if ( (idx = _medium.find_range(addr)) >= 0 ) {
-      const usize bs = _medium.__idx[idx].nd->nd->block_size_of(reinterpret_cast<byte *>(addr));
-      const usize recovered = (bs > __hdr_offset) ? bs - __hdr_offset : 0;
-      __debug_print("__size_of_alloc(): medium buddy user size: ", recovered);
-      return recovered;
-    }
-    if ( (idx = _large.find_range(addr)) >= 0 ) {
-      const usize bs = _large.__idx[idx].nd->nd->block_size_of(reinterpret_cast<byte *>(addr));
-      const usize recovered = (bs > __hdr_offset) ? bs - __hdr_offset : 0;
-      __debug_print("__size_of_alloc(): large buddy user size: ", recovered);
-      return recovered;
-    }
-    if ( (idx = _huge.find_range(addr)) >= 0 ) {
-      const usize bs = _huge.__idx[idx].nd->nd->block_size_of(reinterpret_cast<byte *>(addr));
-      const usize recovered = (bs > __hdr_offset) ? bs - __hdr_offset : 0;
-      __debug_print("__size_of_alloc(): huge buddy user size: ", recovered);
-      return recovered;
-    }
-
-    __debug_print_addr("__size_of_alloc(): WARNING addr not found in any bucket: ", addr);
-    return 0;
+      return true;
+    });
+    if ( !found ) [[unlikely]]
+      __debug_print_addr("__size_of_alloc(): WARNING addr not found in any bucket: ", addr);
+    return recovered;
   }
 
 #if defined(ABCMALLOC_DOCTOR_HELP)
@@ -2116,12 +2854,12 @@ public:
   int
   __doctor_tier_kind(addr_t *addr) const
   {
-    if ( _precise.find_range(addr) >= 0 ) return 1;
-    if ( _small.find_range(addr) >= 0 ) return 1;
-    if ( _medium.find_range(addr) >= 0 ) return 2;
-    if ( _large.find_range(addr) >= 0 ) return 2;
-    if ( _huge.find_range(addr) >= 0 ) return 2;
-    return 0;
+    int kind = 0;
+    (void)__dispatch_addr(addr, [&]<typename TierT>(const TierT &, i32) {
+      kind = TierT::__bind_tag == __sheet_tier_mapped ? 4 : TierT::sheet_t::__exact_classes ? 3 : TierT::__redzoned ? 1 : 2;
+      return true;
+    });
+    return kind;
   }
 
   // structural health check of one tier's sheet index
@@ -2129,15 +2867,19 @@ public:
   void
   __doctor_check_tier(const Tier &t, Ctx &ctx) const
   {
-    for ( u32 i = 0; i < t.__count; ++i ) {
+    u32 live = 0;
+    for ( u32 i = 0; i < t.__slots; ++i ) {
+      if ( t.__at(i).nd == nullptr ) continue;      // free slot
       ++ctx.sheets;
-      addr_t *lo = t.__idx[i].lo;
-      addr_t *hi = t.__idx[i].hi;
-      if ( !(lo < hi) ) ctx.note("tier __idx: lo >= hi (degenerate range)", lo);
-      if ( i + 1 < t.__count && !(hi <= t.__idx[i + 1].lo) ) ctx.note("tier __idx: overlap / mis-order", hi);
-      auto *sh = t.__idx[i].nd->nd;
-      if ( sh->addr() != lo ) ctx.note("sheet base != __idx.lo", lo);
-      if ( sh->addr_end() != hi ) ctx.note("sheet end != __idx.hi", hi);
+      ++live;
+      addr_t *lo = t.__at(i).lo;
+      addr_t *hi = t.__at(i).hi;
+      if ( !(lo < hi) ) ctx.note("tier directory: lo >= hi (degenerate range)", lo);
+      if ( t.__at(i).nd->pos != i ) ctx.note("tier directory: node slot out of step", lo);
+      if ( t.find_range(lo) != static_cast<i32>(i) ) ctx.note("tier directory: sheet base does not resolve to its slot", lo);
+      auto *sh = t.__at(i).nd->nd;
+      if ( sh->addr() != lo ) ctx.note("sheet base != directory lo", lo);
+      if ( sh->addr_end() != hi ) ctx.note("sheet end != directory hi", hi);
       // a sheet spans multiple owner-table granules, checking only lo can miss interior corruption
       for ( uintptr_t a = reinterpret_cast<uintptr_t>(lo), e = reinterpret_cast<uintptr_t>(hi); a < e; a += __sheet_align )
         if ( __owner_of(reinterpret_cast<const void *>(a)) != this ) {
@@ -2145,6 +2887,7 @@ public:
           break;
         }
     }
+    if ( live != t.__count ) ctx.note("tier directory: live sheet count out of step", &t);
   }
 
   template<class Ctx>
@@ -2157,13 +2900,15 @@ public:
     __doctor_check_tier(_medium, ctx);
     __doctor_check_tier(_large, ctx);
     __doctor_check_tier(_huge, ctx);
+    __doctor_check_tier(_mapped, ctx);
   }
 
   template<class Tier, class V>
   void
   __doctor_walk_tier(Tier &t, V &v)
   {
-    for ( u32 i = 0; i < t.__count; ++i ) t.__idx[i].nd->nd->__doctor_walk(v);
+    for ( u32 i = 0; i < t.__slots; ++i )
+      if ( t.__at(i).nd != nullptr ) t.__at(i).nd->nd->__doctor_walk(v);
   }
 
   template<class V>
@@ -2175,6 +2920,7 @@ public:
     __doctor_walk_tier(_medium, v);
     __doctor_walk_tier(_large, v);
     __doctor_walk_tier(_huge, v);
+    __doctor_walk_tier(_mapped, v);
   }
 #endif
 
@@ -0,0 +1,54 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include <micron/types.hpp>
+
+// frame-pointer stack walk, shared by doctor mode and the sampled heap profiler. relies on frame pointers being kept
+// (-fno-omit-frame-pointer); a frame that doesn't look like one ends the walk instead of faulting
+namespace abc
+{
+
+// return addresses of the caller's frames, innermost first; always inlined so the first entry is the caller's caller
+[[gnu::always_inline]] inline usize
+__walk_frames(void **out, usize maxn) noexcept
+{
+  usize n = 0;
+  void **fp = reinterpret_cast<void **>(__builtin_frame_address(0));
+  const uintptr_t lo = reinterpret_cast<uintptr_t>(fp);
+  const uintptr_t hi = lo + (16u << 20);      // 16 MB window above the current frame
+  usize guard = 0;
+  while ( fp && n < maxn && guard++ < 128 ) {
+    const uintptr_t a = reinterpret_cast<uintptr_t>(fp);
+    if ( a < lo || a >= hi || (a & (sizeof(void *) - 1)) ) break;      // not a plausible frame pointer
+    void *ret = fp[1];
+    void **next = reinterpret_cast<void **>(fp[0]);
+    if ( !ret ) break;
+    out[n++] = ret;
+    if ( reinterpret_cast<uintptr_t>(next) <= a ) break;      // fp chain must strictly ascend
+    fp = next;
+  }
+  return n;
+}
+
+};      // namespace abc
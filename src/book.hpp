@@ -29,7 +29,9 @@
 #include "config.hpp"
 #include "free_list.hpp"
 #include "hooks.hpp"
+#include "run_list.hpp"
 #include "sheet_header.hpp"
+#include "slab_list.hpp"
 
 namespace abc
 {
@@ -39,6 +41,8 @@ template<u64 Sz> class sheet
 {
 public:
   constexpr static const u64 __size_class = Sz;      // needed for tomb_for<> dispatch
+  constexpr static const usize __block_overhead = 0;      // order and state live in the buddy's tag table
+  constexpr static const bool __exact_classes = false;
 private:
   using stack_page_list = __buddy_list<micron::__chunk<byte>, __size_class, 64>;
   micron::__chunk<byte> __kernel_memory;
@@ -52,7 +56,7 @@ private:
   {
     if ( !__kernel_memory.zero() ) {
       __sheet_unregister(__kernel_memory.ptr, __kernel_memory.len);
-      __release_kernel_chunk(__kernel_memory);
+      __release_kernel_chunk(__kernel_memory, __guard_offset);
       __kernel_memory.ptr = nullptr;
       __kernel_memory.len = 0;
     }
@@ -155,6 +159,13 @@ public:
     return _p;
   }
 
+  // the block the last mark handed out came from never-used memory and still reads as zero (calloc/salloc elision)
+  bool
+  known_zero(const byte *ptr) const noexcept
+  {
+    return __book.known_zero(ptr);
+  }
+
   // request to deallocate mem of sz
   bool
   try_unmark(micron::__chunk<byte> _p)
@@ -213,6 +224,22 @@ public:
     return __book.block_size(ptr);
   }
 
+  // grow a live block in place over its free right buddies; {nullptr, 0} if it can't
+  micron::__chunk<byte>
+  try_grow(byte *ptr, usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    return __book.grow_in_place(ptr, mem_sz);
+  }
+
+  // decay purge over the free runs; bytes advised this pass
+  usize
+  purge(u64 now)
+  {
+    if ( empty() ) return 0;
+    return __book.purge(now, __purge_grain_for<Sz>());
+  }
+
   // true iff ptr is a live (allocated, in-range) block start
   bool
   is_block_allocated(byte *ptr) const
@@ -308,58 +335,62 @@ make_sheet(__arena *owner, usize req_size)
   return sheet<Sz>(owner, __get_kernel_chunk<micron::__chunk<byte>>(req_size));
 }
 
-// tslf cache sheets
-// implemented to alleviate pressures for small allocations
+// page-run sheets
+// back the medium and large classes (__default_page_runs): blocks are whole pages, sized to the request rather than
+// to a power of two, with every run's length and state kept in the sheet's side table
 
-template<u64 Sz> class tlsf_sheet
+template<u64 Sz> class run_sheet
 {
 public:
   constexpr static const u64 __size_class = Sz;      // exposed for tomb_for<> dispatch
+  constexpr static const usize __block_overhead = 0;      // length and state live in the run tags
+  constexpr static const bool __exact_classes = false;
 private:
-  using stack_page_list = __tlsf_list<micron::__chunk<byte>, __size_class, 64>;
+  using stack_page_list = __run_list<micron::__chunk<byte>>;
   micron::__chunk<byte> __kernel_memory;
   stack_page_list __book;
   usize __guard_offset;
 
   inline __attribute__((always_inline)) void
-  __impl_release(void)
+  __impl_release(void) noexcept
   {
     if ( !__kernel_memory.zero() ) {
       __sheet_unregister(__kernel_memory.ptr, __kernel_memory.len);
-      __release_kernel_chunk(__kernel_memory);
+      __release_kernel_chunk(__kernel_memory, __guard_offset);
       __kernel_memory.ptr = nullptr;
       __kernel_memory.len = 0;
     }
   }
 
 public:
-  ~tlsf_sheet() { __impl_release(); };
+  ~run_sheet() noexcept { __impl_release(); };
 
-  tlsf_sheet(void) = delete;
+  run_sheet(void) = delete;
 
-  tlsf_sheet(__arena *owner, const micron::__chunk<byte> &mem) : __kernel_memory(mem), __book(mem), __guard_offset(0)
+  run_sheet(__arena *owner, const micron::__chunk<byte> &mem) : __kernel_memory(mem), __book(mem), __guard_offset(0)
   {
     __sheet_register(owner, mem.ptr, mem.len);
   }
 
-  tlsf_sheet(__arena *owner, const micron::__chunk<byte> &mem, usize offset)
+  // for guard pages
+  run_sheet(__arena *owner, const micron::__chunk<byte> &mem, usize offset)
       : __kernel_memory(mem), __book(micron::__chunk<byte>{ mem.ptr, mem.len - offset }), __guard_offset(offset)
   {
     __sheet_register(owner, mem.ptr, mem.len);
   }
 
-  tlsf_sheet(const tlsf_sheet &) = delete;
+  run_sheet(const run_sheet &) = delete;
 
-  tlsf_sheet(tlsf_sheet &&o)
+  run_sheet(run_sheet &&o)
       : __kernel_memory(micron::move(o.__kernel_memory)), __book(micron::move(o.__book)), __guard_offset(o.__guard_offset)
   {
     o.__guard_offset = 0;
   }
 
-  tlsf_sheet &operator=(const tlsf_sheet &) = delete;
+  run_sheet &operator=(const run_sheet &) = delete;
 
-  tlsf_sheet &
-  operator=(tlsf_sheet &&o)
+  run_sheet &
+  operator=(run_sheet &&o)
   {
     __kernel_memory = micron::move(o.__kernel_memory);
     __book = micron::move(o.__book);
@@ -371,14 +402,18 @@ public:
   bool
   freeze(void)
   {
-    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, micron::prot_read) != 0 ) return false;
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, micron::prot_read) != 0 ) {
+      return false;
+    }
     return true;
   }
 
   bool
   freeze(int prot)
   {
-    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, prot) != 0 ) return false;
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, prot) != 0 ) {
+      return false;
+    }
     return true;
   }
 
@@ -394,6 +429,7 @@ public:
     return __kernel_memory.zero();
   }
 
+  // request to allocate mem of sz, fail silently (return nullptr)
   micron::__chunk<byte>
   mark(usize mem_sz)
   {
@@ -403,6 +439,7 @@ public:
     return _p;
   }
 
+  // allows marking at existing location
   micron::__chunk<byte>
   temporal_mark(usize mem_sz)
   {
@@ -412,15 +449,35 @@ public:
     return _p;
   }
 
+  // page run on an al boundary (al past the page size); the slack in front of it stays free
+  micron::__chunk<byte>
+  mark_aligned(usize mem_sz, usize al)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    micron::__chunk<byte> _p = __book.allocate_aligned(mem_sz, al);
+    if ( _p.zero() or _p.invalid() ) return { nullptr, 0 };
+    return _p;
+  }
+
+  // request to allocate mem of sz, fail loudly, force quote
   micron::__chunk<byte>
   try_mark(usize mem_sz)
   {
     if ( empty() ) micron::abort();
     micron::__chunk<byte> _p = __book.allocate(mem_sz);
+
     if ( _p.zero() or _p.invalid() ) return { micron::numeric_limits<byte *>::max(), 0xFF };
     return _p;
   }
 
+  // the block the last mark handed out came from never-used memory and still reads as zero (calloc/salloc elision)
+  bool
+  known_zero(const byte *ptr) const noexcept
+  {
+    return __book.known_zero(ptr);
+  }
+
+  // request to deallocate mem of sz
   bool
   try_unmark(micron::__chunk<byte> _p)
   {
@@ -443,13 +500,13 @@ public:
     return true;
   }
 
+  // the run tags vouch for the start, so a stale or interior pointer is reported instead of ignored
   bool
   try_unmark_no_size(byte *_p)
   {
     if ( empty() ) micron::abort();
     if ( _p == nullptr ) micron::abort();
-    __book.deallocate(_p);
-    return true;
+    return __book.deallocate(_p) == __flag_ok;
   }
 
   bool
@@ -457,8 +514,7 @@ public:
   {
     if ( empty() ) micron::abort();
     if ( _p == nullptr ) micron::abort();
-    __book.tombstone(_p);
-    return true;
+    return __book.tombstone(_p) == __flag_tombstoned;
   }
 
   bool
@@ -466,22 +522,61 @@ public:
   {
     if ( _p == nullptr ) return false;
     if ( empty() ) micron::abort();
-    if ( _p == nullptr ) micron::abort();
     return __book.is_allocated(_p) && !__book.is_tombstoned(_p);
   }
 
+  // run-tag read used by the per-class free cache
+  usize
+  block_size_of(byte *ptr) const
+  {
+    return __book.block_size(ptr);
+  }
+
+  // grow a live run in place over the free run after it; {nullptr, 0} if it can't
+  micron::__chunk<byte>
+  try_grow(byte *ptr, usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    return __book.grow_in_place(ptr, mem_sz);
+  }
+
+  // decay purge over the free runs; bytes advised this pass
+  usize
+  purge(u64 now)
+  {
+    if ( empty() ) return 0;
+    return __book.purge(now, __purge_grain_for<Sz>());
+  }
+
+  // true iff ptr is a live (allocated, in-range) block start
+  bool
+  is_block_allocated(byte *ptr) const
+  {
+    // and !ts
+    return __book.is_allocated(ptr) && !__book.is_tombstoned(ptr);
+  }
+
+  bool
+  is_temporal_block(byte *ptr)
+  {
+    return __book.is_temporal(ptr);
+  }
+
   usize
   available() const
   {
-    return empty() ? 0 : __book.available();
+    if ( empty() ) return 0;
+    return __book.available();
   }
 
   usize
   total() const
   {
-    return empty() ? 0 : __book.__total();
+    if ( empty() ) return 0;
+    return __book.__total();
   }
 
+  // to be used in loops where sheet is always allocd
   usize
   ftotal() const
   {
@@ -506,26 +601,6 @@ public:
     return __kernel_memory.len - __guard_offset;
   }
 
-  usize
-  block_size_of(byte *ptr) const
-  {
-    return __book.block_size(ptr);
-  }
-
-  // true iff ptr is a live (allocated, in-range) block start
-  bool
-  is_block_allocated(byte *ptr) const
-  {
-    // and !ts
-    return __book.is_allocated(ptr) && !__book.is_tombstoned(ptr);
-  }
-
-  bool
-  is_temporal_block(byte *ptr)
-  {
-    return __book.is_temporal(ptr);
-  }
-
   addr_t *
   addr() const
   {
@@ -562,10 +637,877 @@ public:
 };
 
 template<u64 Sz>
-tlsf_sheet<Sz>
-make_tlsf_sheet(__arena *owner, usize req_size)
+run_sheet<Sz>
+make_run_sheet(__arena *owner, usize req_size)
 {
-  return tlsf_sheet<Sz>(owner, __get_kernel_chunk<micron::__chunk<byte>>(req_size));
+  return run_sheet<Sz>(owner, __get_kernel_chunk<micron::__chunk<byte>>(req_size));
 }
 
+// the sheet backing a page-granular tier, picked by __default_page_runs
+template<bool Runs, u64 Sz> struct __page_sheet_select {
+  using type = sheet<Sz>;
+};
+
+template<u64 Sz> struct __page_sheet_select<true, Sz> {
+  using type = run_sheet<Sz>;
+};
+
+template<u64 Sz> using __page_sheet_t = typename __page_sheet_select<__default_page_runs, Sz>::type;
+
+// tslf cache sheets
+// implemented to alleviate pressures for small allocations
+
+template<u64 Sz> class tlsf_sheet
+{
+public:
+  constexpr static const u64 __size_class = Sz;      // exposed for tomb_for<> dispatch
+  constexpr static const usize __block_overhead = __hdr_offset;      // leading tlsf_hdr
+  constexpr static const bool __exact_classes = false;
+private:
+  using stack_page_list = __tlsf_list<micron::__chunk<byte>, __size_class, 64>;
+  micron::__chunk<byte> __kernel_memory;
+  stack_page_list __book;
+  usize __guard_offset;
+
+  inline __attribute__((always_inline)) void
+  __impl_release(void)
+  {
+    if ( !__kernel_memory.zero() ) {
+      __sheet_unregister(__kernel_memory.ptr, __kernel_memory.len);
+      __release_kernel_chunk(__kernel_memory, __guard_offset);
+      __kernel_memory.ptr = nullptr;
+      __kernel_memory.len = 0;
+    }
+  }
+
+public:
+  ~tlsf_sheet() { __impl_release(); };
+
+  tlsf_sheet(void) = delete;
+
+  tlsf_sheet(__arena *owner, const micron::__chunk<byte> &mem) : __kernel_memory(mem), __book(mem), __guard_offset(0)
+  {
+    __sheet_register(owner, mem.ptr, mem.len);
+  }
+
+  tlsf_sheet(__arena *owner, const micron::__chunk<byte> &mem, usize offset)
+      : __kernel_memory(mem), __book(micron::__chunk<byte>{ mem.ptr, mem.len - offset }), __guard_offset(offset)
+  {
+    __sheet_register(owner, mem.ptr, mem.len);
+  }
+
+  tlsf_sheet(const tlsf_sheet &) = delete;
+
+  tlsf_sheet(tlsf_sheet &&o)
+      : __kernel_memory(micron::move(o.__kernel_memory)), __book(micron::move(o.__book)), __guard_offset(o.__guard_offset)
+  {
+    o.__guard_offset = 0;
+  }
+
+  tlsf_sheet &operator=(const tlsf_sheet &) = delete;
+
+  tlsf_sheet &
+  operator=(tlsf_sheet &&o)
+  {
+    __kernel_memory = micron::move(o.__kernel_memory);
+    __book = micron::move(o.__book);
+    __guard_offset = o.__guard_offset;
+    o.__guard_offset = 0;
+    return *this;
+  }
+
+  bool
+  freeze(void)
+  {
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, micron::prot_read) != 0 ) return false;
+    return true;
+  }
+
+  bool
+  freeze(int prot)
+  {
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, prot) != 0 ) return false;
+    return true;
+  }
+
+  void
+  release(void)
+  {
+    __impl_release();
+  }
+
+  bool
+  empty(void) const noexcept
+  {
+    return __kernel_memory.zero();
+  }
+
+  micron::__chunk<byte>
+  mark(usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    micron::__chunk<byte> _p = __book.allocate(mem_sz);
+    if ( _p.zero() or _p.invalid() ) return { nullptr, 0 };
+    return _p;
+  }
+
+  micron::__chunk<byte>
+  temporal_mark(usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    micron::__chunk<byte> _p = __book.temporal_allocate(mem_sz);
+    if ( _p.zero() or _p.invalid() ) return { nullptr, 0 };
+    return _p;
+  }
+
+  // user pointer on an al boundary; al is a power of two > __hdr_offset
+  micron::__chunk<byte>
+  mark_aligned(usize mem_sz, usize al)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    micron::__chunk<byte> _p = __book.allocate_aligned(mem_sz, al);
+    if ( _p.zero() or _p.invalid() ) return { nullptr, 0 };
+    return _p;
+  }
+
+  micron::__chunk<byte>
+  try_mark(usize mem_sz)
+  {
+    if ( empty() ) micron::abort();
+    micron::__chunk<byte> _p = __book.allocate(mem_sz);
+    if ( _p.zero() or _p.invalid() ) return { micron::numeric_limits<byte *>::max(), 0xFF };
+    return _p;
+  }
+
+  // blocks here stay under __zero_elide_min, calloc always clears them
+  bool
+  known_zero(const byte *) const noexcept
+  {
+    return false;
+  }
+
+  bool
+  try_unmark(micron::__chunk<byte> _p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p.zero() ) micron::abort();
+    auto r = __book.deallocate(_p);
+    if ( r == __flag_out_of_space ) return false;
+    if ( r == __flag_invalid or r == __flag_failure ) return false;
+    return true;
+  }
+
+  bool
+  try_tombstone(micron::__chunk<byte> _p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p.zero() ) micron::abort();
+    auto r = __book.tombstone(_p);
+    if ( r == __flag_out_of_space ) return false;
+    if ( r == __flag_invalid or r == __flag_failure ) return false;
+    return true;
+  }
+
+  bool
+  try_unmark_no_size(byte *_p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p == nullptr ) micron::abort();
+    __book.deallocate(_p);
+    return true;
+  }
+
+  bool
+  try_tombstone_no_size(byte *_p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p == nullptr ) micron::abort();
+    __book.tombstone(_p);
+    return true;
+  }
+
+  bool
+  find(byte *_p)
+  {
+    if ( _p == nullptr ) return false;
+    if ( empty() ) micron::abort();
+    if ( _p == nullptr ) micron::abort();
+    return __book.is_allocated(_p) && !__book.is_tombstoned(_p);
+  }
+
+  usize
+  available() const
+  {
+    return empty() ? 0 : __book.available();
+  }
+
+  usize
+  total() const
+  {
+    return empty() ? 0 : __book.__total();
+  }
+
+  usize
+  ftotal() const
+  {
+    return __book.__total();
+  }
+
+  usize
+  used() const
+  {
+    return __book.used();
+  }
+
+  usize
+  tombstoned() const
+  {
+    return __book.tombstoned();
+  }
+
+  usize
+  allocated() const
+  {
+    return __kernel_memory.len - __guard_offset;
+  }
+
+  usize
+  block_size_of(byte *ptr) const
+  {
+    return __book.block_size(ptr);
+  }
+
+  // grow a live block in place into its free physical successor; {nullptr, 0} if it can't
+  micron::__chunk<byte>
+  try_grow(byte *ptr, usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    return __book.grow_in_place(ptr, mem_sz);
+  }
+
+  // decay purge over the free runs; bytes advised this pass
+  usize
+  purge(u64 now)
+  {
+    if ( empty() ) return 0;
+    return __book.purge(now, __purge_grain_for<Sz>());
+  }
+
+  // true iff ptr is a live (allocated, in-range) block start
+  bool
+  is_block_allocated(byte *ptr) const
+  {
+    // and !ts
+    return __book.is_allocated(ptr) && !__book.is_tombstoned(ptr);
+  }
+
+  bool
+  is_temporal_block(byte *ptr)
+  {
+    return __book.is_temporal(ptr);
+  }
+
+  addr_t *
+  addr() const
+  {
+    return reinterpret_cast<addr_t *>(__kernel_memory.ptr);
+  }
+
+  addr_t *
+  addr_end() const
+  {
+    return reinterpret_cast<addr_t *>(__kernel_memory.ptr + __kernel_memory.len - __guard_offset);
+  }
+
+  bool
+  is_at(addr_t *_addr) const
+  {
+    if ( _addr >= addr() and _addr < addr_end() ) return true;
+    return false;
+  }
+
+  void
+  reset(void)
+  {
+    __impl_release();
+  }
+
+#if defined(ABCMALLOC_DOCTOR_HELP)
+  template<class V>
+  void
+  __doctor_walk(V &v)
+  {
+    __book.__doctor_walk(v);
+  }
+#endif
+};
+
+template<u64 Sz>
+tlsf_sheet<Sz>
+make_tlsf_sheet(__arena *owner, usize req_size)
+{
+  return tlsf_sheet<Sz>(owner, __get_kernel_chunk<micron::__chunk<byte>>(req_size));
+}
+
+// headerless slab sheets
+// backs the precise class, objects are served from per-class runs with no per-object header
+
+template<u64 Sz> class slab_sheet
+{
+public:
+  constexpr static const u64 __size_class = Sz;      // exposed for tomb_for<> dispatch
+  constexpr static const usize __block_overhead = 0;
+  constexpr static const bool __exact_classes = true;      // cached blocks must match the request's class exactly
+private:
+  using stack_page_list = __slab_list<micron::__chunk<byte>, __size_class>;
+  micron::__chunk<byte> __kernel_memory;
+  stack_page_list __book;
+  usize __guard_offset;
+
+  inline __attribute__((always_inline)) void
+  __impl_release(void)
+  {
+    if ( !__kernel_memory.zero() ) {
+      __sheet_unregister(__kernel_memory.ptr, __kernel_memory.len);
+      __release_kernel_chunk(__kernel_memory, __guard_offset);
+      __kernel_memory.ptr = nullptr;
+      __kernel_memory.len = 0;
+    }
+  }
+
+public:
+  ~slab_sheet() { __impl_release(); };
+
+  slab_sheet(void) = delete;
+
+  slab_sheet(__arena *owner, const micron::__chunk<byte> &mem) : __kernel_memory(mem), __book(mem), __guard_offset(0)
+  {
+    __sheet_register(owner, mem.ptr, mem.len);
+  }
+
+  slab_sheet(__arena *owner, const micron::__chunk<byte> &mem, usize offset)
+      : __kernel_memory(mem), __book(micron::__chunk<byte>{ mem.ptr, mem.len - offset }), __guard_offset(offset)
+  {
+    __sheet_register(owner, mem.ptr, mem.len);
+  }
+
+  slab_sheet(const slab_sheet &) = delete;
+
+  slab_sheet(slab_sheet &&o)
+      : __kernel_memory(micron::move(o.__kernel_memory)), __book(micron::move(o.__book)), __guard_offset(o.__guard_offset)
+  {
+    o.__guard_offset = 0;
+  }
+
+  slab_sheet &operator=(const slab_sheet &) = delete;
+
+  slab_sheet &
+  operator=(slab_sheet &&o)
+  {
+    __kernel_memory = micron::move(o.__kernel_memory);
+    __book = micron::move(o.__book);
+    __guard_offset = o.__guard_offset;
+    o.__guard_offset = 0;
+    return *this;
+  }
+
+  static inline __attribute__((always_inline)) usize
+  round_request(usize n) noexcept
+  {
+    return stack_page_list::round_request(n);
+  }
+
+  bool
+  freeze(void)
+  {
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, micron::prot_read) != 0 ) return false;
+    return true;
+  }
+
+  bool
+  freeze(int prot)
+  {
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, prot) != 0 ) return false;
+    return true;
+  }
+
+  void
+  release(void)
+  {
+    __impl_release();
+  }
+
+  bool
+  empty(void) const noexcept
+  {
+    return __kernel_memory.zero();
+  }
+
+  micron::__chunk<byte>
+  mark(usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    micron::__chunk<byte> _p = __book.allocate(mem_sz);
+    if ( _p.zero() or _p.invalid() ) return { nullptr, 0 };
+    return _p;
+  }
+
+  micron::__chunk<byte>
+  temporal_mark(usize mem_sz)
+  {
+    if ( empty() ) return { nullptr, 0 };
+    micron::__chunk<byte> _p = __book.temporal_allocate(mem_sz);
+    if ( _p.zero() or _p.invalid() ) return { nullptr, 0 };
+    return _p;
+  }
+
+  micron::__chunk<byte>
+  try_mark(usize mem_sz)
+  {
+    if ( empty() ) micron::abort();
+    micron::__chunk<byte> _p = __book.allocate(mem_sz);
+    if ( _p.zero() or _p.invalid() ) return { micron::numeric_limits<byte *>::max(), 0xFF };
+    return _p;
+  }
+
+  // blocks here stay under __zero_elide_min, calloc always clears them
+  bool
+  known_zero(const byte *) const noexcept
+  {
+    return false;
+  }
+
+  bool
+  try_unmark(micron::__chunk<byte> _p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p.zero() ) micron::abort();
+    auto r = __book.deallocate(_p);
+    if ( r == __flag_out_of_space ) return false;
+    if ( r == __flag_invalid or r == __flag_failure ) return false;
+    return true;
+  }
+
+  bool
+  try_tombstone(micron::__chunk<byte> _p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p.zero() ) micron::abort();
+    auto r = __book.tombstone(_p);
+    if ( r == __flag_out_of_space ) return false;
+    if ( r == __flag_invalid or r == __flag_failure ) return false;
+    return true;
+  }
+
+  bool
+  try_unmark_no_size(byte *_p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p == nullptr ) micron::abort();
+    __book.deallocate(_p);
+    return true;
+  }
+
+  bool
+  try_tombstone_no_size(byte *_p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p == nullptr ) micron::abort();
+    __book.tombstone(_p);
+    return true;
+  }
+
+  bool
+  find(byte *_p)
+  {
+    if ( _p == nullptr ) return false;
+    if ( empty() ) micron::abort();
+    return __book.is_allocated(_p) && !__book.is_tombstoned(_p);
+  }
+
+  usize
+  available() const
+  {
+    return empty() ? 0 : __book.available();
+  }
+
+  usize
+  total() const
+  {
+    return empty() ? 0 : __book.__total();
+  }
+
+  usize
+  ftotal() const
+  {
+    return __book.__total();
+  }
+
+  usize
+  used() const
+  {
+    return __book.used();
+  }
+
+  usize
+  tombstoned() const
+  {
+    return __book.tombstoned();
+  }
+
+  usize
+  allocated() const
+  {
+    return __kernel_memory.len - __guard_offset;
+  }
+
+  // object size of the class run ptr lives in
+  usize
+  block_size_of(byte *ptr) const
+  {
+    return __book.block_size(ptr);
+  }
+
+  // true iff ptr is a live (allocated, in-range) object start
+  bool
+  is_block_allocated(byte *ptr) const
+  {
+    return __book.is_allocated(ptr) && !__book.is_tombstoned(ptr);
+  }
+
+  bool
+  is_temporal_block(byte *ptr)
+  {
+    return __book.is_temporal(ptr);
+  }
+
+  addr_t *
+  addr() const
+  {
+    return reinterpret_cast<addr_t *>(__kernel_memory.ptr);
+  }
+
+  addr_t *
+  addr_end() const
+  {
+    return reinterpret_cast<addr_t *>(__kernel_memory.ptr + __kernel_memory.len - __guard_offset);
+  }
+
+  bool
+  is_at(addr_t *_addr) const
+  {
+    if ( _addr >= addr() and _addr < addr_end() ) return true;
+    return false;
+  }
+
+  void
+  reset(void)
+  {
+    __impl_release();
+  }
+
+#if defined(ABCMALLOC_DOCTOR_HELP)
+  template<class V>
+  void
+  __doctor_walk(V &v)
+  {
+    __book.__doctor_walk(v);
+  }
+#endif
+};
+
+template<u64 Sz>
+slab_sheet<Sz>
+make_slab_sheet(__arena *owner, usize req_size)
+{
+  return slab_sheet<Sz>(owner, __get_kernel_chunk<micron::__chunk<byte>>(req_size));
+}
+
+// dedicated mapping sheets
+// exactly one block per sheet: the block is the whole granule-aligned mapping, there is no header and
+// no book. realloc moves the mapping's page tables (mremap) instead of its contents
+
+class map_sheet
+{
+public:
+  constexpr static const u64 __size_class = __direct_map_threshold;
+  constexpr static const usize __block_overhead = 0;
+  constexpr static const bool __exact_classes = false;
+
+private:
+  enum : u8 { __map_free = 0, __map_alloc = 1, __map_tombstone = 2 };
+
+  micron::__chunk<byte> __kernel_memory;
+  u8 __state;
+  bool __frozen;
+  bool __reused;      // handed out and freed at least once, contents are no longer known zero
+
+  inline __attribute__((always_inline)) void
+  __impl_release(void)
+  {
+    if ( !__kernel_memory.zero() ) {
+      __sheet_unregister(__kernel_memory.ptr, __kernel_memory.len);
+      // the block can be freed while frozen; a retained run must come back writable
+      __release_kernel_chunk(__kernel_memory, __frozen ? __kernel_memory.len : 0);
+      __kernel_memory.ptr = nullptr;
+      __kernel_memory.len = 0;
+    }
+    __state = __map_free;
+    __frozen = false;
+    __reused = false;
+  }
+
+  inline __attribute__((always_inline)) bool
+  __is_block(const byte *ptr) const
+  {
+    return !empty() and ptr == __kernel_memory.ptr;
+  }
+
+public:
+  ~map_sheet() { __impl_release(); };
+
+  map_sheet(void) = delete;
+
+  map_sheet(__arena *owner, const micron::__chunk<byte> &mem)
+      : __kernel_memory(mem), __state(__map_free), __frozen(false), __reused(false)
+  {
+    __sheet_register(owner, mem.ptr, mem.len);
+  }
+
+  map_sheet(const map_sheet &) = delete;
+
+  map_sheet(map_sheet &&o)
+      : __kernel_memory(micron::move(o.__kernel_memory)), __state(o.__state), __frozen(o.__frozen), __reused(o.__reused)
+  {
+    o.__state = __map_free;
+    o.__frozen = false;
+    o.__reused = false;
+  }
+
+  map_sheet &operator=(const map_sheet &) = delete;
+
+  map_sheet &
+  operator=(map_sheet &&o)
+  {
+    __kernel_memory = micron::move(o.__kernel_memory);
+    __state = o.__state;
+    __frozen = o.__frozen;
+    __reused = o.__reused;
+    o.__state = __map_free;
+    o.__frozen = false;
+    o.__reused = false;
+    return *this;
+  }
+
+  bool
+  freeze(void)
+  {
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, micron::prot_read) != 0 ) return false;
+    __frozen = true;
+    return true;
+  }
+
+  bool
+  freeze(int prot)
+  {
+    if ( micron::mprotect(__kernel_memory.ptr, __kernel_memory.len, prot) != 0 ) return false;
+    __frozen = prot != (micron::prot_read | micron::prot_write);
+    return true;
+  }
+
+  void
+  release(void)
+  {
+    __impl_release();
+  }
+
+  bool
+  empty(void) const noexcept
+  {
+    return __kernel_memory.zero();
+  }
+
+  micron::__chunk<byte>
+  mark(usize mem_sz)
+  {
+    if ( empty() or __state != __map_free or mem_sz > __kernel_memory.len ) return { nullptr, 0 };
+    __state = __map_alloc;
+    return __kernel_memory;
+  }
+
+  micron::__chunk<byte>
+  temporal_mark(usize mem_sz)
+  {
+    return mark(mem_sz);
+  }
+
+  micron::__chunk<byte>
+  try_mark(usize mem_sz)
+  {
+    if ( empty() ) micron::abort();
+    micron::__chunk<byte> _p = mark(mem_sz);
+    if ( _p.zero() ) return { micron::numeric_limits<byte *>::max(), 0xFF };
+    return _p;
+  }
+
+  // a dedicated mapping is zero until its first hand-out has been freed back
+  bool
+  known_zero(const byte *ptr) const noexcept
+  {
+    return __is_block(ptr) and !__reused;
+  }
+
+  bool
+  try_unmark(micron::__chunk<byte> _p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p.zero() ) micron::abort();
+    return try_unmark_no_size(_p.ptr);
+  }
+
+  bool
+  try_tombstone(micron::__chunk<byte> _p)
+  {
+    if ( empty() ) micron::abort();
+    if ( _p.zero() ) micron::abort();
+    return try_tombstone_no_size(_p.ptr);
+  }
+
+  bool
+  try_unmark_no_size(byte *_p)
+  {
+    if ( empty() ) micron::abort();
+    if ( !__is_block(_p) or __state == __map_free ) return false;
+    __state = __map_free;
+    __reused = true;
+    return true;
+  }
+
+  bool
+  try_tombstone_no_size(byte *_p)
+  {
+    if ( empty() ) micron::abort();
+    if ( !__is_block(_p) or __state != __map_alloc ) return false;
+    __state = __map_tombstone;
+    return true;
+  }
+
+  // move/resize the mapping; the caller re-registers the sheet with its tier afterwards
+  bool
+  remap(__arena *owner, usize new_sz)
+  {
+    if ( empty() or __state != __map_alloc ) return false;
+    __sheet_unregister(__kernel_memory.ptr, __kernel_memory.len);
+    micron::__chunk<byte> moved = __remap_kernel_chunk(__kernel_memory, new_sz);
+    const bool ok = !moved.zero();
+    if ( ok ) __kernel_memory = moved;
+    __sheet_register(owner, __kernel_memory.ptr, __kernel_memory.len);
+    return ok;
+  }
+
+  bool
+  find(byte *_p)
+  {
+    if ( _p == nullptr ) return false;
+    if ( empty() ) micron::abort();
+    return __is_block(_p) and __state == __map_alloc;
+  }
+
+  usize
+  available() const
+  {
+    return (empty() or __state != __map_free) ? 0 : __kernel_memory.len;
+  }
+
+  usize
+  total() const
+  {
+    return __kernel_memory.len;
+  }
+
+  usize
+  ftotal() const
+  {
+    return __kernel_memory.len;
+  }
+
+  usize
+  used() const
+  {
+    return __state == __map_alloc ? __kernel_memory.len : 0;
+  }
+
+  usize
+  tombstoned() const
+  {
+    return __state == __map_tombstone ? __kernel_memory.len : 0;
+  }
+
+  usize
+  allocated() const
+  {
+    return __kernel_memory.len;
+  }
+
+  usize
+  block_size_of(byte *ptr) const
+  {
+    return __is_block(ptr) ? __kernel_memory.len : 0;
+  }
+
+  micron::__chunk<byte>
+  try_grow(byte *, usize)
+  {
+    return { nullptr, 0 };
+  }
+
+  bool
+  is_block_allocated(byte *ptr) const
+  {
+    return __is_block(ptr) and __state == __map_alloc;
+  }
+
+  bool
+  is_temporal_block(byte *)
+  {
+    return false;
+  }
+
+  addr_t *
+  addr() const
+  {
+    return reinterpret_cast<addr_t *>(__kernel_memory.ptr);
+  }
+
+  addr_t *
+  addr_end() const
+  {
+    return reinterpret_cast<addr_t *>(__kernel_memory.ptr + __kernel_memory.len);
+  }
+
+  bool
+  is_at(addr_t *_addr) const
+  {
+    if ( _addr >= addr() and _addr < addr_end() ) return true;
+    return false;
+  }
+
+  void
+  reset(void)
+  {
+    __impl_release();
+  }
+
+#if defined(ABCMALLOC_DOCTOR_HELP)
+  template<class V>
+  void
+  __doctor_walk(V &v)
+  {
+    if ( empty() ) return;
+    ++v.blocks;
+    if ( __state > __map_tombstone ) v.note("mapped: block state corrupt", __kernel_memory.ptr);
+  }
+#endif
+};
+
 };      // namespace abc
@@ -27,7 +27,7 @@
 
 namespace abc
 {
-struct cache {
+struct cache : __arena_counters {
   micron::__chunk<byte>
   __heap_grow(const usize sz)
   {
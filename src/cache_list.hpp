@@ -22,6 +22,7 @@
 #pragma once
 
 #include "metadata.hpp"
+#include "purge.hpp"
 
 #include <micron/mem.hpp>
 #include <micron/memory/cmemory.hpp>
@@ -44,7 +45,7 @@ namespace abc
 //    offset 8:  previous physical block
 //    offset 16: free-list link
 //    offset 24: free-list link
-//    offset 32: meta
+//    offset 32: meta (free blocks: decay purge stamp, only kept when __default_purge)
 
 template<typename T, i64 Min, i32 Mx = 64>
   requires(micron::is_trivially_constructible_v<T> and micron::is_trivially_destructible_v<T> and (bool)((Min & (Min - 1)) == 0))
@@ -132,6 +133,12 @@ struct __tlsf_list {
     return reinterpret_cast<tlsf_hdr *>(reinterpret_cast<byte *>(b) + (usize)b->bsize);
   }
 
+  __attribute__((always_inline)) static inline u64 *
+  __stamp_of(tlsf_hdr *b) noexcept
+  {
+    return reinterpret_cast<u64 *>(reinterpret_cast<byte *>(b) + __hdr_offset);
+  }
+
   void
   fl_insert(tlsf_hdr *block) noexcept
   {
@@ -146,6 +153,7 @@ struct __tlsf_list {
     heads[i] = block;
 
     block->flags = __block_free;
+    if constexpr ( __default_purge ) *__stamp_of(block) = __purge_stamp();
     fl_bitmap |= (1u << fi);
     sl_bitmap[fi] |= (1u << si);
   }
@@ -410,6 +418,41 @@ struct __tlsf_list {
     return { reinterpret_cast<byte *>(block) + __hdr_offset, (usize)block->bsize - __hdr_offset };
   }
 
+  // al must be a power of two above __block_align; user pointers sit __hdr_offset past a 32-aligned header, so the block
+  // is found with room for the worst leading gap, which is split off as a free block of its own (every gap is at least
+  // __min_block, a gap of exactly __block_align is pushed out by a further al)
+  T
+  allocate_aligned(usize n, usize al) noexcept
+  {
+    n += sizeof(micron::simd::i256);
+    if ( !base ) return { nullptr, 0 };
+
+    usize needed = adjusted_block_size(n);
+
+    tlsf_hdr *block = find_free(needed + al + __min_block);
+    if ( !block ) return { nullptr, 0 };
+
+    const uintptr_t user = reinterpret_cast<uintptr_t>(block) + __hdr_offset;
+    usize gap = align_up(user, al) - user;
+    if ( gap != 0 and gap < __min_block ) gap += al;
+    if ( gap ) {
+      // block's physical predecessor is never free (it would have coalesced), so the gap goes back as is
+      tlsf_hdr *blk = reinterpret_cast<tlsf_hdr *>(reinterpret_cast<byte *>(block) + gap);
+      blk->bsize = (u32)((usize)block->bsize - gap);
+      blk->prev_phys = block;
+      next_phys(blk)->prev_phys = blk;
+      block->bsize = (u32)gap;
+      fl_insert(block);
+      block = blk;
+    }
+
+    try_split(block, needed);
+    block->flags = __block_alloc;
+    allocated_bytes += (usize)block->bsize;
+
+    return { reinterpret_cast<byte *>(block) + __hdr_offset, (usize)block->bsize - __hdr_offset };
+  }
+
   T
   temporal_allocate(usize n) noexcept
   {
@@ -549,6 +592,33 @@ struct __tlsf_list {
     return deallocate(node.ptr);
   }
 
+  // grow a live block in place by absorbing its free next-physical neighbour
+  // the absorbed block is split at the new bound, the tail goes back on its free list
+  // temporal blocks are pinned to their class ring and never grow
+  T
+  grow_in_place(byte *ptr, usize n) noexcept
+  {
+    if ( !ptr || !base ) return { nullptr, 0 };
+    tlsf_hdr *block = reinterpret_cast<tlsf_hdr *>(ptr - __hdr_offset);
+    if ( block->flags != __block_alloc ) return { nullptr, 0 };
+
+    const usize needed = adjusted_block_size(n + sizeof(micron::simd::i256));
+    const usize have = (usize)block->bsize;
+    if ( needed <= have ) return { ptr, have - __hdr_offset };
+
+    tlsf_hdr *next = next_phys(block);
+    if ( next->flags != __block_free ) return { nullptr, 0 };
+    if ( have + (usize)next->bsize < needed ) return { nullptr, 0 };
+
+    fl_remove(next);
+    block->bsize = (u32)(have + (usize)next->bsize);
+    next_phys(block)->prev_phys = block;
+    try_split(block, needed);
+    allocated_bytes += (usize)block->bsize - have;
+
+    return { ptr, (usize)block->bsize - __hdr_offset };
+  }
+
   T
   reallocate(T node, usize new_size) noexcept
   {
@@ -560,6 +630,10 @@ struct __tlsf_list {
     }
 
     if ( node.len >= new_size && new_size > (node.len >> 1) ) return node;
+    if ( node.len < new_size ) {
+      T grown = grow_in_place(node.ptr, new_size);
+      if ( grown.ptr ) return grown;
+    }
 
     T nnode = allocate(new_size);
     if ( !nnode.ptr ) return { nullptr, 0 };
@@ -595,6 +669,21 @@ struct __tlsf_list {
     return allocated_bytes;
   }
 
+  // ages every free block spanning at least two grains; the grains holding this header and the next block's stay resident
+  usize
+  purge(u64 now, usize grain) noexcept
+  {
+    if ( !base ) return 0;
+    usize n = 0;
+    for ( i32 i = 0; i < __list_count; ++i )
+      for ( tlsf_hdr *b = heads[i]; b != nullptr; b = b->next_free ) {
+        if ( (usize)b->bsize < 2 * grain ) continue;
+        n += __purge_run(reinterpret_cast<byte *>(b) + __hdr_offset + sizeof(u64), reinterpret_cast<byte *>(b) + (usize)b->bsize,
+                         *__stamp_of(b), now, grain);
+      }
+    return n;
+  }
+
   usize
   block_size(byte *ptr) const noexcept
   {
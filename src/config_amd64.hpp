@@ -58,7 +58,7 @@ constexpr static const usize __alloc_limit = 0;      // forbid any allocations g
 // these two switches determine the number of *pages* to allocate on initialization, by default, it's 512 pages for the
 // internal abcmalloc metabuffer, and a minimum of 16 per each new sheet allocation
 //
-// NOTE: every eager mapping below is rounded up to __sheet_align (2 MiB) by __va_carve, so trimming
+// NOTE: every eager mapping below is rounded up to __sheet_align (2 MiB) by __get_kernel_chunk, so trimming
 // either of the next two knobs past ~512 KiB of request buys nothing, the granule is the floor
 #ifndef MICRON_ABC_CACHE_SIZE_FACTOR
 #define MICRON_ABC_CACHE_SIZE_FACTOR (1 << 13)
@@ -75,6 +75,26 @@ constexpr static const usize __default_minimum_page_mul = 16;      // 65kB minim
 #define MICRON_ABC_PREALLOC_FACTOR 0.0075f
 #endif
 constexpr static const f32 __default_prealloc_factor = MICRON_ABC_PREALLOC_FACTOR;      // 0.75% of total system mem
+// the eager budget above is process-wide, handed out in this many equal per-arena draws; later arenas start minimal
+#ifndef MICRON_ABC_PREALLOC_DRAWS
+#define MICRON_ABC_PREALLOC_DRAWS 4
+#endif
+constexpr static const u32 __prealloc_draws = MICRON_ABC_PREALLOC_DRAWS;
+// hot-tier (precise/small/medium) sheets are mapped MAP_NORESERVE and committed page by page on first touch
+#ifndef MICRON_ABC_LAZY_COMMIT
+#define MICRON_ABC_LAZY_COMMIT true
+#endif
+constexpr static const bool __default_lazy_commit = MICRON_ABC_LAZY_COMMIT;
+// decay purging: free runs inside live sheets go MADV_FREE after this many ms, MADV_DONTNEED after twice that
+#ifndef MICRON_ABC_PURGE
+#define MICRON_ABC_PURGE false
+#endif
+constexpr static const bool __default_purge = MICRON_ABC_PURGE;
+#ifndef MICRON_ABC_PURGE_DECAY_MS
+#define MICRON_ABC_PURGE_DECAY_MS 10000
+#endif
+constexpr static const u64 __purge_decay_ms = MICRON_ABC_PURGE_DECAY_MS;
+constexpr static const u32 __purge_check_interval = 256;      // frees between clock reads on the free path
 constexpr static const usize __default_cache_step = 768;                                // ~5.9MB
 
 constexpr static const bool __default_launder
@@ -89,6 +109,30 @@ constexpr static const bool __default_multithread_safe = false;
 #else
 constexpr static const bool __default_multithread_safe = true;      // essentially, enables locks across API calls
 #endif
+// per-CPU arenas: threads share the arena of the CPU they run on (found through rseq) instead of owning one each;
+// a thread whose rseq registration is unavailable keeps the per-thread arena scheme
+#ifndef MICRON_ABC_PERCPU
+#define MICRON_ABC_PERCPU false
+#endif
+constexpr static const bool __default_percpu_arenas = MICRON_ABC_PERCPU;
+// cross-thread frees are parked per thread, per destination arena, and published as one chain (one CAS per batch)
+#ifndef MICRON_ABC_REMOTE_BATCH
+#define MICRON_ABC_REMOTE_BATCH 32
+#endif
+constexpr static const u32 __remote_batch_depth = MICRON_ABC_REMOTE_BATCH;      // 0 == publish every free on its own
+constexpr static const u32 __remote_batch_slots = 4;                            // destination arenas buffered per thread
+// a parked free is published after at most this many further allocator calls on its thread, full batch or not
+// (0 == only on fill). a thread that stops calling the allocator altogether still wants flush_remote() before it idles
+#ifndef MICRON_ABC_REMOTE_BATCH_AGE
+#define MICRON_ABC_REMOTE_BATCH_AGE 256
+#endif
+constexpr static const u32 __remote_batch_age = MICRON_ABC_REMOTE_BATCH_AGE;
+// single remote frees go through a per-arena ring that is mapped on the first spill and doubles up to the max (powers of two)
+#ifndef MICRON_ABC_REMOTE_RING_MAX
+#define MICRON_ABC_REMOTE_RING_MAX 4096
+#endif
+constexpr static const usize __remote_ring_min = 64;
+constexpr static const usize __remote_ring_max = MICRON_ABC_REMOTE_RING_MAX;
 // eagerly preallocate precise/small/medium with weight-based shares even if __default_lazy_construct is true.
 #ifndef MICRON_ABC_EAGER_HOT_TIERS
 #define MICRON_ABC_EAGER_HOT_TIERS true
@@ -103,10 +147,11 @@ constexpr static const bool __default_per_class_free_cache = __default_persisten
 // >0 == batch only sweep a tier's sheets every N deallocations
 constexpr static const u32 __default_tombstone_sweep_interval = 64;
 
-// per-tier sheet caps (multi-word __space_mask bitmap)
+// per-tier directory leaf width (power of two, at least 64): the first leaf lives inline in the arena, further leaves are
+// mapped as a tier outgrows it, so these no longer cap anything; they size what a small heap carries up front
 // hot tiers (precise/small/medium) carry frequent small-allocation pressure;
 // cold tiers (large/huge) rarely exceed 64 sheets, so keeping them narrow conserves the per-arena tier footprint
-// NOTE: each tier costs sizeof(__range)=24B per __idx slot + ceil(N/64)*8B for the bitmap
+// NOTE: each leaf costs sizeof(__range)=24B per slot + N/64*8B for its availability bitmap
 #ifndef MICRON_ABC_MAX_SHEETS_PRECISE
 #define MICRON_ABC_MAX_SHEETS_PRECISE 512
 #endif
@@ -126,7 +171,7 @@ constexpr static const u32 __max_sheets_precise = MICRON_ABC_MAX_SHEETS_PRECISE;
 constexpr static const u32 __max_sheets_small = MICRON_ABC_MAX_SHEETS_SMALL;
 constexpr static const u32 __max_sheets_medium = MICRON_ABC_MAX_SHEETS_MEDIUM;
 constexpr static const u32 __max_sheets_large = MICRON_ABC_MAX_SHEETS_LARGE;
-constexpr static const u32 __max_sheets_huge = MICRON_ABC_MAX_SHEETS_HUGE;      // doubled to absorb sustained huge-band pressure
+constexpr static const u32 __max_sheets_huge = MICRON_ABC_MAX_SHEETS_HUGE;
 constexpr static const u32 __max_sheets_arena_internal = 64;
 
 // per-tier free-cache slot counts (LIFO depth per tier)
@@ -165,6 +210,38 @@ constexpr static const usize __default_overcommit
     = 1;      // overcommit multiplier, multiplies all page req. by this value. MUST BE GREATER THAN ONE AND INTEGRAL.
 
 constexpr static const bool __default_init_large_pages = false;
+// back precise/small/medium sheets with transparent huge pages: every hot sheet is a 2 MiB-aligned carve, marked MADV_HUGEPAGE.
+// first touch then faults in a whole huge page, so this trades the page-by-page lazy commit for fewer dTLB misses
+#ifndef MICRON_ABC_THP
+#define MICRON_ABC_THP false
+#endif
+constexpr static const bool __default_thp = MICRON_ABC_THP;
+// additionally collapse each new hot sheet synchronously (MADV_COLLAPSE, linux 6.1+; ignored where unsupported)
+#ifndef MICRON_ABC_THP_COLLAPSE
+#define MICRON_ABC_THP_COLLAPSE false
+#endif
+constexpr static const bool __default_thp_collapse = MICRON_ABC_THP_COLLAPSE;
+
+// dedicated mappings for requests >= __direct_map_threshold; one granule-aligned mapping per block, realloc'd via mremap.
+// the granule table binds whole granules, so a block holds its size rounded up to 2 MiB of address space and commit
+// charge: a 1 MiB + 1 B block pins 2 MiB (the untouched tail never becomes resident). raise the threshold, or turn
+// this off, where many blocks sit just over a granule multiple
+#ifndef MICRON_ABC_DIRECT_MAP
+#define MICRON_ABC_DIRECT_MAP true
+#endif
+#ifndef MICRON_ABC_MAX_SHEETS_MAPPED
+#define MICRON_ABC_MAX_SHEETS_MAPPED 256
+#endif
+constexpr static const bool __default_direct_map = MICRON_ABC_DIRECT_MAP;
+constexpr static const usize __direct_map_threshold = __class_1mb;
+constexpr static const u32 __max_sheets_mapped = MICRON_ABC_MAX_SHEETS_MAPPED;      // directory leaf width, see above
+
+// medium and large tiers carve exact page runs (12.5% binned, metadata out of band) instead of power-of-two buddy blocks
+#ifndef MICRON_ABC_PAGE_RUNS
+#define MICRON_ABC_PAGE_RUNS true
+#endif
+constexpr static const bool __default_page_runs = MICRON_ABC_PAGE_RUNS;
+
 constexpr static const bool __default_oom_enable = false;      // NOTE: costs performance
 constexpr static const bool __default_borrow_auto = true;
 constexpr static const float __default_oom_limit_warn = 0.1f;
@@ -213,11 +290,40 @@ constexpr static const bool __default_zero_on_alloc = MICRON_ABC_ZERO_ON_ALLOC;
 #define MICRON_ABC_ZERO_ON_FREE false
 #endif
 constexpr static const bool __default_zero_on_free = MICRON_ABC_ZERO_ON_FREE;
+// calloc/salloc skip the memset for blocks carved from never-handed-out sheet memory (the kernel already zeroed it);
+// only blocks of at least __zero_elide_min are tracked, below that the memset is cheaper than the check
+#ifndef MICRON_ABC_ZERO_ELIDE
+#define MICRON_ABC_ZERO_ELIDE true
+#endif
+constexpr static const bool __default_zero_elide = MICRON_ABC_ZERO_ELIDE;
+constexpr static const usize __zero_elide_min = __system_pagesize;
 constexpr static const bool __default_full_on_free = false;
 constexpr static const bool __default_sanitize = false;
 constexpr static const byte __default_sanitize_with_on_alloc = 0xcc;
 
-constexpr static const bool __default_collect_stats = false;
+// per-arena, per-tier counters behind abc::stats_snapshot(); owner-only relaxed stores, no shared line (stats.hpp)
+#ifndef MICRON_ABC_COLLECT_STATS
+#define MICRON_ABC_COLLECT_STATS true
+#endif
+constexpr static const bool __default_collect_stats = MICRON_ABC_COLLECT_STATS;
+
+// sampled heap profiler (heap_profile.hpp): compiled in, idle until abc::profile_start(); a sample every
+// __prof_default_rate bytes on average, __prof_bt_depth frames each, at most __prof_slots live samples per arena
+#ifndef MICRON_ABC_HEAP_PROFILE
+#define MICRON_ABC_HEAP_PROFILE true
+#endif
+constexpr static const bool __default_heap_profile = MICRON_ABC_HEAP_PROFILE;
+constexpr static const usize __prof_default_rate = 512 * 1024;
+constexpr static const u32 __prof_bt_depth = 24;
+constexpr static const u32 __prof_slots = 4096;
+
+// allocation trace recorder (trace.hpp): every alloc/free/realloc to a per-thread ring of __trace_ring_records,
+// flushed to the file given to abc::trace_start(); a capture build, every op then takes a shared ticket
+#ifndef MICRON_ABC_TRACE
+#define MICRON_ABC_TRACE false
+#endif
+constexpr static const bool __default_trace = MICRON_ABC_TRACE;
+constexpr static const u32 __trace_ring_records = 16384;
 constexpr static const byte __default_double_free_action = 2;
 // 0 == ignore silently (return false, no log)
 // 1 == log diagnostic return false
@@ -80,6 +80,26 @@ constexpr static const usize __default_minimum_page_mul = 16;
 #define MICRON_ABC_PREALLOC_FACTOR 0.02f
 #endif
 constexpr static const f32 __default_prealloc_factor = MICRON_ABC_PREALLOC_FACTOR;
+// the eager budget above is process-wide, handed out in this many equal per-arena draws; later arenas start minimal
+#ifndef MICRON_ABC_PREALLOC_DRAWS
+#define MICRON_ABC_PREALLOC_DRAWS 1
+#endif
+constexpr static const u32 __prealloc_draws = MICRON_ABC_PREALLOC_DRAWS;
+// hot-tier (precise/small/medium) sheets are mapped MAP_NORESERVE and committed page by page on first touch
+#ifndef MICRON_ABC_LAZY_COMMIT
+#define MICRON_ABC_LAZY_COMMIT true
+#endif
+constexpr static const bool __default_lazy_commit = MICRON_ABC_LAZY_COMMIT;
+// decay purging: free runs inside live sheets go MADV_FREE after this many ms, MADV_DONTNEED after twice that
+#ifndef MICRON_ABC_PURGE
+#define MICRON_ABC_PURGE false
+#endif
+constexpr static const bool __default_purge = MICRON_ABC_PURGE;
+#ifndef MICRON_ABC_PURGE_DECAY_MS
+#define MICRON_ABC_PURGE_DECAY_MS 1000
+#endif
+constexpr static const u64 __purge_decay_ms = MICRON_ABC_PURGE_DECAY_MS;
+constexpr static const u32 __purge_check_interval = 64;      // frees between clock reads on the free path
 
 // 384 precise blocks per expansion (384 * 256 = 96 KB)
 constexpr static const usize __default_cache_step = 384;
@@ -97,6 +117,29 @@ constexpr static const bool __default_multithread_safe = false;
 #else
 constexpr static const bool __default_multithread_safe = true;      // essentially, enables locks across API calls
 #endif
+// per-CPU arenas: threads share the arena of the CPU they run on (found through rseq) instead of owning one each;
+// a thread whose rseq registration is unavailable keeps the per-thread arena scheme
+#ifndef MICRON_ABC_PERCPU
+#define MICRON_ABC_PERCPU false
+#endif
+constexpr static const bool __default_percpu_arenas = MICRON_ABC_PERCPU;
+// cross-thread frees are parked per thread, per destination arena, and published as one chain (one CAS per batch)
+#ifndef MICRON_ABC_REMOTE_BATCH
+#define MICRON_ABC_REMOTE_BATCH 8
+#endif
+constexpr static const u32 __remote_batch_depth = MICRON_ABC_REMOTE_BATCH;      // 0 == publish every free on its own
+constexpr static const u32 __remote_batch_slots = 2;                            // destination arenas buffered per thread
+// a parked free is published after at most this many further allocator calls on its thread, full batch or not
+#ifndef MICRON_ABC_REMOTE_BATCH_AGE
+#define MICRON_ABC_REMOTE_BATCH_AGE 64
+#endif
+constexpr static const u32 __remote_batch_age = MICRON_ABC_REMOTE_BATCH_AGE;
+// single remote frees go through a per-arena ring that is mapped on the first spill and doubles up to the max (powers of two)
+#ifndef MICRON_ABC_REMOTE_RING_MAX
+#define MICRON_ABC_REMOTE_RING_MAX 256
+#endif
+constexpr static const usize __remote_ring_min = 16;
+constexpr static const usize __remote_ring_max = MICRON_ABC_REMOTE_RING_MAX;
 
 #ifndef MICRON_ABC_EAGER_HOT_TIERS
 #define MICRON_ABC_EAGER_HOT_TIERS true
@@ -108,7 +151,7 @@ constexpr static const bool __default_per_class_free_cache = false;
 
 constexpr static const u32 __default_tombstone_sweep_interval = 32;
 
-// keep all tiers narrow, old behavior for amd64, default here
+// keep all inline directory leaves narrow (tiers still grow past them), old behavior for amd64, default here
 #ifndef MICRON_ABC_MAX_SHEETS_PRECISE
 #define MICRON_ABC_MAX_SHEETS_PRECISE 64
 #endif
@@ -170,6 +213,30 @@ constexpr static const bool __default_saturated_mode = true;      // enables a s
 constexpr static const usize __default_overcommit = 1;
 
 constexpr static const bool __default_init_large_pages = false;
+// back precise/small/medium sheets with transparent huge pages (MADV_HUGEPAGE); no effect on 64 KiB granules (width-32)
+#ifndef MICRON_ABC_THP
+#define MICRON_ABC_THP false
+#endif
+constexpr static const bool __default_thp = MICRON_ABC_THP;
+#ifndef MICRON_ABC_THP_COLLAPSE
+#define MICRON_ABC_THP_COLLAPSE false
+#endif
+constexpr static const bool __default_thp_collapse = MICRON_ABC_THP_COLLAPSE;
+
+// dedicated mappings cost a full carve granule each (a block holds its size rounded up to the granule in address
+// space and commit charge); off on embedded targets
+#ifndef MICRON_ABC_DIRECT_MAP
+#define MICRON_ABC_DIRECT_MAP false
+#endif
+constexpr static const bool __default_direct_map = MICRON_ABC_DIRECT_MAP;
+constexpr static const usize __direct_map_threshold = __class_1mb;
+constexpr static const u32 __max_sheets_mapped = 16;      // leaves are at least 64 slots wide
+
+// page runs round to a page instead of a power of two; one 24 byte tag per page
+#ifndef MICRON_ABC_PAGE_RUNS
+#define MICRON_ABC_PAGE_RUNS true
+#endif
+constexpr static const bool __default_page_runs = MICRON_ABC_PAGE_RUNS;
 
 // OFF assume the user handles memory fully and skillfully
 // too wasteful for low cr systems
@@ -218,11 +285,38 @@ static_assert(!(__default_persistent_mode && __default_per_class_free_cache),
 constexpr static const bool __default_debug_notices = false;
 constexpr static const bool __default_zero_on_alloc = false;
 constexpr static const bool __default_zero_on_free = false;
+#ifndef MICRON_ABC_ZERO_ELIDE
+#define MICRON_ABC_ZERO_ELIDE true
+#endif
+constexpr static const bool __default_zero_elide = MICRON_ABC_ZERO_ELIDE;      // calloc/salloc skip the memset on never-handed-out memory
+constexpr static const usize __zero_elide_min = __system_pagesize;
 constexpr static const bool __default_full_on_free = false;
 constexpr static const bool __default_sanitize = false;
 constexpr static const byte __default_sanitize_with_on_alloc = 0xcc;
 
-constexpr static const bool __default_collect_stats = false;
+// per-arena, per-tier counters behind abc::stats_snapshot(); owner-only relaxed stores, no shared line (stats.hpp)
+#ifndef MICRON_ABC_COLLECT_STATS
+#define MICRON_ABC_COLLECT_STATS false
+#endif
+constexpr static const bool __default_collect_stats = MICRON_ABC_COLLECT_STATS;
+
+// sampled heap profiler (heap_profile.hpp): compiled in, idle until abc::profile_start(); a sample every
+// __prof_default_rate bytes on average, __prof_bt_depth frames each, at most __prof_slots live samples per arena
+#ifndef MICRON_ABC_HEAP_PROFILE
+#define MICRON_ABC_HEAP_PROFILE false
+#endif
+constexpr static const bool __default_heap_profile = MICRON_ABC_HEAP_PROFILE;
+constexpr static const usize __prof_default_rate = 512 * 1024;
+constexpr static const u32 __prof_bt_depth = 8;
+constexpr static const u32 __prof_slots = 256;
+
+// allocation trace recorder (trace.hpp): every alloc/free/realloc to a per-thread ring of __trace_ring_records,
+// flushed to the file given to abc::trace_start(); a capture build, every op then takes a shared ticket
+#ifndef MICRON_ABC_TRACE
+#define MICRON_ABC_TRACE false
+#endif
+constexpr static const bool __default_trace = MICRON_ABC_TRACE;
+constexpr static const u32 __trace_ring_records = 1024;
 
 // abort on double free
 constexpr static const byte __default_double_free_action = 2;
@@ -68,6 +68,14 @@ constexpr static const usize __default_minimum_page_mul = 16;      // 65kB minim
 
 // 1% of system RAM. on 256 GB this is ~2.6 GB distributed across all five size classes by weight
 constexpr static const f32 __default_prealloc_factor = 0.01f;
+// the eager budget above is process-wide, handed out in this many equal per-arena draws; later arenas start minimal
+constexpr static const u32 __prealloc_draws = 8;
+// hot-tier (precise/small/medium) sheets are mapped MAP_NORESERVE and committed page by page on first touch
+constexpr static const bool __default_lazy_commit = true;
+// decay purging: free runs inside live sheets go MADV_FREE after this many ms, MADV_DONTNEED after twice that
+constexpr static const bool __default_purge = false;
+constexpr static const u64 __purge_decay_ms = 10000;
+constexpr static const u32 __purge_check_interval = 256;      // frees between clock reads on the free path
 
 // 8192 precise blocks per expansion = 2 MB
 constexpr static const usize __default_cache_step = 8192;
@@ -85,6 +93,15 @@ constexpr static const bool __default_multithread_safe = false;
 #else
 constexpr static const bool __default_multithread_safe = true;      // essentially, enables locks across API calls
 #endif
+// per-CPU arenas: threads share the arena of the CPU they run on (found through rseq) instead of owning one each;
+// a thread whose rseq registration is unavailable keeps the per-thread arena scheme
+constexpr static const bool __default_percpu_arenas = false;
+// cross-thread frees are parked per thread, per destination arena, and published as one chain (one CAS per batch)
+constexpr static const u32 __remote_batch_depth = 64;      // 0 == publish every free on its own
+constexpr static const u32 __remote_batch_slots = 8;       // destination arenas buffered per thread
+constexpr static const u32 __remote_batch_age = 1024;      // allocator calls before parked frees go out regardless of fill
+constexpr static const usize __remote_ring_min = 64;         // remote-free ring, mapped on the first spill
+constexpr static const usize __remote_ring_max = 16384;      // doubled per grow up to here (powers of two)
 
 // preallocate precise/small/medium at startup with weight-based shares.
 constexpr static const bool __default_eager_hot_tiers = true;
@@ -95,6 +112,7 @@ constexpr static const bool __default_per_class_free_cache = __default_persisten
 // under contention
 constexpr static const u32 __default_tombstone_sweep_interval = 128;
 
+// directory leaf widths; tiers grow past them, wide inline leaves just keep busy tiers off the mapped leaves
 constexpr static const u32 __max_sheets_precise = 1024;
 constexpr static const u32 __max_sheets_small = 1024;
 constexpr static const u32 __max_sheets_medium = 1024;
@@ -127,6 +145,26 @@ constexpr static const bool __default_saturated_mode = true;      // enables a s
 constexpr static const usize __default_overcommit = 2;
 
 constexpr static const bool __default_init_large_pages = true;
+// back precise/small/medium sheets with transparent huge pages: every hot sheet is a 2 MiB-aligned carve, marked MADV_HUGEPAGE
+// on by default here; -DMICRON_ABC_THP=false opts out, same knob as the other presets
+#ifndef MICRON_ABC_THP
+#define MICRON_ABC_THP true
+#endif
+constexpr static const bool __default_thp = MICRON_ABC_THP;
+// additionally collapse each new hot sheet synchronously (MADV_COLLAPSE, linux 6.1+; ignored where unsupported)
+#ifndef MICRON_ABC_THP_COLLAPSE
+#define MICRON_ABC_THP_COLLAPSE false
+#endif
+constexpr static const bool __default_thp_collapse = MICRON_ABC_THP_COLLAPSE;
+
+// multi-megabyte buffers get their own mappings so realloc moves page tables instead of bytes; each holds its size
+// rounded up to a 2 MiB granule of address space and commit charge (the untouched tail never becomes resident)
+constexpr static const bool __default_direct_map = true;
+constexpr static const usize __direct_map_threshold = __class_1mb;
+constexpr static const u32 __max_sheets_mapped = 512;
+
+// 4 KiB - 256 KiB buffers take whole pages, not the next power of two
+constexpr static const bool __default_page_runs = true;
 
 constexpr static const bool __default_oom_enable = false;
 constexpr static const bool __default_borrow_auto = true;
@@ -167,11 +205,21 @@ static_assert(!(__default_persistent_mode && __default_per_class_free_cache),
 constexpr static const bool __default_debug_notices = false;
 constexpr static const bool __default_zero_on_alloc = false;
 constexpr static const bool __default_zero_on_free = false;
+constexpr static const bool __default_zero_elide = true;      // calloc/salloc skip the memset on never-handed-out memory
+constexpr static const usize __zero_elide_min = __system_pagesize;
 constexpr static const bool __default_full_on_free = false;
 constexpr static const bool __default_sanitize = false;
 constexpr static const byte __default_sanitize_with_on_alloc = 0xcc;
 
-constexpr static const bool __default_collect_stats = false;
+constexpr static const bool __default_collect_stats = true;      // per-arena, per-tier counters behind abc::stats_snapshot()
+
+constexpr static const bool __default_heap_profile = true;      // sampled heap profiler, idle until abc::profile_start()
+constexpr static const usize __prof_default_rate = 512 * 1024;      // mean bytes between samples
+constexpr static const u32 __prof_bt_depth = 32;
+constexpr static const u32 __prof_slots = 16384;      // live samples per arena
+
+constexpr static const bool __default_trace = false;      // allocation trace recorder (capture builds only)
+constexpr static const u32 __trace_ring_records = 65536;      // records per thread between flushes
 
 constexpr static const byte __default_double_free_action = 2;
 // 0 == ignore silently (return false, no log)
@@ -32,6 +32,7 @@
 
 #include <micron/memory/allocation/kmemory.hpp>
 
+#include "backtrace.hpp"
 #include "config.hpp"
 #include "metadata.hpp"
 #include "printing.hpp"
@@ -200,22 +201,7 @@ constexpr static const usize __doctor_bt_depth = 4;      // frames captured per
 __capture_backtrace(void **out, usize maxn) noexcept
 {
   usize n = 0;
-  if constexpr ( __default_doctor_backtrace ) {
-    void **fp = reinterpret_cast<void **>(__builtin_frame_address(0));
-    const uintptr_t lo = reinterpret_cast<uintptr_t>(fp);
-    const uintptr_t hi = lo + (16u << 20);      // 16 MB window above the current frame
-    usize guard = 0;
-    while ( fp && n < maxn && guard++ < 128 ) {
-      const uintptr_t a = reinterpret_cast<uintptr_t>(fp);
-      if ( a < lo || a >= hi || (a & (sizeof(void *) - 1)) ) break;      // not a plausible frame pointer
-      void *ret = fp[1];
-      void **next = reinterpret_cast<void **>(fp[0]);
-      if ( !ret ) break;
-      out[n++] = ret;
-      if ( reinterpret_cast<uintptr_t>(next) <= a ) break;      // fp chain must strictly ascend
-      fp = next;
-    }
-  }
+  if constexpr ( __default_doctor_backtrace ) n = __walk_frames(out, maxn);
   for ( usize i = n; i < maxn; ++i ) out[i] = nullptr;
   return n;
 }
@@ -704,9 +690,6 @@ __state_name(__rec_state s) noexcept
   return "?";
 }
 
-// buddy block orders start at 0, which collides with hdr_shadow's "0 == not captured" sentinel
-inline constexpr u32 __hdr_shadow_buddy_captured = 0x80000000u;
-
 inline void
 __doctor_arm_canaries(byte *ptr, usize req, const void *owner, __rec &s) noexcept
 {
@@ -716,15 +699,10 @@ __doctor_arm_canaries(byte *ptr, usize req, const void *owner, __rec &s) noexcep
     if ( !o || o != __tls_arena ) return;
     const int kind = o->__doctor_tier_kind(reinterpret_cast<addr_t *>(ptr));
     const usize real = o->__size_of_alloc(reinterpret_cast<addr_t *>(ptr));
-    if ( kind == 1 ) {      // TLSF: bsize (u32) at user - __hdr_offset
+    if ( kind == 1 ) {      // TLSF: bsize (u32) at user - __hdr_offset; buddy/slab/mapped blocks carry no header
       u32 bs = 0;
       __builtin_memcpy(&bs, ptr - __hdr_offset, sizeof(bs));
       s.hdr_shadow = bs;
-    } else if ( kind == 2 ) {      // buddy: order (i32) at the tail = user + real
-      i32 ord = 0;
-      __builtin_memcpy(&ord, ptr + real, sizeof(ord));
-      // OR in the captured marker so order 0 is distinct from the 0 "not captured" sentinel
-      s.hdr_shadow = __hdr_shadow_buddy_captured | static_cast<u32>(ord);
     }
     if constexpr ( !ABC_EFF_REDZONE ) {      // the allocator's own redzone owns that region if enabled
       if ( real > req ) __builtin_memset(ptr + req, __default_doctor_canary_byte, real - req);
@@ -998,10 +976,10 @@ leaks(void)
   __banner("leaks: live tracked pointers (classified by tier)\n");
   __arena *const self = __tls_arena;
   usize shown = 0, total_bytes = 0;
-  // classes: 0 unresolved/internal, 1 TLSF, 2 buddy, 3 cross-thread (owned by another arena)
-  usize cls_cnt[4] = { 0, 0, 0, 0 };
-  usize cls_bytes[4] = { 0, 0, 0, 0 };
-  usize cls_max[4] = { 0, 0, 0, 0 };
+  // classes: 0 unresolved/internal, 1 TLSF, 2 buddy/page run, 3 cross-thread (owned by another arena), 4 slab, 5 mapped
+  usize cls_cnt[6] = { 0, 0, 0, 0, 0, 0 };
+  usize cls_bytes[6] = { 0, 0, 0, 0, 0, 0 };
+  usize cls_max[6] = { 0, 0, 0, 0, 0, 0 };
   if ( __dr.slots ) {
     for ( usize i = 0; i < __dr.cap; ++i ) {
       const __rec &s = __dr.slots[i];
@@ -1010,13 +988,13 @@ leaks(void)
       total_bytes += s.req_size;
       byte *u = reinterpret_cast<byte *>(s.key);
       int cls = 0;
-      __arena *o = __va_contains(u) ? __owner_of(u) : nullptr;
+      __arena *o = __owner_of(u);
       if ( o && o != self )
         cls = 3;
       else if ( o == self ) {
         int kind = 0;
         __guard_read([&] { kind = o->__doctor_tier_kind(reinterpret_cast<addr_t *>(u)); });
-        cls = (kind == 1) ? 1 : (kind == 2) ? 2 : 0;
+        cls = (kind == 1) ? 1 : (kind == 2) ? 2 : (kind == 3) ? 4 : (kind == 4) ? 5 : 0;
       }
       ++cls_cnt[cls];
       cls_bytes[cls] += s.req_size;
@@ -1037,8 +1015,9 @@ leaks(void)
   __d(" (");
   __d_u(total_bytes);
   __d(" B)\n");
-  static const char *const names[4] = { "unresolved/internal", "TLSF (user)", "buddy (user)", "cross-thread" };
-  for ( int c = 0; c < 4; ++c )
+  static const char *const names[6]
+      = { "unresolved/internal", "TLSF (user)", "buddy/run (user)", "cross-thread", "slab (user)", "mapped (user)" };
+  for ( int c = 0; c < 6; ++c )
     if ( cls_cnt[c] ) {
       __d("    ");
       __d(names[c]);
@@ -1085,11 +1064,11 @@ stats(void)
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 // gdb-like forensics
 
-// kind: 1 = TLSF, 2 = buddy, 0 = unresolved
+// kind: 1 = TLSF, 2 = buddy or page run, 3 = slab (headerless), 4 = dedicated mapping (headerless), 0 = unresolved
 inline const char *
 __kind_name(int kind) noexcept
 {
-  return kind == 1 ? "TLSF" : kind == 2 ? "buddy" : "unresolved";
+  return kind == 1 ? "TLSF" : kind == 2 ? "buddy/run" : kind == 3 ? "slab" : kind == 4 ? "mapped" : "unresolved";
 }
 
 inline void
@@ -1140,20 +1119,32 @@ __flags_known(i32 f) noexcept
 inline void
 __decode_header(byte *user, usize user_size, int kind, bool expect_live, const __rec *rec) noexcept
 {
-  if ( kind != 1 && kind != 2 ) {
+  if ( kind == 2 ) {
+    __d("  header       none (buddy block or page run; length and state live in the sheet's tag table)\n");
+    return;
+  }
+  if ( kind == 3 ) {
+    __d("  header       none (headerless slab object; size comes from its run's class)\n");
+    return;
+  }
+  if ( kind == 4 ) {
+    __d("  header       none (dedicated mapping; size is the mapping length)\n");
+    return;
+  }
+  if ( kind != 1 ) {
     __d("  header       (allocator kind unresolved; block not in any tier)\n");
     return;
   }
-  byte *h = (kind == 1) ? user - __hdr_offset : user + user_size;      // buddy header lives at the block tail
-  const usize hdr_n = (kind == 1) ? __hdr_offset : 2 * sizeof(i32);
+  (void)user_size;
+  byte *h = user - __hdr_offset;
+  const usize hdr_n = __hdr_offset;
   byte c[__hdr_offset] = {};
   const bool readable = __guard_read([&] {
     for ( usize i = 0; i < hdr_n; ++i ) c[i] = h[i];      // copy under guard; decode outside
   });
 
   const u32 shadow = (rec && rec->state == __rec_state::live) ? rec->hdr_shadow : 0;
-  const bool tlsf_shadow = shadow && kind == 1 && !(shadow & __hdr_shadow_buddy_captured);
-  const bool buddy_shadow = shadow && kind == 2 && (shadow & __hdr_shadow_buddy_captured);
+  const bool tlsf_shadow = shadow != 0;
 
   const auto field_flags = [&](i32 f) {
     const bool ok = __flags_known(f) && (!expect_live || (f & __block_alloc));
@@ -1176,11 +1167,10 @@ __decode_header(byte *user, usize user_size, int kind, bool expect_live, const _
 
   if ( !readable ) {
     __d("  header       (");
-    __d(kind == 1 ? "tlsf_hdr" : "block_header");
-    __d(" slot unreadable @");
+    __d("tlsf_hdr slot unreadable @");
     __d_ptr(h);
     __d("; raw window below)\n");
-  } else if ( kind == 1 ) {
+  } else {
     u32 bsize = 0;
     i32 flags = 0;
     u64 prev_phys = 0, next_free = 0, prev_free = 0;
@@ -1230,40 +1220,6 @@ __decode_header(byte *user, usize user_size, int kind, bool expect_live, const _
     field_link("next_free  ", next_free, "unvalidated (free link; stale while allocated)");
     field_link("prev_free  ", prev_free, "unvalidated (free link; stale while allocated)");
     __d("  };\n");
-  } else {
-    i32 order = 0;
-    i32 flags = 0;
-    __builtin_memcpy(&order, c + 0, sizeof(order));
-    __builtin_memcpy(&flags, c + 4, sizeof(flags));
-    __d("  header       struct block_header {   // @");
-    __d_ptr(h);
-    __d(" = user+");
-    __d_u(user_size);
-    __d(" (buddy tail)  metadata.hpp:35\n");
-    const i32 want_order = buddy_shadow ? static_cast<i32>(shadow & ~__hdr_shadow_buddy_captured) : 0;
-    const bool order_ok = buddy_shadow ? (order == want_order) : (order >= 0 && order <= 25);
-    __d("    i32       order      = ");
-    __d_i(order);
-    __d(";");
-    if ( !order_ok )
-      __d("  <-- BAD");
-    else
-      __d(buddy_shadow ? "   // matches alloc-time snapshot" : "   // plausible (no alloc-time snapshot)");
-    __d_nl();
-    if ( !order_ok ) {
-      __d_bad_begin();
-      if ( buddy_shadow ) {
-        __d("    i32       order      = ");
-        __d_i(want_order);
-        __d(";   // SHOULD READ (alloc-time snapshot)");
-      } else {
-        __d("    i32       order      = ?;   // SHOULD READ: 0..25 (exact unknown: no alloc-time snapshot)");
-      }
-      __d_bad_end();
-      __d_nl();
-    }
-    field_flags(flags);
-    __d("  };   // 8 of 32 tail-slot bytes used (free_list.hpp:41)\n");
   }
   __d("    raw [hdr-8, hdr+32):\n");
   __splat_window(h, __hdr_offset);
@@ -1520,14 +1476,7 @@ __check_header_ok(byte *user, usize user_size, int kind) noexcept
     __builtin_memcpy(&flags, user - __hdr_offset + 4, sizeof(flags));
     return bsize == static_cast<u32>(user_size + __hdr_offset) && __alloc_flags_ok(flags);
   }
-  if ( kind == 2 ) {
-    i32 order = 0;
-    i32 flags = 0;
-    __builtin_memcpy(&order, user + user_size, sizeof(order));
-    __builtin_memcpy(&flags, user + user_size + 4, sizeof(flags));
-    return order >= 0 && order <= 25 && __alloc_flags_ok(flags);
-  }
-  return true;
+  return true;      // buddy and run state is out of band, walked by the sheet itself
 }
 
 inline __rec *
@@ -1642,7 +1591,7 @@ __sweep_all_locked(const char *cause, bool verbose) noexcept
       if ( r.state != __rec_state::live ) continue;
       byte *u = reinterpret_cast<byte *>(r.key);
       ++ctx.live_checked;
-      if ( !__va_contains(u) ) {
+      if ( !__va_contains(u) and !__owner_of(u) ) {
         ctx.note("live record: pointer not in abcmalloc VA region", u);
         continue;
       }
@@ -1672,14 +1621,9 @@ __sweep_all_locked(const char *cause, bool verbose) noexcept
           ctx.note("live record: recorded request exceeds the real block size (ledger/allocator disagree -- corruption)", u);
         if constexpr ( __default_doctor_canary ) {
           bool hdr_shadow_ok = true;
-          if ( kind && r.hdr_shadow ) {
+          if ( kind == 1 && r.hdr_shadow ) {
             u32 cur = 0;
-            if ( kind == 1 )
-              __builtin_memcpy(&cur, u - __hdr_offset, sizeof(cur));
-            else {
-              __builtin_memcpy(&cur, u + sz, sizeof(cur));
-              cur = __hdr_shadow_buddy_captured | cur;      // match the captured marker armed for buddy blocks
-            }
+            __builtin_memcpy(&cur, u - __hdr_offset, sizeof(cur));
             if ( cur != r.hdr_shadow ) {
               hdr_shadow_ok = false;
               ctx.note("live record: header structural field changed since alloc (metadata overwrite)", u);
@@ -1768,14 +1712,6 @@ __repair_header_locked(byte *user, usize user_size, int kind) noexcept
     __d("  RESCUE       rewrote tlsf_hdr {bsize,flags} to live form (temporal bit preserved)\n");
     return __check_header_ok(user, user_size, kind);
   }
-  if ( kind == 2 ) {
-    i32 old = 0;
-    __builtin_memcpy(&old, user + user_size + 4, sizeof(old));
-    i32 flags = __block_alloc | (old & __block_temporal);      // preserve temporal (rings still reference it)
-    __builtin_memcpy(user + user_size + 4, &flags, sizeof(flags));
-    __d("  RESCUE       rewrote buddy block_header.flags to allocated form (temporal bit preserved)\n");
-    return __check_header_ok(user, user_size, kind);
-  }
   return false;
 }
 
@@ -1999,21 +1935,13 @@ __report_hw_fault(int sig, const void *addr, const void *uctx) noexcept
           __d_nl();
           const uintptr_t hbase = f->key;
           int hkind = 0;
-          usize husz = 0;
-          if ( f->hdr_shadow && !(f->hdr_shadow & __hdr_shadow_buddy_captured) )
+          if ( f->hdr_shadow )
             hkind = 1;
           else {
             __arena *o = __owner_of(reinterpret_cast<const void *>(hbase));
             if ( o && o == __tls_arena ) {
               int k = 0;
-              usize s2 = 0;
-              if ( __guard_read([&] {
-                     k = o->__doctor_tier_kind(reinterpret_cast<addr_t *>(hbase));
-                     s2 = o->__size_of_alloc(reinterpret_cast<addr_t *>(hbase));
-                   }) ) {
-                hkind = k;
-                husz = s2;
-              }
+              if ( __guard_read([&] { k = o->__doctor_tier_kind(reinterpret_cast<addr_t *>(hbase)); }) ) hkind = k;
             }
           }
           if ( hkind == 1 ) {
@@ -2021,14 +1949,13 @@ __report_hw_fault(int sig, const void *addr, const void *uctx) noexcept
             __d_ptr(reinterpret_cast<const void *>(hbase - __hdr_offset));
             __d(" (base-32); raw [hdr-8, hdr+32):\n");
             __splat_window(reinterpret_cast<const void *>(hbase - __hdr_offset), __hdr_offset);
-          } else if ( hkind == 2 && husz ) {
-            __d("  header       block_header @");
-            __d_ptr(reinterpret_cast<const void *>(hbase + husz));
-            __d(" (base+");
-            __d_u(husz);
-            __d(", buddy tail); raw [hdr-8, hdr+32):\n");
-            __splat_window(reinterpret_cast<const void *>(hbase + husz), __hdr_offset);
-          } else
+          } else if ( hkind == 2 )
+            __d("  header       none (buddy block or page run, state in the tag table)\n");
+          else if ( hkind == 3 )
+            __d("  header       none (headerless slab object)\n");
+          else if ( hkind == 4 )
+            __d("  header       none (dedicated mapping)\n");
+          else
             __d("  header       (tier/tail unresolved for this block; header not splatted)\n");
         } else
           __d("  ledger       no tracked block contains this address (wild pointer / metadata)\n");
@@ -2146,7 +2073,7 @@ on_corruption(byte *ptr, const char *kind, const char *file, int line) noexcept
     if constexpr ( !__default_doctor_rescue_conservative ) {
       // aggressive: attempt an in-place structural repair of the block header
       // WARNING: only touch our own arena; repairing another thread's live arena races it
-      __arena *o = __va_contains(ptr) ? __owner_of(ptr) : nullptr;
+      __arena *o = __owner_of(ptr);
       if ( o && o == __tls_arena && usz ) {
         const int kind2 = o->__doctor_tier_kind(reinterpret_cast<addr_t *>(ptr));
         const usize sz2 = o->__size_of_alloc(reinterpret_cast<addr_t *>(ptr));
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "metadata.hpp"
+#include "purge.hpp"
 
 #include <micron/mem.hpp>
 #include <micron/memory/cmemory.hpp>
@@ -35,20 +36,21 @@ template<typename T, i64 Min, i32 Mx = 64>
   requires(micron::is_trivially_constructible_v<T> and micron::is_trivially_destructible_v<T> and (bool)((Min & (Min - 1)) == 0))
 struct __buddy_list {
 
-  static_assert(Min >= __hdr_offset, "Min block size must be at least __hdr_offset");
   static_assert(Mx <= 64, "Mx must fit in u64 free_mask");
 
-  // header is placed at the TAIL of each region
-  //   [ usable region | __hdr_offset bytes ]
-  //                    ^block_start + order_size - __hdr_offset
-  //                    block_header lives here remaining bytes are spare for
-  //                    future metadata expansion (sizeof(block_header) < __hdr_offset)
-  //   ^-- block_start == user_ptr  (naturally aligned)
+  // blocks carry no header: the whole order size is usable
+  //   [ block 0 | block 1 | ... | block_tags[tag_count] | block_state[tag_count] ]
+  //   ^-- block_start == user_ptr  (naturally aligned, to its order size)
+  // a block's order lives in block_tags and its alloc/temporal/tombstone state in block_state, both indexed by
+  // min-block at the block start, so a power-of-two request fits its own order
 
   struct free_block {
     free_block *next;
+    u64 stamp;      // decay purge state + clock, see purge.hpp (only kept when __default_purge)
   };
 
+  static_assert(Min >= sizeof(free_block), "Min block size must hold a free_block");
+
   static constexpr int __log2_min = []() constexpr {
     int r = 0;
     i64 v = Min;
@@ -66,6 +68,9 @@ struct __buddy_list {
   static constexpr u8 __tag_free = 0x80;
   static constexpr u8 __tag_none = 0xFF;
 
+  // per-block tag + state bytes carved out of the region (tag_buf mode: the caller's buffer holds both)
+  static constexpr usize __meta_per_block = 2;
+
   static constexpr i32 __cache_cap = 4;
   // ring of temporal-active addresses per order
   static constexpr i32 __active_ring = 2;
@@ -84,6 +89,7 @@ struct __buddy_list {
   usize tombstoned_bytes;
   u64 free_mask;        // main bitmap for o(1): bit i set iff free_lists[i] != nullptr
   u8 *block_tags;       // one tag per min-block
+  u8 *block_state;      // one block_flags value per min-block, meaningful at allocated block starts
   usize tag_count;      // == total >> __log2_min
   bool tags_external;
   usize order_sizes[Mx];      // order_sizes[i] = Min << i
@@ -96,6 +102,12 @@ struct __buddy_list {
   free_block *cold_cache[Mx];
   i32 cold_count[Mx];
 
+  // zero elision (__default_zero_elide): nothing at or past clean_off has ever been handed out, so it still reads as
+  // zero apart from the link/stamp at the start of each free run there; fresh is the block the last allocation carved
+  // out of that region (its link already cleared), nullptr otherwise
+  usize clean_off;
+  byte *fresh;
+
   __attribute__((always_inline)) static inline int
   ceil_log2_u64(u64 v) noexcept
   {
@@ -118,6 +130,23 @@ struct __buddy_list {
     return order_sizes[o];
   }
 
+  __attribute__((always_inline)) inline void
+  note_carve(byte *blk, i64 o) noexcept
+  {
+    if constexpr ( __default_zero_elide ) {
+      const usize off = (usize)(blk - base);
+      const usize end = off + order_sizes[o];
+      if ( off >= clean_off ) {
+        ((free_block *)blk)->next = nullptr;
+        ((free_block *)blk)->stamp = 0;
+        fresh = blk;
+      } else {
+        fresh = nullptr;
+      }
+      if ( end > clean_off ) clean_off = end;
+    }
+  }
+
   __attribute__((always_inline)) inline usize
   tag_index_of(usize off) const noexcept
   {
@@ -183,24 +212,16 @@ struct __buddy_list {
     return o + __builtin_ctzll(m);
   }
 
-  __attribute__((always_inline)) inline block_header *
-  hdr_of(byte *block_start, i64 o) const noexcept
-  {
-    return reinterpret_cast<block_header *>(block_start + order_sizes[o] - __hdr_offset);
-  }
-
-  __attribute__((always_inline)) inline const block_header *
-  hdr_of(const byte *block_start, i64 o) const noexcept
+  __attribute__((always_inline)) inline i32
+  state_of(const byte *block_start) const noexcept
   {
-    return reinterpret_cast<const block_header *>(block_start + order_sizes[o] - __hdr_offset);
+    return static_cast<i32>(block_state[(usize)(block_start - base) >> __log2_min]);
   }
 
-  __attribute__((always_inline)) inline block_header *
-  hdr_of_tagged(byte *block_start) const noexcept
+  __attribute__((always_inline)) inline void
+  set_state(const byte *block_start, i32 f) noexcept
   {
-    u8 tag = block_tags[tag_index(block_start)];
-    i64 o = static_cast<i64>(tag & ~__tag_free);
-    return hdr_of(block_start, o);
+    block_state[(usize)(block_start - base) >> __log2_min] = static_cast<u8>(f);
   }
 
   // guard against corrupted heads/links
@@ -240,6 +261,7 @@ struct __buddy_list {
     free_block *nb = (free_block *)addr;
     nb->next = free_lists[o];
     free_lists[o] = nb;
+    if constexpr ( __default_purge ) nb->stamp = __purge_stamp();
     mask_set(o);
     tag_set_free(addr, o);
   }
@@ -250,6 +272,7 @@ struct __buddy_list {
     free_block *nb = (free_block *)addr;
     nb->next = free_lists[o];
     free_lists[o] = nb;
+    if constexpr ( __default_purge ) nb->stamp = __purge_stamp();
     mask_set(o);
     tag_set_free_at(off >> __log2_min, o);
   }
@@ -418,10 +441,11 @@ struct __buddy_list {
         return;
       }
       total = data_usable;
+      block_state = ext_tags + (total >> __log2_min);
     } else {
 
       tags_external = false;
-      usize approx_tags = (usable + Min) / (Min + 1);
+      usize approx_tags = (__meta_per_block * usable + Min + 1) / (Min + __meta_per_block);
       usize tag_area = (approx_tags + Min - 1) & ~(usize)(Min - 1);
       if ( tag_area >= usable ) {
         base = nullptr;
@@ -431,8 +455,9 @@ struct __buddy_list {
         block_tags = nullptr;
         return;
       }
-      block_tags = aligned;
-      base = aligned + tag_area;
+      // tags go at the tail so base keeps the chunk's own alignment: a block is then aligned to its order size in
+      // absolute terms (up to whatever the chunk is aligned to, __sheet_align for carved sheets)
+      base = aligned;
       usize data_usable = usable - tag_area;
       data_usable = (data_usable / Min) * Min;
       if ( data_usable < Min ) {
@@ -444,6 +469,8 @@ struct __buddy_list {
         return;
       }
       total = data_usable;
+      block_tags = aligned + data_usable;
+      block_state = block_tags + (total >> __log2_min);
     }
 
     tag_count = total >> __log2_min;
@@ -465,6 +492,7 @@ struct __buddy_list {
 
     free_lists[max_order - 1] = (free_block *)base;
     free_lists[max_order - 1]->next = nullptr;
+    if constexpr ( __default_purge ) free_lists[max_order - 1]->stamp = __purge_stamp();
     mask_set(max_order - 1);
     tag_set_free(base, max_order - 1);
   }
@@ -474,8 +502,8 @@ struct __buddy_list {
   __buddy_list(void) = delete;
 
   __buddy_list(const T &mem) noexcept
-      : base(nullptr), total(0), max_order(0), allocated_bytes(0), tombstoned_bytes(0), free_mask(0), block_tags(nullptr), tag_count(0),
-        tags_external(false)
+      : base(nullptr), total(0), max_order(0), allocated_bytes(0), tombstoned_bytes(0), free_mask(0), block_tags(nullptr),
+        block_state(nullptr), tag_count(0), tags_external(false), clean_off(0), fresh(nullptr)
   {
     __impl_zero_arrays();
     if ( mem.zero() or mem.len < Min ) micron::abort();
@@ -483,8 +511,8 @@ struct __buddy_list {
   }
 
   __buddy_list(const T &mem, u8 *tag_buf) noexcept
-      : base(nullptr), total(0), max_order(0), allocated_bytes(0), tombstoned_bytes(0), free_mask(0), block_tags(nullptr), tag_count(0),
-        tags_external(true)
+      : base(nullptr), total(0), max_order(0), allocated_bytes(0), tombstoned_bytes(0), free_mask(0), block_tags(nullptr),
+        block_state(nullptr), tag_count(0), tags_external(true), clean_off(0), fresh(nullptr)
   {
     __impl_zero_arrays();
     if ( mem.zero() or mem.len < Min ) micron::abort();
@@ -495,7 +523,8 @@ struct __buddy_list {
 
   __buddy_list(__buddy_list &&o)
       : base(o.base), total(o.total), max_order(o.max_order), allocated_bytes(o.allocated_bytes), tombstoned_bytes(o.tombstoned_bytes),
-        free_mask(o.free_mask), block_tags(o.block_tags), tag_count(o.tag_count), tags_external(o.tags_external)
+        free_mask(o.free_mask), block_tags(o.block_tags), block_state(o.block_state), tag_count(o.tag_count), tags_external(o.tags_external),
+        clean_off(o.clean_off), fresh(o.fresh)
   {
     o.base = nullptr;
     o.total = 0;
@@ -504,8 +533,11 @@ struct __buddy_list {
     o.tombstoned_bytes = 0;
     o.free_mask = 0;
     o.block_tags = nullptr;
+    o.block_state = nullptr;
     o.tag_count = 0;
     o.tags_external = false;
+    o.clean_off = 0;
+    o.fresh = nullptr;
 
     for ( i64 i = 0; i < Mx; ++i ) {
       free_lists[i] = o.free_lists[i];
@@ -544,8 +576,11 @@ struct __buddy_list {
     tombstoned_bytes = o.tombstoned_bytes;
     free_mask = o.free_mask;
     block_tags = o.block_tags;
+    block_state = o.block_state;
     tag_count = o.tag_count;
     tags_external = o.tags_external;
+    clean_off = o.clean_off;
+    fresh = o.fresh;
 
     o.base = nullptr;
     o.total = 0;
@@ -554,8 +589,11 @@ struct __buddy_list {
     o.tombstoned_bytes = 0;
     o.free_mask = 0;
     o.block_tags = nullptr;
+    o.block_state = nullptr;
     o.tag_count = 0;
     o.tags_external = false;
+    o.clean_off = 0;
+    o.fresh = nullptr;
 
     for ( i64 i = 0; i < Mx; ++i ) {
       free_lists[i] = o.free_lists[i];
@@ -582,7 +620,6 @@ struct __buddy_list {
   T
   allocate(usize n) noexcept
   {
-    n += __hdr_offset;
     if ( n == 0 ) n = 1;
     if ( !base ) return { nullptr, 0 };
     usize needed = (n + Min - 1) & ~(Min - 1);
@@ -590,12 +627,11 @@ struct __buddy_list {
     if ( o >= max_order ) return { nullptr, 0 };
 
     if ( free_block *cold = cold_pop(o) ) {
-      block_header *hdr = hdr_of((byte *)cold, o);
-      hdr->order = static_cast<i32>(o);
-      hdr->flags = __block_alloc;
+      note_carve((byte *)cold, o);
+      set_state((byte *)cold, __block_alloc);
       tag_set_alloc((byte *)cold, o);
       allocated_bytes += order_sizes[o];
-      return { (byte *)cold, order_sizes[o] - __hdr_offset };
+      return { (byte *)cold, order_sizes[o] };
     }
 
     i64 i = find_free_order(o);
@@ -616,20 +652,17 @@ struct __buddy_list {
       freelist_push(right, i);
     }
 
-    // write header at the tail of the block
-    block_header *hdr = hdr_of((byte *)blk, o);
-    hdr->order = static_cast<i32>(o);
-    hdr->flags = __block_alloc;
+    note_carve((byte *)blk, o);
+    set_state((byte *)blk, __block_alloc);
     tag_set_alloc((byte *)blk, o);
     allocated_bytes += order_sizes[o];
 
-    return { (byte *)blk, order_sizes[o] - __hdr_offset };
+    return { (byte *)blk, order_sizes[o] };
   }
 
   T
   temporal_allocate(usize n) noexcept
   {
-    n += __hdr_offset;
     if ( n == 0 ) n = 1;
     if ( !base ) return { nullptr, 0 };
 
@@ -638,32 +671,32 @@ struct __buddy_list {
     if ( o >= max_order ) return { nullptr, 0 };
 
     usize target_size = order_sizes[o];
+    if constexpr ( __default_zero_elide ) fresh = nullptr;
 
     const u8 r0 = active_rotor[o];
     if ( active[o][r0] != nullptr ) {
       free_block *blk = active[o][r0];
       active_rotor[o] = static_cast<u8>((r0 + 1) % __active_ring);
-      return { reinterpret_cast<byte *>(blk), target_size - __hdr_offset };
+      return { reinterpret_cast<byte *>(blk), target_size };
     }
     for ( i32 j = 1; j < __active_ring; ++j ) {
       const u8 jj = static_cast<u8>((r0 + j) % __active_ring);
       if ( active[o][jj] != nullptr ) {
         free_block *blk = active[o][jj];
         active_rotor[o] = static_cast<u8>((jj + 1) % __active_ring);
-        return { reinterpret_cast<byte *>(blk), target_size - __hdr_offset };
+        return { reinterpret_cast<byte *>(blk), target_size };
       }
     }
 
     free_block *cached = tcache_pop(o);
     if ( cached ) {
-      block_header *hdr = hdr_of((byte *)cached, o);
-      hdr->order = static_cast<i32>(o);
-      hdr->flags = __block_alloc | __block_temporal;
+      note_carve((byte *)cached, o);
+      set_state((byte *)cached, __block_alloc | __block_temporal);
       tag_set_alloc((byte *)cached, o);
       allocated_bytes += target_size;
       active[o][r0] = cached;
       active_rotor[o] = static_cast<u8>((r0 + 1) % __active_ring);
-      return { (byte *)cached, target_size - __hdr_offset };
+      return { (byte *)cached, target_size };
     }
 
     i64 i = find_free_order(o);
@@ -680,16 +713,15 @@ struct __buddy_list {
       freelist_push(right, i);
     }
 
-    block_header *hdr = hdr_of((byte *)blk, o);
-    hdr->order = static_cast<i32>(o);
-    hdr->flags = __block_alloc | __block_temporal;
+    note_carve((byte *)blk, o);
+    set_state((byte *)blk, __block_alloc | __block_temporal);
     tag_set_alloc((byte *)blk, o);
     allocated_bytes += target_size;
 
     active[o][r0] = blk;
     active_rotor[o] = static_cast<u8>((r0 + 1) % __active_ring);
 
-    return { (byte *)blk, target_size - __hdr_offset };
+    return { (byte *)blk, target_size };
   }
 
   T
@@ -707,25 +739,22 @@ struct __buddy_list {
     free_lists[o] = __link_valid(__nx) ? __nx : nullptr;      // hard contain a poisoned link
     mask_clear_if_empty(o);
 
-    block_header *hdr = hdr_of((byte *)blk, o);
-    hdr->order = static_cast<i32>(o);
-    hdr->flags = __block_alloc;
+    note_carve((byte *)blk, o);
+    set_state((byte *)blk, __block_alloc);
     tag_set_alloc((byte *)blk, o);
     allocated_bytes += order_sizes[o];
 
-    return { (byte *)blk, order_sizes[o] - __hdr_offset };
+    return { (byte *)blk, order_sizes[o] };
   }
 
   ret_flag
   tombstone(byte *ptr) noexcept
   {
     if ( !is_allocated(ptr) ) return { __flag_invalid };
-    block_header *hdr = hdr_of_tagged(ptr);
-    i64 o = static_cast<i64>(hdr->order);
-    if ( o < 0 || o >= max_order ) return { __flag_invalid };
-    if ( !(hdr->flags & __block_alloc) ) return { __flag_invalid };
+    const i64 o = static_cast<i64>(block_tags[tag_index(ptr)]);
+    if ( !(state_of(ptr) & __block_alloc) ) return { __flag_invalid };
 
-    hdr->flags = __block_tombstone;
+    set_state(ptr, __block_tombstone);
     allocated_bytes -= order_sizes[o];
     tombstoned_bytes += order_sizes[o];
 
@@ -742,35 +771,31 @@ struct __buddy_list {
   bool
   is_tombstoned(byte *ptr) const noexcept
   {
-    block_header *hdr = hdr_of_tagged(ptr);
-    return (hdr->flags & __block_tombstone) != 0;
+    return (state_of(ptr) & __block_tombstone) != 0;
   }
 
   bool
   is_temporal(byte *ptr) noexcept
   {
-    block_header *hdr = hdr_of_tagged(ptr);
-    return (hdr->flags & __block_temporal) != 0;
+    return (state_of(ptr) & __block_temporal) != 0;
   }
 
   ret_flag
   deallocate(byte *ptr) noexcept
   {
-    // WARNING: validate a min-block-aligned, authoritatively-allocated block START before any header access
+    // WARNING: validate a min-block-aligned, authoritatively-allocated block START before any tag/state access
     // protects against forged/out-of-range ptrs
     if ( !is_allocated(ptr) ) return { __flag_invalid };
     byte *addr = ptr;
-    block_header *hdr = hdr_of_tagged(addr);
-    const i64 original_o = static_cast<i64>(hdr->order);
-    if ( original_o < 0 || original_o >= max_order ) return { __flag_invalid };
-    if ( !base || !addr ) return __flag_failure;
-    if ( hdr->flags == __block_free ) return { __flag_invalid };
+    const i64 original_o = static_cast<i64>(block_tags[tag_index(addr)]);
+    const i32 st = state_of(addr);
+    if ( st == __block_free ) return { __flag_invalid };
 
     allocated_bytes -= order_sizes[original_o];
-    if ( hdr->flags & __block_tombstone ) tombstoned_bytes -= order_sizes[original_o];
+    if ( st & __block_tombstone ) tombstoned_bytes -= order_sizes[original_o];
 
-    bool was_temporal = (hdr->flags & __block_temporal) != 0;
-    hdr->flags = __block_free;
+    bool was_temporal = (st & __block_temporal) != 0;
+    set_state(addr, __block_free);
 
     for ( i32 r = 0; r < __active_ring; ++r ) {
       if ( active[original_o][r] == (free_block *)addr ) {
@@ -800,6 +825,40 @@ struct __buddy_list {
     return deallocate(node.ptr);
   }
 
+  // grow a live block in place by promoting it order by order over its free right buddies
+  // only succeeds if the block is the left half at every level up to the target order and each
+  // right buddy is free whole at that order; temporal/tombstoned blocks never grow
+  T
+  grow_in_place(byte *ptr, usize n) noexcept
+  {
+    if ( !is_allocated(ptr) ) return { nullptr, 0 };
+    const usize off = (usize)(ptr - base);
+    const i64 o = static_cast<i64>(block_tags[tag_index_of(off)]);
+    if ( state_of(ptr) != __block_alloc ) return { nullptr, 0 };
+
+    const i64 t = order_for_size((n + Min - 1) & ~(Min - 1));
+    if ( t <= o ) return { ptr, order_sizes[o] };
+    if ( t >= max_order || off + order_sizes[t] > total ) return { nullptr, 0 };
+
+    for ( i64 k = o; k < t; ++k ) {
+      if ( off & order_sizes[k] ) return { nullptr, 0 };
+      if ( !tag_is_free_at_off(off + order_sizes[k], k) ) return { nullptr, 0 };
+    }
+    for ( i64 k = o; k < t; ++k ) {
+      const usize buddy_off = off + order_sizes[k];
+      freelist_remove(base + buddy_off, k);
+      block_tags[buddy_off >> __log2_min] = __tag_none;
+    }
+
+    if constexpr ( __default_zero_elide ) {
+      if ( off + order_sizes[t] > clean_off ) clean_off = off + order_sizes[t];
+    }
+    tag_set_alloc(ptr, t);
+    allocated_bytes += order_sizes[t] - order_sizes[o];
+
+    return { ptr, order_sizes[t] };
+  }
+
   T
   reallocate(T node, usize new_size) noexcept
   {
@@ -811,6 +870,10 @@ struct __buddy_list {
     }
 
     if ( node.len >= new_size && new_size > (node.len >> 1) ) return node;
+    if ( node.len < new_size ) {
+      T grown = grow_in_place(node.ptr, new_size);
+      if ( grown.ptr ) return grown;
+    }
 
     T nnode = allocate(new_size);
     if ( !nnode.ptr ) return { nullptr, 0 };
@@ -821,6 +884,14 @@ struct __buddy_list {
     return nnode;
   }
 
+  // ptr is the block the last allocation carved out of never-handed-out memory; its usable bytes all read as zero
+  bool
+  known_zero(const byte *ptr) const noexcept
+  {
+    if constexpr ( __default_zero_elide ) return fresh != nullptr and ptr == fresh;
+    return false;
+  }
+
   usize
   available() const noexcept
   {
@@ -846,6 +917,21 @@ struct __buddy_list {
     return allocated_bytes;
   }
 
+  // ages every free run spanning at least two grains; the first grain (links, stamp) stays resident
+  usize
+  purge(u64 now, usize grain) noexcept
+  {
+    if ( !base ) return 0;
+    usize n = 0;
+    for ( i64 o = 0; o < max_order; ++o ) {
+      if ( order_sizes[o] < 2 * grain ) continue;
+      for ( free_block *b = free_lists[o]; b != nullptr; b = __link_valid(b->next) ? b->next : nullptr )
+        n += __purge_run(reinterpret_cast<byte *>(b) + sizeof(free_block), reinterpret_cast<byte *>(b) + order_sizes[o],
+                         b->stamp, now, grain);
+    }
+    return n;
+  }
+
   usize
   block_size(byte *ptr) const noexcept
   {
@@ -906,24 +992,15 @@ struct __buddy_list {
       if ( ((usize)(blk - base) & (osz - 1)) != 0 ) v.note("buddy: block not aligned to its order size", blk);
 
       const bool tag_free = (tag & __tag_free) != 0;
-      // the tail block_header is a maintained redundant copy
-      // only for allocated blocks
+      // allocated blocks keep their state out of band, next to the tag
       if ( !tag_free ) {
-        block_header *h = hdr_of(blk, o);
-        if ( h->order != static_cast<i32>(o) ) {
-          v.note("buddy: allocated block tail header order != block_tags order", blk);
-          if ( v.repair ) {
-            h->order = static_cast<i32>(o);
-            v.did_repair("buddy: rewrote tail header order from tag", blk);
-          }
-        }
-        const bool flags_alloc
-            = (h->flags == __block_alloc || h->flags == (__block_alloc | __block_temporal) || h->flags == __block_tombstone);
+        const i32 f = state_of(blk);
+        const bool flags_alloc = (f == __block_alloc || f == (__block_alloc | __block_temporal) || f == __block_tombstone);
         if ( !flags_alloc ) {
-          v.note("buddy: allocated block tail header flags not allocated", blk);
+          v.note("buddy: allocated block state not in an allocated form", blk);
           if ( v.repair ) {
-            h->flags = __block_alloc | (h->flags & __block_temporal);
-            v.did_repair("buddy: reset tail header flags to allocated form", blk);
+            set_state(blk, __block_alloc | (f & __block_temporal));
+            v.did_repair("buddy: reset block state to allocated form", blk);
           }
         }
       }
@@ -136,9 +136,9 @@ check_alignment(const addr_t *addr)
 // ...user_ptr = block + __hdr_offset
 // ...bsize = *(u32*)(user_ptr - __hdr_offset)
 
-// buddy layout: [user_data ... | block_header]
+// buddy layout: [user_data ...]
 // ...user_ptr = block_start
-// ...header is at block_start + order_size - __hdr_offset (at TAIL)
+// ...no header, order and state are out of band in the sheet's tag table
 
 inline __attribute__((always_inline)) void
 sanitize_on_alloc([[maybe_unused]] byte *addr, [[maybe_unused]] usize sz)
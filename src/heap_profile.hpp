@@ -0,0 +1,559 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "backtrace.hpp"
+#include "config.hpp"
+#include "va_reserve.hpp"
+
+#include <micron/memory/allocation/kmemory.hpp>
+#include <micron/syscall.hpp>
+#include <micron/types.hpp>
+
+// sampled heap profiler (__default_heap_profile)
+// compiled in, idle until abc::profile_start(rate). every arena counts allocated bytes down to its next sample, the
+// gap drawn from an exponential with mean `rate`: each byte is equally likely to be the sampled one, so a block of s
+// bytes is caught with probability 1 - e^(-s / rate) and the profile unsamples exactly. a sample keeps the block's
+// address, size and a frame-pointer backtrace in its arena's record table. only the thread holding the arena writes
+// the table (its owner, or whoever holds a per-CPU arena's lock), so sampling adds no lock and no atomic RMW;
+// profile_dump() reads it from any thread, a per-record sequence number skipping records caught mid-rewrite. a free looks in the table only when its granule holds a sample
+namespace abc
+{
+
+enum class profile_format : u32 {
+  pprof,          // gperftools heap_v2 text, raw sampled counts + rate, MAPPED_LIBRARIES for symbolization
+  collapsed,      // one `root;...;leaf bytes` line per stack, unsampled, for flamegraph.pl / speedscope
+};
+
+struct heap_profile_stats {
+  u64 samples;           // blocks sampled since the arenas came up
+  u64 live;              // sampled blocks not yet freed
+  u64 live_bytes;        // their sizes, not unsampled
+  u64 dropped;           // samples lost to a full record table
+};
+
+// mean bytes between samples, 0 == idle; each arena reads it when its countdown runs out. __prof_last_rate is what
+// profile_dump() reports after profile_stop(), the samples taken before it still describe the heap
+inline u64 __prof_rate = 0;
+inline u64 __prof_last_rate = __prof_default_rate;
+
+// an idle arena rereads __prof_rate after this many bytes, so profile_start() reaches every thread quickly
+constexpr static const i64 __prof_idle_recheck = 1 << 20;
+
+constexpr static const u32 __prof_mask = __prof_slots - 1;
+constexpr static const u32 __prof_slots_log2 = __builtin_ctz(__prof_slots);
+static_assert(__prof_slots >= 16 and (__prof_slots & __prof_mask) == 0, "abcmalloc: __prof_slots must be a power of two.");
+static_assert(__prof_slots / 2 <= 0xFFFF, "abcmalloc: __prof_slots / 2 live samples must fit a granule's u16 count.");
+static_assert(__prof_bt_depth >= 1, "abcmalloc: __prof_bt_depth must be at least 1.");
+
+struct __prof_record {
+  u32 seq;        // odd while the owner rewrites the record
+  u32 depth;
+  byte *ptr;      // nullptr == empty slot
+  usize size;
+  void *bt[__prof_bt_depth];
+};
+
+[[gnu::always_inline]] inline u32
+__prof_home(const byte *p) noexcept
+{
+  return static_cast<u32>(((reinterpret_cast<uintptr_t>(p) >> 4) * 0x9E3779B97F4A7C15ull) >> (64 - __prof_slots_log2));
+}
+
+// ln x for x > 0 without libm: x = m * 2^e, m in [1, 2), ln m = 2 atanh((m - 1) / (m + 1)); ~1e-6 relative
+inline double
+__prof_ln(double x) noexcept
+{
+  u64 bits;
+  __builtin_memcpy(&bits, &x, sizeof(bits));
+  const i64 e = static_cast<i64>((bits >> 52) & 0x7FF) - 1023;
+  bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+  double m;
+  __builtin_memcpy(&m, &bits, sizeof(m));
+  const double t = (m - 1.0) / (m + 1.0);
+  const double t2 = t * t;
+  const double lnm = 2.0 * t * (1.0 + t2 * (1.0 / 3.0 + t2 * (1.0 / 5.0 + t2 * (1.0 / 7.0 + t2 * (1.0 / 9.0)))));
+  return lnm + static_cast<double>(e) * 0.6931471805599453;
+}
+
+// e^-x for x >= 0: 2^-k * e^-r with r = x - k ln 2 in [0, ln 2), e^-r by its series
+inline double
+__prof_exp_neg(double x) noexcept
+{
+  if ( x >= 700.0 ) return 0.0;
+  const u64 k = static_cast<u64>(x * 1.4426950408889634);
+  const double r = x - static_cast<double>(k) * 0.6931471805599453;
+  double term = 1.0;
+  double sum = 1.0;
+  for ( u32 i = 1; i <= 12; ++i ) {
+    term *= -r / static_cast<double>(i);
+    sum += term;
+  }
+  const u64 bits = (1023 - k) << 52;
+  double scale;
+  __builtin_memcpy(&scale, &bits, sizeof(scale));
+  return sum * scale;
+}
+
+// expected number of blocks (and, times size, bytes) one sample of a size-byte block stands for
+inline double
+__prof_unsample(usize size, u64 rate) noexcept
+{
+  const double p = 1.0 - __prof_exp_neg(static_cast<double>(size) / static_cast<double>(rate));
+  return p > 0.0 ? 1.0 / p : 1.0;
+}
+
+inline u64 __prof_seed_counter = 0;
+
+// per-arena sampler; the arena holds one and calls it from its alloc/free paths (arena.hpp)
+struct __heap_sampler {
+  i64 left = 0;      // bytes until the next sample; starts spent so the first alloc reads __prof_rate
+  u64 rng = 0;
+  __prof_record *table = nullptr;
+  u32 live = 0;
+  u64 samples = 0;
+  u64 live_bytes = 0;
+  u64 dropped = 0;
+
+  [[gnu::always_inline]] inline void
+  on_alloc(byte *p, usize sz) noexcept
+  {
+    if constexpr ( __default_heap_profile ) {
+      if ( (left -= static_cast<i64>(sz)) < 0 ) [[unlikely]]
+        __sample(p, sz);
+    }
+  }
+
+  // before the block goes back to its sheet, so a sample never outlives its address
+  [[gnu::always_inline]] inline void
+  on_free(byte *p) noexcept
+  {
+    if constexpr ( __default_heap_profile ) {
+      if ( live == 0 ) return;
+      if ( const __granule_entry *g = __granule_of(p); g and g->prof_samples == 0 ) return;
+      __forget(p);
+    }
+  }
+
+  // a realloc that kept or moved the block: the sample follows it with the new size
+  [[gnu::always_inline]] inline void
+  on_resize(byte *from, byte *to, usize sz) noexcept
+  {
+    if constexpr ( __default_heap_profile ) {
+      if ( live == 0 ) return;
+      __move(from, to, sz);
+    }
+  }
+
+  // every sample inside [lo, hi), for a sheet reset wholesale
+  void
+  forget_range(const byte *lo, const byte *hi) noexcept
+  {
+    if ( live == 0 ) return;
+    for ( u32 i = 0; i < __prof_slots; ) {
+      const byte *p = table[i].ptr;
+      if ( p != nullptr and p >= lo and p < hi )
+        __erase_at(i);      // the shift may pull the next record into i, look at it again
+      else
+        ++i;
+    }
+  }
+
+  // calls fn(const __prof_record &) for every consistent record; safe from any thread
+  template<typename Fn>
+  void
+  each(Fn &&fn) const noexcept
+  {
+    const __prof_record *t = __atomic_load_n(&table, __ATOMIC_ACQUIRE);
+    if ( t == nullptr ) return;
+    __prof_record r;
+    for ( u32 i = 0; i < __prof_slots; ++i ) {
+      const u32 s0 = __atomic_load_n(&t[i].seq, __ATOMIC_ACQUIRE);
+      if ( s0 & 1 ) continue;
+      __builtin_memcpy(&r, &t[i], sizeof(r));
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if ( __atomic_load_n(&t[i].seq, __ATOMIC_RELAXED) != s0 or r.ptr == nullptr ) continue;
+      fn(static_cast<const __prof_record &>(r));
+    }
+  }
+
+  void
+  stats_into(heap_profile_stats &s) const noexcept
+  {
+    s.samples += __atomic_load_n(&samples, __ATOMIC_RELAXED);
+    s.live += __atomic_load_n(&live, __ATOMIC_RELAXED);
+    s.live_bytes += __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+    s.dropped += __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+  }
+
+  void
+  release(void) noexcept
+  {
+    if ( table ) micron::munmap(reinterpret_cast<addr_t *>(table), sizeof(__prof_record) * __prof_slots);
+    table = nullptr;
+    live = 0;
+  }
+
+private:
+  [[gnu::always_inline]] inline u64
+  __next_random(void) noexcept
+  {
+    if ( rng == 0 ) [[unlikely]] {
+      u64 z = reinterpret_cast<uintptr_t>(this) ^ (__atomic_fetch_add(&__prof_seed_counter, 1, __ATOMIC_RELAXED) << 32);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      rng = (z ^ (z >> 31)) | 1;
+    }
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1Dull;
+  }
+
+  // exponential gap with mean rate: -ln(u) * rate, u uniform in (0, 1]
+  i64
+  __next_gap(u64 rate) noexcept
+  {
+    const double u = static_cast<double>((__next_random() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    const double gap = -__prof_ln(u) * static_cast<double>(rate);
+    return gap < 1.0 ? 1 : (gap > 4.0e18 ? static_cast<i64>(4.0e18) : static_cast<i64>(gap));
+  }
+
+  [[gnu::cold, gnu::noinline]] void
+  __sample(byte *p, usize sz) noexcept
+  {
+    const u64 rate = __atomic_load_n(&__prof_rate, __ATOMIC_RELAXED);
+    if ( rate == 0 ) {
+      left = __prof_idle_recheck;
+      return;
+    }
+    left = __next_gap(rate);
+    void *bt[__prof_bt_depth];
+    const u32 depth = static_cast<u32>(__walk_frames(bt, __prof_bt_depth));
+    __insert(p, sz, bt, depth);
+  }
+
+  bool
+  __map_table(void) noexcept
+  {
+    addr_t *m = micron::map_normal(nullptr, sizeof(__prof_record) * __prof_slots);
+    if ( reinterpret_cast<uintptr_t>(m) >= ~static_cast<uintptr_t>(0xfff) ) [[unlikely]]
+      return false;
+    __atomic_store_n(&table, reinterpret_cast<__prof_record *>(m), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // seqlock around every rewrite of a slot, so each() never hands out half a record
+  static void
+  __put(__prof_record &r, byte *p, usize sz, void *const *bt, u32 depth) noexcept
+  {
+    const u32 s = r.seq;
+    __atomic_store_n(&r.seq, s + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    r.ptr = p;
+    r.size = sz;
+    r.depth = depth;
+    for ( u32 i = 0; i < depth; ++i ) r.bt[i] = bt[i];
+    __atomic_store_n(&r.seq, s + 2, __ATOMIC_RELEASE);
+  }
+
+  static void
+  __granule_count(const byte *p, bool up) noexcept
+  {
+    if ( __granule_entry *g = __granule_of(p); g ) {
+      if ( up )
+        ++g->prof_samples;
+      else if ( g->prof_samples )
+        --g->prof_samples;
+    }
+  }
+
+  void
+  __insert(byte *p, usize sz, void *const *bt, u32 depth) noexcept
+  {
+    if ( (table == nullptr and !__map_table()) or live >= __prof_slots / 2 ) [[unlikely]] {
+      __atomic_store_n(&dropped, dropped + 1, __ATOMIC_RELAXED);
+      return;
+    }
+    u32 i = __prof_home(p);
+    while ( table[i].ptr != nullptr ) i = (i + 1) & __prof_mask;
+    __put(table[i], p, sz, bt, depth);
+    __granule_count(p, true);
+    __atomic_store_n(&live, live + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&samples, samples + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&live_bytes, live_bytes + sz, __ATOMIC_RELAXED);
+  }
+
+  i32
+  __find(const byte *p) const noexcept
+  {
+    for ( u32 i = __prof_home(p);; i = (i + 1) & __prof_mask ) {
+      if ( table[i].ptr == p ) return static_cast<i32>(i);
+      if ( table[i].ptr == nullptr ) return -1;
+    }
+  }
+
+  // linear probing, backward-shift delete: no tombstones, so a miss always stops at the first empty slot.
+  // a record is cleared from its old slot before it is written to the hole, so it is never in two slots at once: an
+  // each() running alongside may miss a record that is being shifted, but never counts one twice
+  void
+  __erase_at(u32 i) noexcept
+  {
+    __granule_count(table[i].ptr, false);
+    __atomic_store_n(&live, live - 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&live_bytes, live_bytes - table[i].size, __ATOMIC_RELAXED);
+    __put(table[i], nullptr, 0, nullptr, 0);
+    void *bt[__prof_bt_depth];
+    for ( u32 j = i;; ) {
+      j = (j + 1) & __prof_mask;
+      byte *p = table[j].ptr;
+      if ( p == nullptr ) return;
+      // j's record may fill the hole unless the hole lies before its home slot
+      const u32 h = __prof_home(p);
+      if ( ((j - h) & __prof_mask) >= ((j - i) & __prof_mask) ) {
+        const usize sz = table[j].size;
+        const u32 depth = table[j].depth;
+        for ( u32 k = 0; k < depth; ++k ) bt[k] = table[j].bt[k];
+        __put(table[j], nullptr, 0, nullptr, 0);
+        __put(table[i], p, sz, bt, depth);
+        i = j;
+      }
+    }
+  }
+
+  [[gnu::cold, gnu::noinline]] void
+  __forget(const byte *p) noexcept
+  {
+    if ( const i32 i = __find(p); i >= 0 ) __erase_at(static_cast<u32>(i));
+  }
+
+  [[gnu::cold, gnu::noinline]] void
+  __move(byte *from, byte *to, usize sz) noexcept
+  {
+    const i32 i = __find(from);
+    if ( i < 0 ) return;
+    __prof_record &r = table[i];
+    if ( from == to ) {
+      __atomic_store_n(&live_bytes, live_bytes - r.size + sz, __ATOMIC_RELAXED);
+      __put(r, to, sz, r.bt, r.depth);
+      return;
+    }
+    void *bt[__prof_bt_depth];
+    const u32 depth = r.depth;
+    for ( u32 k = 0; k < depth; ++k ) bt[k] = r.bt[k];
+    const u64 n = samples;
+    __erase_at(static_cast<u32>(i));
+    __insert(to, sz, bt, depth);
+    __atomic_store_n(&samples, n, __ATOMIC_RELAXED);      // the same sample, not a new one
+  }
+};
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// dump: records from every arena are merged by stack in a scratch table mapped for the purpose, never from the
+// allocator itself, and written straight to a file descriptor
+
+struct __prof_stack {
+  u32 depth;
+  u64 count;
+  u64 bytes;
+  double est_bytes;
+  void *bt[__prof_bt_depth];
+};
+
+struct __prof_writer {
+  int fd;
+  bool ok = true;
+  u32 n = 0;
+  char buf[4096];
+
+  void
+  flush(void) noexcept
+  {
+    usize off = 0;
+    while ( ok and off < n ) {
+      const long w = static_cast<long>(micron::syscall(SYS_write, fd, buf + off, n - off));
+      if ( w <= 0 ) ok = false;
+      else off += static_cast<usize>(w);
+    }
+    n = 0;
+  }
+
+  void
+  put(const char *s, usize len) noexcept
+  {
+    for ( usize i = 0; i < len; ++i ) {
+      if ( n == sizeof(buf) ) flush();
+      buf[n++] = s[i];
+    }
+  }
+
+  void
+  put(const char *s) noexcept
+  {
+    put(s, __builtin_strlen(s));
+  }
+
+  void
+  dec(u64 v) noexcept
+  {
+    char tmp[20];
+    u32 k = 0;
+    do {
+      tmp[k++] = static_cast<char>('0' + v % 10);
+      v /= 10;
+    } while ( v );
+    while ( k ) put(&tmp[--k], 1);
+  }
+
+  void
+  hex(uintptr_t v) noexcept
+  {
+    char tmp[18] = { '0', 'x' };
+    u32 k = 2;
+    bool lead = true;
+    for ( i32 s = 60; s >= 0; s -= 4 ) {
+      const u32 d = static_cast<u32>((v >> s) & 0xF);
+      if ( lead and d == 0 and s != 0 ) continue;
+      lead = false;
+      tmp[k++] = static_cast<char>(d < 10 ? '0' + d : 'a' + d - 10);
+    }
+    put(tmp, k);
+  }
+};
+
+struct __prof_merge {
+  __prof_stack *s = nullptr;
+  u32 cap = 0;
+  u32 used = 0;
+  u64 rate = 1;
+
+  bool
+  init(u64 records, u64 r) noexcept
+  {
+    rate = r ? r : 1;
+    cap = 64;
+    while ( cap < records * 2 and cap < (1u << 30) ) cap <<= 1;
+    addr_t *m = micron::map_normal(nullptr, sizeof(__prof_stack) * cap);
+    if ( reinterpret_cast<uintptr_t>(m) >= ~static_cast<uintptr_t>(0xfff) ) [[unlikely]]
+      return false;
+    s = reinterpret_cast<__prof_stack *>(m);
+    return true;
+  }
+
+  ~__prof_merge(void)
+  {
+    if ( s ) micron::munmap(reinterpret_cast<addr_t *>(s), sizeof(__prof_stack) * cap);
+  }
+
+  void
+  add(const __prof_record &r) noexcept
+  {
+    if ( used * 2 >= cap ) return;      // samples taken since the count; the next dump has them
+    u64 h = r.depth;
+    for ( u32 k = 0; k < r.depth; ++k ) h = (h ^ reinterpret_cast<uintptr_t>(r.bt[k])) * 0x100000001B3ull;
+    for ( u32 i = static_cast<u32>(h) & (cap - 1);; i = (i + 1) & (cap - 1) ) {
+      __prof_stack &e = s[i];
+      if ( e.count == 0 ) {
+        e.depth = r.depth;
+        for ( u32 k = 0; k < r.depth; ++k ) e.bt[k] = r.bt[k];
+        ++used;
+      } else if ( e.depth != r.depth or __builtin_memcmp(e.bt, r.bt, sizeof(void *) * r.depth) != 0 ) {
+        continue;
+      }
+      ++e.count;
+      e.bytes += r.size;
+      e.est_bytes += __prof_unsample(r.size, rate) * static_cast<double>(r.size);
+      return;
+    }
+  }
+
+  // heap_v2 keeps the raw sampled counts; pprof unsamples them with the rate in the header
+  void
+  write_pprof(__prof_writer &w) noexcept
+  {
+    u64 tc = 0, tb = 0;
+    for ( u32 i = 0; i < cap; ++i ) {
+      tc += s[i].count;
+      tb += s[i].bytes;
+    }
+    w.put("heap profile: ");
+    w.dec(tc);
+    w.put(": ");
+    w.dec(tb);
+    w.put(" [");
+    w.dec(tc);
+    w.put(": ");
+    w.dec(tb);
+    w.put("] @ heap_v2/");
+    w.dec(rate);
+    w.put("\n");
+    for ( u32 i = 0; i < cap; ++i ) {
+      const __prof_stack &e = s[i];
+      if ( e.count == 0 ) continue;
+      w.dec(e.count);
+      w.put(": ");
+      w.dec(e.bytes);
+      w.put(" [");
+      w.dec(e.count);
+      w.put(": ");
+      w.dec(e.bytes);
+      w.put("] @");
+      for ( u32 k = 0; k < e.depth; ++k ) {
+        w.put(" ");
+        w.hex(reinterpret_cast<uintptr_t>(e.bt[k]));
+      }
+      w.put("\n");
+    }
+    // the mappings let pprof symbolize the addresses against the right binaries
+    w.put("\nMAPPED_LIBRARIES:\n");
+    const int fd = static_cast<int>(micron::syscall(SYS_open, "/proc/self/maps", 0 /*O_RDONLY*/, 0));
+    if ( fd < 0 ) return;
+    char chunk[1024];
+    for ( ;; ) {
+      const long r = static_cast<long>(micron::syscall(SYS_read, fd, chunk, sizeof(chunk)));
+      if ( r <= 0 ) break;
+      w.put(chunk, static_cast<usize>(r));
+    }
+    micron::syscall(SYS_close, fd);
+  }
+
+  // outermost frame first, estimated live bytes as the weight
+  void
+  write_collapsed(__prof_writer &w) noexcept
+  {
+    for ( u32 i = 0; i < cap; ++i ) {
+      const __prof_stack &e = s[i];
+      if ( e.count == 0 ) continue;
+      if ( e.depth == 0 ) w.put("[unknown]");
+      for ( u32 k = e.depth; k > 0; --k ) {
+        w.hex(reinterpret_cast<uintptr_t>(e.bt[k - 1]));
+        if ( k > 1 ) w.put(";");
+      }
+      w.put(" ");
+      w.dec(static_cast<u64>(e.est_bytes + 0.5));
+      w.put("\n");
+    }
+  }
+};
+
+};      // namespace abc
@@ -159,25 +159,87 @@ __get_kernel_memory(u64 sz)
   return micron::sys_allocator<byte>::alloc(sz);
 }
 
+// transparent huge pages (__default_thp). carves are already __sheet_align (2 MiB) aligned and sized on width-64,
+// so a hot sheet is a whole number of huge pages and a single madvise is all it takes. a sheet's trailing guard page
+// (__default_insert_guard_pages) leaves its last huge page on small pages
+constexpr static const usize __thp_size = static_cast<usize>(2) << 20;
+constexpr static const i32 __madv_hugepage = 14;
+constexpr static const i32 __madv_collapse = 25;
+
+template<u64 Sz>
+consteval bool
+__thp_for(void) noexcept
+{
+  return __default_thp and Sz <= __class_medium and __sheet_align >= __thp_size;
+}
+
+// smallest extent a sheet of class Sz ever gives back to the kernel on its own; a huge page is never split for part of it
+template<u64 Sz>
+consteval usize
+__purge_grain_for(void) noexcept
+{
+  return __thp_for<Sz>() ? __thp_size : __system_pagesize;
+}
+
+[[gnu::cold]] inline void
+__advise_huge(addr_t *p, usize len) noexcept
+{
+  micron::syscall(SYS_madvise, p, len, __madv_hugepage);
+  if constexpr ( __default_thp_collapse ) micron::syscall(SYS_madvise, p, len, __madv_collapse);
+}
+
+// lazy == commit on first touch (hot-tier sheets); huge == back with THP (see __thp_for).
+// a request no reservation can hold (or with no VA left to chain one) gets its own granule-aligned mapping, so it is
+// still whole granules of the owner table; those are always eager and never huge-aligned. zero chunk on failure
 template<typename T>
 inline T
-__get_kernel_chunk(u64 sz)
+__get_kernel_chunk(u64 sz, bool lazy = false, bool huge = false)
 {
-  if ( auto *p = __va_carve(static_cast<usize>(sz)); p ) [[likely]] {
-    const usize rounded = (static_cast<usize>(sz) + __sheet_align_mask) & ~__sheet_align_mask;
+  const usize rounded = (static_cast<usize>(sz) + __sheet_align_mask) & ~__sheet_align_mask;
+  if ( auto *p = __va_carve(static_cast<usize>(sz), lazy); p ) [[likely]] {
+    if ( huge ) __advise_huge(p, rounded);
     return { reinterpret_cast<byte *>(p), rounded };
   }
-  return { micron::sys_allocator<byte>::alloc(sz), static_cast<usize>(sz) };
+  if ( auto *p = __va_map_aligned(rounded, micron::prot_read | micron::prot_write, 0); p ) return { reinterpret_cast<byte *>(p), rounded };
+  return { nullptr, 0 };
 }
 
+// guard == trailing bytes the owner mprotect'ed (its guard page); they are reopened if the run is retained
 template<typename T>
 inline void
-__release_kernel_chunk(const T &mem)
+__release_kernel_chunk(const T &mem, usize guard = 0)
 {
   if ( __va_contains(mem.ptr) ) {
-    __va_release(reinterpret_cast<addr_t *>(mem.ptr), mem.len);
+    __va_release(reinterpret_cast<addr_t *>(mem.ptr), mem.len, guard);
     return;
   }
   micron::sys_allocator<byte>::dealloc(mem.ptr, mem.len);
 }
+
+// resize a kernel chunk without copying; carved chunks stay inside the reservations, the others grow in place if
+// the kernel lets them and otherwise move onto a fresh granule-aligned range. returns a zero chunk on failure (mem
+// is untouched)
+template<typename T>
+inline T
+__remap_kernel_chunk(const T &mem, u64 sz)
+{
+  const usize rounded = (static_cast<usize>(sz) + __sheet_align_mask) & ~__sheet_align_mask;
+  if ( __va_contains(mem.ptr) ) {
+    if ( auto *p = __va_remap(reinterpret_cast<addr_t *>(mem.ptr), mem.len, rounded); p ) [[likely]]
+      return { reinterpret_cast<byte *>(p), rounded };
+    return { nullptr, 0 };
+  }
+  if ( rounded == mem.len ) return mem;
+  long r = static_cast<long>(micron::syscall(SYS_mremap, mem.ptr, mem.len, rounded, 0));
+  if ( !micron::mmap_failed(reinterpret_cast<addr_t *>(r)) ) return { mem.ptr, rounded };
+  addr_t *dst = __va_map_aligned(rounded, micron::prot_none, __map_noreserve_flag);
+  if ( !dst ) [[unlikely]]
+    return { nullptr, 0 };
+  r = static_cast<long>(micron::syscall(SYS_mremap, mem.ptr, mem.len, rounded, __mremap_maymove_flag | __mremap_fixed_flag, dst));
+  if ( micron::mmap_failed(reinterpret_cast<addr_t *>(r)) || reinterpret_cast<addr_t *>(r) != dst ) [[unlikely]] {
+    micron::munmap(dst, rounded);
+    return { nullptr, 0 };
+  }
+  return { reinterpret_cast<byte *>(dst), rounded };
+}
 };      // namespace abc
@@ -39,37 +39,13 @@ malloc(usize size) noexcept      // alloc memory of size 'size', prefer using al
 extern "C" void *
 calloc(usize num, usize size) noexcept      // alloc's zero'd out memory, prefer using salloc()
 {
-  if ( size != 0 && (size * num) / size != num ) return nullptr;
-
-  byte *mem = abc::alloc(size * num);
-  if ( !mem ) return nullptr;
-  micron::zero(mem, size * num);
-  return mem;
+  return abc::calloc(num, size);      // overflow check and zero elision live there
 }
 
 extern "C" void *
 realloc(void *ptr, usize size) noexcept      // reallocates memory
 {
-  // NOTE: this always gets the full size of the allocated memory, not what was requested
-  usize old_size = abc::query_size(reinterpret_cast<addr_t *>(ptr));
-  if ( size == 0 ) {
-    abc::dealloc(reinterpret_cast<byte *>(ptr));
-    return nullptr;
-  }
-
-  if ( !ptr ) {
-    return reinterpret_cast<void *>(abc::alloc(size));
-  }
-
-  byte *new_block = abc::alloc(size);
-  if ( !new_block ) return nullptr;      // allocation failed
-
-  usize copy_size = old_size < size ? old_size : size;
-  micron::memcpy(new_block, reinterpret_cast<byte *>(ptr), copy_size);
-
-  abc::dealloc(reinterpret_cast<byte *>(ptr));
-
-  return new_block;
+  return abc::realloc(ptr, size);      // in-place growth, mremap and owner routing live there
 }
 
 extern "C" void
@@ -78,6 +54,23 @@ free(void *ptr) noexcept      // frees memory, prefer abc::dealloc always
   abc::dealloc(reinterpret_cast<byte *>(ptr));
 }
 
-extern "C" void *aligned_alloc(usize alignment, usize size) noexcept;
+// aligned blocks are ordinary block starts, free() takes them back
+extern "C" void *
+aligned_alloc(usize alignment, usize size) noexcept
+{
+  return abc::aligned_alloc(alignment, size);
+}
+
+extern "C" int
+posix_memalign(void **out, usize alignment, usize size) noexcept
+{
+  return abc::posix_memalign(out, alignment, size);
+}
+
+extern "C" void *
+memalign(usize alignment, usize size) noexcept
+{
+  return abc::memalign(alignment, size);
+}
 
 #endif
@@ -0,0 +1,225 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include "malloc.hpp"
+
+#include <micron/types.hpp>
+
+// replaceable global operator new/delete, every form
+// plain forms go straight to abc::alloc / abc::dealloc; sized deletes take the dealloc(ptr, len) path, which never
+// reads the block header to learn the size. align_val_t forms are served natively by the tiers whenever the alignment
+// is past what every plain block already has, and free like any other block. define ABCMALLOC_DISABLE_NEW to keep the
+// toolchain's operators
+
+#if !defined(ABCMALLOC_DISABLE) && !defined(__micron_sanitizer_owns_heap) && !defined(ABCMALLOC_DISABLE_NEW)
+
+// opaque redeclarations, so <new> is never pulled in; both agree with it if it is
+namespace std
+{
+enum class align_val_t : __SIZE_TYPE__;
+struct nothrow_t;
+};      // namespace std
+
+namespace abc
+{
+
+[[gnu::always_inline]] inline void *
+__new_plain(usize sz) noexcept
+{
+  return reinterpret_cast<void *>(abc::alloc(sz ? sz : 1));      // new(0) still returns a unique pointer
+}
+
+[[gnu::always_inline]] inline void *
+__new_aligned(usize sz, usize al) noexcept
+{
+  if ( al <= __block_align_min ) return __new_plain(sz);
+  return reinterpret_cast<void *>(abc::__aligned_push(al, sz ? sz : 1));
+}
+
+[[gnu::always_inline]] inline void
+__delete_aligned(void *ptr, usize) noexcept
+{
+  abc::dealloc(reinterpret_cast<byte *>(ptr));      // aligned blocks are plain block starts
+}
+
+[[gnu::always_inline]] inline void
+__delete_sized(void *ptr, usize sz) noexcept
+{
+  if ( sz == 0 ) [[unlikely]] {
+    abc::dealloc(reinterpret_cast<byte *>(ptr));      // new(0) was served as 1 byte, let the block say so
+    return;
+  }
+  abc::dealloc(reinterpret_cast<byte *>(ptr), sz);
+}
+
+[[noreturn, gnu::cold]] inline void
+__new_oom(void)
+{
+  micron::exc<micron::except::memory_error_abc_fetch_oom>("operator new: allocation failed, out of memory");
+  micron::abort();      // exceptions compiled out
+}
+
+};      // namespace abc
+
+// throwing forms
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new(usize sz)
+{
+  void *p = abc::__new_plain(sz);
+  if ( !p ) [[unlikely]]
+    abc::__new_oom();
+  return p;
+}
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new[](usize sz)
+{
+  void *p = abc::__new_plain(sz);
+  if ( !p ) [[unlikely]]
+    abc::__new_oom();
+  return p;
+}
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new(usize sz, std::align_val_t al)
+{
+  void *p = abc::__new_aligned(sz, static_cast<usize>(al));
+  if ( !p ) [[unlikely]]
+    abc::__new_oom();
+  return p;
+}
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new[](usize sz, std::align_val_t al)
+{
+  void *p = abc::__new_aligned(sz, static_cast<usize>(al));
+  if ( !p ) [[unlikely]]
+    abc::__new_oom();
+  return p;
+}
+
+// nothrow forms
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new(usize sz, const std::nothrow_t &) noexcept
+{
+  return abc::__new_plain(sz);
+}
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new[](usize sz, const std::nothrow_t &) noexcept
+{
+  return abc::__new_plain(sz);
+}
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new(usize sz, std::align_val_t al, const std::nothrow_t &) noexcept
+{
+  return abc::__new_aligned(sz, static_cast<usize>(al));
+}
+
+__attribute__((malloc, alloc_size(1))) void *
+operator new[](usize sz, std::align_val_t al, const std::nothrow_t &) noexcept
+{
+  return abc::__new_aligned(sz, static_cast<usize>(al));
+}
+
+// deletes
+
+void
+operator delete(void *ptr) noexcept
+{
+  abc::dealloc(reinterpret_cast<byte *>(ptr));
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+  abc::dealloc(reinterpret_cast<byte *>(ptr));
+}
+
+void
+operator delete(void *ptr, usize sz) noexcept
+{
+  if ( !ptr ) [[unlikely]]
+    return;
+  abc::__delete_sized(ptr, sz);
+}
+
+void
+operator delete[](void *ptr, usize sz) noexcept
+{
+  if ( !ptr ) [[unlikely]]
+    return;
+  abc::__delete_sized(ptr, sz);
+}
+
+void
+operator delete(void *ptr, std::align_val_t al) noexcept
+{
+  abc::__delete_aligned(ptr, static_cast<usize>(al));
+}
+
+void
+operator delete[](void *ptr, std::align_val_t al) noexcept
+{
+  abc::__delete_aligned(ptr, static_cast<usize>(al));
+}
+
+void
+operator delete(void *ptr, usize, std::align_val_t al) noexcept
+{
+  abc::__delete_aligned(ptr, static_cast<usize>(al));
+}
+
+void
+operator delete[](void *ptr, usize, std::align_val_t al) noexcept
+{
+  abc::__delete_aligned(ptr, static_cast<usize>(al));
+}
+
+void
+operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+  abc::dealloc(reinterpret_cast<byte *>(ptr));
+}
+
+void
+operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+  abc::dealloc(reinterpret_cast<byte *>(ptr));
+}
+
+void
+operator delete(void *ptr, std::align_val_t al, const std::nothrow_t &) noexcept
+{
+  abc::__delete_aligned(ptr, static_cast<usize>(al));
+}
+
+void
+operator delete[](void *ptr, std::align_val_t al, const std::nothrow_t &) noexcept
+{
+  abc::__delete_aligned(ptr, static_cast<usize>(al));
+}
+
+#endif
@@ -145,6 +145,7 @@ balloc(usize size)      // allocates memory, returns entire memory chunk
   micron::__chunk<byte> mem = __current_arena()->push(size);
   if ( __is_sentinel(mem.ptr) ) [[unlikely]]
     return { nullptr, 0 };
+  __trace(trace_op::alloc, mem.ptr, size);
   return mem;
 }
 
@@ -157,6 +158,7 @@ fetch(usize size)
   micron::__chunk<byte> mem = __current_arena()->push(size);
   if ( __is_sentinel(mem.ptr) ) [[unlikely]]
     return { nullptr, 0 };
+  __trace(trace_op::alloc, mem.ptr, size);
   return mem;
 }
 
@@ -170,6 +172,7 @@ fetch(void)
     micron::exc<micron::except::memory_error_abc_fetch_oom>("fetch<T>(): allocation failed, out of memory");
     return nullptr;
   }
+  __trace(trace_op::alloc, mem.ptr, sizeof(T));
   return reinterpret_cast<T *>(mem.ptr);
 }
 
@@ -180,6 +183,7 @@ retire(byte *ptr)
   if ( !ptr ) [[unlikely]]
     return;
 
+  __trace(trace_op::free, ptr);
   if ( !__query_arena(ptr)->ts_pop(ptr) ) [[unlikely]] {
     ABC_DOCTOR(if ( doctor::on_bad_free(ptr, 0, "retire(): tombstone free failed, pointer not allocated by this arena", __FILE__,
                                         __LINE__) ) return;)
@@ -213,13 +217,15 @@ salloc(usize size)
   if ( size == 0 ) [[unlikely]]
     return nullptr;
 
-  micron::__chunk<byte> mem = __current_arena()->push(size);
+  bool zeroed;
+  micron::__chunk<byte> mem = __current_arena()->push(size, zeroed);
   if ( __is_sentinel(mem.ptr) ) [[unlikely]] {
     micron::exc<micron::except::memory_error_abc_salloc_oom>("salloc(): hardened allocation failed, out of memory");
     return nullptr;
   }
+  __trace(trace_op::alloc, mem.ptr, size);
 
-  micron::bzero(mem.ptr, mem.len);
+  if ( !zeroed ) micron::bzero(mem.ptr, mem.len);      // fresh sheet memory is already zero
 
   return mem.ptr;
 }
@@ -232,6 +238,7 @@ dealloc(byte *ptr)
 
   // WARNING:: due to poor interop with missing the STL and micron, there are edge cases where global objects constructed by glibc might
   // be invoked through *this* dealloc, instead of the libc free() one
+  __trace(trace_op::free, ptr);
   if ( !__route_dealloc(ptr, 0) ) [[unlikely]] {
     // REGARDING FOREIGN POINTERS
     // there are certain cases (aka bad code) where we genuinely get hit by a rouge pointer not owned by us;
@@ -255,6 +262,7 @@ dealloc(byte *ptr, usize len)
   }
 
   ABC_DOCTOR(len = doctor::check_free_size(ptr, len, __FILE__, __LINE__);)
+  __trace(trace_op::free, ptr, len);
   // dealloc(ptr len) is always explicit us, no fall throughs; treat it as a hard error, we went wrong somewhere
   if ( !__route_dealloc(ptr, len) ) [[unlikely]] {
     ABC_DOCTOR(if ( doctor::on_bad_free(ptr, len, "dealloc(ptr,len): no arena owns this pointer", __FILE__, __LINE__) ) return;)
@@ -281,6 +289,33 @@ dealloc(T *__ptr, usize len)
   dealloc(ptr, len);
 }
 
+// allocates n blocks of size into out[0..n) in one pass over the tier; returns how many were filled (n unless
+// memory ran out, the rest of out is then untouched)
+usize
+alloc_batch(usize size, usize n, byte **out)
+{
+  if ( size == 0 or n == 0 or !out ) [[unlikely]]
+    return 0;
+  const usize got = __current_arena()->push_batch(size, n, out);
+  if constexpr ( __default_trace ) {
+    for ( usize i = 0; i < got; ++i ) __trace(trace_op::alloc, out[i], size);
+  }
+  return got;
+}
+
+// frees ptrs[0..n), skipping nullptrs; pointers from one alloc_batch call, kept in order, free with one lookup
+// per sheet rather than per object. returns how many were freed
+usize
+dealloc_batch(byte **ptrs, usize n)
+{
+  if ( !ptrs or n == 0 ) [[unlikely]]
+    return 0;
+  if constexpr ( __default_trace ) {
+    for ( usize i = 0; i < n; ++i ) __trace(trace_op::free, ptrs[i]);
+  }
+  return __route_dealloc_batch(ptrs, n);
+}
+
 void
 freeze(byte *ptr)
 {
@@ -339,6 +374,7 @@ launder(usize size)
     micron::exc<micron::except::memory_error_abc_launder>("launder(): temporal allocation failed, out of memory");
     return nullptr;
   }
+  __trace(trace_op::alloc, mem.ptr, size);
   return mem.ptr;
 }
 
@@ -375,6 +411,121 @@ musage(void)
   return total;
 }
 
+// sums every arena's counter shard without stopping anyone (stats.hpp); the hot counters read zero unless built with
+// MICRON_ABC_COLLECT_STATS
+stats_t
+stats_snapshot(void)
+{
+  stats_t s = {};
+  __for_each_live_arena([&](__arena &a) { a.stats_into(s); });
+  __stats_finish(s);
+  return s;
+}
+
+stats_t
+get_stats(void)
+{
+  return stats_snapshot();
+}
+
+// sampled heap profiler (heap_profile.hpp): a sample every sample_bytes allocated on average, per arena; threads pick
+// the rate up within about a MiB of their next allocations. no-op unless built with MICRON_ABC_HEAP_PROFILE
+void
+profile_start(usize sample_bytes = __prof_default_rate)
+{
+  if constexpr ( __default_heap_profile ) {
+    if ( sample_bytes == 0 ) sample_bytes = 1;
+    __atomic_store_n(&__prof_last_rate, static_cast<u64>(sample_bytes), __ATOMIC_RELAXED);
+    __atomic_store_n(&__prof_rate, static_cast<u64>(sample_bytes), __ATOMIC_RELAXED);
+  } else {
+    (void)sample_bytes;
+  }
+}
+
+// stops taking samples; the live ones stay until their blocks are freed, so a later dump still shows them
+void
+profile_stop(void)
+{
+  __atomic_store_n(&__prof_rate, static_cast<u64>(0), __ATOMIC_RELAXED);
+}
+
+heap_profile_stats
+profile_stats(void)
+{
+  heap_profile_stats s = {};
+  __for_each_live_arena([&](__arena &a) { a.heap_profile().stats_into(s); });
+  return s;
+}
+
+// writes the live samples of every arena to path, merged by call stack; false if nothing could be written
+bool
+profile_dump(const char *path, profile_format fmt = profile_format::pprof)
+{
+  if constexpr ( !__default_heap_profile ) {
+    (void)path;
+    (void)fmt;
+    return false;
+  } else {
+    if ( path == nullptr ) return false;
+    __prof_merge m;
+    if ( !m.init(profile_stats().live + __prof_slots, __atomic_load_n(&__prof_last_rate, __ATOMIC_RELAXED)) ) return false;
+    __for_each_live_arena([&](__arena &a) { a.heap_profile().each([&](const __prof_record &r) { m.add(r); }); });
+    // O_WRONLY | O_CREAT | O_TRUNC, 0644
+    const int fd = static_cast<int>(micron::syscall(SYS_open, path, 01 | 0100 | 01000, 0644));
+    if ( fd < 0 ) return false;
+    __prof_writer w{ fd };
+    if ( fmt == profile_format::collapsed )
+      m.write_collapsed(w);
+    else
+      m.write_pprof(w);
+    w.flush();
+    micron::syscall(SYS_close, fd);
+    return w.ok;
+  }
+}
+
+// allocation trace (trace.hpp): records every alloc/free/realloc made through this API, from any thread, to path until
+// trace_stop(); false if a trace is already running, the file can't be opened, or the build lacks MICRON_ABC_TRACE
+bool
+trace_start(const char *path)
+{
+  if constexpr ( !__default_trace ) {
+    (void)path;
+    return false;
+  } else {
+    return __trace_start(path);
+  }
+}
+
+// flushes every thread's ring and closes the file; threads that keep allocating afterwards are simply not recorded
+trace_stats
+trace_stop(void)
+{
+  return __trace_stop();
+}
+
+// publishes every cross-thread free this thread still has parked; call before a freeing thread goes idle
+void
+flush_remote(void)
+{
+  __remote_flush_all();
+}
+
+// the calling thread's cross-thread free counters
+remote_free_stats
+remote_stats(void)
+{
+  return __tls_remote_batch.stats;
+}
+
+// runs a decay purge pass (MICRON_ABC_PURGE) over every arena the caller can take; arenas held by live threads purge on their
+// owner's next call. the allocator never spawns threads; a background purger is a thread that calls this periodically
+usize
+purge(void)
+{
+  return __purge_all();
+}
+
 __attribute__((malloc, alloc_size(1))) void *
 malloc(usize size)      // alloc memory of size 'size', prefer using alloc
 {
@@ -390,10 +541,13 @@ calloc(usize num, usize size)      // alloc's zero'd out memory, prefer using sa
   if ( check_mul_overflow(num, size, total) ) [[unlikely]]
     return nullptr;
 
-  byte *mem = abc::alloc(total);
-  if ( !mem ) return nullptr;
-  micron::zero(mem, total);
-  return mem;
+  bool zeroed;
+  micron::__chunk<byte> mem = __current_arena()->push(total, zeroed);
+  if ( __is_sentinel(mem.ptr) ) [[unlikely]]
+    return nullptr;
+  if ( !zeroed ) micron::zero(mem.ptr, total);      // fresh sheet memory is already zero
+  __trace(trace_op::alloc, mem.ptr, total);
+  return mem.ptr;
 }
 
 void *
@@ -406,7 +560,9 @@ realloc(void *ptr, usize size)      // reallocates memory
     return nullptr;
   }
 
-  byte *result = __current_arena()->resize(reinterpret_cast<byte *>(ptr), size);
+  __trace(trace_op::resize_from, ptr);
+  byte *result = __route_resize(reinterpret_cast<byte *>(ptr), size);
+  __trace(trace_op::resize_to, result ? result : ptr, result ? size : 0);      // size 0: failed, the block stayed put
   if ( !result ) [[unlikely]] {
     // rescue: report, then signal failure the C-standard way (return nullptr, original block untouched)
     ABC_DOCTOR(if ( doctor::on_bad_free(reinterpret_cast<byte *>(ptr), size, "realloc(): pointer not recognised or allocation OOM",
@@ -425,11 +581,24 @@ free(void *ptr)      // frees memory, prefer abc::dealloc always
   abc::dealloc(reinterpret_cast<byte *>(ptr));
 }
 
-// C11 aligned_alloc
+// C11 aligned_alloc / posix_memalign / memalign
+
+// aligned blocks are served natively by the tiers (see __arena::push_aligned): the returned pointer is the block start,
+// so abc::free / abc::dealloc release it like any other. alignments past __block_align_max (one sheet granule, 2 MiB on
+// width-64) are refused
 
-// WARNING: when alignment > __hdr_offset (32), the returned pointer differs from the allocator's block start. abc::free / abc::dealloc will
-// NOT work: you __MUST__ use abc::aligned_free for these pointers. when alignment <= __hdr_offset, the pointer is identical to a normal
-// allocation and abc::free works normally.
+constexpr static const int __enomem = 12;      // posix_memalign results, kept off <errno.h>
+constexpr static const int __einval = 22;
+
+inline byte *
+__aligned_push(usize alignment, usize size)
+{
+  micron::__chunk<byte> mem = __current_arena()->push_aligned(size, alignment);
+  if ( mem.zero() or __is_sentinel(mem.ptr) ) [[unlikely]]
+    return nullptr;
+  __trace(trace_op::alloc, mem.ptr, size);
+  return mem.ptr;
+}
 
 void *
 aligned_alloc(usize alignment, usize size)
@@ -445,55 +614,41 @@ aligned_alloc(usize alignment, usize size)
   if ( size == 0 ) [[unlikely]]
     return nullptr;
 
-  if ( alignment <= __hdr_offset ) return reinterpret_cast<void *>(abc::alloc(size));
+  return reinterpret_cast<void *>(__aligned_push(alignment, size));
+}
 
-  usize overhead = alignment + sizeof(void *);
-  usize total;
-  if ( check_add_overflow(size, overhead, total) ) [[unlikely]]
-    return nullptr;
+// POSIX: alignment is a power of two multiple of sizeof(void *), any size; returns 0 or an errno value, *out untouched
+// on failure
+int
+posix_memalign(void **out, usize alignment, usize size)
+{
+  if ( alignment < sizeof(void *) or (alignment & (alignment - 1)) != 0 ) [[unlikely]]
+    return __einval;
+  if ( alignment > __block_align_max ) [[unlikely]]
+    return __enomem;
+  byte *p = __aligned_push(alignment, size ? size : 1);
+  if ( !p ) [[unlikely]]
+    return __enomem;
+  *out = reinterpret_cast<void *>(p);
+  return 0;
+}
 
-  byte *raw = abc::alloc(total);
-  if ( !raw ) [[unlikely]]
+// obsolete, kept for the C shim; any power of two alignment, any size
+void *
+memalign(usize alignment, usize size)
+{
+  if ( alignment == 0 or (alignment & (alignment - 1)) != 0 ) [[unlikely]]
     return nullptr;
-
-  // find the first aligned address at least sizeof(void*) bytes past raw
-  uintptr_t raw_addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void *);
-  uintptr_t aligned_addr = (raw_addr + alignment - 1) & ~(alignment - 1);
-  byte *aligned = reinterpret_cast<byte *>(aligned_addr);
-
-  // stash the original pointer immediately before the aligned return
-  *reinterpret_cast<byte **>(aligned - sizeof(void *)) = raw;
-
-  return reinterpret_cast<void *>(aligned);
+  return reinterpret_cast<void *>(__aligned_push(alignment, size ? size : 1));
 }
 
+// aligned blocks no longer need a dedicated free; kept so existing callers keep building
 void
 aligned_free(void *ptr)
 {
   if ( !ptr ) [[unlikely]]
     return;
-
-  // recover the original raw pointer stashed before the aligned address
-  byte *raw = *reinterpret_cast<byte **>(reinterpret_cast<byte *>(ptr) - sizeof(void *));
-
-  // sanity: if the stashed pointer equals the aligned pointer, this was abnormal allocation shouldn't happen through the aligned_alloc path
-  // reroute to regular dealloc
-  if ( raw == reinterpret_cast<byte *>(ptr) ) [[unlikely]] {
-    abc::dealloc(reinterpret_cast<byte *>(ptr));
-    return;
-  }
-
-  uintptr_t raw_addr = reinterpret_cast<uintptr_t>(raw);
-  uintptr_t aligned_addr = reinterpret_cast<uintptr_t>(ptr);
-  if ( raw_addr >= aligned_addr ) [[unlikely]] {
-    ABC_DOCTOR(if ( doctor::on_bad_free(reinterpret_cast<byte *>(ptr), 0, "aligned_free(): not an aligned_alloc pointer (bad stashed raw)",
-                                        __FILE__, __LINE__) ) return;)
-    micron::exc<micron::except::memory_error_abc_aligned_free_bad>(
-        "aligned_free(): stashed raw pointer is invalid, this pointer was not allocated by aligned_alloc");
-    return;
-  }
-
-  abc::dealloc(raw);
+  abc::dealloc(reinterpret_cast<byte *>(ptr));
 }
 
 };      // namespace abc
@@ -503,3 +658,4 @@ aligned_free(void *ptr)
 #endif
 
 #include "malloc-c.hpp"
+#include "malloc-new.hpp"
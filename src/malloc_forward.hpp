@@ -57,6 +57,9 @@ void dealloc(byte *ptr);
 
 void dealloc(byte *ptr, usize len);
 
+usize alloc_batch(usize size, usize n, byte **out);
+usize dealloc_batch(byte **ptrs, usize n);
+
 void freeze(byte *ptr);
 
 void which(void);
@@ -71,6 +74,9 @@ void *realloc(void *ptr, usize size);
 
 void free(void *ptr);
 void *aligned_alloc(usize alignment, usize size);
+int posix_memalign(void **out, usize alignment, usize size);
+void *memalign(usize alignment, usize size);
+void aligned_free(void *ptr);
 
 };      // namespace abc
 #ifdef ABCMALLOC_DISABLE
@@ -81,4 +87,6 @@ extern "C" void *realloc(void *ptr, usize size) noexcept;
 
 extern "C" void free(void *ptr) noexcept;
 extern "C" void *aligned_alloc(usize alignment, usize size) noexcept;
+extern "C" int posix_memalign(void **out, usize alignment, usize size) noexcept;
+extern "C" void *memalign(usize alignment, usize size) noexcept;
 #endif
@@ -24,9 +24,13 @@
 
 #pragma once
 
+#include "config.hpp"
+#include "stats.hpp"
+
 #include <micron/atomic/atomic.hpp>
 #include <micron/bits/__backoff.hpp>
 #include <micron/bits/__pause.hpp>
+#include <micron/memory/allocation/kmemory.hpp>
 #include <micron/memory/cache.hpp>
 #include <micron/types.hpp>
 
@@ -38,76 +42,191 @@ struct __mpsc_free_payload {
   usize size;
 };
 
-template<usize N>
-  requires(N > 0 and (N & (N - 1)) == 0)
-class __mpsc_free_queue
+// intrusive node written over the first 16 B of a freed block (the smallest class is 16 B)
+struct __mpsc_free_node {
+  __mpsc_free_node *next;
+  usize size;      // 0 == size-unknown (route through __vmap_remove_at)
+};
+
+// unbounded Treiber stack of intrusive nodes; producers push single nodes or whole pre-linked chains
+// with one CAS, the consumer detaches everything with one swap
+class __mpsc_free_stack
 {
+  alignas(micron::cache_line_size()) micron::atomic_token<__mpsc_free_node *> __top{ nullptr };
+
+public:
+  __mpsc_free_stack() noexcept = default;
+  __mpsc_free_stack(const __mpsc_free_stack &) = delete;
+  __mpsc_free_stack(__mpsc_free_stack &&) = delete;
+  __mpsc_free_stack &operator=(const __mpsc_free_stack &) = delete;
+  __mpsc_free_stack &operator=(__mpsc_free_stack &&) = delete;
+
+  [[gnu::always_inline]] inline bool
+  maybe_nonempty() const noexcept
+  {
+    return __top.get(micron::memory_order_relaxed) != nullptr;
+  }
+
+  // first..last must already be linked through next; last->next is overwritten
+  [[gnu::always_inline]] inline void
+  push_chain(__mpsc_free_node *first, __mpsc_free_node *last) noexcept
+  {
+    __mpsc_free_node *top = __top.get(micron::memory_order_relaxed);
+    do {
+      last->next = top;
+    } while ( !__top.compare_exchange_weak(top, first, micron::memory_order_release, micron::memory_order_relaxed) );
+  }
+
+  [[gnu::always_inline]] inline void
+  push(__mpsc_free_node *nd) noexcept
+  {
+    push_chain(nd, nd);
+  }
+
+  // take-all: producers only push, so swapping the top detaches a consistent list
+  [[gnu::always_inline]] inline __mpsc_free_node *
+  take() noexcept
+  {
+    return __top.swap(nullptr, micron::memory_order::acq_rel);
+  }
+};
+
+// single-owner chain built without atomics, published through __mpsc_free_stack::push_chain
+struct __mpsc_free_batch {
+  __mpsc_free_node *first;
+  __mpsc_free_node *last;
+  u32 count;
+
+  [[gnu::always_inline]] inline void
+  add(byte *p, usize sz) noexcept
+  {
+    __mpsc_free_node *nd = reinterpret_cast<__mpsc_free_node *>(p);
+    nd->size = sz;
+    nd->next = first;
+    if ( first == nullptr ) last = nd;
+    first = nd;
+    ++count;
+  }
+
+  [[gnu::always_inline]] inline void
+  reset() noexcept
+  {
+    first = last = nullptr;
+    count = 0;
+  }
+};
 
+// one segment of the remote-free ring: Vyukov's bounded MPSC queue over a runtime power-of-two capacity, mapped on its
+// own so an arena only pays for the segments its traffic asked for. the owner retires a segment by setting __sealed in
+// its tail; producers that see the bit go back to the channel for the newer segment, slots reserved before it are
+// still drained
+class __mpsc_free_segment
+{
   static constexpr u64 __cache_line = micron::cache_line_size();
-  static constexpr usize __capacity = N;
-  static constexpr usize __mask = N - 1;
+
+public:
+  static constexpr usize __sealed = static_cast<usize>(1) << (sizeof(usize) * 8 - 1);
+
+  enum class push_result : u32 { ok, full, sealed };
 
   struct alignas(__cache_line) __cell {
     micron::atomic_token<usize> seq;
     __mpsc_free_payload payload;
   };
 
-  alignas(__cache_line) __cell __cells[__capacity];
+private:
   alignas(__cache_line) micron::atomic_token<usize> __tail;
   alignas(__cache_line) usize __head;
+  usize __mask;
+  __cell *__cells;
 
 public:
-  __mpsc_free_queue() noexcept : __tail(0), __head(0)
+  __mpsc_free_segment *next;       // the newer segment, owner only
+  __mpsc_free_segment *older;      // retired list, owner only
+
+  static constexpr usize
+  bytes_for(usize cap) noexcept
   {
-    for ( usize i = 0; i < __capacity; ++i ) {
-      __cells[i].seq.store(i, micron::memory_order_relaxed);
-    }
+    return sizeof(__mpsc_free_segment) + cap * sizeof(__cell);
   }
 
-  __mpsc_free_queue(const __mpsc_free_queue &) = delete;
-  __mpsc_free_queue(__mpsc_free_queue &&) = delete;
-  __mpsc_free_queue &operator=(const __mpsc_free_queue &) = delete;
-  __mpsc_free_queue &operator=(__mpsc_free_queue &&) = delete;
+  // nullptr if the mapping fails; the caller keeps using the chain
+  static __mpsc_free_segment *
+  create(usize cap) noexcept
+  {
+    addr_t *m = micron::map_normal(nullptr, bytes_for(cap));
+    if ( reinterpret_cast<uintptr_t>(m) >= ~static_cast<uintptr_t>(0xfff) ) [[unlikely]]
+      return nullptr;
+    __mpsc_free_segment *s = reinterpret_cast<__mpsc_free_segment *>(m);      // fresh pages read as zero
+    s->__mask = cap - 1;
+    s->__cells = reinterpret_cast<__cell *>(reinterpret_cast<byte *>(m) + sizeof(__mpsc_free_segment));
+    for ( usize i = 0; i < cap; ++i ) s->__cells[i].seq.store(i, micron::memory_order_relaxed);
+    return s;
+  }
 
-  static constexpr usize
-  capacity() noexcept
+  static void
+  destroy(__mpsc_free_segment *s) noexcept
+  {
+    micron::munmap(reinterpret_cast<addr_t *>(s), bytes_for(s->capacity()));
+  }
+
+  usize
+  capacity() const noexcept
   {
-    return __capacity;
+    return __mask + 1;
   }
 
   [[gnu::always_inline]] inline bool
   maybe_nonempty() const noexcept
   {
-    return __tail.get(micron::memory_order_relaxed) != __head;
+    return (__tail.get(micron::memory_order_relaxed) & ~__sealed) != __head;
   }
 
-  [[gnu::always_inline]] inline bool
+  // sealed, and every slot reserved before the seal has been drained
+  bool
+  retired() const noexcept
+  {
+    const usize t = __tail.get(micron::memory_order_acquire);
+    return (t & __sealed) and (t & ~__sealed) == __head;
+  }
+
+  [[gnu::always_inline]] inline push_result
   push(byte *p, usize sz) noexcept
   {
-    usize tail = __tail.get(micron::memory_order_relaxed);
+    usize tail = __tail.get(micron::memory_order_acquire);
     unsigned backoff = 1u;
     for ( ;; ) {
+      if ( tail & __sealed ) [[unlikely]]
+        return push_result::sealed;
       __cell &c = __cells[tail & __mask];
       const usize seq = c.seq.get(micron::memory_order_acquire);
       const long long diff = static_cast<long long>(seq) - static_cast<long long>(tail);
       if ( diff == 0 ) {
-        if ( __tail.compare_exchange_weak(tail, tail + 1u, micron::memory_order_relaxed, micron::memory_order_relaxed) ) {
+        if ( __tail.compare_exchange_weak(tail, tail + 1u, micron::memory_order_relaxed, micron::memory_order_acquire) ) {
           c.payload.ptr = p;
           c.payload.size = sz;
           c.seq.store(tail + 1u, micron::memory_order_release);
-          return true;
+          return push_result::ok;
         }
         backoff = micron::__spin_backoff(backoff);
-        tail = __tail.get(micron::memory_order_relaxed);
       } else if ( diff < 0 ) {
-        return false;
+        return push_result::full;
       } else {
         backoff = micron::__spin_backoff(backoff);
-        tail = __tail.get(micron::memory_order_relaxed);
+        tail = __tail.get(micron::memory_order_acquire);
       }
     }
   }
 
+  // owner: no new reservations from here on
+  void
+  seal() noexcept
+  {
+    usize t = __tail.get(micron::memory_order_relaxed);
+    while ( !__tail.compare_exchange_weak(t, t | __sealed, micron::memory_order_acq_rel, micron::memory_order_relaxed) ) {
+    }
+  }
+
   [[gnu::always_inline]] inline bool
   pop(__mpsc_free_payload &out) noexcept
   {
@@ -117,7 +236,7 @@ public:
     const long long diff = static_cast<long long>(seq) - static_cast<long long>(head + 1u);
     if ( diff != 0 ) return false;
     out = c.payload;
-    c.seq.store(head + __capacity, micron::memory_order_release);
+    c.seq.store(head + capacity(), micron::memory_order_release);
     __head = head + 1u;
     return true;
   }
@@ -136,4 +255,167 @@ public:
   }
 };
 
+static_assert(__remote_ring_min > 0 and (__remote_ring_min & (__remote_ring_min - 1)) == 0 and __remote_ring_max >= __remote_ring_min
+                  and (__remote_ring_max & (__remote_ring_max - 1)) == 0,
+              "abcmalloc: remote ring sizes must be powers of two, min <= max");
+
+// an arena's remote-free channel. an arena starts with no ring at all, only the intrusive chain (one cache line), and
+// producers that find no ring, or a full one, spill onto the chain and bump __spill. the owner reads __spill on every
+// drain: a quiet arena never crosses __remote_ring_min / 2 and never maps a ring; a busy one gets a __remote_ring_min
+// segment, then a segment twice the size each time a drain finds a quarter of the current capacity spilled, up to
+// __remote_ring_max. a new segment is published before the old one is sealed, and the owner drains segments oldest
+// first, so the ring stays FIFO across growth. retired segments stay mapped until the arena goes (a producer may
+// still be reading an old tail), which bounds them at twice the largest segment
+class __mpsc_free_channel
+{
+  alignas(micron::cache_line_size()) micron::atomic_token<__mpsc_free_segment *> __tail_seg{ nullptr };
+  alignas(micron::cache_line_size()) micron::atomic_token<u32> __spill{ 0 };      // spills since the owner last looked
+  __mpsc_free_stack __chain;
+
+  // owner only
+  alignas(micron::cache_line_size()) __mpsc_free_segment *__head_seg = nullptr;      // oldest segment still draining
+  __mpsc_free_segment *__retired = nullptr;
+  u64 __drains = 0;
+  u64 __from_ring = 0;
+  u64 __from_chain = 0;
+  u64 __spills = 0;
+  u64 __max_drain = 0;
+  u64 __grows = 0;
+  u64 __ring_cells = 0;
+  u64 __ring_bytes = 0;
+
+  void
+  __grow(void) noexcept
+  {
+    __mpsc_free_segment *cur = __tail_seg.get(micron::memory_order_relaxed);
+    const usize cap = cur ? cur->capacity() * 2 : __remote_ring_min;
+    if ( cap > __remote_ring_max ) return;
+    __mpsc_free_segment *s = __mpsc_free_segment::create(cap);
+    if ( !s ) [[unlikely]]
+      return;
+    if ( cur ) cur->next = s;
+    else __head_seg = s;
+    __tail_seg.store(s, micron::memory_order_release);
+    if ( cur ) cur->seal();      // after the publish: a producer bounced off the seal finds s
+    __stat_store_add(__grows, 1);
+    __atomic_store_n(&__ring_cells, static_cast<u64>(cap), __ATOMIC_RELAXED);
+    __stat_store_add(__ring_bytes, __mpsc_free_segment::bytes_for(cap));
+  }
+
+public:
+  __mpsc_free_channel() noexcept = default;
+  __mpsc_free_channel(const __mpsc_free_channel &) = delete;
+  __mpsc_free_channel(__mpsc_free_channel &&) = delete;
+  __mpsc_free_channel &operator=(const __mpsc_free_channel &) = delete;
+  __mpsc_free_channel &operator=(__mpsc_free_channel &&) = delete;
+
+  // owner only
+  [[gnu::always_inline]] inline bool
+  maybe_nonempty() const noexcept
+  {
+    return (__head_seg and (__head_seg->maybe_nonempty() or __head_seg->next)) or __chain.maybe_nonempty();
+  }
+
+  // single free from another thread; never blocks, the chain takes whatever the ring can't
+  [[gnu::always_inline]] inline void
+  push(byte *p, usize sz) noexcept
+  {
+    for ( __mpsc_free_segment *s = __tail_seg.get(micron::memory_order_acquire); s != nullptr;
+          s = __tail_seg.get(micron::memory_order_acquire) ) {
+      const __mpsc_free_segment::push_result r = s->push(p, sz);
+      if ( r == __mpsc_free_segment::push_result::ok ) [[likely]]
+        return;
+      if ( r == __mpsc_free_segment::push_result::full ) break;
+    }
+    __mpsc_free_node *nd = reinterpret_cast<__mpsc_free_node *>(p);
+    nd->size = sz;
+    __chain.push(nd);
+    __spill.fetch_add(1, micron::memory_order_relaxed);
+  }
+
+  // a thread-local batch, one CAS; batches are already amortised and never count as spills
+  [[gnu::always_inline]] inline void
+  push_chain(__mpsc_free_batch &b) noexcept
+  {
+    __chain.push_chain(b.first, b.last);
+  }
+
+  // owner only: the ring oldest segment first, then every published chain; grows the ring if it spilled
+  template<typename Fn>
+  u32
+  drain(Fn &&fn) noexcept
+  {
+    u32 ring = 0;
+    while ( __mpsc_free_segment *s = __head_seg ) {
+      ring += s->drain(fn);
+      if ( s->next == nullptr or !s->retired() ) break;      // never step off the tail segment
+      __head_seg = s->next;
+      s->older = __retired;
+      __retired = s;
+    }
+    u32 chain = 0;
+    if ( __chain.maybe_nonempty() ) {
+      __mpsc_free_node *nd = __chain.take();
+      while ( nd != nullptr ) {
+        __mpsc_free_node *nx = nd->next;      // read the embedded node before the free recycles it
+        const usize sz = nd->size;
+        fn(reinterpret_cast<byte *>(nd), sz);
+        ++chain;
+        nd = nx;
+      }
+    }
+    const u32 spilled = __spill.get(micron::memory_order_relaxed) ? __spill.swap(0, micron::memory_order::relaxed) : 0u;
+    if ( spilled ) {
+      __stat_store_add(__spills, spilled);
+      const __mpsc_free_segment *cur = __tail_seg.get(micron::memory_order_relaxed);
+      if ( spilled >= (cur ? cur->capacity() / 4 : __remote_ring_min / 2) ) __grow();
+    }
+    const u32 n = ring + chain;
+    if constexpr ( __default_collect_stats ) {
+      if ( n ) {
+        __stat_store_add(__drains, 1);
+        __stat_store_add(__from_ring, ring);
+        __stat_store_add(__from_chain, chain);
+        if ( n > __max_drain ) __atomic_store_n(&__max_drain, static_cast<u64>(n), __ATOMIC_RELAXED);
+      }
+    }
+    return n;
+  }
+
+  // any thread; relaxed reads of owner-written counters
+  void
+  stats_into(remote_drain_stats &s) const noexcept
+  {
+    s.drains += __atomic_load_n(&__drains, __ATOMIC_RELAXED);
+    s.from_ring += __atomic_load_n(&__from_ring, __ATOMIC_RELAXED);
+    s.from_chain += __atomic_load_n(&__from_chain, __ATOMIC_RELAXED);
+    s.spills += __atomic_load_n(&__spills, __ATOMIC_RELAXED) + __spill.get(micron::memory_order_relaxed);
+    const u64 m = __atomic_load_n(&__max_drain, __ATOMIC_RELAXED);
+    if ( m > s.max_drain ) s.max_drain = m;
+    s.grows += __atomic_load_n(&__grows, __ATOMIC_RELAXED);
+    s.ring_cells += __atomic_load_n(&__ring_cells, __ATOMIC_RELAXED);
+    s.ring_bytes += __atomic_load_n(&__ring_bytes, __ATOMIC_RELAXED);
+  }
+
+  // arena teardown; nothing may push afterwards
+  void
+  release(void) noexcept
+  {
+    for ( __mpsc_free_segment *s = __retired; s != nullptr; ) {
+      __mpsc_free_segment *o = s->older;
+      __mpsc_free_segment::destroy(s);
+      s = o;
+    }
+    for ( __mpsc_free_segment *s = __head_seg; s != nullptr; ) {
+      __mpsc_free_segment *n = s->next;
+      __mpsc_free_segment::destroy(s);
+      s = n;
+    }
+    __retired = __head_seg = nullptr;
+    __tail_seg.store(nullptr, micron::memory_order_release);
+    __atomic_store_n(&__ring_cells, u64{ 0 }, __ATOMIC_RELAXED);
+    __atomic_store_n(&__ring_bytes, u64{ 0 }, __ATOMIC_RELAXED);
+  }
+};
+
 };      // namespace abc
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "config.hpp"
+
+#include <micron/atomic/atomic.hpp>
+#include <micron/syscall.hpp>
+#include <micron/types.hpp>
+
+// decay purging (__default_purge)
+// every free run big enough to own a whole page carries a u64 stamp: a time in ms plus a two-bit state in the top bits.
+// a run enters its free list fresh and undated, and the first pass to see it dates it with that pass's clock, so its
+// age is never more than it has really been free (at the cost of up to one pass interval). a run that stays free for
+// __purge_decay_ms goes dirty -> muzzy (MADV_FREE, the kernel may take the pages lazily), and after twice that
+// muzzy -> clean (MADV_DONTNEED, the pages are gone).
+// the page holding the list links and the stamp itself is never advised, so the run's bookkeeping survives.
+// runs are trimmed inward to the sheet's grain: a page, or a whole huge page in THP-backed sheets (__purge_grain_for)
+namespace abc
+{
+
+constexpr static const i32 __madv_dontneed = 4;
+constexpr static const i32 __madv_free = 8;
+constexpr static const i32 __clock_monotonic = 1;
+
+constexpr static const u64 __purge_state_shift = 62;
+constexpr static const u64 __purge_time_mask = (static_cast<u64>(1) << __purge_state_shift) - 1;
+constexpr static const u64 __purge_dirty = 0;
+constexpr static const u64 __purge_muzzy = 1;
+constexpr static const u64 __purge_clean = 2;
+constexpr static const u64 __purge_fresh = 3;      // freed since the last pass, no time yet
+
+struct __purge_timespec {
+  i64 sec;
+  i64 nsec;
+};
+
+inline u64
+__purge_now_ms(void) noexcept
+{
+  __purge_timespec ts{ 0, 0 };
+  micron::syscall(SYS_clock_gettime, __clock_monotonic, &ts);
+  return static_cast<u64>(ts.sec) * 1000u + static_cast<u64>(ts.nsec) / 1000000u;
+}
+
+[[gnu::always_inline]] inline u64
+__purge_stamp(void) noexcept
+{
+  // no clock read on the free path: a stamp taken from a clock only passes advance would be as old as the last pass,
+  // and after an idle gap a run freed a moment ago would look ready to purge
+  return __purge_fresh << __purge_state_shift;
+}
+
+// ages one free run [lo, hi), advising only whole grains inside it; returns the bytes advised on this call
+[[gnu::cold]] inline usize
+__purge_run(byte *lo, byte *hi, u64 &stamp, u64 now, usize grain) noexcept
+{
+  const u64 state = stamp >> __purge_state_shift;
+  if ( state == __purge_fresh ) {
+    stamp = (__purge_dirty << __purge_state_shift) | (now & __purge_time_mask);
+    return 0;
+  }
+  const uintptr_t a = (reinterpret_cast<uintptr_t>(lo) + grain - 1) & ~(static_cast<uintptr_t>(grain) - 1);
+  const uintptr_t b = reinterpret_cast<uintptr_t>(hi) & ~(static_cast<uintptr_t>(grain) - 1);
+  if ( b <= a ) return 0;
+  const u64 since = stamp & __purge_time_mask;
+  const u64 age = now > since ? now - since : 0;
+  if ( state == __purge_dirty and age >= __purge_decay_ms ) {
+    if ( micron::syscall(SYS_madvise, a, b - a, __madv_free) == 0 ) {
+      stamp = (__purge_muzzy << __purge_state_shift) | since;
+    } else {
+      // pre-4.5 kernels have no MADV_FREE; go straight to clean
+      micron::syscall(SYS_madvise, a, b - a, __madv_dontneed);
+      stamp = (__purge_clean << __purge_state_shift) | since;
+    }
+    return b - a;
+  }
+  if ( state == __purge_muzzy and age >= 2 * __purge_decay_ms ) {
+    micron::syscall(SYS_madvise, a, b - a, __madv_dontneed);
+    stamp = (__purge_clean << __purge_state_shift) | since;
+    return b - a;
+  }
+  return 0;
+}
+
+};      // namespace abc
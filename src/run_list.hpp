@@ -0,0 +1,681 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "metadata.hpp"
+#include "purge.hpp"
+
+#include <micron/mem.hpp>
+#include <micron/memory/cmemory.hpp>
+#include <micron/type_traits.hpp>
+#include <micron/types.hpp>
+
+namespace abc
+{
+
+//^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+//  __run_list: page-granular runs for the medium and large classes
+// the buddy rounds every block to a power of two, so a 33 KiB request holds a 64 KiB block; here a block is the
+// exact number of pages it needs. free runs are binned by length in classes spaced 12.5% apart (exact up to 16
+// pages, then eight steps per doubling); a request searches from the class at or above its length, so the first run
+// of the first non-empty bin always fits and allocation stays a bitmap scan plus a split
+//
+//  sheet layout:
+//    [ page 0 | page 1 | ... | page npages-1 | run tags (__run_tag[npages]) | free_map | head_map ]
+//
+// nothing is stored in the pages themselves: a run's length, state, free-bin links and purge stamp live in the tag of
+// its first page (free runs repeat the length at their last page for left coalescing). free_map has a bit per free
+// page, head_map a bit per allocated run start; base keeps the chunk's own alignment, which aligned requests rely on
+
+constexpr static const usize __run_page = __system_pagesize;
+constexpr static const u32 __run_page_shift = static_cast<u32>(__builtin_ctzll(__run_page));
+constexpr static const u32 __run_bins = 256;
+constexpr static const u32 __run_bin_words = __run_bins / 64;
+constexpr static const u32 __run_exact_bins = 16;      // runs shorter than this many pages get a bin each
+constexpr static const u32 __run_active_bins = 64;      // temporal rings kept for the first bins only
+constexpr static const u32 __run_active_ring = 2;
+constexpr static const u32 __run_nil = ~static_cast<u32>(0);
+
+template<typename T>
+  requires(micron::is_trivially_constructible_v<T> and micron::is_trivially_destructible_v<T>)
+struct __run_list {
+
+  struct __run_tag {
+    u32 len;        // pages in the run: at every run's first page, and at the last page of a free one
+    u32 next;       // free-bin links (page indices)
+    u32 prev;
+    u32 state;      // block_flags of an allocated run
+    u64 stamp;      // decay purge state + clock of a free run, see purge.hpp (only kept when __default_purge)
+  };
+
+  byte *base;
+  __run_tag *tags;
+  u64 *free_map;
+  u64 *head_map;
+  u32 npages;
+  u32 map_words;
+  u32 clean;      // pages at or past clean have never been handed out
+  u32 bins[__run_bins];
+  u64 bin_mask[__run_bin_words];
+  u32 active[__run_active_bins][__run_active_ring];
+  u8 active_rotor[__run_active_bins];
+  usize total;
+  usize allocated_bytes;
+  usize tombstoned_bytes;
+  byte *fresh;      // the run the last allocation carved out of never-handed-out pages (zero elision)
+
+  // free runs of n pages go to bin_of(n); every run in bin_of(class_round(n)) and above holds at least n pages
+  [[gnu::always_inline]] static inline u32
+  bin_of(u32 n) noexcept
+  {
+    if ( n < __run_exact_bins ) return n;
+    const u32 e = 31u - static_cast<u32>(__builtin_clz(n));
+    return __run_exact_bins + ((e - 4) << 3) + ((n >> (e - 3)) & 7u);
+  }
+
+  [[gnu::always_inline]] static inline u32
+  class_round(u32 n) noexcept
+  {
+    if ( n < __run_exact_bins ) return n;
+    const u32 e = 31u - static_cast<u32>(__builtin_clz(n));
+    const u32 g = 1u << (e - 3);
+    return (n + g - 1) & ~(g - 1);
+  }
+
+  [[gnu::always_inline]] static inline u32
+  pages_for(usize n) noexcept
+  {
+    return static_cast<u32>((n + __run_page - 1) >> __run_page_shift);
+  }
+
+  [[gnu::always_inline]] inline byte *
+  page_addr(u32 pg) const noexcept
+  {
+    return base + (static_cast<usize>(pg) << __run_page_shift);
+  }
+
+  [[gnu::always_inline]] static inline bool
+  bit_get(const u64 *m, u32 i) noexcept
+  {
+    return (m[i >> 6] >> (i & 63)) & 1ULL;
+  }
+
+  [[gnu::always_inline]] static inline void
+  bit_set(u64 *m, u32 i) noexcept
+  {
+    m[i >> 6] |= (1ULL << (i & 63));
+  }
+
+  [[gnu::always_inline]] static inline void
+  bit_clear(u64 *m, u32 i) noexcept
+  {
+    m[i >> 6] &= ~(1ULL << (i & 63));
+  }
+
+  // set (or clear) bits [lo, lo + n)
+  static inline void
+  bits_fill(u64 *m, u32 lo, u32 n, bool v) noexcept
+  {
+    while ( n ) {
+      const u32 b = lo & 63;
+      const u32 k = (64 - b) < n ? (64 - b) : n;
+      const u64 mask = (k == 64 ? ~0ULL : ((1ULL << k) - 1)) << b;
+      if ( v )
+        m[lo >> 6] |= mask;
+      else
+        m[lo >> 6] &= ~mask;
+      lo += k;
+      n -= k;
+    }
+  }
+
+  // start page of a live (allocated or tombstoned) run at p; false for anything else
+  [[gnu::always_inline]] inline bool
+  locate(const byte *p, u32 &pg) const noexcept
+  {
+    if ( !base || p < base || p >= base + total ) return false;
+    const usize off = static_cast<usize>(p - base);
+    if ( off & (__run_page - 1) ) return false;
+    pg = static_cast<u32>(off >> __run_page_shift);
+    return bit_get(head_map, pg);
+  }
+
+  [[gnu::always_inline]] inline u32
+  find_bin(u32 b) const noexcept
+  {
+    u32 w = b >> 6;
+    u64 m = bin_mask[w] & (~0ULL << (b & 63));
+    while ( !m ) {
+      if ( ++w >= __run_bin_words ) return __run_nil;
+      m = bin_mask[w];
+    }
+    return (w << 6) | static_cast<u32>(__builtin_ctzll(m));
+  }
+
+  // file run [h, h + n) as free; its pages' free bits are the caller's
+  [[gnu::always_inline]] inline void
+  bin_insert(u32 h, u32 n, u64 stamp) noexcept
+  {
+    const u32 b = bin_of(n);
+    __run_tag &t = tags[h];
+    t.len = n;
+    t.state = __block_free;
+    t.stamp = stamp;
+    t.prev = __run_nil;
+    t.next = bins[b];
+    tags[h + n - 1].len = n;
+    if ( bins[b] != __run_nil ) tags[bins[b]].prev = h;
+    bins[b] = h;
+    bin_mask[b >> 6] |= (1ULL << (b & 63));
+  }
+
+  [[gnu::always_inline]] inline void
+  bin_remove(u32 h) noexcept
+  {
+    const u32 b = bin_of(tags[h].len);
+    __run_tag &t = tags[h];
+    if ( t.prev != __run_nil )
+      tags[t.prev].next = t.next;
+    else
+      bins[b] = t.next;
+    if ( t.next != __run_nil ) tags[t.next].prev = t.prev;
+    if ( bins[b] == __run_nil ) bin_mask[b >> 6] &= ~(1ULL << (b & 63));
+  }
+
+  // hand out [at, at + c) of the free run [h, h + len) (already off its bin); the slack on either side goes back to the
+  // bins with the run's purge stamp, it is still the same aging memory
+  T
+  carve(u32 h, u32 len, u32 at, u32 c, i32 state) noexcept
+  {
+    const u64 stamp = tags[h].stamp;
+    if ( at > h ) bin_insert(h, at - h, stamp);
+    if ( at + c < h + len ) bin_insert(at + c, h + len - (at + c), stamp);
+    bits_fill(free_map, at, c, false);
+    bit_set(head_map, at);
+    tags[at].len = c;
+    tags[at].state = static_cast<u32>(state);
+    const usize sz = static_cast<usize>(c) << __run_page_shift;
+    allocated_bytes += sz;
+    if constexpr ( __default_zero_elide ) {
+      fresh = at >= clean ? page_addr(at) : nullptr;
+      if ( at + c > clean ) clean = at + c;
+    }
+    return { page_addr(at), sz };
+  }
+
+  T
+  take(usize n, i32 state) noexcept
+  {
+    if ( !base ) return { nullptr, 0 };
+    if ( n == 0 ) n = 1;
+    if ( n > total ) return { nullptr, 0 };
+    const u32 c = pages_for(n);
+    const u32 b = find_bin(bin_of(class_round(c)));
+    if ( b == __run_nil ) return { nullptr, 0 };
+    const u32 h = bins[b];
+    const u32 len = tags[h].len;
+    bin_remove(h);
+    return carve(h, len, h, c, state);
+  }
+
+  // give [s, s + n) back, merged with the free runs on either side
+  void
+  release_run(u32 s, u32 n) noexcept
+  {
+    bits_fill(free_map, s, n, true);
+    if ( s > 0 && bit_get(free_map, s - 1) ) {
+      const u32 l = tags[s - 1].len;
+      bin_remove(s - l);
+      s -= l;
+      n += l;
+    }
+    if ( s + n < npages && bit_get(free_map, s + n) ) {
+      const u32 r = s + n;
+      const u32 l = tags[r].len;
+      bin_remove(r);
+      n += l;
+    }
+    u64 stamp = 0;
+    if constexpr ( __default_purge ) stamp = __purge_stamp();
+    bin_insert(s, n, stamp);
+  }
+
+  void
+  __impl_reset_lists(void) noexcept
+  {
+    clean = 0;
+    fresh = nullptr;
+    for ( u32 b = 0; b < __run_bins; ++b ) bins[b] = __run_nil;
+    for ( u32 w = 0; w < __run_bin_words; ++w ) bin_mask[w] = 0;
+    for ( u32 b = 0; b < __run_active_bins; ++b ) {
+      for ( u32 r = 0; r < __run_active_ring; ++r ) active[b][r] = __run_nil;
+      active_rotor[b] = 0;
+    }
+  }
+
+  void
+  __impl_init_memory(byte *_ptr, usize _len) noexcept
+  {
+    base = nullptr;
+    const usize pages = _len >> __run_page_shift;
+    // pages + tags + two bitmaps (a quarter byte a page, counted as one) must fit with the tail rounded to a page
+    const usize per_page = __run_page + sizeof(__run_tag) + 1;
+    usize np = (_len - 2 * __run_page) / per_page;
+    if ( np > pages ) np = pages;
+    if ( np > static_cast<usize>(__run_nil - 1) ) np = static_cast<usize>(__run_nil - 1);
+    usize words = 0, meta = 0;
+    while ( np > 0 ) {
+      words = (np + 63) >> 6;
+      meta = np * sizeof(__run_tag) + 2 * words * sizeof(u64);
+      meta = (meta + __run_page - 1) & ~(__run_page - 1);
+      if ( (np << __run_page_shift) + meta <= _len ) break;
+      --np;
+    }
+    if ( np == 0 ) return;
+    base = _ptr;
+    npages = static_cast<u32>(np);
+    map_words = static_cast<u32>(words);
+    total = np << __run_page_shift;
+    tags = reinterpret_cast<__run_tag *>(_ptr + total);
+    free_map = reinterpret_cast<u64 *>(tags + np);
+    head_map = free_map + words;
+    for ( u32 w = 0; w < map_words; ++w ) {
+      free_map[w] = 0;
+      head_map[w] = 0;
+    }
+    bits_fill(free_map, 0, npages, true);
+    u64 stamp = 0;
+    if constexpr ( __default_purge ) stamp = __purge_stamp();
+    bin_insert(0, npages, stamp);
+  }
+
+  ~__run_list() noexcept = default;
+  __run_list(void) = delete;
+
+  __run_list(const T &mem) noexcept
+      : base(nullptr), tags(nullptr), free_map(nullptr), head_map(nullptr), npages(0), map_words(0), clean(0), total(0), allocated_bytes(0),
+        tombstoned_bytes(0), fresh(nullptr)
+  {
+    __impl_reset_lists();
+    if ( mem.zero() or mem.len < 2 * __run_page ) micron::abort();
+    __impl_init_memory(mem.ptr, mem.len);
+    if ( !base ) micron::abort();
+  }
+
+  __run_list(const __run_list &) = delete;
+
+  __run_list(__run_list &&o)
+      : base(o.base), tags(o.tags), free_map(o.free_map), head_map(o.head_map), npages(o.npages), map_words(o.map_words), clean(o.clean),
+        total(o.total), allocated_bytes(o.allocated_bytes), tombstoned_bytes(o.tombstoned_bytes), fresh(o.fresh)
+  {
+    __impl_take_lists(o);
+    o.base = nullptr;
+    o.tags = nullptr;
+    o.free_map = nullptr;
+    o.head_map = nullptr;
+    o.npages = 0;
+    o.map_words = 0;
+    o.total = 0;
+    o.allocated_bytes = 0;
+    o.tombstoned_bytes = 0;
+    o.__impl_reset_lists();
+  }
+
+  __run_list &operator=(const __run_list &) = delete;
+
+  __run_list &
+  operator=(__run_list &&o)
+  {
+    base = o.base;
+    tags = o.tags;
+    free_map = o.free_map;
+    head_map = o.head_map;
+    npages = o.npages;
+    map_words = o.map_words;
+    clean = o.clean;
+    total = o.total;
+    allocated_bytes = o.allocated_bytes;
+    tombstoned_bytes = o.tombstoned_bytes;
+    fresh = o.fresh;
+    __impl_take_lists(o);
+    o.base = nullptr;
+    o.tags = nullptr;
+    o.free_map = nullptr;
+    o.head_map = nullptr;
+    o.npages = 0;
+    o.map_words = 0;
+    o.total = 0;
+    o.allocated_bytes = 0;
+    o.tombstoned_bytes = 0;
+    o.__impl_reset_lists();
+    return *this;
+  }
+
+  void
+  __impl_take_lists(const __run_list &o) noexcept
+  {
+    for ( u32 b = 0; b < __run_bins; ++b ) bins[b] = o.bins[b];
+    for ( u32 w = 0; w < __run_bin_words; ++w ) bin_mask[w] = o.bin_mask[w];
+    for ( u32 b = 0; b < __run_active_bins; ++b ) {
+      for ( u32 r = 0; r < __run_active_ring; ++r ) active[b][r] = o.active[b][r];
+      active_rotor[b] = o.active_rotor[b];
+    }
+  }
+
+  T
+  allocate(usize n) noexcept
+  {
+    return take(n, __block_alloc);
+  }
+
+  // launder: the last few temporal runs of a class are handed out again while they are live, same as the buddy.
+  // from __run_exact_bins up a bin spans several lengths, so temporal runs are carved at the class length: every run
+  // in ring k then holds any request that maps to k
+  T
+  temporal_allocate(usize n) noexcept
+  {
+    if ( !base ) return { nullptr, 0 };
+    if ( n == 0 ) n = 1;
+    if constexpr ( __default_zero_elide ) fresh = nullptr;
+    const u32 c = class_round(pages_for(n));
+    const u32 k = bin_of(c);
+    if ( k >= __run_active_bins ) return take(n, __block_alloc | __block_temporal);
+
+    const u8 r0 = active_rotor[k];
+    for ( u32 j = 0; j < __run_active_ring; ++j ) {
+      const u32 jj = (r0 + j) % __run_active_ring;
+      const u32 pg = active[k][jj];
+      if ( pg == __run_nil ) continue;
+      active_rotor[k] = static_cast<u8>((jj + 1) % __run_active_ring);
+      return { page_addr(pg), static_cast<usize>(tags[pg].len) << __run_page_shift };
+    }
+    T mem = take(static_cast<usize>(c) << __run_page_shift, __block_alloc | __block_temporal);
+    if ( mem.ptr ) {
+      active[k][r0] = static_cast<u32>(static_cast<usize>(mem.ptr - base) >> __run_page_shift);
+      active_rotor[k] = static_cast<u8>((r0 + 1) % __run_active_ring);
+    }
+    return mem;
+  }
+
+  // al is a power of two above the page size; the run is placed on an al boundary in absolute terms, the slack in
+  // front of it stays free. walks the candidate bins' runs, never on the plain allocation path
+  T
+  allocate_aligned(usize n, usize al) noexcept
+  {
+    if ( !base ) return { nullptr, 0 };
+    if ( n == 0 ) n = 1;
+    if ( n > total ) return { nullptr, 0 };
+    const u32 c = pages_for(n);
+    for ( u32 b = find_bin(bin_of(class_round(c))); b != __run_nil; b = (b + 1 < __run_bins) ? find_bin(b + 1) : __run_nil ) {
+      for ( u32 h = bins[b]; h != __run_nil; h = tags[h].next ) {
+        const u32 len = tags[h].len;
+        const uintptr_t lo = reinterpret_cast<uintptr_t>(page_addr(h));
+        const uintptr_t a = (lo + al - 1) & ~(static_cast<uintptr_t>(al) - 1);
+        const u32 at = static_cast<u32>(static_cast<usize>(a - reinterpret_cast<uintptr_t>(base)) >> __run_page_shift);
+        if ( at + c > h + len ) continue;
+        bin_remove(h);
+        return carve(h, len, at, c, __block_alloc);
+      }
+    }
+    return { nullptr, 0 };
+  }
+
+  ret_flag
+  deallocate(byte *ptr) noexcept
+  {
+    u32 pg;
+    if ( !locate(ptr, pg) ) return { __flag_invalid };
+    const u32 len = tags[pg].len;
+    const u32 st = tags[pg].state;
+    const usize sz = static_cast<usize>(len) << __run_page_shift;
+    if ( st & __block_tombstone )
+      tombstoned_bytes -= sz;
+    else
+      allocated_bytes -= sz;
+    if ( st & __block_temporal ) {
+      const u32 k = bin_of(class_round(len));
+      if ( k < __run_active_bins ) {
+        for ( u32 r = 0; r < __run_active_ring; ++r )
+          if ( active[k][r] == pg ) active[k][r] = __run_nil;
+      }
+    }
+    bit_clear(head_map, pg);
+    release_run(pg, len);
+    return { __flag_ok };
+  }
+
+  ret_flag
+  deallocate(T &node) noexcept
+  {
+    if ( !node.ptr or node.len == 0 ) return __flag_invalid;
+    return deallocate(node.ptr);
+  }
+
+  // tombstoned runs keep their pages (never handed out again) until explicitly deallocated
+  ret_flag
+  tombstone(byte *ptr) noexcept
+  {
+    u32 pg;
+    if ( !locate(ptr, pg) ) return { __flag_invalid };
+    if ( !(tags[pg].state & __block_alloc) ) return { __flag_invalid };
+    const usize sz = static_cast<usize>(tags[pg].len) << __run_page_shift;
+    tags[pg].state = __block_tombstone;
+    allocated_bytes -= sz;
+    tombstoned_bytes += sz;
+    return __flag_tombstoned;
+  }
+
+  ret_flag
+  tombstone(T &node) noexcept
+  {
+    if ( !node.ptr or node.len == 0 ) return __flag_invalid;
+    return tombstone(node.ptr);
+  }
+
+  bool
+  is_tombstoned(byte *ptr) const noexcept
+  {
+    u32 pg;
+    return locate(ptr, pg) && (tags[pg].state & __block_tombstone) != 0;
+  }
+
+  bool
+  is_temporal(byte *ptr) const noexcept
+  {
+    u32 pg;
+    return locate(ptr, pg) && (tags[pg].state & __block_temporal) != 0;
+  }
+
+  bool
+  is_allocated(byte *ptr) const noexcept
+  {
+    u32 pg;
+    return locate(ptr, pg);
+  }
+
+  usize
+  block_size(byte *ptr) const noexcept
+  {
+    u32 pg;
+    if ( !locate(ptr, pg) ) return 0;
+    return static_cast<usize>(tags[pg].len) << __run_page_shift;
+  }
+
+  // extend a live run over the free run right after it; temporal/tombstoned runs never grow
+  T
+  grow_in_place(byte *ptr, usize n) noexcept
+  {
+    u32 pg;
+    if ( !locate(ptr, pg) || tags[pg].state != __block_alloc ) return { nullptr, 0 };
+    const u32 len = tags[pg].len;
+    if ( n > total ) return { nullptr, 0 };
+    const u32 c = pages_for(n);
+    if ( c <= len ) return { ptr, static_cast<usize>(len) << __run_page_shift };
+
+    const u32 r = pg + len;
+    const u32 need = c - len;
+    if ( r >= npages || !bit_get(free_map, r) ) return { nullptr, 0 };
+    const u32 rl = tags[r].len;
+    if ( rl < need ) return { nullptr, 0 };
+    const u64 stamp = tags[r].stamp;
+    bin_remove(r);
+    if ( rl > need ) bin_insert(r + need, rl - need, stamp);
+    bits_fill(free_map, r, need, false);
+    tags[pg].len = c;
+    allocated_bytes += static_cast<usize>(need) << __run_page_shift;
+    if constexpr ( __default_zero_elide ) {
+      if ( pg + c > clean ) clean = pg + c;
+    }
+    return { ptr, static_cast<usize>(c) << __run_page_shift };
+  }
+
+  // ptr is the run the last allocation carved out of never-handed-out pages; every byte of it reads as zero
+  bool
+  known_zero(const byte *ptr) const noexcept
+  {
+    if constexpr ( __default_zero_elide ) return fresh != nullptr and ptr == fresh;
+    return false;
+  }
+
+  usize
+  available() const noexcept
+  {
+    if ( !base ) return 0;
+    return total - allocated_bytes - tombstoned_bytes;
+  }
+
+  usize
+  __total() const noexcept
+  {
+    return total;
+  }
+
+  usize
+  tombstoned() const noexcept
+  {
+    return tombstoned_bytes;
+  }
+
+  usize
+  used() const noexcept
+  {
+    return allocated_bytes;
+  }
+
+  // ages every free run; no bookkeeping lives in the pages, so the whole run is eligible
+  usize
+  purge(u64 now, usize grain) noexcept
+  {
+    if ( !base ) return 0;
+    usize n = 0;
+    for ( u32 w = 0; w < __run_bin_words; ++w ) {
+      for ( u64 m = bin_mask[w]; m; m &= m - 1 ) {
+        const u32 b = (w << 6) | static_cast<u32>(__builtin_ctzll(m));
+        for ( u32 h = bins[b]; h != __run_nil; h = tags[h].next )
+          n += __purge_run(page_addr(h), page_addr(h + tags[h].len), tags[h].stamp, now, grain);
+      }
+    }
+    return n;
+  }
+
+#if defined(ABCMALLOC_DOCTOR_HELP)
+  // deep corruption walk
+  template<class V>
+  void
+  __doctor_walk(V &v)
+  {
+    if ( !base ) return;
+
+    u32 pg = 0;
+    bool prev_free = false;
+    while ( pg < npages ) {
+      byte *blk = page_addr(pg);
+      const bool is_free = bit_get(free_map, pg);
+      const bool is_head = bit_get(head_map, pg);
+      if ( !is_free && !is_head ) {
+        v.note("run: page neither free nor the start of a run", blk);
+        prev_free = false;
+        ++pg;
+        continue;
+      }
+      ++v.blocks;
+      const u32 len = tags[pg].len;
+      if ( len == 0 || pg + len > npages ) {
+        v.note("run: run length out of range", blk);
+        break;
+      }
+      if ( is_free ) {
+        if ( is_head ) v.note("run: page both free and an allocated run start", blk);
+        if ( prev_free ) v.note("run: adjacent free runs were not coalesced", blk);
+        if ( tags[pg + len - 1].len != len ) {
+          v.note("run: free run tail length disagrees with its head", blk);
+          if ( v.repair ) {
+            tags[pg + len - 1].len = len;
+            v.did_repair("run: rewrote free run tail length", blk);
+          }
+        }
+        if ( !bit_get(free_map, pg + len - 1) ) v.note("run: free run has allocated pages in it", blk);
+      } else {
+        const u32 f = tags[pg].state;
+        const bool alloc_form = (f == __block_alloc || f == (__block_alloc | __block_temporal) || f == __block_tombstone);
+        if ( !alloc_form ) {
+          v.note("run: allocated run state not in an allocated form", blk);
+          if ( v.repair ) {
+            tags[pg].state = __block_alloc | (f & __block_temporal);
+            v.did_repair("run: reset run state to allocated form", blk);
+          }
+        }
+        if ( bit_get(free_map, pg + len - 1) ) v.note("run: allocated run has free pages in it", blk);
+      }
+      prev_free = is_free;
+      pg += len;
+    }
+
+    for ( u32 b = 0; b < __run_bins; ++b ) {
+      const bool has = bins[b] != __run_nil;
+      const bool bit = ((bin_mask[b >> 6] >> (b & 63)) & 1ULL) != 0;
+      if ( has != bit ) {
+        v.note("run: bin mask bit disagrees with its bin", base);
+        if ( v.repair ) {
+          if ( has )
+            bin_mask[b >> 6] |= (1ULL << (b & 63));
+          else
+            bin_mask[b >> 6] &= ~(1ULL << (b & 63));
+          v.did_repair("run: fixed bin mask bit", base);
+        }
+      }
+      usize gc = 0;
+      for ( u32 h = bins[b]; h != __run_nil && gc++ <= npages; h = tags[h].next ) {
+        ++v.freelist_nodes;
+        if ( h >= npages || !bit_get(free_map, h) ) {
+          v.note("run: bin links a page that is not free", base);
+          break;
+        }
+        if ( bin_of(tags[h].len) != b ) v.note("run: free run filed in the wrong bin", page_addr(h));
+      }
+      if ( gc > npages ) v.note("run: bin list cycle / overrun", base);
+    }
+  }
+#endif
+};
+
+};      // namespace abc
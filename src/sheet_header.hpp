@@ -29,111 +29,84 @@
 namespace abc
 {
 
-class __arena;
-
-constexpr static const usize __num_blocks = __va_reservation_size >> __sheet_align_log2;
-
-inline __arena *__block_owner_table[__num_blocks]{};
-
-[[gnu::always_inline]] inline u64
-__block_index(const void *p) noexcept
-{
-  addr_t *base = __va_base.get(micron::memory_order_relaxed);
-  return (reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(base)) >> __sheet_align_log2;
-}
-
-struct __oor_sheet {
-  uintptr_t lo;
-  uintptr_t hi;      // exclusive
-  __arena *owner;
-  __oor_sheet *next;
+// per-granule binding tags; the tier tag is folded into the low bits of the node pointer (nodes are 16-byte aligned)
+enum __sheet_tier : uintptr_t {
+  __sheet_tier_none = 0,
+  __sheet_tier_precise = 1,
+  __sheet_tier_small = 2,
+  __sheet_tier_medium = 3,
+  __sheet_tier_large = 4,
+  __sheet_tier_huge = 5,
+  __sheet_tier_mapped = 6,
+  __sheet_tier_arena = 7,      // allocator metadata, bound only so the arena finds its own sheets in O(1)
 };
+constexpr static const uintptr_t __sheet_tier_mask = 0xF;
 
-inline micron::atomic_token<__oor_sheet *> __oor_head{ nullptr };
-inline micron::atomic_token<u32> __oor_live{ 0 };      // lock-free empty probe; 0 == skip the walk
+// owner + binding live in the granule table (va_reserve.hpp): every kernel chunk is granule aligned, inside a
+// reservation or not, so any sheet is registered and looked up the same way, in two loads
 
 inline void
-__oor_insert(__arena *arena, const void *base, usize len) noexcept
+__sheet_register(__arena *arena, const void *base, usize len) noexcept
 {
-  const uintptr_t lo = reinterpret_cast<uintptr_t>(base);
-  const uintptr_t hi = lo + len;
-  for ( __oor_sheet *n = __oor_head.get(micron::memory_order_acquire); n != nullptr; n = n->next ) {
-    if ( n->lo != lo || n->hi != hi ) continue;
-    __arena *expect = nullptr;
-    if ( __atomic_compare_exchange_n(&n->owner, &expect, arena, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ) {
-      __oor_live.fetch_add(1, micron::memory_order_acq_rel);
-      return;
-    }
+  const u32 first = __va_granule(base);
+  const u32 blocks = static_cast<u32>((len + __sheet_align_mask) >> __sheet_align_log2);
+  for ( u32 i = 0; i < blocks; ++i ) {
+    __granule_entry *g = __granule_make(first + i);
+    if ( !g ) [[unlikely]]
+      return;      // no table leaf for it; the tiers still find the sheet by their slot scan
+    __atomic_store_n(&g->owner, arena, __ATOMIC_RELEASE);
   }
-  byte *mem = micron::sys_allocator<byte>::alloc(sizeof(__oor_sheet));
-  if ( !mem ) [[unlikely]]
-    return;      // cannot track it; degrades to the old behaviour for this sheet only
-  __oor_sheet *n = new (mem) __oor_sheet{ lo, hi, arena, nullptr };
-  n->next = __oor_head.get(micron::memory_order_acquire);
-  while ( !__oor_head.compare_exchange_weak(n->next, n, micron::memory_order_acq_rel, micron::memory_order_acquire) ) {
-  }
-  __oor_live.fetch_add(1, micron::memory_order_acq_rel);
 }
 
 inline void
-__oor_retire(const void *base, usize len) noexcept
+__sheet_unregister(const void *base, usize len) noexcept
 {
-  if ( __oor_live.get(micron::memory_order_acquire) == 0 ) return;
-  const uintptr_t lo = reinterpret_cast<uintptr_t>(base);
-  for ( __oor_sheet *n = __oor_head.get(micron::memory_order_acquire); n != nullptr; n = n->next ) {
-    if ( n->lo == lo && n->hi == lo + len && __atomic_load_n(&n->owner, __ATOMIC_ACQUIRE) != nullptr ) {
-      __atomic_store_n(&n->owner, static_cast<__arena *>(nullptr), __ATOMIC_RELEASE);
-      __oor_live.sub_fetch(1, micron::memory_order_acq_rel);
-      return;
-    }
+  const u32 first = __va_granule(base);
+  const u32 blocks = static_cast<u32>((len + __sheet_align_mask) >> __sheet_align_log2);
+  for ( u32 i = 0; i < blocks; ++i ) {
+    __granule_entry *g = __granule_of(__va_addr(first + i));
+    if ( !g ) continue;
+    __atomic_store_n(&g->sheet, uintptr_t{ 0 }, __ATOMIC_RELAXED);
+    __atomic_store_n(&g->owner, static_cast<__arena *>(nullptr), __ATOMIC_RELEASE);
   }
 }
 
-[[gnu::cold, gnu::noinline]] inline __arena *
-__oor_owner_of(const void *p) noexcept
+// bind [lo, hi) to a tier node; called by the owning tier once the sheet holds a slot in its index
+inline void
+__sheet_bind(const void *lo, const void *hi, uintptr_t tier, const void *nd) noexcept
 {
-  if ( __oor_live.get(micron::memory_order_acquire) == 0 ) return nullptr;
-  const uintptr_t a = reinterpret_cast<uintptr_t>(p);
-  for ( __oor_sheet *n = __oor_head.get(micron::memory_order_acquire); n != nullptr; n = n->next ) {
-    if ( a >= n->lo && a < n->hi ) return __atomic_load_n(&n->owner, __ATOMIC_ACQUIRE);
-  }
-  return nullptr;
+  const u32 first = __va_granule(lo);
+  const u32 last = __va_granule(reinterpret_cast<const byte *>(hi) - 1);
+  const uintptr_t b = reinterpret_cast<uintptr_t>(nd) | tier;
+  for ( u32 i = first; i <= last; ++i )
+    if ( __granule_entry *g = __granule_of(__va_addr(i)); g ) __atomic_store_n(&g->sheet, b, __ATOMIC_RELEASE);
 }
 
 inline void
-__sheet_register(__arena *arena, const void *base, usize len) noexcept
+__sheet_unbind(const void *lo, const void *hi) noexcept
 {
-  if ( !__va_contains(base) ) {
-    __oor_insert(arena, base, len);
-    return;
-  }
-  const u64 first = __block_index(base);
-  const usize blocks = (len + __sheet_align_mask) >> __sheet_align_log2;
-  for ( usize i = 0; i < blocks; ++i ) {
-    __atomic_store_n(&__block_owner_table[first + i], arena, __ATOMIC_RELEASE);
-  }
+  const u32 first = __va_granule(lo);
+  const u32 last = __va_granule(reinterpret_cast<const byte *>(hi) - 1);
+  for ( u32 i = first; i <= last; ++i )
+    if ( __granule_entry *g = __granule_of(__va_addr(i)); g ) __atomic_store_n(&g->sheet, uintptr_t{ 0 }, __ATOMIC_RELEASE);
 }
 
-inline void
-__sheet_unregister(const void *base, usize len) noexcept
+// tier binding of p if (and only if) its granule is owned by arena, else 0
+[[gnu::always_inline]] inline uintptr_t
+__sheet_binding_of(const __arena *arena, const void *p) noexcept
 {
-  if ( !__va_contains(base) ) {
-    __oor_retire(base, len);
-    return;
-  }
-  const u64 first = __block_index(base);
-  const usize blocks = (len + __sheet_align_mask) >> __sheet_align_log2;
-  for ( usize i = 0; i < blocks; ++i ) {
-    __atomic_store_n(&__block_owner_table[first + i], static_cast<__arena *>(nullptr), __ATOMIC_RELEASE);
-  }
+  const __granule_entry *g = __granule_of(p);
+  if ( !g ) [[unlikely]]
+    return 0;
+  if ( __atomic_load_n(&g->owner, __ATOMIC_ACQUIRE) != arena ) return 0;
+  return __atomic_load_n(&g->sheet, __ATOMIC_ACQUIRE);
 }
 
 [[gnu::always_inline]] inline __arena *
 __owner_of(const void *p) noexcept
 {
-  if ( !__va_contains(p) ) [[unlikely]]
-    return __oor_owner_of(p);
-  return __atomic_load_n(&__block_owner_table[__block_index(p)], __ATOMIC_ACQUIRE);
+  const __granule_entry *g = __granule_of(p);
+  return g ? __atomic_load_n(&g->owner, __ATOMIC_ACQUIRE) : nullptr;
 }
 
 };      // namespace abc
@@ -0,0 +1,480 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "metadata.hpp"
+
+#include <micron/mem.hpp>
+#include <micron/memory/cmemory.hpp>
+#include <micron/type_traits.hpp>
+#include <micron/types.hpp>
+
+namespace abc
+{
+
+//^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+//  __slab_list: headerless size-class slabs for the precise class
+// the tlsf list pays a 32b header and a 64b minimum block for every object, so a 16b node costs 64b
+// here the sheet is cut into fixed 16 KiB runs, each run is bound to one size class on demand and tracks its
+// objects in an out-of-band bitmap; objects carry no header at all, size is recovered from the run descriptor
+//
+//  sheet layout:
+//    [ run descriptors (__slab_run[nruns]) | pad to run | run 0 | run 1 | ... | run nruns-1 ]
+//
+// classes are multiples of 16 (keeps max_align_t alignment for every object), and every multiple of 32
+// up to 256 is a class of its own, so 32-aligned requests land on 32-aligned objects
+
+constexpr static const usize __slab_run_shift = 14;
+constexpr static const usize __slab_run_size = 1ULL << __slab_run_shift;      // 16 KiB
+constexpr static const usize __slab_min_object = 16;
+constexpr static const u32 __slab_classes = 12;
+constexpr static const u32 __slab_words = static_cast<u32>((__slab_run_size / __slab_min_object) / 64);      // 16
+constexpr static const u32 __slab_nil = ~static_cast<u32>(0);
+constexpr static const u16 __slab_unassigned = 0xFFFF;
+
+constexpr static const u32 __slab_class_size[__slab_classes] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256 };
+
+// (sz + 15) >> 4 -> class index
+constexpr static const u8 __slab_class_lut[17] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11 };
+
+// ceil(2^32 / size): exact quotient for every run offset (< 2^14) against every class (<= 2^8)
+constexpr static const u64 __slab_class_recip[__slab_classes] = {
+  ((1ULL << 32) + 15) / 16,   ((1ULL << 32) + 31) / 32,   ((1ULL << 32) + 47) / 48,   ((1ULL << 32) + 63) / 64,
+  ((1ULL << 32) + 79) / 80,   ((1ULL << 32) + 95) / 96,   ((1ULL << 32) + 111) / 112, ((1ULL << 32) + 127) / 128,
+  ((1ULL << 32) + 159) / 160, ((1ULL << 32) + 191) / 192, ((1ULL << 32) + 223) / 224, ((1ULL << 32) + 255) / 256,
+};
+
+template<typename T, u64 Sz>
+  requires(micron::is_trivially_constructible_v<T> and micron::is_trivially_destructible_v<T>)
+struct __slab_list {
+  static_assert(Sz <= 256, "__slab_list: classes stop at 256 bytes");
+
+  struct __slab_run {
+    u16 cls;       // class index, __slab_unassigned while the run sits on the free list
+    u16 used;      // live + tombstoned objects
+    u16 cap;       // objects per run for cls
+    u16 hint;      // lowest bitmap word that may hold a clear bit
+    u32 next;      // partial / free list links (run indices)
+    u32 prev;
+    u64 live[__slab_words];
+    u64 tomb[__slab_words];
+  };
+
+  byte *base;             // first data run
+  __slab_run *runs;       // descriptors, at the head of the backing chunk
+  u32 nruns;
+  u32 fresh;              // runs >= fresh have never been touched (descriptor not initialised)
+  u32 free_head;          // recycled, unassigned runs
+  u32 partial[__slab_classes];
+  usize total;
+  usize allocated_bytes;
+  usize tombstoned_bytes;
+
+  [[gnu::always_inline]] static inline u32
+  class_of(usize n) noexcept
+  {
+    return __slab_class_lut[(n + __slab_min_object - 1) >> 4];
+  }
+
+  // request size -> the object size it is served with; 0 if the request does not fit a class
+  [[gnu::always_inline]] static inline usize
+  round_request(usize n) noexcept
+  {
+    if ( n > __slab_class_size[__slab_classes - 1] ) return 0;
+    return __slab_class_size[class_of(n)];
+  }
+
+  [[gnu::always_inline]] inline u32
+  run_of(const byte *p) const noexcept
+  {
+    return static_cast<u32>(static_cast<usize>(p - base) >> __slab_run_shift);
+  }
+
+  [[gnu::always_inline]] inline byte *
+  run_base(u32 r) const noexcept
+  {
+    return base + (static_cast<usize>(r) << __slab_run_shift);
+  }
+
+  // run + object slot of p; false if p is outside the data region, in an unassigned run, or not an object start
+  [[gnu::always_inline]] inline bool
+  locate(const byte *p, u32 &r, u32 &slot) const noexcept
+  {
+    if ( !base || p < base || p >= base + total ) return false;
+    r = run_of(p);
+    if ( r >= fresh ) return false;
+    const __slab_run &rn = runs[r];
+    if ( rn.cls >= __slab_classes ) return false;
+    const u64 off = static_cast<u64>(p - run_base(r));
+    slot = static_cast<u32>((off * __slab_class_recip[rn.cls]) >> 32);
+    if ( static_cast<u64>(slot) * __slab_class_size[rn.cls] != off || slot >= rn.cap ) return false;
+    return true;
+  }
+
+  [[gnu::always_inline]] inline void
+  list_push(u32 &head, u32 r) noexcept
+  {
+    runs[r].prev = __slab_nil;
+    runs[r].next = head;
+    if ( head != __slab_nil ) runs[head].prev = r;
+    head = r;
+  }
+
+  [[gnu::always_inline]] inline void
+  list_remove(u32 &head, u32 r) noexcept
+  {
+    __slab_run &rn = runs[r];
+    if ( rn.prev != __slab_nil )
+      runs[rn.prev].next = rn.next;
+    else
+      head = rn.next;
+    if ( rn.next != __slab_nil ) runs[rn.next].prev = rn.prev;
+    rn.next = rn.prev = __slab_nil;
+  }
+
+  // bind a run to class c; bits past the run's capacity are pinned so the scan never hands them out
+  void
+  bind_run(u32 r, u32 c) noexcept
+  {
+    __slab_run &rn = runs[r];
+    rn.cls = static_cast<u16>(c);
+    rn.used = 0;
+    rn.cap = static_cast<u16>(__slab_run_size / __slab_class_size[c]);
+    rn.hint = 0;
+    for ( u32 w = 0; w < __slab_words; ++w ) {
+      const u32 lo = w << 6;
+      if ( lo >= rn.cap )
+        rn.live[w] = ~0ULL;
+      else if ( rn.cap - lo < 64 )
+        rn.live[w] = ~0ULL << (rn.cap - lo);
+      else
+        rn.live[w] = 0;
+      rn.tomb[w] = 0;
+    }
+  }
+
+  // a run for class c with at least one free slot, or __slab_nil
+  inline u32
+  acquire_run(u32 c) noexcept
+  {
+    if ( partial[c] != __slab_nil ) [[likely]]
+      return partial[c];
+    u32 r;
+    if ( free_head != __slab_nil ) {
+      r = free_head;
+      list_remove(free_head, r);
+    } else if ( fresh < nruns ) {
+      r = fresh++;
+    } else {
+      return __slab_nil;
+    }
+    bind_run(r, c);
+    list_push(partial[c], r);
+    return r;
+  }
+
+  void
+  __impl_init_memory(byte *_ptr, usize _len) noexcept
+  {
+    const usize runs_total = _len >> __slab_run_shift;
+    const usize meta_bytes = runs_total * sizeof(__slab_run);
+    const usize meta_runs = (meta_bytes + __slab_run_size - 1) >> __slab_run_shift;
+    if ( runs_total <= meta_runs ) {
+      base = nullptr;
+      return;
+    }
+    runs = reinterpret_cast<__slab_run *>(_ptr);
+    base = _ptr + (meta_runs << __slab_run_shift);
+    nruns = static_cast<u32>(runs_total - meta_runs);
+    total = static_cast<usize>(nruns) << __slab_run_shift;
+  }
+
+  void
+  __impl_reset_lists(void) noexcept
+  {
+    fresh = 0;
+    free_head = __slab_nil;
+    for ( u32 c = 0; c < __slab_classes; ++c ) partial[c] = __slab_nil;
+  }
+
+  ~__slab_list() noexcept = default;
+  __slab_list(void) = delete;
+
+  __slab_list(const T &mem) noexcept
+      : base(nullptr), runs(nullptr), nruns(0), fresh(0), free_head(__slab_nil), partial{}, total(0), allocated_bytes(0), tombstoned_bytes(0)
+  {
+    __impl_reset_lists();
+    if ( mem.zero() ) micron::abort();
+    __impl_init_memory(mem.ptr, mem.len);
+    if ( !base ) micron::abort();
+  }
+
+  __slab_list(const __slab_list &) = delete;
+
+  __slab_list(__slab_list &&o)
+      : base(o.base), runs(o.runs), nruns(o.nruns), fresh(o.fresh), free_head(o.free_head), partial{}, total(o.total),
+        allocated_bytes(o.allocated_bytes), tombstoned_bytes(o.tombstoned_bytes)
+  {
+    for ( u32 c = 0; c < __slab_classes; ++c ) partial[c] = o.partial[c];
+    o.base = nullptr;
+    o.runs = nullptr;
+    o.nruns = 0;
+    o.total = 0;
+    o.allocated_bytes = 0;
+    o.tombstoned_bytes = 0;
+    o.__impl_reset_lists();
+  }
+
+  __slab_list &operator=(const __slab_list &) = delete;
+
+  __slab_list &
+  operator=(__slab_list &&o)
+  {
+    base = o.base;
+    runs = o.runs;
+    nruns = o.nruns;
+    fresh = o.fresh;
+    free_head = o.free_head;
+    for ( u32 c = 0; c < __slab_classes; ++c ) partial[c] = o.partial[c];
+    total = o.total;
+    allocated_bytes = o.allocated_bytes;
+    tombstoned_bytes = o.tombstoned_bytes;
+    o.base = nullptr;
+    o.runs = nullptr;
+    o.nruns = 0;
+    o.total = 0;
+    o.allocated_bytes = 0;
+    o.tombstoned_bytes = 0;
+    o.__impl_reset_lists();
+    return *this;
+  }
+
+  T
+  allocate(usize n) noexcept
+  {
+    if ( !base || n > __slab_class_size[__slab_classes - 1] ) return { nullptr, 0 };
+    const u32 c = class_of(n);
+    const u32 r = acquire_run(c);
+    if ( r == __slab_nil ) return { nullptr, 0 };
+
+    __slab_run &rn = runs[r];
+    for ( u32 w = rn.hint; w < __slab_words; ++w ) {
+      const u64 freeb = ~rn.live[w];
+      if ( !freeb ) continue;
+      const u32 b = static_cast<u32>(__builtin_ctzll(freeb));
+      rn.live[w] |= (1ULL << b);
+      rn.hint = static_cast<u16>(w);
+      if ( ++rn.used == rn.cap ) list_remove(partial[c], r);      // full, parked until a free
+      const usize sz = __slab_class_size[c];
+      allocated_bytes += sz;
+      return { run_base(r) + static_cast<usize>((w << 6) | b) * sz, sz };
+    }
+    // a partial run always has a clear bit; reaching here means the descriptor is corrupt
+    return { nullptr, 0 };
+  }
+
+  // launder is never routed to the slab class, plain allocation is enough
+  T
+  temporal_allocate(usize n) noexcept
+  {
+    return allocate(n);
+  }
+
+  ret_flag
+  deallocate(byte *ptr) noexcept
+  {
+    if ( !ptr || !base ) return __flag_failure;
+    u32 r, slot;
+    if ( !locate(ptr, r, slot) ) return { __flag_invalid };
+    __slab_run &rn = runs[r];
+    const u32 w = slot >> 6;
+    const u64 bit = 1ULL << (slot & 63);
+    if ( !(rn.live[w] & bit) ) return { __flag_invalid };
+
+    const usize sz = __slab_class_size[rn.cls];
+    if ( rn.tomb[w] & bit ) {
+      rn.tomb[w] &= ~bit;
+      tombstoned_bytes -= sz;
+    } else {
+      allocated_bytes -= sz;
+    }
+    rn.live[w] &= ~bit;
+    if ( w < rn.hint ) rn.hint = static_cast<u16>(w);
+
+    const u32 c = rn.cls;
+    if ( rn.used-- == rn.cap ) list_push(partial[c], r);      // was full, back in rotation
+    if ( rn.used == 0 and (partial[c] != r or rn.next != __slab_nil) ) {
+      // hand the whole run back so another class can claim it; the class keeps its last run bound so a
+      // single alloc/free ping-pong does not rebind on every call
+      list_remove(partial[c], r);
+      rn.cls = __slab_unassigned;
+      list_push(free_head, r);
+    }
+    return { __flag_ok };
+  }
+
+  ret_flag
+  deallocate(T &node) noexcept
+  {
+    if ( !node.ptr or node.len == 0 ) return __flag_invalid;
+    return deallocate(node.ptr);
+  }
+
+  // tombstoned objects keep their live bit (never handed out again) until explicitly deallocated
+  ret_flag
+  tombstone(byte *ptr) noexcept
+  {
+    u32 r, slot;
+    if ( !locate(ptr, r, slot) ) return { __flag_invalid };
+    __slab_run &rn = runs[r];
+    const u32 w = slot >> 6;
+    const u64 bit = 1ULL << (slot & 63);
+    if ( !(rn.live[w] & bit) || (rn.tomb[w] & bit) ) return { __flag_invalid };
+    rn.tomb[w] |= bit;
+    const usize sz = __slab_class_size[rn.cls];
+    allocated_bytes -= sz;
+    tombstoned_bytes += sz;
+    return __flag_tombstoned;
+  }
+
+  ret_flag
+  tombstone(T &node) noexcept
+  {
+    if ( !node.ptr or node.len == 0 ) return __flag_invalid;
+    return tombstone(node.ptr);
+  }
+
+  bool
+  is_tombstoned(byte *ptr) const noexcept
+  {
+    u32 r, slot;
+    if ( !locate(ptr, r, slot) ) return false;
+    return (runs[r].tomb[slot >> 6] >> (slot & 63)) & 1ULL;
+  }
+
+  bool
+  is_temporal(byte *) const noexcept
+  {
+    return false;
+  }
+
+  bool
+  is_allocated(byte *ptr) const noexcept
+  {
+    u32 r, slot;
+    if ( !locate(ptr, r, slot) ) return false;
+    return (runs[r].live[slot >> 6] >> (slot & 63)) & 1ULL;
+  }
+
+  // object size of the run ptr lives in (no header to account for)
+  usize
+  block_size(byte *ptr) const noexcept
+  {
+    u32 r, slot;
+    if ( !locate(ptr, r, slot) ) return 0;
+    return __slab_class_size[runs[r].cls];
+  }
+
+  usize
+  available() const noexcept
+  {
+    if ( !base ) return 0;
+    return total - allocated_bytes - tombstoned_bytes;
+  }
+
+  usize
+  __total() const noexcept
+  {
+    return total;
+  }
+
+  usize
+  tombstoned() const noexcept
+  {
+    return tombstoned_bytes;
+  }
+
+  usize
+  used() const noexcept
+  {
+    return allocated_bytes;
+  }
+
+#if defined(ABCMALLOC_DOCTOR_HELP)
+  // deep corruption walk
+  template<class V>
+  void
+  __doctor_walk(V &v)
+  {
+    if ( !base ) return;
+    if ( fresh > nruns ) {
+      v.note("slab: fresh cursor past run count", base);
+      return;
+    }
+    for ( u32 r = 0; r < fresh; ++r ) {
+      __slab_run &rn = runs[r];
+      byte *rb = run_base(r);
+      if ( rn.cls == __slab_unassigned ) continue;
+      ++v.blocks;
+      if ( rn.cls >= __slab_classes ) {
+        v.note("slab: run bound to an unknown class", rb);
+        continue;
+      }
+      if ( rn.cap != __slab_run_size / __slab_class_size[rn.cls] ) v.note("slab: run capacity disagrees with its class", rb);
+      u32 live = 0;
+      for ( u32 w = 0; w < __slab_words; ++w ) {
+        const u32 lo = w << 6;
+        u64 in_cap = ~0ULL;
+        if ( lo >= rn.cap )
+          in_cap = 0;
+        else if ( rn.cap - lo < 64 )
+          in_cap = ~(~0ULL << (rn.cap - lo));
+        if ( (rn.live[w] | in_cap) != ~0ULL ) v.note("slab: pinned bits past capacity were cleared", rb);
+        if ( rn.tomb[w] & ~rn.live[w] ) v.note("slab: tombstone bit on a free slot", rb);
+        live += static_cast<u32>(__builtin_popcountll(rn.live[w] & in_cap));
+      }
+      if ( live != rn.used ) {
+        v.note("slab: run used count disagrees with its bitmap", rb);
+        if ( v.repair ) {
+          rn.used = static_cast<u16>(live);
+          v.did_repair("slab: recomputed run used count from bitmap", rb);
+        }
+      }
+    }
+    for ( u32 c = 0; c < __slab_classes; ++c ) {
+      usize gc = 0;
+      for ( u32 r = partial[c]; r != __slab_nil && gc++ <= nruns; r = runs[r].next ) {
+        ++v.freelist_nodes;
+        if ( r >= fresh ) {
+          v.note("slab: partial list points past the fresh cursor", base);
+          break;
+        }
+        if ( runs[r].cls != c ) v.note("slab: run on the wrong class partial list", run_base(r));
+      }
+      if ( gc > nruns ) v.note("slab: partial list cycle / overrun", base);
+    }
+  }
+#endif
+};
+
+};      // namespace abc
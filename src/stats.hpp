@@ -26,15 +26,12 @@ namespace abc
 
 #include "config.hpp"
 
-struct stats_t {
-  u64 alloc_requests;
-  u64 dealloc_requests;
-  u64 total_memory_req;             // how much was requested
-  u64 total_memory_throughput;      // how much was actually allocd
-  u64 total_memory_freed;
-  u64 current_memory_usage;
-  u64 current_page_usage;
-};
+// counters are sharded: one block per arena for requests as the api sees them (stat_type), and one per tier of that
+// arena (tier_stat). each is written only by whoever holds the arena, as a relaxed load and store -- no lock prefix,
+// no line shared with another writer. stats_snapshot() (malloc.hpp) sums them with relaxed loads while every thread
+// keeps running, so a snapshot never stops the world; it is a sum of recent values, not one instant.
+// the hot counters compile out unless __default_collect_stats; the sheet and committed-bytes gauges are kept either
+// way (they only move when a sheet is mapped or unmapped), musage() is a read of them
 
 enum class stat_type : int {
   alloc,
@@ -42,35 +39,166 @@ enum class stat_type : int {
   total_memory_req,
   total_memory_throughput,
   total_memory_freed,
+  remote_free,      // cross-thread frees this arena drained
   current_memory_usage,
   current_page_usage,
   __end
 };
 
-static stats_t stat = {};
+enum class tier_stat : int {
+  allocs,               // blocks handed out, cache hits included
+  frees,                // blocks taken back, into the free cache or the sheet
+  bytes_live,           // bytes marked in the tier's sheets; a block parked in the free cache stays marked
+  bytes_committed,      // backing of the tier's live sheets
+  sheets,
+  cache_hits,
+  cache_misses,
+  expansions,      // sheets mapped on demand, the warm-up sheet excluded
+  purged,          // bytes handed back to the kernel by decay purging
+  __end
+};
+
+// snapshot slots, in __sheet_tier order (tag - 1)
+enum class stat_tier : int { precise, small, medium, large, huge, mapped, metadata, __end };
+constexpr static const usize __stat_tiers = static_cast<usize>(stat_tier::__end);
 
-template<stat_type S>
-inline __attribute__((always_inline)) void
-collect_stats(usize n = 0)
+[[gnu::always_inline]] inline void
+__stat_store_add(u64 &c, u64 n) noexcept
 {
-  if constexpr ( __default_collect_stats ) {
-    if constexpr ( S == stat_type::alloc ) {
-      stat.alloc_requests++;
-    } else if constexpr ( S == stat_type::dealloc ) {
-      stat.dealloc_requests++;
-    } else if constexpr ( S == stat_type::total_memory_req ) {
-      stat.total_memory_req += n;
-    } else if constexpr ( S == stat_type::total_memory_throughput ) {
-      stat.total_memory_throughput += n;
-    } else if constexpr ( S == stat_type::total_memory_freed ) {
-      stat.total_memory_freed += n;
-    }
+  __atomic_store_n(&c, __atomic_load_n(&c, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+template<typename E>
+struct __stat_shard {
+  u64 v[static_cast<usize>(E::__end)] = {};
+
+  template<E S>
+  inline __attribute__((always_inline)) void
+  add(u64 n = 1) noexcept
+  {
+    if constexpr ( __default_collect_stats ) __stat_store_add(v[static_cast<usize>(S)], n);
+  }
+
+  template<E S>
+  inline __attribute__((always_inline)) void
+  sub(u64 n) noexcept
+  {
+    if constexpr ( __default_collect_stats ) __stat_store_add(v[static_cast<usize>(S)], 0 - n);
   }
+
+  // always kept, collection or not
+  template<E S>
+  inline __attribute__((always_inline)) void
+  gauge(u64 delta) noexcept
+  {
+    __stat_store_add(v[static_cast<usize>(S)], delta);
+  }
+
+  template<E S>
+  inline __attribute__((always_inline)) void
+  clear(void) noexcept
+  {
+    __atomic_store_n(&v[static_cast<usize>(S)], u64{ 0 }, __ATOMIC_RELAXED);
+  }
+
+  inline __attribute__((always_inline)) u64
+  get(E s) const noexcept
+  {
+    return __atomic_load_n(&v[static_cast<usize>(s)], __ATOMIC_RELAXED);
+  }
+};
+
+using __tier_counters = __stat_shard<tier_stat>;
+
+// the arena's own shard; a base of cache (and so of __arena), so collect_stats<>() reads the same inside either
+struct __arena_counters {
+  __stat_shard<stat_type> __counters;
+
+  template<stat_type S>
+  inline __attribute__((always_inline)) void
+  collect_stats(usize n = 0)
+  {
+    if constexpr ( S == stat_type::alloc or S == stat_type::dealloc or S == stat_type::remote_free )
+      __counters.add<S>();
+    else
+      __counters.add<S>(n);
+  }
+};
+
+struct tier_stats {
+  u64 allocs;
+  u64 frees;
+  u64 bytes_live;
+  u64 bytes_committed;
+  u64 sheets;
+  u64 cache_hits;
+  u64 cache_misses;
+  u64 expansions;
+  u64 purged;
+};
+
+// the remote-free channel (mpsc_free.hpp), summed over arenas; max_drain is the largest single drain seen by any of them
+struct remote_drain_stats {
+  u64 drains;          // drains that found work
+  u64 from_ring;       // frees drained from the ring
+  u64 from_chain;      // frees drained from the intrusive chain, thread-local batches included
+  u64 spills;          // single frees that found no ring, or a full one
+  u64 max_drain;
+  u64 grows;           // ring segments mapped
+  u64 ring_cells;      // current ring capacity
+  u64 ring_bytes;      // ring segments mapped, retired ones included
+};
+
+struct stats_t {
+  u64 alloc_requests;
+  u64 dealloc_requests;
+  u64 total_memory_req;             // how much was requested
+  u64 total_memory_throughput;      // how much was actually allocd
+  u64 total_memory_freed;
+  u64 current_memory_usage;      // bytes_live over every tier
+  u64 current_page_usage;        // bytes_committed over every tier, in pages
+  u64 remote_frees;
+  u64 arenas;
+  tier_stats tiers[__stat_tiers];      // indexed by stat_tier
+  remote_drain_stats remote_drain;
+};
+
+inline void
+__stats_add_tier(tier_stats &t, const __tier_counters &c) noexcept
+{
+  t.allocs += c.get(tier_stat::allocs);
+  t.frees += c.get(tier_stat::frees);
+  t.bytes_live += c.get(tier_stat::bytes_live);
+  t.bytes_committed += c.get(tier_stat::bytes_committed);
+  t.sheets += c.get(tier_stat::sheets);
+  t.cache_hits += c.get(tier_stat::cache_hits);
+  t.cache_misses += c.get(tier_stat::cache_misses);
+  t.expansions += c.get(tier_stat::expansions);
+  t.purged += c.get(tier_stat::purged);
 }
 
-inline __attribute__((always_inline)) auto &
-get_stats(void)
+inline void
+__stats_add_arena(stats_t &s, const __stat_shard<stat_type> &c) noexcept
 {
-  return stat;
+  s.alloc_requests += c.get(stat_type::alloc);
+  s.dealloc_requests += c.get(stat_type::dealloc);
+  s.total_memory_req += c.get(stat_type::total_memory_req);
+  s.total_memory_throughput += c.get(stat_type::total_memory_throughput);
+  s.total_memory_freed += c.get(stat_type::total_memory_freed);
+  s.remote_frees += c.get(stat_type::remote_free);
+  ++s.arenas;
+}
+
+// the two derived totals, once every shard is summed in
+inline void
+__stats_finish(stats_t &s) noexcept
+{
+  u64 live = 0, committed = 0;
+  for ( usize i = 0; i < __stat_tiers; ++i ) {
+    live += s.tiers[i].bytes_live;
+    committed += s.tiers[i].bytes_committed;
+  }
+  s.current_memory_usage = live;
+  s.current_page_usage = committed / __system_pagesize;
 }
 };      // namespace abc
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "arena.hpp"
+#include "trace.hpp"
 
 #include <micron/atomic/atomic.hpp>
 #include <micron/atomic/flag.hpp>
@@ -64,6 +65,38 @@ struct __arena_node {
 
 inline micron::atomic_token<__arena_node *> __overflow_head{ nullptr };
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%
+// per-CPU arenas (__default_percpu_arenas)
+
+// the kernel keeps cpu_id current on every return to userspace, so the running CPU is a plain TLS load.
+// the allocator paths are far too long to live inside an rseq critical section, so the arena itself is
+// leased under a per-CPU lock that is only ever contended when a thread is preempted or migrates mid-call
+struct alignas(32) __rseq_area {
+  u32 cpu_id_start;
+  u32 cpu_id;
+  u64 rseq_cs;
+  u32 flags;
+};
+
+constexpr static const u32 __rseq_sig = 0x53053053;
+constexpr static const u32 __rseq_cpu_unset = static_cast<u32>(-1);
+constexpr static const int __rseq_flag_unregister = 1;
+
+// glibc >= 2.35 registers its own area per thread and publishes where it lives
+extern "C" {
+[[gnu::weak]] extern const long __rseq_offset;
+[[gnu::weak]] extern const unsigned int __rseq_size;
+}
+
+inline thread_local __rseq_area __tls_rseq_area{ 0, __rseq_cpu_unset, 0, 0 };
+inline thread_local const volatile __rseq_area *__tls_rseq = nullptr;
+inline thread_local bool __tls_rseq_probed = false;
+inline thread_local bool __tls_rseq_owned = false;
+
+// lazily constructed per-CPU arenas; a CPU index at or past __max_arenas shares slot cpu % __max_arenas
+inline micron::atomic_token<__arena *> __percpu_arena[__max_arenas]{};
+inline micron::atomic_flag __percpu_lock[__max_arenas]{};
+
 // kernel tid of the calling thread.
 [[gnu::always_inline]] static inline i32
 __this_tid(void) noexcept
@@ -80,10 +113,107 @@ __owner_alive(i32 tid) noexcept
   return micron::syscall(SYS_tgkill, pid, tid, 0) == 0;
 }
 
+// per-thread record of the remote-free path; publishes are the atomic RMWs landing on other arenas' queues
+struct remote_free_stats {
+  u64 frees;
+  u64 publishes;
+};
+
+// cross-thread free batching: one open chain per destination arena, published with a single CAS on fill, on
+// eviction, on thread exit, once __remote_batch_age further allocator calls have gone by on the thread (so a thread
+// that frees a few blocks and moves on never pins them), or when the thread calls flush_remote() before going idle
+struct __remote_batch_slot {
+  __arena *dst;
+  __mpsc_free_batch chain;
+};
+
+struct __remote_batch_set {
+  __remote_batch_slot slot[__remote_batch_slots];
+  u32 victim;
+  u32 age;          // allocator calls left before everything parked is published; 0 == nothing parked
+  bool closed;      // set on thread exit; later frees publish directly so nothing is stranded in dead TLS
+  remote_free_stats stats;
+};
+
+static_assert(__remote_batch_slots >= 1, "abcmalloc: __remote_batch_slots must be at least 1.");
+
+inline thread_local __remote_batch_set __tls_remote_batch{};
+
+[[gnu::always_inline]] static inline void
+__remote_publish(__remote_batch_slot &s) noexcept
+{
+  if ( s.chain.count == 0 ) return;
+  s.dst->__remote_push_chain(s.chain);
+  ++__tls_remote_batch.stats.publishes;
+  s.chain.reset();
+  s.dst = nullptr;
+}
+
+[[gnu::cold]] static inline void
+__remote_flush_all(void) noexcept
+{
+  if constexpr ( __default_multithread_safe and __remote_batch_depth > 0 ) {
+    for ( u32 i = 0; i < __remote_batch_slots; ++i ) __remote_publish(__tls_remote_batch.slot[i]);
+    __tls_remote_batch.age = 0;
+  }
+}
+
+// every allocator call on the thread; one tls load and a not-taken branch unless frees are parked
+[[gnu::always_inline]] static inline void
+__remote_batch_tick(void) noexcept
+{
+  if constexpr ( __default_multithread_safe and __remote_batch_depth > 0 ) {
+    u32 &age = __tls_remote_batch.age;
+    if ( age ) [[unlikely]]
+      if ( --age == 0 ) __remote_flush_all();
+  }
+}
+
+[[gnu::always_inline]] static inline void
+__remote_batch_push(__arena *owner, byte *p, usize sz) noexcept
+{
+  __remote_batch_set &set = __tls_remote_batch;
+  __remote_batch_slot *s = nullptr;
+  __remote_batch_slot *empty = nullptr;
+  for ( u32 i = 0; i < __remote_batch_slots; ++i ) {
+    if ( set.slot[i].dst == owner ) {
+      s = &set.slot[i];
+      break;
+    }
+    if ( !empty and set.slot[i].dst == nullptr ) empty = &set.slot[i];
+  }
+  if ( !s ) [[unlikely]] {
+    if ( empty ) {
+      s = empty;
+    } else {
+      // every slot is bound to another arena; round-robin eviction publishes the victim early
+      s = &set.slot[set.victim];
+      set.victim = (set.victim + 1u) % __remote_batch_slots;
+      __remote_publish(*s);
+    }
+    s->dst = owner;
+  }
+  s->chain.add(p, sz);
+  if ( s->chain.count >= __remote_batch_depth ) __remote_publish(*s);
+  else if ( set.age == 0 ) set.age = __remote_batch_age;      // the clock starts with the oldest parked free
+}
+
 // runs on the exiting thread (via thread_kernel) and returns its arena slot to the pool
 static void
 __release_tls_arena(void) noexcept
 {
+  __remote_flush_all();
+  __tls_remote_batch.closed = true;
+  if constexpr ( __default_trace ) __trace_thread_exit();
+#if defined(SYS_rseq)
+  if constexpr ( __default_percpu_arenas ) {
+    if ( __tls_rseq_owned ) {
+      micron::syscall(SYS_rseq, &__tls_rseq_area, sizeof(__rseq_area), __rseq_flag_unregister, __rseq_sig);
+      __tls_rseq_owned = false;
+    }
+    __tls_rseq = nullptr;
+  }
+#endif
   __arena *a = __tls_arena;
   if ( !a ) return;
   const i32 tid = __this_tid();
@@ -193,37 +323,186 @@ __claim_arena_slow(void) noexcept
   return &node->arena;
 }
 
+// finds (or registers) this thread's rseq area; nullptr keeps the thread on the per-thread scheme
+[[gnu::cold, gnu::noinline]] inline const volatile __rseq_area *
+__rseq_attach(void) noexcept
+{
+  __tls_rseq_probed = true;
+#if defined(SYS_rseq)
+  micron::__thread_exit_hook = &__release_tls_arena;
+  (void)&__arena_releaser_tls;      // unregister on thread exit
+  const long r = static_cast<long>(micron::syscall(SYS_rseq, &__tls_rseq_area, sizeof(__rseq_area), 0, __rseq_sig));
+  if ( r == 0 ) {
+    __tls_rseq_owned = true;
+    __tls_rseq = &__tls_rseq_area;
+  } else if ( r == -16 /* EBUSY: the runtime registered first */ and &__rseq_offset != nullptr and &__rseq_size != nullptr
+              and __rseq_size >= 8 ) {
+    __tls_rseq = reinterpret_cast<const volatile __rseq_area *>(reinterpret_cast<byte *>(__builtin_thread_pointer()) + __rseq_offset);
+  }
+  if ( __tls_rseq and __tls_rseq->cpu_id == __rseq_cpu_unset ) __tls_rseq = nullptr;
+#endif
+  return __tls_rseq;
+}
+
+[[gnu::cold, gnu::noinline]] inline __arena *
+__percpu_create(u32 slot) noexcept
+{
+  while ( __arena_pool_init_lock.test_and_set(micron::memory_order::acquire) ) __cpu_pause();
+  __arena *a = __percpu_arena[slot].get(micron::memory_order_acquire);
+  if ( !a ) {
+    byte *mem = micron::sys_allocator<byte>::alloc(sizeof(__arena));
+    a = new (mem) __arena();
+    __percpu_arena[slot].store(a, micron::memory_order_release);
+  }
+  __arena_pool_init_lock.clear(micron::memory_order::release);
+  return a;
+}
+
+// the arena a call operates on; in per-CPU mode it also holds that CPU's lock until the end of the full-expression
+class __arena_lease
+{
+  __arena *_a;
+  micron::atomic_flag *_lk;      // nullptr == per-thread arena, nothing to release
+
+public:
+  [[gnu::always_inline]] __arena_lease(__arena *a, micron::atomic_flag *lk) noexcept : _a(a), _lk(lk) { }
+
+  [[gnu::always_inline]] ~__arena_lease() noexcept
+  {
+    if constexpr ( __default_percpu_arenas ) {
+      if ( _lk ) _lk->clear(micron::memory_order::release);
+    }
+  }
+
+  __arena_lease(const __arena_lease &) = delete;
+  __arena_lease(__arena_lease &&) = delete;
+  __arena_lease &operator=(const __arena_lease &) = delete;
+  __arena_lease &operator=(__arena_lease &&) = delete;
+
+  [[gnu::always_inline]] inline __arena *
+  operator->() const noexcept
+  {
+    return _a;
+  }
+
+  [[gnu::always_inline]] inline __arena *
+  get() const noexcept
+  {
+    return _a;
+  }
+};
+
 // hot path init; taken when arena already live
-[[gnu::always_inline]] static inline __arena *
+[[gnu::always_inline]] static inline __arena_lease
 __current_arena(void) noexcept
 {
+  __remote_batch_tick();
+  if constexpr ( __default_percpu_arenas and __default_multithread_safe ) {
+    const volatile __rseq_area *rs = __tls_rseq;
+    if ( !rs and !__tls_rseq_probed ) [[unlikely]]
+      rs = __rseq_attach();
+    if ( rs ) [[likely]] {
+      const u32 slot = rs->cpu_id % __max_arenas;
+      __arena *a = __percpu_arena[slot].get(micron::memory_order_acquire);
+      if ( !a ) [[unlikely]]
+        a = __percpu_create(slot);
+      __percpu_lock[slot].ttas(micron::memory_order::acquire, micron::memory_order::relaxed);
+      __tls_arena = a;      // doctor's "own arena" checks follow the lease
+      a->__maybe_drain();
+      return __arena_lease{ a, &__percpu_lock[slot] };
+    }
+  }
   __arena *a = __tls_arena;
   if ( a ) [[likely]] {
     a->__maybe_drain();
-    return a;
+    return __arena_lease{ a, nullptr };
   }
-  return __claim_arena_slow();
+  return __arena_lease{ __claim_arena_slow(), nullptr };
+}
+
+// cross-thread branch of __route_dealloc; owner is never the calling thread's arena
+[[gnu::always_inline]] static inline bool
+__route_remote(__arena *owner, byte *p, usize sz) noexcept
+{
+  ABC_DOCTOR(doctor::record_remote_free(p, sz);)
+  ++__tls_remote_batch.stats.frees;
+  if constexpr ( __remote_batch_depth > 0 ) {
+    // hot-tier blocks (<= medium) are parked and published as one chain; anything larger, or not yet bound,
+    // goes straight out so big blocks never sit in a thread's buffer
+    const uintptr_t tier = __sheet_binding_of(owner, p) & __sheet_tier_mask;
+    if ( tier != __sheet_tier_none and tier <= __sheet_tier_medium and !__tls_remote_batch.closed ) [[likely]] {
+      __remote_batch_push(owner, p, sz);
+      return true;
+    }
+  }
+  // wait-free: the owner's ring, falling back to the embedded-node overflow LIFO when the ring is full; never spin here
+  ++__tls_remote_batch.stats.publishes;
+  (void)owner->__remote_push(p, sz);
+  return true;
 }
 
 [[gnu::always_inline]] static inline bool
 __route_dealloc(byte *p, usize sz) noexcept
 {
-  __arena *me = __current_arena();
+  const __arena_lease me = __current_arena();
   if constexpr ( !__default_multithread_safe ) {
     // single-thread
     return sz ? me->pop(micron::__chunk<byte>{ p, sz }) : me->pop(p);
   }
   __arena *owner = __owner_of(p);
-  if ( !owner || owner == me ) [[likely]] {
+  if ( !owner || owner == me.get() ) [[likely]] {
     return sz ? me->pop(micron::__chunk<byte>{ p, sz }) : me->pop(p);
   }
-  // wait-free: the owner's ring, falling back to the embedded-node overflow LIFO when the ring is full; never spin here
-  ABC_DOCTOR(doctor::record_remote_free(p, sz);)
-  (void)owner->__remote_push(p, sz);
-  return true;
+  return __route_remote(owner, p, sz);
+}
+
+// batch free: each stretch of pointers this thread's arena owns goes to pop_batch in one piece, under one lease;
+// foreign blocks take the usual cross-thread route one by one
+inline usize
+__route_dealloc_batch(byte *const *ptrs, usize n) noexcept
+{
+  const __arena_lease me = __current_arena();
+  if constexpr ( !__default_multithread_safe ) {
+    return me->pop_batch(ptrs, n);
+  } else {
+    usize freed = 0;
+    usize i = 0;
+    while ( i < n ) {
+      usize j = i;
+      __arena *owner = nullptr;
+      while ( j < n ) {
+        owner = ptrs[j] ? __owner_of(ptrs[j]) : nullptr;
+        if ( owner and owner != me.get() ) break;
+        ++j;
+      }
+      if ( j > i ) freed += me->pop_batch(ptrs + i, j - i);
+      if ( j < n and __route_remote(owner, ptrs[j], 0) ) ++freed;
+      i = j + 1;
+    }
+    return freed;
+  }
+}
+
+// the lock guarding per-CPU arena a, nullptr for a per-thread or overflow arena; the CPU the caller runs on is the
+// likely answer, so its slot is tried before the scan
+[[gnu::always_inline]] static inline micron::atomic_flag *
+__percpu_lock_of(const __arena *a) noexcept
+{
+  if constexpr ( __default_percpu_arenas ) {
+    if ( const volatile __rseq_area *rs = __tls_rseq; rs ) [[likely]] {
+      const u32 slot = rs->cpu_id % __max_arenas;
+      if ( __percpu_arena[slot].get(micron::memory_order_acquire) == a ) return &__percpu_lock[slot];
+    }
+    for ( u32 i = 0; i < __max_arenas; ++i )
+      if ( __percpu_arena[i].get(micron::memory_order_acquire) == a ) return &__percpu_lock[i];
+  }
+  (void)a;
+  return nullptr;
 }
 
-[[gnu::always_inline]] static inline __arena *
+// the arena that owns p, leased: a per-CPU owner is shared with whichever thread runs on its CPU, so its lock is held
+// for the full-expression like any other lease. never called with a lease already held (two CPU locks, two orders)
+[[gnu::always_inline]] static inline __arena_lease
 __query_arena(const void *p) noexcept
 {
   if constexpr ( !__default_multithread_safe ) {
@@ -231,7 +510,52 @@ __query_arena(const void *p) noexcept
     return __current_arena();
   } else {
     __arena *owner = __owner_of(p);
-    return owner ? owner : __current_arena();
+    if ( !owner ) return __current_arena();
+    if constexpr ( __default_percpu_arenas ) {
+      if ( micron::atomic_flag *lk = __percpu_lock_of(owner); lk ) {
+        lk->ttas(micron::memory_order::acquire, micron::memory_order::relaxed);
+        return __arena_lease{ owner, lk };
+      }
+    }
+    return __arena_lease{ owner, nullptr };
+  }
+}
+
+// realloc. a block of the caller's own arena is resized there; one another arena owns (another thread's, or another
+// CPU's after a migration) is sized under the owner's lease, copied into a block of the caller's arena, and the old
+// one goes back the cross-thread way. the leases are taken one at a time, never nested
+[[gnu::always_inline]] static inline byte *
+__route_resize(byte *p, usize sz) noexcept
+{
+  if constexpr ( !__default_multithread_safe ) {
+    return __current_arena()->resize(p, sz);
+  } else {
+    __arena *owner = __owner_of(p);
+    {
+      const __arena_lease me = __current_arena();
+      if ( !owner || owner == me.get() ) [[likely]]
+        return me->resize(p, sz);
+    }
+    usize old;
+    {
+      const __arena_lease o = __query_arena(p);
+      if ( o->__is_cached(p) ) [[unlikely]]
+        return nullptr;
+      old = o->__size_of_alloc(reinterpret_cast<addr_t *>(p));
+    }
+    if ( old == 0 ) [[unlikely]]
+      return nullptr;
+    byte *fresh;
+    {
+      const __arena_lease me = __current_arena();
+      const micron::__chunk<byte> c = me->push(sz);
+      if ( __arena::__is_sentinel_chunk(c) ) [[unlikely]]
+        return nullptr;
+      fresh = c.ptr;
+    }
+    micron::memcpy(fresh, p, old < sz ? old : sz);
+    (void)__route_dealloc(p, 0);
+    return fresh;
   }
 }
 
@@ -249,6 +573,66 @@ __for_each_live_arena(Fn &&fn) noexcept
     if ( auto *a = __arena_pool[i]; a ) fn(*a);
   }
   for ( __arena_node *nd = __overflow_head.get(micron::memory_order_acquire); nd != nullptr; nd = nd->next ) fn(nd->arena);
+  if constexpr ( __default_percpu_arenas ) {
+    for ( u32 i = 0; i < __max_arenas; ++i ) {
+      if ( auto *a = __percpu_arena[i].get(micron::memory_order_acquire); a ) fn(*a);
+    }
+  }
+}
+
+// decay pass over every arena the caller can own for the duration: its own, unowned pool/overflow slots (claimed by CAS
+// and handed back), and per-CPU arenas whose lock is free. an arena held by a live thread only gets __purge_req set,
+// its owner runs the pass on its next call
+[[gnu::cold]] static inline usize
+__purge_all(void) noexcept
+{
+  if constexpr ( !__default_purge ) {
+    return 0;
+  } else {
+    const u64 now = __purge_now_ms();
+    if constexpr ( !__default_multithread_safe ) {
+      __arena *a = __tls_arena;
+      return a ? a->__purge_pass(now) : 0;
+    } else {
+      const i32 tid = __this_tid();
+      usize n = 0;
+      auto __visit = [&](__arena *a, micron::atomic_token<i32> &owner) {
+        i32 cur = owner.get(micron::memory_order_acquire);
+        if ( cur == tid ) {
+          n += a->__purge_pass(now);
+          return;
+        }
+        i32 expect = __arena_slot_free;
+        if ( cur == __arena_slot_free
+             and owner.compare_exchange_strong(expect, tid, micron::memory_order_acq_rel, micron::memory_order_acquire) ) {
+          n += a->__purge_pass(now);
+          owner.store(__arena_slot_free, micron::memory_order_release);
+          return;
+        }
+        a->__purge_req.store(1, micron::memory_order_relaxed);
+      };
+      const u32 pn = __arena_pool_next.get(micron::memory_order_acquire);
+      const u32 lim = pn > __max_arenas ? __max_arenas : pn;
+      for ( u32 i = 0; i < lim; ++i ) {
+        if ( __arena *a = __arena_pool[i]; a ) __visit(a, __arena_owner[i]);
+      }
+      for ( __arena_node *nd = __overflow_head.get(micron::memory_order_acquire); nd != nullptr; nd = nd->next )
+        __visit(&nd->arena, nd->owner);
+      if constexpr ( __default_percpu_arenas ) {
+        for ( u32 i = 0; i < __max_arenas; ++i ) {
+          __arena *a = __percpu_arena[i].get(micron::memory_order_acquire);
+          if ( !a ) continue;
+          if ( !__percpu_lock[i].test_and_set(micron::memory_order::acquire) ) {
+            n += a->__purge_pass(now);
+            __percpu_lock[i].clear(micron::memory_order::release);
+          } else {
+            a->__purge_req.store(1, micron::memory_order_relaxed);
+          }
+        }
+      }
+      return n;
+    }
+  }
 }
 
 // NOTE: __boot_abcmalloc was the old entry point, keeping it around in case old start files are still used
@@ -0,0 +1,238 @@
+// Copyright (c) 2025 David Lucius Severus
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "config.hpp"
+
+#include <micron/atomic/flag.hpp>
+#include <micron/bits/__pause.hpp>
+#include <micron/memory/allocation/kmemory.hpp>
+#include <micron/syscall.hpp>
+#include <micron/types.hpp>
+
+// allocation trace recorder (__default_trace)
+// compiled out unless built with MICRON_ABC_TRACE; then idle until abc::trace_start(path). every alloc, free and
+// realloc made through the public API appends a trace_record to the calling thread's ring (mmap'd, never from the
+// heap it is recording), and a full ring is written to the trace file in one piece. frees are recorded where they are
+// called, not where the owner drains them, so a replay sees the program's thread structure and not the allocator's.
+// ts is a process-wide ticket, taken after an allocation returns and before a free starts: an address freed on one
+// thread and handed out on another always gets the later ticket, so sorting by ts rebuilds a consistent history. the
+// shared ticket costs every op one contended RMW, which is why the recorder is a build of its own
+namespace abc
+{
+
+enum class trace_op : u32 {
+  alloc,            // ptr returned, size requested
+  free,             // ptr freed, size as passed to dealloc(ptr, len), 0 if unknown
+  resize_from,      // realloc: ptr given up (ticket taken before the call)
+  resize_to,        // realloc: ptr returned, size requested (ticket after); size 0 == failed, block unchanged
+};
+
+struct trace_record {
+  u64 ts;
+  u64 ptr;
+  u64 size;
+  u32 tid;      // kernel tid of the calling thread
+  u32 op;       // trace_op
+};
+static_assert(sizeof(trace_record) == 32, "abcmalloc: trace records are written raw, keep them packed.");
+
+// file layout: one trace_header, then records in flush order (per thread in order, threads interleaved by flush)
+struct trace_header {
+  char magic[8];      // "ABCTRACE"
+  u32 version;
+  u32 record_size;
+};
+
+constexpr static const u32 __trace_version = 1;
+
+struct trace_stats {
+  u64 records;      // written to the file
+  u64 lost;         // dropped: failed writes, or recorded after the thread's ring was closed
+};
+
+struct __trace_ring {
+  __trace_ring *next;      // grow-only list, walked by trace_stop()
+  micron::atomic_flag lock;
+  u32 owner;      // kernel tid, 0 == free for the next thread
+  u32 n;
+  trace_record rec[__trace_ring_records];
+};
+
+inline u32 __trace_on = 0;
+inline i32 __trace_fd = -1;
+inline u64 __trace_clock = 0;
+inline u64 __trace_written = 0;
+inline u64 __trace_lost = 0;
+inline __trace_ring *__trace_rings = nullptr;
+inline micron::atomic_flag __trace_file_lock{};
+
+inline thread_local __trace_ring *__tls_trace = nullptr;
+inline thread_local bool __tls_trace_closed = false;
+
+// one write() per flush under the file lock, so a ring's records land contiguously even when write() comes back short
+inline void
+__trace_flush_locked(__trace_ring *r) noexcept
+{
+  if ( r->n == 0 ) return;
+  const usize bytes = sizeof(trace_record) * r->n;
+  bool ok = false;
+  while ( __trace_file_lock.test_and_set(micron::memory_order_acquire) ) __cpu_pause();
+  if ( const i32 fd = __atomic_load_n(&__trace_fd, __ATOMIC_ACQUIRE); fd >= 0 ) {
+    const byte *buf = reinterpret_cast<const byte *>(r->rec);
+    usize off = 0;
+    while ( off < bytes ) {
+      const long w = static_cast<long>(micron::syscall(SYS_write, fd, buf + off, bytes - off));
+      if ( w <= 0 ) break;
+      off += static_cast<usize>(w);
+    }
+    ok = off == bytes;
+  }
+  __trace_file_lock.clear(micron::memory_order_release);
+  __atomic_fetch_add(ok ? &__trace_written : &__trace_lost, static_cast<u64>(r->n), __ATOMIC_RELAXED);
+  r->n = 0;
+}
+
+// runs on thread exit (tapi.hpp's releaser and the TLS dtor below); the ring goes back to the list for the next thread
+inline void
+__trace_thread_exit(void) noexcept
+{
+  __trace_ring *r = __tls_trace;
+  __tls_trace_closed = true;
+  if ( !r ) return;
+  while ( r->lock.test_and_set(micron::memory_order_acquire) ) __cpu_pause();
+  __trace_flush_locked(r);
+  __atomic_store_n(&r->owner, 0u, __ATOMIC_RELEASE);
+  r->lock.clear(micron::memory_order_release);
+  __tls_trace = nullptr;
+}
+
+struct __trace_releaser {
+  inline ~__trace_releaser() noexcept { __trace_thread_exit(); }
+};
+
+inline thread_local __trace_releaser __trace_releaser_tls{};
+
+// a free ring from an exited thread, else a fresh mapping pushed on the list; published before its first record so
+// trace_stop() cannot miss it
+[[gnu::cold, gnu::noinline]] inline __trace_ring *
+__trace_claim(void) noexcept
+{
+  (void)&__trace_releaser_tls;      // force-instantiate the TLS-dtor flush
+  const u32 tid = static_cast<u32>(micron::syscall(SYS_gettid));
+  for ( __trace_ring *r = __atomic_load_n(&__trace_rings, __ATOMIC_ACQUIRE); r != nullptr; r = r->next ) {
+    u32 expect = 0;
+    if ( __atomic_compare_exchange_n(&r->owner, &expect, tid, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ) return __tls_trace = r;
+  }
+  addr_t *m = micron::map_normal(nullptr, sizeof(__trace_ring));
+  if ( reinterpret_cast<uintptr_t>(m) >= ~static_cast<uintptr_t>(0xfff) ) [[unlikely]]
+    return nullptr;
+  __trace_ring *r = reinterpret_cast<__trace_ring *>(m);      // fresh pages read as zero: empty, unlocked
+  r->owner = tid;
+  r->next = __atomic_load_n(&__trace_rings, __ATOMIC_RELAXED);
+  while ( !__atomic_compare_exchange_n(&__trace_rings, &r->next, r, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ) {
+  }
+  return __tls_trace = r;
+}
+
+[[gnu::cold, gnu::noinline]] inline void
+__trace_append(trace_op op, const void *ptr, usize size) noexcept
+{
+  // relaxed is enough: the tickets of one free and the alloc that reuses its address are ordered by the allocator's
+  // own synchronization, and RMWs on one variable follow happens-before
+  const u64 ts = __atomic_fetch_add(&__trace_clock, 1, __ATOMIC_RELAXED);
+  __trace_ring *r = __tls_trace;
+  if ( !r ) [[unlikely]] {
+    if ( __tls_trace_closed or (r = __trace_claim()) == nullptr ) {
+      __atomic_fetch_add(&__trace_lost, 1, __ATOMIC_RELAXED);
+      return;
+    }
+  }
+  while ( r->lock.test_and_set(micron::memory_order_acquire) ) __cpu_pause();
+  // rechecked under the lock: trace_stop() flips the switch before it flushes, so nothing lands after its flush
+  if ( __atomic_load_n(&__trace_on, __ATOMIC_SEQ_CST) ) [[likely]] {
+    r->rec[r->n++] = trace_record{ ts, reinterpret_cast<uintptr_t>(ptr), static_cast<u64>(size), r->owner, static_cast<u32>(op) };
+    if ( r->n == __trace_ring_records ) [[unlikely]]
+      __trace_flush_locked(r);
+  }
+  r->lock.clear(micron::memory_order_release);
+}
+
+// the hooks malloc.hpp calls; a single relaxed load while idle, nothing at all unless built with MICRON_ABC_TRACE
+[[gnu::always_inline]] inline void
+__trace(trace_op op, const void *ptr, usize size = 0) noexcept
+{
+  if constexpr ( __default_trace ) {
+    if ( __atomic_load_n(&__trace_on, __ATOMIC_RELAXED) == 0 ) [[likely]]
+      return;
+    if ( ptr == nullptr ) return;
+    __trace_append(op, ptr, size);
+  } else {
+    (void)op;
+    (void)ptr;
+    (void)size;
+  }
+}
+
+inline bool
+__trace_start(const char *path) noexcept
+{
+  if ( path == nullptr ) return false;
+  while ( __trace_file_lock.test_and_set(micron::memory_order_acquire) ) __cpu_pause();
+  bool ok = false;
+  if ( __atomic_load_n(&__trace_fd, __ATOMIC_RELAXED) < 0 ) {
+    // O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644
+    const int fd = static_cast<int>(micron::syscall(SYS_open, path, 01 | 0100 | 01000 | 02000, 0644));
+    const trace_header h{ { 'A', 'B', 'C', 'T', 'R', 'A', 'C', 'E' }, __trace_version, static_cast<u32>(sizeof(trace_record)) };
+    if ( fd >= 0 and static_cast<long>(micron::syscall(SYS_write, fd, &h, sizeof(h))) == static_cast<long>(sizeof(h)) ) {
+      __atomic_store_n(&__trace_written, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&__trace_lost, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&__trace_fd, static_cast<i32>(fd), __ATOMIC_RELEASE);
+      __atomic_store_n(&__trace_on, 1u, __ATOMIC_SEQ_CST);
+      ok = true;
+    } else if ( fd >= 0 ) {
+      micron::syscall(SYS_close, fd);
+    }
+  }
+  __trace_file_lock.clear(micron::memory_order_release);
+  return ok;
+}
+
+// switch off, then flush every ring (each under its owner's lock) and close the file
+inline trace_stats
+__trace_stop(void) noexcept
+{
+  __atomic_store_n(&__trace_on, 0u, __ATOMIC_SEQ_CST);
+  for ( __trace_ring *r = __atomic_load_n(&__trace_rings, __ATOMIC_SEQ_CST); r != nullptr; r = r->next ) {
+    while ( r->lock.test_and_set(micron::memory_order_acquire) ) __cpu_pause();
+    __trace_flush_locked(r);
+    r->lock.clear(micron::memory_order_release);
+  }
+  while ( __trace_file_lock.test_and_set(micron::memory_order_acquire) ) __cpu_pause();
+  const i32 fd = __atomic_exchange_n(&__trace_fd, -1, __ATOMIC_ACQ_REL);
+  __trace_file_lock.clear(micron::memory_order_release);
+  if ( fd >= 0 ) micron::syscall(SYS_close, fd);
+  return trace_stats{ __atomic_load_n(&__trace_written, __ATOMIC_RELAXED), __atomic_load_n(&__trace_lost, __ATOMIC_RELAXED) };
+}
+
+};      // namespace abc
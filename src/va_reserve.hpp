@@ -27,6 +27,7 @@
 #include <micron/memory/mman.hpp>
 #include <micron/memory/mmap_bits.hpp>
 #include <micron/mutex/locks/guard_lock.hpp>
+#include <micron/syscall.hpp>
 #include <micron/types.hpp>
 
 namespace abc
@@ -43,6 +44,7 @@ constexpr static const usize __sheet_align_log2 = 16;      // 64 KiB == the mini
 constexpr static const usize __sheet_align = 1ULL << __sheet_align_log2;
 constexpr static const usize __sheet_align_mask = __sheet_align - 1;
 
+// VA taken per reservation; more are chained on as they fill, so this bounds one sheet, not the heap
 #ifndef MICRON_ABC_VA_RESERVE_SIZE
 #if defined(__micron_arch_width_64)
 // 256 GiB
@@ -58,170 +60,592 @@ static_assert((__va_reservation_size & __sheet_align_mask) == 0,
               "abcmalloc: MICRON_ABC_VA_RESERVE_SIZE must be a whole multiple of the sheet granule.");
 
 constexpr static const i32 __map_noreserve_flag = 0x4000;
+constexpr static const i32 __mremap_maymove_flag = 0x1;
+constexpr static const i32 __mremap_fixed_flag = 0x2;
 
-inline micron::atomic_token<addr_t *> __va_base{ nullptr };      // PROT_NONE base, or nullptr if not yet reserved
-inline micron::atomic_token<u64> __va_offset{ 0 };               // bump cursor in bytes
-inline micron::atomic_flag __va_init_lock{};                     // one-shot init guard
+class __arena;
 
-struct __va_free_run {
-  u64 off;           // byte offset from __va_base
-  u32 granules;      // run length in __sheet_align granules
-};
-
-constexpr static const usize __va_free_granules = __va_reservation_size >> __sheet_align_log2;
+// granule table
+//
+// every granule a sheet can live in has one entry, reached in two loads: a static directory of leaves indexed by
+// the high address bits, then the leaf. a leaf covers 2^__va_leaf_log2 bytes of address space and is mapped
+// MAP_NORESERVE the first time anything in its span is registered, so only the entries actually touched are ever
+// committed. the table covers the whole user address space, which is what lets reservations chain and lets
+// mappings made outside them (a request bigger than a reservation, or no VA left to chain one) be found the same way
 #if defined(__micron_arch_width_64)
-constexpr static const usize __va_free_cap = __va_free_granules;
+constexpr static const usize __va_addr_bits = 48;      // user VA on x86-64 (47) and arm64 (48)
+constexpr static const usize __va_leaf_log2 = 36;      // 64 GiB of address space per leaf
 #else
-constexpr static const usize __va_free_cap = __va_free_granules > 1024 ? usize{ 1024 } : __va_free_granules;
+constexpr static const usize __va_addr_bits = 32;
+constexpr static const usize __va_leaf_log2 = 28;      // 256 MiB of address space per leaf
 #endif
-inline __va_free_run __va_free_runs[__va_free_cap]{};
-inline usize __va_free_count{ 0 };
-inline micron::atomic_flag __va_free_lock{};
+constexpr static const u32 __va_leaf_granules = 1u << (__va_leaf_log2 - __sheet_align_log2);
+constexpr static const usize __va_leaves = static_cast<usize>(1) << (__va_addr_bits - __va_leaf_log2);
+constexpr static const u32 __va_reservation_granules = static_cast<u32>(__va_reservation_size >> __sheet_align_log2);
+constexpr static const u32 __va_no_granule = ~static_cast<u32>(0);
+static_assert(__va_leaf_granules >= 64, "abcmalloc: a granule table leaf must hold at least one reservation bitmap word.");
+
+// owning arena + tier binding (sheet_header.hpp), and the boundary tags of the VA run index (below).
+// granules are numbered absolutely (address >> __sheet_align_log2), so a granule number fits a u32 on every target
+struct __granule_entry {
+  __arena *owner;
+  uintptr_t sheet;      // tier node | tier tag, 0 == unbound
+  u32 run_len;
+  u32 run_next;      // granule + 1, 0 == end of the bin list
+  u32 run_prev;
+  u8 run_kind;
+  u16 prof_samples;      // live heap-profile samples in this granule, owner-only (heap_profile.hpp)
+};
+
+struct __va_leaf {
+  u64 reserved[__va_leaf_granules / 64];      // granules inside one of our reservations
+  __granule_entry g[__va_leaf_granules];
+};
+
+inline __va_leaf *__va_table[__va_leaves]{};
 
-[[gnu::cold, gnu::noinline]] inline addr_t *
-__va_reserve_once() noexcept
+[[gnu::always_inline]] inline u32
+__va_granule(const void *p) noexcept
 {
-  addr_t *base = __va_base.get(micron::memory_order_acquire);
-  if ( base ) return base;
+  return static_cast<u32>(reinterpret_cast<uintptr_t>(p) >> __sheet_align_log2);
+}
 
-  // serialize the actual mmap; double-checked under the lock so contenders just observe the publish
-  micron::free_guard<> guard{ &__va_init_lock };
-  base = __va_base.get(micron::memory_order_relaxed);
-  if ( base ) return base;
+[[gnu::always_inline]] inline addr_t *
+__va_addr(u32 g) noexcept
+{
+  return reinterpret_cast<addr_t *>(static_cast<uintptr_t>(g) << __sheet_align_log2);
+}
 
-  base = micron::mmap(nullptr, __va_reservation_size, micron::prot_none, micron::map_private | micron::map_anonymous | __map_noreserve_flag,
-                      -1, 0);
-  if ( micron::mmap_failed(base) || !base ) {
+// entry of p's granule, nullptr if nothing in its leaf was ever registered
+[[gnu::always_inline]] inline __granule_entry *
+__granule_of(const void *p) noexcept
+{
+  const uintptr_t pi = reinterpret_cast<uintptr_t>(p);
+  const uintptr_t l = pi >> __va_leaf_log2;
+  if ( l >= __va_leaves ) [[unlikely]]
     return nullptr;
+  __va_leaf *lf = __atomic_load_n(&__va_table[l], __ATOMIC_ACQUIRE);
+  if ( !lf ) return nullptr;
+  return &lf->g[(pi >> __sheet_align_log2) & (__va_leaf_granules - 1)];
+}
+
+[[gnu::cold, gnu::noinline]] inline __va_leaf *
+__va_leaf_make(uintptr_t l) noexcept
+{
+  addr_t *m = micron::mmap(nullptr, sizeof(__va_leaf), micron::prot_read | micron::prot_write,
+                           micron::map_private | micron::map_anonymous | __map_noreserve_flag, -1, 0);
+  if ( micron::mmap_failed(m) || !m ) return nullptr;
+  __va_leaf *expect = nullptr;
+  if ( __atomic_compare_exchange_n(&__va_table[l], &expect, reinterpret_cast<__va_leaf *>(m), false, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE) )
+    return reinterpret_cast<__va_leaf *>(m);
+  micron::munmap(m, sizeof(__va_leaf));      // lost the race; the winner's leaf is as good
+  return expect;
+}
+
+// entry of granule g, mapping its leaf first if need be; nullptr only if the leaf can't be mapped
+inline __granule_entry *
+__granule_make(u32 g) noexcept
+{
+  const uintptr_t l = static_cast<uintptr_t>(g) >> (__va_leaf_log2 - __sheet_align_log2);
+  if ( l >= __va_leaves ) [[unlikely]]
+    return nullptr;
+  __va_leaf *lf = __atomic_load_n(&__va_table[l], __ATOMIC_ACQUIRE);
+  if ( !lf ) [[unlikely]] {
+    lf = __va_leaf_make(l);
+    if ( !lf ) return nullptr;
+  }
+  return &lf->g[g & (__va_leaf_granules - 1)];
+}
+
+// run-index access; every granule of a reservation has its leaf mapped before the reservation is handed out
+[[gnu::always_inline]] inline __granule_entry &
+__va_tag(u32 g) noexcept
+{
+  return __va_table[g >> (__va_leaf_log2 - __sheet_align_log2)]->g[g & (__va_leaf_granules - 1)];
+}
+
+// a neighbour of a run may lie outside every reservation, in a leaf that was never mapped
+[[gnu::always_inline]] inline u8
+__va_kind_at(u32 g) noexcept
+{
+  const usize l = g >> (__va_leaf_log2 - __sheet_align_log2);
+  const __va_leaf *lf = l < __va_leaves ? __va_table[l] : nullptr;
+  return lf ? lf->g[g & (__va_leaf_granules - 1)].run_kind : static_cast<u8>(0);
+}
+
+[[gnu::always_inline]] inline bool
+__va_contains(const void *p) noexcept
+{
+  const uintptr_t pi = reinterpret_cast<uintptr_t>(p);
+  const uintptr_t l = pi >> __va_leaf_log2;
+  if ( l >= __va_leaves ) [[unlikely]]
+    return false;
+  const __va_leaf *lf = __atomic_load_n(&__va_table[l], __ATOMIC_ACQUIRE);
+  if ( !lf ) return false;
+  const u32 i = static_cast<u32>(pi >> __sheet_align_log2) & (__va_leaf_granules - 1);
+  return (__atomic_load_n(&lf->reserved[i >> 6], __ATOMIC_RELAXED) >> (i & 63)) & 1;
+}
+
+// reservations
+//
+// VA is reserved __va_reservation_size at a time, PROT_NONE and granule aligned. the bump cursor walks the newest
+// one; when it can't fit a request another reservation is chained on and the unbumped tail of the old one goes to
+// the free run index, so nothing reserved is lost. the cursor packs (end granule << 32) | next granule into one
+// word, so a bump is a single CAS and a new reservation is published in one store
+inline micron::atomic_token<u64> __va_cursor{ 0 };
+inline micron::atomic_token<u32> __va_reservations{ 0 };      // chained so far
+inline micron::atomic_flag __va_grow_lock{};
+
+// granule-aligned mapping of `rounded` bytes anywhere in the address space: over-map by one granule, trim both ends
+[[gnu::cold]] inline addr_t *
+__va_map_aligned(usize rounded, i32 prot, i32 flags) noexcept
+{
+  const usize span = rounded + __sheet_align;
+  addr_t *raw = micron::mmap(nullptr, span, prot, micron::map_private | micron::map_anonymous | flags, -1, 0);
+  if ( micron::mmap_failed(raw) || !raw ) return nullptr;
+  const uintptr_t r = reinterpret_cast<uintptr_t>(raw);
+  const uintptr_t b = (r + __sheet_align_mask) & ~__sheet_align_mask;
+  if ( b > r ) micron::munmap(raw, b - r);
+  if ( b + rounded < r + span ) micron::munmap(reinterpret_cast<addr_t *>(b + rounded), r + span - b - rounded);
+  return reinterpret_cast<addr_t *>(b);
+}
+
+// reserve one more window and make it indexable; returns its first granule, __va_no_granule if the kernel refused
+[[gnu::cold, gnu::noinline]] inline u32
+__va_reserve_more() noexcept
+{
+  addr_t *base = __va_map_aligned(__va_reservation_size, micron::prot_none, __map_noreserve_flag);
+  if ( !base ) return __va_no_granule;
+  const uintptr_t bi = reinterpret_cast<uintptr_t>(base);
+  const u32 g = __va_granule(base);
+  for ( uintptr_t l = bi >> __va_leaf_log2; l <= (bi + __va_reservation_size - 1) >> __va_leaf_log2; ++l ) {
+    if ( l >= __va_leaves || !__granule_make(static_cast<u32>(l << (__va_leaf_log2 - __sheet_align_log2))) ) [[unlikely]] {
+      micron::munmap(base, __va_reservation_size);
+      return __va_no_granule;
+    }
   }
-  __va_base.store(base, micron::memory_order_release);
-  return base;
+  for ( u32 i = 0; i < __va_reservation_granules; ++i ) {
+    __va_leaf *lf = __va_table[(g + i) >> (__va_leaf_log2 - __sheet_align_log2)];
+    const u32 k = (g + i) & (__va_leaf_granules - 1);
+    __atomic_fetch_or(&lf->reserved[k >> 6], u64{ 1 } << (k & 63), __ATOMIC_RELAXED);
+  }
+  __va_reservations.fetch_add(1, micron::memory_order_acq_rel);
+  return g;
 }
 
-// commit a carved run: replace its PROT_NONE backing with PROT_READ|WRITE anonymous pages
+// commit a carved run: replace its PROT_NONE backing with PROT_READ|WRITE anonymous pages.
+// lazy runs skip commit accounting (MAP_NORESERVE); their pages are charged one fault at a time on first touch
 [[gnu::always_inline]] inline addr_t *
-__va_commit(addr_t *slot, usize rounded) noexcept
+__va_commit(addr_t *slot, usize rounded, bool lazy = false) noexcept
 {
   addr_t *got = micron::mmap(slot, rounded, micron::prot_read | micron::prot_write,
-                             micron::map_private | micron::map_anonymous | micron::map_fixed, -1, 0);
+                             micron::map_private | micron::map_anonymous | micron::map_fixed | (lazy ? __map_noreserve_flag : 0), -1, 0);
   if ( micron::mmap_failed(got) || got != slot ) [[unlikely]]
     return nullptr;
   return slot;
 }
 
-constexpr static const u64 __va_bump_fail = ~static_cast<u64>(0);
-
-[[gnu::always_inline]] inline u64
-__va_bump(usize rounded) noexcept
+[[gnu::always_inline]] inline u32
+__va_bump(u32 want) noexcept
 {
-  u64 off = __va_offset.get(micron::memory_order_acquire);
+  u64 c = __va_cursor.get(micron::memory_order_acquire);
   for ( ;; ) {
-    if ( off + rounded > __va_reservation_size ) [[unlikely]]
-      return __va_bump_fail;
-    if ( __va_offset.compare_exchange_weak(off, off + rounded, micron::memory_order_acq_rel, micron::memory_order_acquire) ) return off;
+    if ( static_cast<u32>(c >> 32) - static_cast<u32>(c) < want ) [[unlikely]]
+      return __va_no_granule;
+    if ( __va_cursor.compare_exchange_weak(c, c + want, micron::memory_order_acq_rel, micron::memory_order_acquire) )
+      return static_cast<u32>(c);
+  }
+}
+
+// released runs, size-segregated and coalescing
+//   free:     PROT_NONE again, needs a commit (mmap MAP_FIXED) before it can back a sheet
+//   retained: still mapped PROT_READ|WRITE, its pages dropped with MADV_DONTNEED. reuse costs no syscall and the
+//             pages still read as zero, exactly like a fresh commit. the run keeps the commit accounting
+//             (MAP_NORESERVE or not) of whatever last mapped it
+// every head and tail granule of an indexed run carries its kind and length (boundary tags), so a release finds
+// and absorbs both neighbours in O(1); runs of the same kind never sit next to each other. two reservations the
+// kernel happened to place back to back are one stretch of our VA, and runs coalesce across the seam.
+// lengths are binned two-level (TLSF-style: power of two, then __va_sl_count linear steps), lookup is two bitmap scans
+#ifndef MICRON_ABC_VA_RETAIN
+#if defined(__micron_arch_width_64)
+// 512 MiB
+#define MICRON_ABC_VA_RETAIN (512ULL << 20)
+#else
+// 64 MiB
+#define MICRON_ABC_VA_RETAIN (64U << 20)
+#endif
+#endif
+constexpr static const usize __va_retain_bytes = MICRON_ABC_VA_RETAIN;      // 0 == every release goes back to PROT_NONE
+
+constexpr static const u64 __va_retain_granules = __va_retain_bytes >> __sheet_align_log2;
+
+constexpr static const u32 __va_sl_log2 = 3;
+constexpr static const u32 __va_sl_count = 1u << __va_sl_log2;
+constexpr static const u32 __va_fl_count = 32;
+constexpr static const u32 __va_fit_scan = 16;      // runs inspected in the request's own bin before settling for the next bin up
+
+enum : u8 { __va_run_none = 0, __va_run_free = 1, __va_run_retained = 2 };
+
+// the boundary tags live in the granule table (__granule_entry::run_*); links are stored as granule + 1 so a
+// freshly mapped, zeroed leaf is an empty index
+struct __va_run_bins {
+  u32 fl_map;
+  u32 sl_map[__va_fl_count];
+  u32 head[__va_fl_count][__va_sl_count];
+  u64 granules;      // total held in this index
+};
+
+inline __va_run_bins __va_bins[3]{};      // indexed by kind; [__va_run_none] is unused
+inline micron::atomic_flag __va_free_lock{};
+
+[[gnu::always_inline]] inline void
+__va_bin_of(u32 len, u32 &fl, u32 &sl) noexcept
+{
+  if ( len < __va_sl_count ) {
+    fl = 0;
+    sl = len;
+    return;
+  }
+  const u32 f = 31u - static_cast<u32>(__builtin_clz(len));
+  fl = f - __va_sl_log2 + 1;
+  sl = (len >> (f - __va_sl_log2)) ^ __va_sl_count;
+}
+
+inline void
+__va_bin_link(u8 kind, u32 g) noexcept
+{
+  __va_run_bins &b = __va_bins[kind];
+  __granule_entry &t = __va_tag(g);
+  u32 fl, sl;
+  __va_bin_of(t.run_len, fl, sl);
+  const u32 h = b.head[fl][sl];
+  t.run_next = h;
+  t.run_prev = 0;
+  if ( h ) __va_tag(h - 1).run_prev = g + 1;
+  b.head[fl][sl] = g + 1;
+  b.sl_map[fl] |= 1u << sl;
+  b.fl_map |= 1u << fl;
+  b.granules += t.run_len;
+}
+
+inline void
+__va_bin_unlink(u8 kind, u32 g) noexcept
+{
+  __va_run_bins &b = __va_bins[kind];
+  const __granule_entry &t = __va_tag(g);
+  u32 fl, sl;
+  __va_bin_of(t.run_len, fl, sl);
+  const u32 nx = t.run_next;
+  const u32 pv = t.run_prev;
+  if ( nx ) __va_tag(nx - 1).run_prev = pv;
+  if ( pv )
+    __va_tag(pv - 1).run_next = nx;
+  else
+    b.head[fl][sl] = nx;
+  if ( !b.head[fl][sl] ) {
+    b.sl_map[fl] &= ~(1u << sl);
+    if ( !b.sl_map[fl] ) b.fl_map &= ~(1u << fl);
+  }
+  b.granules -= t.run_len;
+}
+
+[[gnu::always_inline]] inline void
+__va_run_tag(u32 g, u32 len, u8 kind) noexcept
+{
+  __granule_entry &h = __va_tag(g);
+  __granule_entry &t = __va_tag(g + len - 1);
+  h.run_len = len;
+  h.run_kind = kind;
+  t.run_len = len;
+  t.run_kind = kind;
+}
+
+// index [g, g + len) as `kind`, absorbing same-kind neighbours. caller holds __va_free_lock
+inline void
+__va_run_insert(u32 g, u32 len, u8 kind) noexcept
+{
+  if ( g > 0 && __va_kind_at(g - 1) == kind ) {
+    const u32 l = __va_tag(g - 1).run_len;
+    const u32 lh = g - l;
+    __va_bin_unlink(kind, lh);
+    __va_tag(g - 1).run_kind = __va_run_none;
+    g = lh;
+    len += l;
   }
+  const u32 r = g + len;
+  if ( __va_kind_at(r) == kind ) {
+    const u32 rl = __va_tag(r).run_len;
+    __va_bin_unlink(kind, r);
+    __va_tag(r).run_kind = __va_run_none;
+    len += rl;
+  }
+  __va_run_tag(g, len, kind);
+  __va_bin_link(kind, g);
 }
 
-inline u64
-__va_reuse(u32 want) noexcept
+// take the first `want` granules of the indexed run headed at g; the tail stays indexed in place
+inline void
+__va_run_take(u8 kind, u32 g, u32 want) noexcept
+{
+  const u32 len = __va_tag(g).run_len;
+  __va_bin_unlink(kind, g);
+  __va_tag(g).run_kind = __va_run_none;
+  __va_tag(g + len - 1).run_kind = __va_run_none;
+  if ( len > want ) {
+    __va_run_tag(g + want, len - want, kind);
+    __va_bin_link(kind, g + want);
+  }
+}
+
+// best fit among the runs of `kind`: the request's own bin is searched for the tightest run (bounded),
+// otherwise the first run of the next non-empty bin up, which fits by construction
+inline u32
+__va_run_find(u8 kind, u32 want) noexcept
+{
+  const __va_run_bins &b = __va_bins[kind];
+  if ( !b.fl_map ) return 0;
+  u32 fl, sl;
+  __va_bin_of(want, fl, sl);
+  u32 best = 0;
+  u32 best_len = ~0u;
+  u32 n = 0;
+  for ( u32 c = b.head[fl][sl]; c && n < __va_fit_scan; c = __va_tag(c - 1).run_next, ++n ) {
+    const u32 l = __va_tag(c - 1).run_len;
+    if ( l < want || l >= best_len ) continue;
+    best = c;
+    best_len = l;
+    if ( l == want ) break;
+  }
+  if ( best ) return best;
+  // every run in a higher bin is strictly longer than anything in (fl, sl)
+  u32 sm = (sl + 1 < __va_sl_count) ? (b.sl_map[fl] & (~0u << (sl + 1))) : 0;
+  if ( !sm ) {
+    const u32 fm = (fl + 1 < __va_fl_count) ? (b.fl_map & (~0u << (fl + 1))) : 0;
+    if ( !fm ) return 0;
+    fl = static_cast<u32>(__builtin_ctz(fm));
+    sm = b.sl_map[fl];
+  }
+  return b.head[fl][static_cast<u32>(__builtin_ctz(sm))];
+}
+
+// claim `want` granules from the index, retained runs first when `prefer_retained`; returns the first granule, or
+// __va_no_granule. `kind` reports what backs the claimed range
+inline u32
+__va_reuse(u32 want, bool prefer_retained, u8 &kind) noexcept
 {
-  constexpr usize __none = ~static_cast<usize>(0);
   micron::free_guard<> guard{ &__va_free_lock };
-  usize best = __none;
-  for ( usize i = __va_free_count; i-- > 0; ) {
-    const u32 g = __va_free_runs[i].granules;
-    if ( g < want ) continue;
-    if ( best == __none || g < __va_free_runs[best].granules ) best = i;
-    if ( g == want ) break;      // exact fit, stop looking
+  const u8 first = prefer_retained ? __va_run_retained : __va_run_free;
+  const u8 second = prefer_retained ? __va_run_free : __va_run_retained;
+  u8 k = first;
+  u32 c = __va_run_find(k, want);
+  if ( !c ) {
+    k = second;
+    c = __va_run_find(k, want);
   }
-  if ( best == __none ) return __va_bump_fail;
-  const u64 off = __va_free_runs[best].off;
-  const u32 g = __va_free_runs[best].granules;
-  if ( g > want ) {      // hand back the head, keep the shrunk tail in place
-    __va_free_runs[best].off = off + (static_cast<u64>(want) << __sheet_align_log2);
-    __va_free_runs[best].granules = g - want;
-  } else {
-    __va_free_runs[best] = __va_free_runs[--__va_free_count];      // swap-remove
+  if ( !c ) return __va_no_granule;
+  __va_run_take(k, c - 1, want);
+  kind = k;
+  return c - 1;
+}
+
+// chain a new reservation once the current one can't fit `want` granules. the old cursor is swapped out in one
+// CAS, after which nothing can bump into the old tail, so it is indexed as a free run. false if the kernel is out of VA
+[[gnu::cold, gnu::noinline]] inline bool
+__va_grow(u32 want) noexcept
+{
+  if ( want > __va_reservation_granules ) return false;
+  micron::free_guard<> guard{ &__va_grow_lock };
+  u64 c = __va_cursor.get(micron::memory_order_acquire);
+  if ( static_cast<u32>(c >> 32) - static_cast<u32>(c) >= want ) return true;      // chained by someone else meanwhile
+  const u32 g = __va_reserve_more();
+  if ( g == __va_no_granule ) return false;
+  const u64 fresh = (static_cast<u64>(g + __va_reservation_granules) << 32) | g;
+  while ( !__va_cursor.compare_exchange_weak(c, fresh, micron::memory_order_acq_rel, micron::memory_order_acquire) ) {
   }
-  return off;
+  const u32 next = static_cast<u32>(c);
+  const u32 end = static_cast<u32>(c >> 32);
+  if ( next < end ) {
+    micron::free_guard<> lk{ &__va_free_lock };
+    __va_run_insert(next, end - next, __va_run_free);
+  }
+  return true;
 }
 
-inline addr_t *
-__va_carve(usize bytes) noexcept
+// fresh granules off the cursor, chaining reservations as needed
+inline u32
+__va_bump_or_grow(u32 want) noexcept
 {
-  addr_t *base = __va_base.get(micron::memory_order_acquire);
-  if ( !base ) [[unlikely]] {
-    base = __va_reserve_once();
-    if ( !base ) return nullptr;
+  for ( ;; ) {
+    const u32 g = __va_bump(want);
+    if ( g != __va_no_granule ) [[likely]]
+      return g;
+    if ( !__va_grow(want) ) return __va_no_granule;
   }
+}
 
+// nullptr if the request is bigger than a reservation or no more VA can be reserved; the caller maps it on its own
+inline addr_t *
+__va_carve(usize bytes, bool lazy = false) noexcept
+{
   const usize rounded = (bytes + __sheet_align_mask) & ~__sheet_align_mask;
+  if ( rounded > __va_reservation_size ) [[unlikely]]
+    return nullptr;
   const u32 want = static_cast<u32>(rounded >> __sheet_align_log2);
 
-  const u64 reuse_off = __va_reuse(want);
-  if ( reuse_off != __va_bump_fail ) {
-    addr_t *slot = reinterpret_cast<addr_t *>(reinterpret_cast<uintptr_t>(base) + reuse_off);
-    if ( addr_t *got = __va_commit(slot, rounded); got ) [[likely]]
+  u8 kind = __va_run_none;
+  const u32 reuse = __va_reuse(want, true, kind);
+  if ( reuse != __va_no_granule ) {
+    addr_t *slot = __va_addr(reuse);
+    if ( kind == __va_run_retained ) return slot;      // already committed and zeroed
+    if ( addr_t *got = __va_commit(slot, rounded, lazy); got ) [[likely]]
       return got;
-    // remap failed: the run is now dropped from the list (effectively leaked); fall through to a fresh carve
+    // a failed MAP_FIXED leaves the PROT_NONE backing in place: back into the index, then try fresh granules
+    micron::free_guard<> lk{ &__va_free_lock };
+    __va_run_insert(reuse, want, __va_run_free);
   }
 
-  const u64 off = __va_bump(rounded);
-  if ( off == __va_bump_fail ) [[unlikely]]
-    return nullptr;      // reservation exhausted
-
-  return __va_commit(reinterpret_cast<addr_t *>(reinterpret_cast<uintptr_t>(base) + off), rounded);
+  const u32 g = __va_bump_or_grow(want);
+  if ( g == __va_no_granule ) [[unlikely]]
+    return nullptr;
+  if ( addr_t *got = __va_commit(__va_addr(g), rounded, lazy); got ) [[likely]]
+    return got;
+  micron::free_guard<> lk{ &__va_free_lock };
+  __va_run_insert(g, want, __va_run_free);
+  return nullptr;
 }
 
+// VA only: the result is either PROT_NONE or a retained mapping, and must be replaced wholesale (mremap MAP_FIXED)
 inline addr_t *
 __va_carve_reserved(usize bytes) noexcept
 {
-  addr_t *base = __va_base.get(micron::memory_order_acquire);
-  if ( !base ) [[unlikely]] {
-    base = __va_reserve_once();
-    if ( !base ) return nullptr;
-  }
-
   const usize rounded = (bytes + __sheet_align_mask) & ~__sheet_align_mask;
+  if ( rounded > __va_reservation_size ) [[unlikely]]
+    return nullptr;
   const u32 want = static_cast<u32>(rounded >> __sheet_align_log2);
 
-  const u64 reuse_off = __va_reuse(want);
-  if ( reuse_off != __va_bump_fail ) return reinterpret_cast<addr_t *>(reinterpret_cast<uintptr_t>(base) + reuse_off);
+  u8 kind = __va_run_none;
+  const u32 reuse = __va_reuse(want, false, kind);
+  if ( reuse != __va_no_granule ) return __va_addr(reuse);
 
-  const u64 off = __va_bump(rounded);
-  if ( off == __va_bump_fail ) [[unlikely]]
-    return nullptr;      // reservation exhausted
-  return reinterpret_cast<addr_t *>(reinterpret_cast<uintptr_t>(base) + off);
+  const u32 g = __va_bump_or_grow(want);
+  if ( g == __va_no_granule ) [[unlikely]]
+    return nullptr;
+  return __va_addr(g);
 }
 
+// replace the range with PROT_NONE again (drops its pages, keeps the VA reserved) and index it as free.
+// the only safe release for a range whose mapping state is unknown: a hole left by mremap, or a carve_reserved slot
 inline void
-__va_release(addr_t *slot, usize bytes) noexcept
+__va_unreserve(addr_t *slot, usize rounded) noexcept
+{
+  (void)micron::mmap(slot, rounded, micron::prot_none,
+                     micron::map_private | micron::map_anonymous | micron::map_fixed | __map_noreserve_flag, -1, 0);
+  micron::free_guard<> guard{ &__va_free_lock };
+  __va_run_insert(__va_granule(slot), static_cast<u32>(rounded >> __sheet_align_log2), __va_run_free);
+}
+
+// release a committed run. while the retained index is under __va_retain_bytes the run stays mapped: one madvise, no
+// mmap_lock write, and the next carve of that size costs no syscall at all. `guard` trailing bytes were mprotect'ed
+// by the sheet (its guard page) and are opened back up so a retained run is uniformly PROT_READ|WRITE.
+// runs are whole 2 MiB granules on width-64, so dropping one never splits a transparent huge page
+inline void
+__va_release(addr_t *slot, usize bytes, usize guard = 0) noexcept
 {
   if ( !slot ) return;
-  addr_t *base = __va_base.get(micron::memory_order_relaxed);
-  if ( !base ) return;
-  const uintptr_t si = reinterpret_cast<uintptr_t>(slot);
-  const uintptr_t bi = reinterpret_cast<uintptr_t>(base);
-  if ( si < bi || si >= bi + __va_reservation_size ) [[unlikely]]
+  if ( !__va_contains(slot) ) [[unlikely]]
     return;      // not a carved VA slot; nothing to reclaim
   const usize rounded = (bytes + __sheet_align_mask) & ~__sheet_align_mask;
-  // replace the populated region with PROT_NONE again to release physical pages (keeps the VA reserved)
-  (void)micron::mmap(slot, rounded, micron::prot_none,
-                     micron::map_private | micron::map_anonymous | micron::map_fixed | __map_noreserve_flag, -1, 0);
-  const u64 off = static_cast<u64>(si - bi);
+  const u32 g = __va_granule(slot);
   const u32 granules = static_cast<u32>(rounded >> __sheet_align_log2);
-  micron::free_guard<> guard{ &__va_free_lock };
-  if ( __va_free_count < __va_free_cap ) __va_free_runs[__va_free_count++] = __va_free_run{ off, granules };
+
+  if constexpr ( __va_retain_granules > 0 ) {
+    // the cap is checked before the madvise and is soft: concurrent releases can overshoot it by a run each
+    bool fits;
+    {
+      micron::free_guard<> lk{ &__va_free_lock };
+      fits = __va_bins[__va_run_retained].granules + granules <= __va_retain_granules;
+    }
+    if ( fits ) {
+      byte *const s = reinterpret_cast<byte *>(slot);
+      const bool opened = guard == 0 || micron::mprotect(s + rounded - guard, guard, micron::prot_read | micron::prot_write) == 0;
+      if ( opened && micron::madvise(s, rounded, micron::madv_dontneed) == 0 ) [[likely]] {
+        micron::free_guard<> lk{ &__va_free_lock };
+        __va_run_insert(g, granules, __va_run_retained);
+        return;
+      }
+    }
+  }
+  __va_unreserve(slot, rounded);
 }
 
-[[gnu::always_inline]] inline bool
-__va_contains(const void *p) noexcept
+// claim the `extra` bytes of VA directly after a carved run so it can grow in place. succeeds iff the run ends at the
+// bump cursor or an indexed run starts there; `kind` says whether the claimed range still needs a commit
+inline bool
+__va_claim_after(addr_t *slot, usize bytes, usize extra, u8 &kind) noexcept
 {
-  addr_t *base = __va_base.get(micron::memory_order_relaxed);
-  if ( !base ) return false;
-  const uintptr_t pi = reinterpret_cast<uintptr_t>(p);
-  const uintptr_t bi = reinterpret_cast<uintptr_t>(base);
-  return pi >= bi && pi < bi + __va_reservation_size;
+  const u32 end = __va_granule(slot) + static_cast<u32>(((bytes + __sheet_align_mask) & ~__sheet_align_mask) >> __sheet_align_log2);
+  const u32 want = static_cast<u32>(((extra + __sheet_align_mask) & ~__sheet_align_mask) >> __sheet_align_log2);
+
+  u64 c = __va_cursor.get(micron::memory_order_acquire);
+  while ( static_cast<u32>(c) == end && static_cast<u32>(c >> 32) - end >= want ) {
+    if ( __va_cursor.compare_exchange_weak(c, c + want, micron::memory_order_acq_rel, micron::memory_order_acquire) ) {
+      kind = __va_run_free;
+      return true;
+    }
+  }
+
+  micron::free_guard<> guard{ &__va_free_lock };
+  // end - 1 is ours, so a tag at end can only be the head of an indexed run (or nothing, past a reservation's edge)
+  const u8 k = __va_kind_at(end);
+  if ( k == __va_run_none || __va_tag(end).run_len < want ) return false;
+  __va_run_take(k, end, want);
+  kind = k;
+  return true;
+}
+// resize a carved, committed run without copying its contents
+//   shrink: mremap in place, the released tail goes back to the index
+//   grow:   commit the VA right after the run if it is free (nothing to do if it is retained), else move the page
+//           tables with mremap(MAYMOVE | FIXED) onto a freshly carved slot and release the old run
+// returns the (possibly moved) slot, nullptr if the reservation can't hold the new size
+inline addr_t *
+__va_remap(addr_t *slot, usize bytes, usize new_bytes) noexcept
+{
+  const usize rounded = (bytes + __sheet_align_mask) & ~__sheet_align_mask;
+  const usize new_rounded = (new_bytes + __sheet_align_mask) & ~__sheet_align_mask;
+  if ( new_rounded == rounded ) return slot;
+  byte *const s = reinterpret_cast<byte *>(slot);
+
+  if ( new_rounded < rounded ) {
+    const long r = static_cast<long>(micron::syscall(SYS_mremap, slot, rounded, new_rounded, 0));
+    if ( micron::mmap_failed(reinterpret_cast<addr_t *>(r)) ) [[unlikely]]
+      return nullptr;
+    // mremap unmapped the tail: a hole, not a mapping
+    __va_unreserve(reinterpret_cast<addr_t *>(s + new_rounded), rounded - new_rounded);
+    return slot;
+  }
+
+  u8 kind = __va_run_none;
+  if ( __va_claim_after(slot, rounded, new_rounded - rounded, kind) ) {
+    if ( kind == __va_run_retained ) return slot;
+    if ( __va_commit(reinterpret_cast<addr_t *>(s + rounded), new_rounded - rounded) ) [[likely]]
+      return slot;
+    __va_unreserve(reinterpret_cast<addr_t *>(s + rounded), new_rounded - rounded);
+    return nullptr;
+  }
+
+  addr_t *dst = __va_carve_reserved(new_rounded);
+  if ( !dst ) [[unlikely]]
+    return nullptr;
+  const long r = static_cast<long>(
+      micron::syscall(SYS_mremap, slot, rounded, new_rounded, __mremap_maymove_flag | __mremap_fixed_flag, dst));
+  if ( micron::mmap_failed(reinterpret_cast<addr_t *>(r)) || reinterpret_cast<addr_t *>(r) != dst ) [[unlikely]] {
+    __va_unreserve(dst, new_rounded);
+    return nullptr;
+  }
+  // the old range is now a hole inside the reservation; re-reserve it and hand it back
+  __va_unreserve(slot, rounded);
+  return dst;
 }
 
 };      // namespace abc
@@ -61,7 +61,7 @@ main()
       mc::console("#", n, " - Allocated memory, with size of: ", mem.len, " at address: ", mem.ptr);
       if ( arena.pop(mem) == false ) mc::console("Failed to pop memory at: ", mem.ptr);
     }
-    abc::stats_t stats = abc::get_stats();
+    abc::stats_t stats = arena.stats();
     mc::console("Total number of memory allocations: ", stats.alloc_requests);
     mc::console("Total number of memory deallocations: ", stats.dealloc_requests);
     mc::console("Total amount of memory requested: ", stats.total_memory_req);
@@ -8,7 +8,7 @@
 //  See accompanying file LICENSE_1_0.txt or copy at
 //  http://www.boost.org/LICENSE_1_0.txt
 
-// extensive abcmalloc test: hot/cold tier ceiling, multi-word __space_mask
+// extensive abcmalloc test: hot/cold tier ceiling, multi-word availability bitmap
 // invariants, allocator_small routing, tombstone reclaim, provenance & freeze,
 // alignment & redzone-friendly patterns.
 
@@ -170,7 +170,7 @@ main(int, char **)
 
   // ─────────────────────────────────────────────────────────────────────────
   // multi-word bitmap stress — drive each hot tier past 64 simultaneous
-  // allocations so the expanded __space_mask is actually exercised
+  // allocations so the multi-word availability bitmap is actually exercised
   // ─────────────────────────────────────────────────────────────────────────
 
   test_case("multi-word bitmap: 200 simultaneous 4 KiB allocations stay live");
@@ -0,0 +1,135 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// native aligned allocation (push_aligned): aligned_alloc / posix_memalign / memalign.
+//
+// every aligned block is a real block start, so plain free takes it back, and it is never grown past what the
+// alignment needs; the second allocation of a pair getting the first one's address back shows the free landed.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr usize ALIGNS[] = { 64, 128, 256, 512, 1024, 2048, 4096, 16384, 65536, 262144, 2u << 20 };
+constexpr usize SIZES[] = { 1, 24, 100, 300, 1000, 4000, 4096, 9000, 70000, 600000 };
+
+bool
+aligned_to(const void *p, usize al)
+{
+  return (reinterpret_cast<uintptr_t>(p) & (al - 1)) == 0;
+}
+
+bool
+writable(byte *p, usize sz)
+{
+  p[0] = 0x5A;
+  p[sz - 1] = 0xA5;
+  return p[0] == 0x5A and p[sz - 1] == 0xA5;
+}
+
+};      // namespace
+
+int
+main()
+{
+  test_case("aligned blocks are not over-allocated");
+  {
+    // slab class
+    byte *a = reinterpret_cast<byte *>(abc::aligned_alloc(64, 64));
+    require_true(a != nullptr and aligned_to(a, 64));
+    require_true(abc::query_size(reinterpret_cast<addr_t *>(a)) < 128);
+    // aligned tlsf split
+    byte *b = reinterpret_cast<byte *>(abc::memalign(512, 600));
+    require_true(b != nullptr and aligned_to(b, 512));
+    require_true(abc::query_size(reinterpret_cast<addr_t *>(b)) < 600 + 512);
+    // one page-sized buddy block (checked first, before the caches hold anything bigger)
+    byte *c = reinterpret_cast<byte *>(abc::memalign(4096, 100));
+    require_true(c != nullptr and aligned_to(c, 4096));
+    require_true(abc::query_size(reinterpret_cast<addr_t *>(c)) <= 4096);
+    abc::free(a);
+    abc::free(b);
+    abc::free(c);
+  }
+  end_test_case();
+
+  test_case("posix_memalign serves every alignment up to 2 MiB at any size, free takes it back");
+  {
+    for ( usize al : ALIGNS ) {
+      for ( usize sz : SIZES ) {
+        void *p = nullptr;
+        require_true(abc::posix_memalign(&p, al, sz) == 0);
+        require_true(p != nullptr);
+        require_true(aligned_to(p, al));
+        require_true(abc::is_present(reinterpret_cast<byte *>(p)));
+        require_true(writable(reinterpret_cast<byte *>(p), sz));
+        abc::free(p);
+        require_true(!abc::is_present(reinterpret_cast<byte *>(p)));
+      }
+    }
+  }
+  end_test_case();
+
+  test_case("a freed aligned block is reused by the next aligned request");
+  {
+    const usize als[] = { 64, 4096, 65536 };
+    for ( usize al : als ) {
+      void *p = abc::aligned_alloc(al, al * 2);
+      abc::free(p);
+      void *q = abc::aligned_alloc(al, al * 2);
+      require_true(p == q);
+      abc::free(q);
+    }
+  }
+  end_test_case();
+
+  test_case("aligned and plain allocations interleave in the tlsf tier");
+  {
+    constexpr u32 N = 2048;
+    static byte *held[N];
+    for ( u32 i = 0; i < N; ++i ) {
+      held[i] = (i & 1) ? abc::alloc(300 + i % 700) : reinterpret_cast<byte *>(abc::memalign(64u << (i % 5), 300 + i % 700));
+      require_true(held[i] != nullptr);
+      if ( !(i & 1) ) require_true(aligned_to(held[i], 64u << (i % 5)));
+      micron::memset(held[i], static_cast<byte>(i), 300);
+    }
+    for ( u32 i = 0; i < N; ++i ) require_true(held[i][0] == static_cast<byte>(i) and held[i][299] == static_cast<byte>(i));
+    for ( u32 i = 0; i < N; i += 2 ) abc::free(held[i]);
+    for ( u32 i = 1; i < N; i += 2 ) abc::free(held[i]);
+  }
+  end_test_case();
+
+  test_case("argument checks");
+  {
+    void *p = reinterpret_cast<void *>(0x1);
+    require_true(abc::posix_memalign(&p, 3, 64) != 0);
+    require_true(abc::posix_memalign(&p, 4, 64) != 0);      // below sizeof(void *)
+    require_true(abc::posix_memalign(&p, 8u << 20, 64) != 0);
+    require_true(p == reinterpret_cast<void *>(0x1));      // untouched on failure
+    require_true(abc::memalign(48, 96) == nullptr);
+    require_true(abc::aligned_alloc(64, 100) == nullptr);
+    abc::aligned_free(nullptr);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC ALIGNED TESTS PASSED ===\n");
+  return 1;
+}
@@ -0,0 +1,106 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// alloc_batch / dealloc_batch.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr usize N = 4096;
+constexpr usize SIZES[] = { 16, 48, 256, 700, 3000, 9000, 70000 };
+
+byte *g_ptrs[N];
+
+u64
+xorshift(u64 &s) noexcept
+{
+  s ^= s << 13;
+  s ^= s >> 7;
+  s ^= s << 17;
+  return s;
+}
+
+bool
+disjoint_and_live(byte **p, usize n, usize sz)
+{
+  for ( usize i = 0; i < n; ++i ) {
+    if ( p[i] == nullptr or !abc::is_present(p[i]) ) return false;
+    micron::memset(p[i], static_cast<byte>(i), sz);
+  }
+  for ( usize i = 0; i < n; ++i )
+    if ( p[i][0] != static_cast<byte>(i) or p[i][sz - 1] != static_cast<byte>(i) ) return false;
+  return true;
+}
+
+};      // namespace
+
+int
+main()
+{
+  test_case("a batch is n distinct live blocks and frees back whole");
+  {
+    for ( usize sz : SIZES ) {
+      const usize n = sz > 8192 ? N / 16 : N;
+      require_true(abc::alloc_batch(sz, n, g_ptrs) == n);
+      require_true(disjoint_and_live(g_ptrs, n, sz));
+      require_true(abc::dealloc_batch(g_ptrs, n) == n);
+      for ( usize i = 0; i < n; i += 97 ) require_true(!abc::is_present(g_ptrs[i]));
+    }
+  }
+  end_test_case();
+
+  test_case("shuffled input with holes and mixed tiers");
+  {
+    const usize h = N / 2;
+    require_true(abc::alloc_batch(128, h, g_ptrs) == h);
+    require_true(abc::alloc_batch(2048, h, g_ptrs + h) == h);
+    u64 seed = 0x9E3779B97F4A7C15ULL;
+    for ( usize i = N - 1; i > 0; --i ) {
+      const usize j = static_cast<usize>(xorshift(seed) % (i + 1));
+      byte *t = g_ptrs[i];
+      g_ptrs[i] = g_ptrs[j];
+      g_ptrs[j] = t;
+    }
+    usize holes = 0;
+    for ( usize i = 0; i < N; i += 13 ) {
+      abc::dealloc(g_ptrs[i]);
+      g_ptrs[i] = nullptr;
+      ++holes;
+    }
+    require_true(abc::dealloc_batch(g_ptrs, N) == N - holes);
+  }
+  end_test_case();
+
+  test_case("batched blocks mix with the single-object API");
+  {
+    require_true(abc::alloc_batch(512, 64, g_ptrs) == 64);
+    for ( usize i = 0; i < 64; i += 2 ) abc::dealloc(g_ptrs[i]);
+    for ( usize i = 0; i < 64; i += 2 ) g_ptrs[i] = abc::alloc(512);
+    require_true(disjoint_and_live(g_ptrs, 64, 512));
+    require_true(abc::dealloc_batch(g_ptrs, 64) == 64);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC BATCH TESTS PASSED ===\n");
+  return 1;
+}
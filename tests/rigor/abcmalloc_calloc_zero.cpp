@@ -0,0 +1,124 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// calloc / salloc zero elision (__default_zero_elide).
+//
+// every block calloc hands out must read as zero whether or not the memset was skipped; blocks that were written and
+// freed must never be reported as known-zero again.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+bool
+all_zero(const byte *p, usize n)
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( p[i] != 0 ) return false;
+  return true;
+}
+
+constexpr usize SIZES[] = { 4096, 6000, 40000, 300000, 2u << 20 };
+
+};      // namespace
+
+int
+main()
+{
+  test_case("calloc is zero on fresh and on recycled blocks");
+  {
+    for ( usize sz : SIZES ) {
+      byte *a = reinterpret_cast<byte *>(abc::calloc(1, sz));
+      require_true(a != nullptr);
+      require_true(all_zero(a, sz));
+      micron::memset(a, 0xA5, sz);
+      abc::free(a);
+      // likely the same block again, now dirty
+      byte *b = reinterpret_cast<byte *>(abc::calloc(sz, 1));
+      require_true(b != nullptr);
+      require_true(all_zero(b, sz));
+      micron::memset(b, 0x5A, sz);
+      abc::free(b);
+    }
+  }
+  end_test_case();
+
+  test_case("salloc is zero over its whole chunk");
+  {
+    for ( usize sz : SIZES ) {
+      byte *a = abc::salloc(sz);
+      require_true(a != nullptr);
+      const usize len = abc::query_size(reinterpret_cast<addr_t *>(a));
+      require_true(len >= sz);
+      require_true(all_zero(a, len));
+      micron::memset(a, 0xC3, len);
+      abc::dealloc(a);
+    }
+  }
+  end_test_case();
+
+  test_case("only never-handed-out blocks are reported zero");
+  {
+    if constexpr ( abc::__default_zero_elide and !abc::__default_zero_on_alloc and !abc::__default_sanitize ) {
+      // a dedicated mapping is always fresh on first hand-out
+      bool z = false;
+      micron::__chunk<byte> m = abc::__current_arena()->push(4u << 20, z);
+      require_true(m.ptr != nullptr);
+      require_true(z);
+      require_true(all_zero(m.ptr, 4u << 20));
+      abc::dealloc(m.ptr);
+
+      // carve a run of buddy blocks out of untouched sheet space; at least the tail of the run is fresh
+      byte *held[16];
+      u32 fresh = 0;
+      for ( u32 i = 0; i < 16; ++i ) {
+        z = false;
+        micron::__chunk<byte> c = abc::__current_arena()->push(100000, z);
+        require_true(c.ptr != nullptr);
+        if ( z ) {
+          ++fresh;
+          require_true(all_zero(c.ptr, c.len));
+        }
+        micron::memset(c.ptr, 0x77, c.len);
+        held[i] = c.ptr;
+      }
+      require_true(fresh > 0);
+      for ( u32 i = 0; i < 16; ++i ) abc::dealloc(held[i]);
+
+      // everything just freed was written; none of it may come back as known-zero
+      for ( u32 i = 0; i < 16; ++i ) {
+        z = false;
+        micron::__chunk<byte> c = abc::__current_arena()->push(100000, z);
+        require_true(c.ptr != nullptr);
+        bool reused = false;
+        for ( u32 j = 0; j < 16; ++j ) reused = reused or c.ptr == held[j];
+        require_true(!(reused and z));
+        held[i] = c.ptr;
+      }
+      for ( u32 i = 0; i < 16; ++i ) abc::dealloc(held[i]);
+    }
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC CALLOC ZERO TESTS PASSED ===\n");
+  return 1;
+}
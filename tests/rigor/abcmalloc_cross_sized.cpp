@@ -17,8 +17,8 @@
 //
 // two cases, both of which used to abort on width-32:
 //   1. plain cross-thread sized free of a VA-resident block
-//   2. the same after the VA reservation is exhausted, i.e. of a block on a sheet that
-//      __va_carve could not place inside the reservation (__owner_of must still find its arena)
+//   2. the same after the first VA reservation is used up, i.e. of a block on a sheet carved from
+//      a chained reservation (__owner_of must still find its arena through the granule table)
 
 #define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
 
@@ -95,17 +95,18 @@ big_consumer(big_handoff *h)
   h->freed.store(1, micron::memory_order_release);
 }
 
-// burn the reservation down so the next sheets land outside it
-usize
-exhaust_va()
+// burn the current reservation down until a second one is chained on; returns the first granule past the old one
+u32
+exhaust_va(usize &spun)
 {
-  usize spun = 0;
-  const u64 cap = static_cast<u64>(abc::__va_reservation_size);
-  while ( abc::__va_offset.get(micron::memory_order_acquire) < cap ) {
+  const u32 end = static_cast<u32>(abc::__va_cursor.get(micron::memory_order_acquire) >> 32);
+  const u32 chained = abc::__va_reservations.get(micron::memory_order_acquire);
+  spun = 0;
+  while ( abc::__va_reservations.get(micron::memory_order_acquire) == chained ) {
     if ( abc::__va_carve(abc::__sheet_align * 16) == nullptr ) break;
-    if ( ++spun > (cap >> abc::__sheet_align_log2) + 8 ) break;
+    if ( ++spun > abc::__va_reservation_granules + 8 ) break;
   }
-  return spun;
+  return end;
 }
 
 };      // namespace
@@ -124,31 +125,37 @@ main()
   }
   end_test_case();
 
-  test_case("cross-thread sized free (VA exhausted, unregistered sheets)");
+  test_case("cross-thread sized free (first reservation used up, chained sheets)");
   {
-    const usize spun = exhaust_va();
-    micron::console("burned ", (u64)spun, " granule runs; va_offset=", abc::__va_offset.get(micron::memory_order_acquire), " of ",
-                    (u64)abc::__va_reservation_size, "\n");
+    usize spun = 0;
+    const u32 old_end = exhaust_va(spun);
+    micron::console("burned ", (u64)spun, " granule runs; reservations=", (u64)abc::__va_reservations.get(micron::memory_order_acquire),
+                    "\n");
+    require_true(abc::__va_reservations.get(micron::memory_order_acquire) >= 2u);
 
-    // exhausting the reservation is not enough on its own -- the arena keeps serving small
+    // chaining a reservation is not enough on its own -- the arena keeps serving small
     // requests from sheets it already owns. force fresh sheets with large blocks until one
-    // actually lands outside the reservation (that is the block the old __route_dealloc
-    // misfiled as "mine").
+    // actually lands in the new reservation (the old __route_dealloc misfiled blocks on sheets
+    // past the first reservation as "mine").
     big_handoff bh{};
     usize outside = 0;
+    const u32 old_lo = old_end - abc::__va_reservation_granules;
     for ( usize i = 0; i < BIG_N; ++i ) {
       auto c = abc::balloc(BIG_SZ);
       bh.ptrs[i] = c.ptr;
       bh.lens[i] = c.len;
-      if ( c.ptr != nullptr && !abc::__va_contains(c.ptr) ) ++outside;
+      if ( c.ptr != nullptr && (abc::__va_granule(c.ptr) < old_lo || abc::__va_granule(c.ptr) >= old_end) ) ++outside;
     }
-    micron::console("blocks outside the reservation: ", (u64)outside, " of ", (u64)BIG_N, "\n");
+    micron::console("blocks outside the first reservation: ", (u64)outside, " of ", (u64)BIG_N, "\n");
     // if this ever hits, the test has stopped covering what it was written for
     require_true(outside > 0);
 
-    // every one of them must still name its owning arena
-    for ( usize i = 0; i < BIG_N; ++i )
-      if ( bh.ptrs[i] != nullptr && !abc::__va_contains(bh.ptrs[i]) ) require_true(abc::__owner_of(bh.ptrs[i]) != nullptr);
+    // every one of them must still name its owning arena, and the chained reservation is ours like the first
+    for ( usize i = 0; i < BIG_N; ++i ) {
+      if ( bh.ptrs[i] == nullptr ) continue;
+      require_true(abc::__owner_of(bh.ptrs[i]) != nullptr);
+      require_true(abc::__va_contains(bh.ptrs[i]));
+    }
 
     // and the sized free must survive crossing a thread. this is the exact interleaving that
     // raised memory_error_abc_dealloc_size and SIGABRT'd t_parallel_{scan,compact} on armv7.
@@ -0,0 +1,131 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// pointer -> sheet dispatch through the granule table (sheet_header.hpp, __arena::__dispatch_addr).
+//
+// every live block, first byte to last, resolves to its arena and tier in the table; the tier tag never goes down as
+// the size goes up; a foreign arena sees nothing; sheets that move slots in their tier's index as others are released
+// still resolve; and a released mapping leaves no binding behind.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/arena.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr usize SIZES[] = { 16, 200, 400, 2000, 4096, 20 * 1024, 100 * 1024, 512 * 1024, 3u << 20 };
+constexpr usize NSIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+uintptr_t
+tag_of(const abc::__arena &a, const void *p)
+{
+  return abc::__sheet_binding_of(&a, p) & abc::__sheet_tier_mask;
+}
+
+bool
+live(const micron::__chunk<byte> &c)
+{
+  return c.ptr != nullptr and c.ptr != reinterpret_cast<byte *>(-1);
+}
+
+};      // namespace
+
+int
+main()
+{
+  test_case("every tier binds its blocks, first byte to last");
+  {
+    abc::__arena arena;
+    micron::__chunk<byte> held[NSIZES];
+    uintptr_t prev = abc::__sheet_tier_none;
+    for ( usize i = 0; i < NSIZES; ++i ) {
+      held[i] = arena.push(SIZES[i]);
+      require_true(live(held[i]));
+      const uintptr_t t = tag_of(arena, held[i].ptr);
+      require_true(t >= abc::__sheet_tier_precise and t <= abc::__sheet_tier_mapped);
+      require_true(t >= prev);
+      require_true(tag_of(arena, held[i].ptr + SIZES[i] - 1) == t);
+      require_true(abc::__owner_of(held[i].ptr) == &arena);
+      require_true(arena.__size_of_alloc(reinterpret_cast<addr_t *>(held[i].ptr)) >= SIZES[i]);
+      require_true(arena.is_valid_block(reinterpret_cast<addr_t *>(held[i].ptr)));
+      prev = t;
+    }
+    require_true(tag_of(arena, held[0].ptr) == abc::__sheet_tier_precise);
+    require_true(tag_of(arena, held[NSIZES - 1].ptr) == abc::__sheet_tier_mapped);
+    for ( usize i = 0; i < NSIZES; ++i ) require_true(arena.pop(held[i]));
+  }
+  end_test_case();
+
+  test_case("a foreign arena resolves nothing");
+  {
+    abc::__arena a;
+    abc::__arena b;
+    const micron::__chunk<byte> c = a.push(700);
+    require_true(live(c));
+    require_true(abc::__sheet_binding_of(&b, c.ptr) == 0);
+    require_true(b.__size_of_alloc(reinterpret_cast<addr_t *>(c.ptr)) == 0);
+    require_true(!b.is_valid_block(reinterpret_cast<addr_t *>(c.ptr)));
+    require_true(a.pop(c));
+  }
+  end_test_case();
+
+  test_case("sheets keep resolving as their index slots move");
+  {
+    // enough 3 MiB mappings for a dozen slots in the mapped tier, released from the front so the survivors are
+    // re-slotted while their granule bindings still point at the same nodes
+    constexpr usize N = 12;
+    constexpr usize SZ = 3u << 20;
+    abc::__arena arena;
+    micron::__chunk<byte> held[N];
+    for ( usize i = 0; i < N; ++i ) {
+      held[i] = arena.push(SZ);
+      require_true(live(held[i]));
+    }
+    for ( usize i = 0; i < N; i += 2 ) require_true(arena.pop(held[i]));
+    for ( usize i = 1; i < N; i += 2 ) {
+      require_true(tag_of(arena, held[i].ptr) == abc::__sheet_tier_mapped);
+      require_true(arena.__size_of_alloc(reinterpret_cast<addr_t *>(held[i].ptr)) >= SZ);
+    }
+    for ( usize i = 0; i < N; i += 2 ) require_true(abc::__sheet_binding_of(&arena, held[i].ptr) == 0);
+    for ( usize i = 1; i < N; i += 2 ) require_true(arena.pop(held[i]));
+  }
+  end_test_case();
+
+  test_case("many hot-tier sheets resolve through the table");
+  {
+    constexpr usize N = 4096;
+    static micron::__chunk<byte> held[N];
+    abc::__arena arena;
+    for ( usize i = 0; i < N; ++i ) {
+      held[i] = arena.push(8 * 1024 + (i & 7) * 512);
+      require_true(live(held[i]));
+    }
+    for ( usize i = 0; i < N; ++i ) {
+      require_true(abc::__sheet_binding_of(&arena, held[i].ptr) != 0);
+      require_true(arena.__size_of_alloc(reinterpret_cast<addr_t *>(held[i].ptr)) >= 8 * 1024 + (i & 7) * 512);
+    }
+    for ( usize i = 0; i < N; ++i ) require_true(arena.pop(held[i]));
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC DISPATCH TESTS PASSED ===\n");
+  return 1;
+}
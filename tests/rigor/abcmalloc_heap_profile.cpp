@@ -0,0 +1,185 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// sampled heap profiler (heap_profile.hpp): profile_start / profile_stop / profile_stats / profile_dump.
+//
+// the profiler is idle until started, samples roughly one block per `rate` bytes, forgets a sample when its block is
+// freed (directly, resized, or moved by realloc), and dumps the live samples as heap_v2 text or collapsed stacks.
+
+#include <micron/io/console.hpp>
+#include <micron/syscall.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr usize RATE = 4096;
+constexpr u32 N = 4096;
+byte *held[N];
+
+[[gnu::noinline]] void
+fill_small(void)
+{
+  for ( u32 i = 0; i < N; ++i ) {
+    held[i] = abc::alloc(1024);
+    require_true(held[i] != nullptr);
+  }
+}
+
+void
+drop_small(void)
+{
+  for ( u32 i = 0; i < N; ++i ) abc::dealloc(held[i]);
+}
+
+// the whole file, up to cap bytes; returns the length read
+usize
+slurp(const char *path, char *out, usize cap)
+{
+  const int fd = static_cast<int>(micron::syscall(SYS_open, path, 0, 0));
+  if ( fd < 0 ) return 0;
+  usize n = 0;
+  while ( n < cap ) {
+    const long r = static_cast<long>(micron::syscall(SYS_read, fd, out + n, cap - n));
+    if ( r <= 0 ) break;
+    n += static_cast<usize>(r);
+  }
+  micron::syscall(SYS_close, fd);
+  return n;
+}
+
+bool
+contains(const char *hay, usize n, const char *needle)
+{
+  const usize k = micron::strlen(needle);
+  for ( usize i = 0; i + k <= n; ++i ) {
+    usize j = 0;
+    while ( j < k and hay[i + j] == needle[j] ) ++j;
+    if ( j == k ) return true;
+  }
+  return false;
+}
+
+char text[1 << 20];
+
+};      // namespace
+
+int
+main()
+{
+  if constexpr ( !abc::__default_heap_profile ) {
+    micron::console("=== heap profiler compiled out (MICRON_ABC_HEAP_PROFILE), nothing to test ===\n");
+    return 1;
+  }
+
+  test_case("the profiler is idle until started");
+  {
+    const u64 s0 = abc::profile_stats().samples;
+    fill_small();
+    drop_small();
+    require_true(abc::profile_stats().samples == s0);
+  }
+  end_test_case();
+
+  test_case("a started profiler samples about one block per rate bytes");
+  {
+    abc::profile_start(RATE);
+    // the first MiB may go by before the arena rereads the rate
+    fill_small();
+    drop_small();
+    const abc::heap_profile_stats s0 = abc::profile_stats();
+    fill_small();
+    const abc::heap_profile_stats s1 = abc::profile_stats();
+    const u64 taken = s1.samples - s0.samples;
+    // N KiB at one sample per 4 KiB: ~1024 expected, a generous band around it
+    require_true(taken > 512 and taken < 2048);
+    require_true(s1.live - s0.live == taken or s1.dropped > s0.dropped);
+    drop_small();
+    require_true(abc::profile_stats().live == s0.live);
+  }
+  end_test_case();
+
+  test_case("blocks far above the rate are always sampled and followed through realloc");
+  {
+    const abc::heap_profile_stats s0 = abc::profile_stats();
+    constexpr u32 M = 32;
+    static byte *big[M];
+    for ( u32 i = 0; i < M; ++i ) big[i] = abc::alloc(256 * 1024);
+    const abc::heap_profile_stats s1 = abc::profile_stats();
+    require_true(s1.live - s0.live >= M - 1);      // e^-64 misses, in practice none
+    for ( u32 i = 0; i < M; ++i ) {
+      big[i] = reinterpret_cast<byte *>(abc::realloc(big[i], (2u << 20) + i * 4096));
+      require_true(big[i] != nullptr);
+    }
+    const abc::heap_profile_stats s2 = abc::profile_stats();
+    require_true(s2.live == s1.live);
+    require_true(s2.live_bytes > s1.live_bytes);
+    for ( u32 i = 0; i < M; ++i ) abc::dealloc(big[i]);
+    require_true(abc::profile_stats().live == s0.live);
+  }
+  end_test_case();
+
+  test_case("a pprof dump carries the rate, the stacks and the mappings");
+  {
+    fill_small();
+    require_true(abc::profile_dump("/tmp/abcmalloc_heap_profile.heap", abc::profile_format::pprof));
+    const usize n = slurp("/tmp/abcmalloc_heap_profile.heap", text, sizeof(text));
+    require_true(n > 0);
+    require_true(contains(text, n, "heap profile: "));
+    require_true(contains(text, n, "@ heap_v2/4096"));
+    require_true(contains(text, n, "] @ 0x"));
+    require_true(contains(text, n, "MAPPED_LIBRARIES:"));
+  }
+  end_test_case();
+
+  test_case("a collapsed dump is one weighted stack per line");
+  {
+    require_true(abc::profile_dump("/tmp/abcmalloc_heap_profile.folded", abc::profile_format::collapsed));
+    const usize n = slurp("/tmp/abcmalloc_heap_profile.folded", text, sizeof(text));
+    require_true(n > 0 and text[n - 1] == '\n');
+    u32 lines = 0;
+    for ( usize i = 0; i < n; ++i ) {
+      if ( text[i] != '\n' ) continue;
+      ++lines;
+      require_true(i > 0 and text[i - 1] >= '0' and text[i - 1] <= '9');
+    }
+    require_true(lines >= 1);
+    drop_small();
+  }
+  end_test_case();
+
+  test_case("profile_stop stops sampling but keeps the live samples");
+  {
+    byte *keep = abc::alloc(512 * 1024);
+    abc::profile_stop();
+    const abc::heap_profile_stats s0 = abc::profile_stats();
+    fill_small();
+    drop_small();
+    const abc::heap_profile_stats s1 = abc::profile_stats();
+    require_true(s1.samples == s0.samples);
+    require_true(s1.live == s0.live);
+    abc::dealloc(keep);      // sampled before the stop, forgotten after it
+    require_true(abc::profile_stats().live == s0.live - 1);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC HEAP PROFILE TESTS PASSED ===\n");
+  return 1;
+}
@@ -0,0 +1,118 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// global operator new/delete replacement (malloc-new.hpp).
+//
+// every replaceable form must land in (and return to) this allocator; sized and aligned deletes must free the
+// block they were handed, which the second allocation of each case checks by getting the same address back.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+struct node {
+  u64 a, b, c;
+  node *next;
+};
+
+struct alignas(64) line {
+  u64 w[8];
+};
+
+struct alignas(4096) page {
+  byte b[4096];
+};
+
+template<typename T>
+bool
+ours(T *p)
+{
+  return abc::is_present(reinterpret_cast<byte *>(p));
+}
+
+bool
+aligned_to(const void *p, usize al)
+{
+  return (reinterpret_cast<uintptr_t>(p) & (al - 1)) == 0;
+}
+
+};      // namespace
+
+int
+main()
+{
+  test_case("plain and array forms are served by abcmalloc");
+  {
+    node *n = new node{ 1, 2, 3, nullptr };
+    require_true(ours(n));
+    require_true(n->c == 3);
+    delete n;      // sized delete
+
+    u32 *arr = new u32[1000];
+    require_true(ours(arr));
+    for ( u32 i = 0; i < 1000; ++i ) arr[i] = i;
+    require_true(arr[999] == 999);
+    delete[] arr;
+
+    byte *z0 = new byte[0];
+    byte *z1 = new byte[0];
+    require_true(z0 != nullptr and z1 != nullptr and z0 != z1);
+    delete[] z0;
+    delete[] z1;
+  }
+  end_test_case();
+
+  test_case("sized delete frees the block");
+  {
+    for ( u32 i = 0; i < 100000; ++i ) {
+      node *n = new node{ i, i, i, nullptr };
+      delete n;
+    }
+    node *a = new node{};
+    delete a;
+    node *b = new node{};
+    require_true(a == b);
+    delete b;
+  }
+  end_test_case();
+
+  test_case("over-aligned types honour their alignment");
+  {
+    line *l = new line{};
+    require_true(aligned_to(l, 64));
+    delete l;
+    line *ls = new line[33];
+    require_true(aligned_to(ls, 64));
+    require_true(aligned_to(ls + 7, 64));
+    delete[] ls;
+    for ( u32 i = 0; i < 64; ++i ) {
+      page *p = new page{};
+      require_true(aligned_to(p, 4096));
+      p->b[4095] = 1;
+      delete p;
+    }
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC OPERATOR NEW TESTS PASSED ===\n");
+  return 1;
+}
@@ -0,0 +1,187 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// page-run tiers (run_sheet): 4 KiB - 256 KiB requests take an exact number of pages.
+//
+// a block is never rounded past the next page, a freed run is found again by the next request of its size, freed
+// neighbours coalesce into one run a bigger request can take, and aligned requests get an aligned start without
+// padding the run. temporal runs handed out again from a class ring always hold the request, even where one bin
+// spans several run lengths.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include "../../src/run_list.hpp"
+#include <micron/std.hpp>
+
+#include "../support/mapped_list.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr usize SIZES[] = { 4097, 5000, 12289, 20000, 33 * 1024, 70000, 100 * 1024, 200 * 1024, 256 * 1024 };
+
+usize
+page_round(usize sz)
+{
+  return (sz + abc::__system_pagesize - 1) & ~(abc::__system_pagesize - 1);
+}
+
+bool
+aligned_to(const void *p, usize al)
+{
+  return (reinterpret_cast<uintptr_t>(p) & (al - 1)) == 0;
+}
+
+using chunk = micron::__chunk<byte>;
+using runs = abc::__run_list<chunk>;
+
+};      // namespace
+
+int
+main()
+{
+  if constexpr ( !abc::__default_page_runs ) {
+    micron::console("=== page runs disabled (MICRON_ABC_PAGE_RUNS), nothing to test ===\n");
+    return 1;
+  }
+
+  // runs first, before any earlier free can leave a larger block in the caches
+  test_case("page-run blocks are rounded to a page, not a power of two");
+  {
+    byte *held[sizeof(SIZES) / sizeof(SIZES[0])] = {};
+    for ( usize i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); ++i ) {
+      held[i] = abc::alloc(SIZES[i]);
+      require_true(held[i] != nullptr and aligned_to(held[i], abc::__system_pagesize));
+      require_true(abc::query_size(reinterpret_cast<addr_t *>(held[i])) == page_round(SIZES[i]));
+      held[i][0] = 0x5A;
+      held[i][SIZES[i] - 1] = 0xA5;
+    }
+    for ( usize i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); ++i ) require_true(held[i][0] == 0x5A and held[i][SIZES[i] - 1] == 0xA5);
+    for ( byte *p : held ) abc::dealloc(p);
+  }
+  end_test_case();
+
+  test_case("a freed run is reused by the next request of its size");
+  {
+    for ( usize sz : SIZES ) {
+      byte *p = abc::alloc(sz);
+      abc::dealloc(p);
+      byte *q = abc::alloc(sz);
+      require_true(p == q);
+      abc::dealloc(q);
+    }
+  }
+  end_test_case();
+
+  test_case("freed neighbours coalesce into a run a bigger request can take");
+  {
+    constexpr u32 N = 512;
+    static byte *held[N];
+    byte *lo = nullptr;
+    byte *hi = nullptr;
+    for ( u32 i = 0; i < N; ++i ) {
+      held[i] = abc::alloc(3 * abc::__system_pagesize);
+      require_true(held[i] != nullptr);
+      if ( lo == nullptr or held[i] < lo ) lo = held[i];
+      if ( hi == nullptr or held[i] > hi ) hi = held[i];
+    }
+    for ( u32 i = 0; i < N; ++i ) abc::dealloc(held[i]);
+    // every freed 12 KiB run is too small on its own; 24 KiB blocks landing in the span means the runs merged
+    constexpr u32 M = 32;
+    static byte *big[M];
+    u32 inside = 0;
+    for ( u32 i = 0; i < M; ++i ) {
+      big[i] = abc::alloc(6 * abc::__system_pagesize);
+      require_true(big[i] != nullptr);
+      if ( big[i] >= lo and big[i] < hi ) ++inside;
+    }
+    require_true(inside > 0);
+    for ( u32 i = 0; i < M; ++i ) abc::dealloc(big[i]);
+  }
+  end_test_case();
+
+  test_case("aligned page runs are placed on the boundary without padding");
+  {
+    const usize als[] = { 8192, 16384, 65536, 262144 };
+    for ( usize al : als ) {
+      for ( usize sz : SIZES ) {
+        byte *p = reinterpret_cast<byte *>(abc::memalign(al, sz));
+        require_true(p != nullptr and aligned_to(p, al));
+        require_true(abc::query_size(reinterpret_cast<addr_t *>(p)) == page_round(sz));
+        p[0] = 0x11;
+        p[sz - 1] = 0x22;
+        abc::free(p);
+        require_true(!abc::is_present(p));
+      }
+    }
+  }
+  end_test_case();
+
+  test_case("mixed page-run sizes interleave without overlap");
+  {
+    constexpr u32 N = 1024;
+    static byte *held[N];
+    static usize lens[N];
+    u32 seed = 0x9E3779B9u;
+    for ( u32 i = 0; i < N; ++i ) {
+      seed = seed * 1664525u + 1013904223u;
+      lens[i] = abc::__system_pagesize + (seed >> 8) % (252 * 1024);
+      held[i] = abc::alloc(lens[i]);
+      require_true(held[i] != nullptr);
+      micron::memset(held[i], static_cast<byte>(i), 64);
+      micron::memset(held[i] + lens[i] - 64, static_cast<byte>(i), 64);
+    }
+    for ( u32 i = 1; i < N; i += 2 ) abc::dealloc(held[i]);
+    for ( u32 i = 1; i < N; i += 2 ) {
+      held[i] = abc::alloc(lens[i] / 2 + abc::__system_pagesize);
+      require_true(held[i] != nullptr);
+      micron::memset(held[i], 0xFF, lens[i] / 2 + abc::__system_pagesize);
+    }
+    for ( u32 i = 0; i < N; i += 2 ) {
+      require_true(held[i][0] == static_cast<byte>(i) and held[i][63] == static_cast<byte>(i));
+      require_true(held[i][lens[i] - 64] == static_cast<byte>(i) and held[i][lens[i] - 1] == static_cast<byte>(i));
+    }
+    for ( u32 i = 0; i < N; ++i ) abc::dealloc(held[i]);
+  }
+  end_test_case();
+
+  test_case("temporal runs from a shared high bin hold every length in it");
+  {
+    constexpr usize PG = abc::__run_page;
+    abctest::mapped<runs, 320 * PG> m;
+    // 17..18 pages share one class ring, 65..72 another; the short length of each is carved first
+    const u32 groups[][2] = { { 17, 18 }, { 65, 72 } };
+    for ( const auto &g : groups ) {
+      require_true(runs::bin_of(runs::class_round(g[0])) == runs::bin_of(runs::class_round(g[1])));
+      for ( u32 c = g[0]; c <= g[1]; ++c ) {
+        const chunk t = m.list.temporal_allocate(c * PG);
+        require_true(t.ptr != nullptr and t.len >= c * PG);
+        require_true(t.ptr + t.len <= m.mem + m.list.__total());
+        require_true(m.list.block_size(t.ptr) == t.len);
+        t.ptr[0] = static_cast<byte>(c);
+        t.ptr[c * PG - 1] = static_cast<byte>(c);
+      }
+    }
+    require_true(m.list.temporal_allocate(19 * PG).len >= 19 * PG);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC PAGE RUN TESTS PASSED ===\n");
+  return 1;
+}
@@ -0,0 +1,229 @@
+// per-CPU arenas are opt-in; this test is their build
+#define MICRON_ABC_PERCPU true
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// per-CPU arenas (tapi.hpp, MICRON_ABC_PERCPU) across CPU migrations.
+//
+// threads move themselves between CPUs with sched_setaffinity, so blocks end up owned by an arena other than the one
+// the caller now runs on: realloc must still find them, and query_size / is_present / retire / freeze must work on
+// them under the owner's lock while other threads allocate from that same arena. on a one-CPU machine there is
+// nothing to migrate to and the threads just share the one arena.
+
+#include <micron/io/console.hpp>
+#include <micron/syscall.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include <micron/thread/thread.hpp>
+#include <micron/thread/thread_types/auto_thread.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr u32 MAX_CPUS = 1024;
+
+struct cpu_set {
+  u64 bits[MAX_CPUS / 64];
+};
+
+cpu_set g_allowed{};
+u32 g_cpus[MAX_CPUS];
+u32 g_ncpus = 0;
+
+void
+read_allowed(void)
+{
+  micron::syscall(SYS_sched_getaffinity, 0, sizeof(g_allowed), &g_allowed);
+  for ( u32 c = 0; c < MAX_CPUS; ++c )
+    if ( (g_allowed.bits[c / 64] >> (c % 64)) & 1 ) g_cpus[g_ncpus++] = c;
+}
+
+// pins the calling thread to the k-th allowed CPU; the kernel moves it before returning
+void
+move_to(u32 k)
+{
+  if ( g_ncpus == 0 ) return;
+  cpu_set one{};
+  const u32 c = g_cpus[k % g_ncpus];
+  one.bits[c / 64] = 1ULL << (c % 64);
+  micron::syscall(SYS_sched_setaffinity, 0, sizeof(one), &one);
+}
+
+u32
+current_cpu(void)
+{
+  u32 cpu = 0;
+  micron::syscall(SYS_getcpu, &cpu, nullptr, nullptr);
+  return cpu;
+}
+
+void
+fill(byte *p, usize n, byte v)
+{
+  for ( usize i = 0; i < n; ++i ) p[i] = static_cast<byte>(v + (i & 0x3F));
+}
+
+bool
+check(const byte *p, usize n, byte v)
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( p[i] != static_cast<byte>(v + (i & 0x3F)) ) return false;
+  return true;
+}
+
+constexpr usize SIZES[] = { 24, 200, 700, 3000, 20 * 1024, 100 * 1024, 600 * 1024 };
+constexpr usize NSIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+constexpr u32 WORKERS = 4;
+constexpr u32 ROUNDS = 2000;
+
+struct worker {
+  u32 id;
+  u32 failures;
+};
+
+micron::atomic_token<u32> g_go{ 0 };
+
+// every round: allocate on one CPU, hop to the next, then query, grow, shrink, retire or free from there; meanwhile the
+// other workers are allocating from the arena that owns the block
+void
+worker_body(worker *w)
+{
+  while ( g_go.get(micron::memory_order_acquire) != 1u ) __cpu_pause();
+  for ( u32 r = 0; r < ROUNDS; ++r ) {
+    move_to(w->id + r);
+    const usize sz = SIZES[(w->id + r) % NSIZES];
+    const byte v = static_cast<byte>(w->id * 31 + r);
+    byte *p = abc::alloc(sz);
+    if ( !p ) {
+      ++w->failures;
+      continue;
+    }
+    fill(p, sz, v);
+    move_to(w->id + r + 1);
+    if ( abc::query_size(p) < sz or !abc::is_present(p) or !abc::within(p) ) ++w->failures;
+    switch ( r % 4 ) {
+    case 0 : {
+      byte *q = reinterpret_cast<byte *>(abc::realloc(p, sz * 2));
+      if ( !q or !check(q, sz, v) ) ++w->failures;
+      abc::dealloc(q);
+      break;
+    }
+    case 1 : {
+      byte *q = reinterpret_cast<byte *>(abc::realloc(p, sz / 3 + 1));
+      if ( !q or !check(q, sz / 3 + 1, v) ) ++w->failures;
+      abc::free(q);
+      break;
+    }
+    case 2 :
+      if ( sz >= 64 and sz < abc::__class_huge )
+        abc::retire(p);
+      else
+        abc::dealloc(p, sz);
+      break;
+    default :
+      abc::dealloc(p);
+      break;
+    }
+  }
+}
+
+};      // namespace
+
+int
+main()
+{
+  if constexpr ( !abc::__default_percpu_arenas or !abc::__default_multithread_safe ) {
+    micron::console("=== per-CPU arenas compiled out, nothing to test ===\n");
+    return 1;
+  }
+  read_allowed();
+
+  test_case("realloc and queries follow a block across a migration");
+  {
+    byte *held[NSIZES];
+    move_to(0);
+    const u32 from = current_cpu();
+    for ( usize i = 0; i < NSIZES; ++i ) {
+      held[i] = abc::alloc(SIZES[i]);
+      require_true(held[i] != nullptr);
+      fill(held[i], SIZES[i], static_cast<byte>(i));
+    }
+    move_to(1);
+    if ( g_ncpus > 1 ) require_true(current_cpu() != from);
+    for ( usize i = 0; i < NSIZES; ++i ) {
+      require_true(abc::query_size(held[i]) >= SIZES[i]);
+      require_true(abc::is_present(held[i]));
+      byte *g = reinterpret_cast<byte *>(abc::realloc(held[i], SIZES[i] * 3));
+      require_true(g != nullptr and check(g, SIZES[i], static_cast<byte>(i)));
+      move_to(0);
+      byte *s = reinterpret_cast<byte *>(abc::realloc(g, SIZES[i] / 2 + 1));
+      require_true(s != nullptr and check(s, SIZES[i] / 2 + 1, static_cast<byte>(i)));
+      move_to(1);
+      held[i] = s;
+    }
+    for ( usize i = 0; i < NSIZES; ++i ) abc::dealloc(held[i]);
+  }
+  end_test_case();
+
+  test_case("a block frozen and retired from another CPU");
+  {
+    move_to(0);
+    byte *r = abc::alloc(512);
+    require_true(r != nullptr);
+    byte *f = nullptr;
+    if constexpr ( abc::__default_direct_map ) {
+      f = abc::alloc(abc::__direct_map_threshold * 2);
+      require_true(f != nullptr);
+      fill(f, 4096, 7);
+    }
+    move_to(1);
+    abc::retire(r);
+    if ( f ) {
+      abc::freeze(f);      // read-only from here on, so it stays mapped until exit
+      require_true(check(f, 4096, 7));
+      require_true(abc::query_size(f) >= abc::__direct_map_threshold * 2);
+    }
+  }
+  end_test_case();
+
+  test_case("concurrent queries, reallocs and frees on migrating threads");
+  {
+    static worker w[WORKERS];
+    for ( u32 i = 0; i < WORKERS; ++i ) w[i] = worker{ i, 0 };
+    {
+      micron::auto_thread<> t0(worker_body, &w[0]);
+      micron::auto_thread<> t1(worker_body, &w[1]);
+      micron::auto_thread<> t2(worker_body, &w[2]);
+      micron::auto_thread<> t3(worker_body, &w[3]);
+      g_go.store(1, micron::memory_order_release);
+      t0.join();
+      t1.join();
+      t2.join();
+      t3.join();
+    }
+    for ( u32 i = 0; i < WORKERS; ++i ) require_true(w[i].failures == 0);
+  }
+  end_test_case();
+
+  micron::syscall(SYS_sched_setaffinity, 0, sizeof(g_allowed), &g_allowed);
+  micron::console("=== ALL ABCMALLOC PER-CPU TESTS PASSED ===\n");
+  return 1;
+}
@@ -0,0 +1,103 @@
+// decay purging is compiled out by default; this test is its build
+#define MICRON_ABC_PURGE true
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// decay purging of free runs (purge.hpp), driven through a page-run list with explicit pass clocks.
+//
+// a free run is dated by the first pass that sees it, so a run freed after a long idle gap is not purged by the next
+// pass however old the previous one was; it goes dirty -> muzzy -> clean on the decay schedule from there, and slack
+// carved off a run keeps its age.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include "../../src/purge.hpp"
+#include "../../src/run_list.hpp"
+#include <micron/std.hpp>
+
+#include "../support/mapped_list.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+using chunk = micron::__chunk<byte>;
+using runs = abc::__run_list<chunk>;
+
+constexpr usize PG = abc::__run_page;
+constexpr usize LIST_BYTES = 72 * PG;
+constexpr u64 D = abc::__purge_decay_ms;
+
+using mapped_runs = abctest::mapped<runs, LIST_BYTES>;
+
+};      // namespace
+
+int
+main()
+{
+  if constexpr ( !abc::__default_purge ) {
+    micron::console("=== decay purging compiled out (MICRON_ABC_PURGE), nothing to test ===\n");
+    return 1;
+  }
+
+  test_case("a run freed after an idle gap is not purged by the next pass");
+  {
+    mapped_runs m;
+    const u64 t0 = abc::__purge_now_ms();
+    const chunk a = m.list.allocate(8 * PG);
+    const chunk guard = m.list.allocate(PG);      // keeps a from merging with the tail
+    require_true(a.ptr != nullptr and guard.ptr == a.ptr + 8 * PG);
+    // settle the tail: dated, then muzzy, then clean
+    require_true(m.list.purge(t0, PG) == 0);
+    require_true(m.list.purge(t0 + D, PG) > 0);
+    require_true(m.list.purge(t0 + 3 * D, PG) > 0);
+    require_true(m.list.purge(t0 + 4 * D, PG) == 0);
+    // twenty decay periods pass with nothing to do, then a is freed
+    require_true(m.list.deallocate(a.ptr) == abc::__flag_ok);
+    require_true(m.list.purge(t0 + 24 * D, PG) == 0);
+    require_true(m.list.purge(t0 + 24 * D + D - 1, PG) == 0);
+    require_true(m.list.purge(t0 + 25 * D, PG) == 8 * PG);
+    require_true(m.list.purge(t0 + 26 * D, PG) == 8 * PG);
+    require_true(m.list.purge(t0 + 40 * D, PG) == 0);
+    require_true(m.list.deallocate(guard.ptr) == abc::__flag_ok);
+  }
+  end_test_case();
+
+  test_case("slack carved off a free run keeps its age");
+  {
+    mapped_runs m;
+    const u64 t0 = abc::__purge_now_ms();
+    const chunk a = m.list.allocate(16 * PG);
+    const chunk guard = m.list.allocate(PG);
+    require_true(a.ptr != nullptr and guard.ptr != nullptr);
+    require_true(m.list.deallocate(a.ptr) == abc::__flag_ok);
+    require_true(m.list.purge(t0, PG) == 0);      // dates a and the tail
+    const chunk b = m.list.allocate(4 * PG);      // out of a; the 12 pages behind it stay dated t0
+    require_true(b.ptr == a.ptr);
+    require_true(m.list.purge(t0 + D, PG) >= 12 * PG);
+    require_true(m.list.deallocate(b.ptr) == abc::__flag_ok);      // merges back into one fresh run
+    (void)m.list.purge(t0 + 2 * D, PG);      // dates it; the tail goes clean
+    require_true(m.list.purge(t0 + 3 * D - 1, PG) == 0);
+    require_true(m.list.purge(t0 + 3 * D, PG) == 16 * PG);
+    require_true(m.list.deallocate(guard.ptr) == abc::__flag_ok);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC PURGE TESTS PASSED ===\n");
+  return 1;
+}
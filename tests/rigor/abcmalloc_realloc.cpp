@@ -29,6 +29,7 @@
 #define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
 
 #include <micron/io/console.hpp>
+#include <micron/syscall.hpp>
 
 #include "../support/abc_rigor.hpp"
 
@@ -67,6 +68,20 @@ constexpr usize kBoundaries[] = {
 };
 constexpr usize kNB = sizeof(kBoundaries) / sizeof(kBoundaries[0]);
 
+// resident pages of [p, p + n) per mincore. a grow that moved page tables keeps only
+// the pages that were touched; one that copied has dirtied every page of the prefix.
+constexpr usize kMapProbe = 128ULL << 20;
+inline usize
+resident_pages(const byte *p, usize n) noexcept
+{
+  static u8 vec[kMapProbe / abc::__system_pagesize];
+  if ( n > kMapProbe ) n = kMapProbe;
+  if ( micron::syscall(SYS_mincore, p, n, vec) != 0 ) return ~static_cast<usize>(0);
+  usize r = 0;
+  for ( usize i = 0; i < n / abc::__system_pagesize; ++i ) r += vec[i] & 1u;
+  return r;
+}
+
 };      // namespace
 
 int
@@ -246,6 +261,118 @@ main(void)
   }
   end_test_case();
 
+  // ── 6. doubling growth in the tlsf range (string/vector pattern) ───────────
+  // small-tier blocks grow in place when the physical successor is free; either
+  // way the prefix must survive and the grown extent must be fully usable.
+  test_case("realloc: doubling growth 257 B -> 4 KiB keeps prefix, grows in place when possible");
+  {
+    usize in_place = 0, steps = 0;
+    for ( usize it = 0; it < 512; ++it ) {
+      usize n = 257 + (it % 64);
+      byte *b = abc::alloc(n);
+      require_true(b != nullptr);
+      full_fill(b, n, 0xE0u, static_cast<u32>(it));
+      while ( n * 2 < 4096 ) {
+        const usize n1 = n * 2;
+        byte *c = static_cast<byte *>(abc::realloc(b, n1));
+        require_true(c != nullptr);
+        require_true(abc::query_size(c) >= n1);
+        require_true(full_check(c, n, 0xE0u, static_cast<u32>(it)));
+        if ( c == b ) ++in_place;
+        ++steps;
+        full_fill(c, n1, 0xE0u, static_cast<u32>(it));
+        b = c;
+        n = n1;
+      }
+      abc::dealloc(b);
+    }
+    sb::print("   grown in place: ", in_place, " / ", steps);
+  }
+  end_test_case();
+
+  // ── 7. doubling growth in the buddy range (ingest buffer pattern) ──────────
+  // buddy blocks are promoted over a free right buddy; the grown block must keep
+  // its prefix and must not overlap a live neighbour allocated in between.
+  test_case("realloc: doubling growth 4 KiB -> 256 KiB keeps prefix and neighbours");
+  {
+    usize in_place = 0, steps = 0;
+    for ( usize it = 0; it < 64; ++it ) {
+      usize n = 4096 + (it % 8) * 512;
+      byte *b = abc::alloc(n);
+      require_true(b != nullptr);
+      full_fill(b, n, 0xF0u, static_cast<u32>(it));
+      byte *fence = abc::alloc(n);
+      require_true(fence != nullptr);
+      full_fill(fence, n, 0xF1u, static_cast<u32>(it));
+      while ( n * 2 <= 262144 ) {
+        const usize n1 = n * 2;
+        byte *c = static_cast<byte *>(abc::realloc(b, n1));
+        require_true(c != nullptr);
+        require_true(abc::query_size(c) >= n1);
+        require_true(full_check(c, n, 0xF0u, static_cast<u32>(it)));
+        if ( c == b ) ++in_place;
+        ++steps;
+        full_fill(c, n1, 0xF0u, static_cast<u32>(it));
+        require_true(full_check(fence, 4096, 0xF1u, static_cast<u32>(it)));
+        b = c;
+        n = n1;
+      }
+      abc::dealloc(fence);
+      abc::dealloc(b);
+    }
+    sb::print("   grown in place: ", in_place, " / ", steps);
+  }
+  end_test_case();
+
+  // ── 8. dedicated mappings: grow/shrink by remap keeps every byte ───────────
+  // blocks >= 1 MiB are whole mappings; realloc moves page tables, so the prefix
+  // must come back intact whether the mapping grew in place or moved.
+  test_case("realloc: mapped blocks 1 MiB -> 64 MiB -> 2 MiB keep their prefix");
+  {
+    constexpr usize kSteps[] = { 1ULL << 20, 3ULL << 20, 8ULL << 20, 64ULL << 20, 5ULL << 20, 2ULL << 20 };
+    byte *b = abc::alloc(kSteps[0]);
+    require_true(b != nullptr);
+    full_fill(b, kSteps[0], 0xA5u, 1u);
+    usize surviving = kSteps[0];
+    for ( usize k = 1; k < sizeof(kSteps) / sizeof(kSteps[0]); ++k ) {
+      byte *c = static_cast<byte *>(abc::realloc(b, kSteps[k]));
+      require_true(c != nullptr);
+      require_true(abc::query_size(c) >= kSteps[k]);
+      surviving = abctest::mn(surviving, kSteps[k]);
+      require_true(full_check(c, surviving, 0xA5u, 1u));
+      c[kSteps[k] - 1] = static_cast<byte>(k);      // the far end is writable
+      b = c;
+    }
+    abc::dealloc(b);
+  }
+  end_test_case();
+
+  // ── 9. the libc drop-in takes the same path ───────────────────────────────
+  // ::realloc must reach abc::realloc: a 64 MiB block with two touched pages grows
+  // to 128 MiB and shrinks to 8 MiB by remap, never by a byte copy.
+  test_case("::realloc: mapped grow/shrink remaps instead of copying");
+  if constexpr ( abc::__default_direct_map ) {
+    constexpr usize kOld = 64ULL << 20;
+    constexpr usize kNew = 128ULL << 20;
+    constexpr usize kSmall = 8ULL << 20;
+    constexpr usize kPages = kOld / abc::__system_pagesize;
+    byte *b = static_cast<byte *>(::malloc(kOld));
+    require_true(b != nullptr);
+    b[0] = 0x3C;
+    b[kOld - 1] = 0xC3;
+    byte *c = static_cast<byte *>(::realloc(b, kNew));
+    require_true(c != nullptr and abc::query_size(c) >= kNew);
+    require_true(c[0] == 0x3C and c[kOld - 1] == 0xC3);
+    require_true(resident_pages(c, kOld) < kPages / 4);      // a copy would have faulted in all of them
+    c[kNew - 1] = 0x5A;
+    byte *d = static_cast<byte *>(::realloc(c, kSmall));
+    require_true(d != nullptr and abc::query_size(d) >= kSmall);
+    require_true(d[0] == 0x3C);
+    require_true(resident_pages(d, kSmall) < kSmall / abc::__system_pagesize / 4);
+    ::free(d);
+  }
+  end_test_case();
+
   sb::print("=== ABCMALLOC REALLOC / QUERY_SIZE RIGOR PASSED ===");
   return 1;
 }
@@ -76,6 +76,23 @@ main(void)
 {
   sb::print("=== ABCMALLOC POWER-OF-TWO SIZE TESTS ===");
 
+  // ── buddy blocks carry no in-band header, so 2^k fits order k exactly ────
+  // runs first, before any earlier free can leave a larger block in the caches
+
+  sb::test_case("power-of-two buddy requests fit their own order (no doubling)");
+  {
+    uint8_t *held[8] = {};
+    for ( int shift = 12; shift < 20; ++shift ) {
+      const size_t S = static_cast<size_t>(1) << shift;
+      held[shift - 12] = abc::alloc(S);
+      sb::require(held[shift - 12] != nullptr);
+      sb::require(abc::query_size(held[shift - 12]) == S);
+      sb::require(spot_write_verify(held[shift - 12], S, 0x5C));
+    }
+    for ( uint8_t *p : held ) abc::dealloc(p);
+  }
+  sb::end_test_case();
+
   // ── raw abc::alloc roundtrip across all sizes ─────────────────────────────
 
   for ( int shift = 12; shift <= 31; ++shift ) {
@@ -219,6 +236,35 @@ main(void)
     }
   }
 
+  // ── a tier outgrows its inline directory leaf ─────────────────────────────
+  //
+  // every 1 MiB block is its own mapped sheet, so 2 x __max_sheets_mapped + 3 live blocks force the mapped tier's
+  // directory onto a second and third leaf; freed slots are handed back out before new ones are taken.
+
+  if constexpr ( sizeof(void *) > 4 && abc::__default_direct_map ) {
+    sb::test_case("mapped tier grows past its inline directory leaf");
+    {
+      const size_t S = static_cast<size_t>(1) << 20;
+      const int K = static_cast<int>(abc::__max_sheets_mapped < 64 ? 64 : abc::__max_sheets_mapped) * 2 + 3;
+      std::vector<uint8_t *> chunks(static_cast<size_t>(K), nullptr);
+      for ( int i = 0; i < K; ++i ) {
+        chunks[i] = abc::alloc(S);
+        sb::require(chunks[i] != nullptr);
+        sb::require(spot_write_verify(chunks[i], S, static_cast<uint8_t>(i & 0xff)));
+      }
+      for ( int i = 0; i < K; ++i ) sb::require(abc::is_present(chunks[i]));
+      for ( int i = 0; i < K; i += 2 ) abc::dealloc(chunks[i]);
+      for ( int i = 1; i < K; i += 2 ) sb::require(abc::query_size(chunks[i]) >= S);
+      for ( int i = 0; i < K; i += 2 ) {
+        chunks[i] = abc::alloc(S);
+        sb::require(chunks[i] != nullptr);
+        sb::require(spot_write_verify(chunks[i], S, 0x77));
+      }
+      for ( uint8_t *p : chunks ) abc::dealloc(p);
+    }
+    sb::end_test_case();
+  }
+
   // ── mixed-size interleave (cross-tier metadata sanity) ────────────────────
 
   sb::test_case("mixed-size interleave, alloc all then free in reverse");
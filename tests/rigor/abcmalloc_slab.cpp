@@ -0,0 +1,237 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// headerless slab classes of the precise tier (slab_list.hpp).
+//
+// a slab over a small mapping first (three 16 KiB runs): a freed object comes back to the next request of its class,
+// a full run spills into a fresh one and comes back into rotation on a free, an empty run is handed to another class,
+// and an exhausted slab says so. then through the arena: a precise tier that fills its sheet spills to a new one,
+// free / realloc either side of the 256 B boundary, and a sized free naming a bigger class than the slot's.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/arena.hpp"
+#include "../../src/config.hpp"
+#include "../../src/slab_list.hpp"
+#include <micron/std.hpp>
+
+#include "../support/mapped_list.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+using chunk = micron::__chunk<byte>;
+using slab = abc::__slab_list<chunk, abc::__class_precise>;
+
+// one run of descriptors + three data runs
+constexpr usize SLAB_BYTES = 4 * abc::__slab_run_size;
+
+using mapped_slab = abctest::mapped<slab, SLAB_BYTES>;
+
+bool
+same_run(const slab &s, const byte *a, const byte *b)
+{
+  return s.run_of(a) == s.run_of(b);
+}
+
+// redzoned builds shave the canaries off the reported size
+bool
+size_is(usize got, usize want)
+{
+  return abc::__default_redzone ? got >= want - 2 * static_cast<usize>(abc::__default_redzone_size) : got == want;
+}
+
+bool
+fill_check(byte *p, usize n, byte v)
+{
+  for ( usize i = 0; i < n; ++i ) p[i] = v;
+  for ( usize i = 0; i < n; ++i )
+    if ( p[i] != v ) return false;
+  return true;
+}
+
+bool
+reads(const byte *p, usize n, byte v)
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( p[i] != v ) return false;
+  return true;
+}
+
+uintptr_t
+tag_of(const void *p)
+{
+  return abc::__sheet_binding_of(abc::__owner_of(p), p) & abc::__sheet_tier_mask;
+}
+
+};      // namespace
+
+int
+main()
+{
+  test_case("a freed object is reused by the next request of its class");
+  {
+    mapped_slab m;
+    const chunk a = m.list.allocate(40);
+    require_true(a.ptr != nullptr and a.len == 48);
+    const chunk b = m.list.allocate(48);
+    require_true(b.ptr == a.ptr + 48);
+    require_true(m.list.deallocate(a.ptr) == abc::__flag_ok);
+    const chunk c = m.list.allocate(33);      // 33..48 share the 48 B class
+    require_true(c.ptr == a.ptr and c.len == 48);
+    const chunk d = m.list.allocate(32);      // another class, another run
+    require_true(d.ptr != nullptr and d.len == 32 and !same_run(m.list, d.ptr, a.ptr));
+    require_true(m.list.block_size(c.ptr) == 48 and m.list.block_size(d.ptr) == 32);
+    require_true(!m.list.is_allocated(a.ptr + 16));      // not an object start
+    require_true(m.list.deallocate(a.ptr + 16) != abc::__flag_ok);
+    require_true(m.list.deallocate(b.ptr) == abc::__flag_ok);
+    require_true(m.list.deallocate(c.ptr) == abc::__flag_ok);
+    require_true(m.list.deallocate(d.ptr) == abc::__flag_ok);
+    require_true(m.list.deallocate(c.ptr) != abc::__flag_ok);      // double free
+    require_true(m.list.used() == 0);
+  }
+  end_test_case();
+
+  test_case("a full run spills into a fresh one and rejoins on a free");
+  {
+    mapped_slab m;
+    const usize cap = abc::__slab_run_size / 256;
+    static byte *run0[abc::__slab_run_size / 256];
+    for ( usize i = 0; i < cap; ++i ) {
+      const chunk c = m.list.allocate(256);
+      require_true(c.ptr != nullptr and c.len == 256);
+      run0[i] = c.ptr;
+      if ( i ) require_true(same_run(m.list, c.ptr, run0[0]));
+    }
+    const chunk spill = m.list.allocate(256);
+    require_true(spill.ptr != nullptr and !same_run(m.list, spill.ptr, run0[0]));
+    require_true(m.list.deallocate(run0[7]) == abc::__flag_ok);
+    const chunk back = m.list.allocate(256);
+    require_true(back.ptr == run0[7]);      // the run that was full is back on the partial list, newest first
+    for ( usize i = 0; i < cap; ++i ) require_true(m.list.deallocate(run0[i]) == abc::__flag_ok);
+    require_true(m.list.deallocate(spill.ptr) == abc::__flag_ok);
+  }
+  end_test_case();
+
+  test_case("an empty run goes to another class, an exhausted slab returns null");
+  {
+    mapped_slab m;
+    const usize cap = abc::__slab_run_size / 256;
+    static byte *run0[abc::__slab_run_size / 256];
+    for ( usize i = 0; i < cap; ++i ) run0[i] = m.list.allocate(256).ptr;
+    const chunk extra = m.list.allocate(256);      // second 256 B run
+    const chunk small = m.list.allocate(16);       // third and last run
+    require_true(run0[cap - 1] != nullptr and extra.ptr != nullptr and small.ptr != nullptr);
+    require_true(m.list.allocate(128).ptr == nullptr);      // three runs bound, nothing left for a fourth class
+    // a class keeps its last partial run even when it empties; any other empty run is handed back
+    require_true(m.list.deallocate(run0[0]) == abc::__flag_ok);
+    require_true(m.list.deallocate(extra.ptr) == abc::__flag_ok);
+    const chunk mid = m.list.allocate(128);
+    require_true(mid.ptr != nullptr and same_run(m.list, mid.ptr, extra.ptr));
+    require_true(m.list.block_size(mid.ptr) == 128);
+    require_true(m.list.deallocate(mid.ptr) == abc::__flag_ok);
+    require_true(m.list.deallocate(small.ptr) == abc::__flag_ok);
+    for ( usize i = 1; i < cap; ++i ) require_true(m.list.deallocate(run0[i]) == abc::__flag_ok);
+    require_true(m.list.used() == 0);
+  }
+  end_test_case();
+
+  test_case("a precise tier that fills its sheet spills to a new one");
+  {
+    constexpr usize CAP = 1u << 19;      // 128 MiB of 256 B objects, far past any single precise sheet
+    static byte *held[CAP];
+    abc::__arena arena;
+    const chunk first = arena.push(256);
+    require_true(first.ptr != nullptr);
+    const uintptr_t nd0 = abc::__sheet_binding_of(&arena, first.ptr) & ~abc::__sheet_tier_mask;
+    usize n = 0;
+    bool spilled = false;
+    while ( n < CAP and !spilled ) {
+      const chunk c = arena.push(256);
+      require_true(c.ptr != nullptr and c.ptr != reinterpret_cast<byte *>(-1));
+      held[n++] = c.ptr;
+      require_true((abc::__sheet_binding_of(&arena, c.ptr) & abc::__sheet_tier_mask) == abc::__sheet_tier_precise);
+      spilled = (abc::__sheet_binding_of(&arena, c.ptr) & ~abc::__sheet_tier_mask) != nd0;
+    }
+    require_true(spilled);
+    require_true(size_is(arena.__size_of_alloc(reinterpret_cast<addr_t *>(held[n - 1])), 256));
+    for ( usize i = 0; i < n; ++i ) require_true(arena.pop(held[i]));
+    require_true(arena.pop(first.ptr));
+  }
+  end_test_case();
+
+  test_case("free and realloc across the 256 B boundary");
+  {
+    byte *p = abc::alloc(256);
+    require_true(p != nullptr and tag_of(p) == abc::__sheet_tier_precise);
+    require_true(size_is(abc::query_size(p), 256));
+    require_true(fill_check(p, 256, 0x5A));
+    byte *q = abc::alloc(257);
+    require_true(q != nullptr and tag_of(q) != abc::__sheet_tier_precise);
+    require_true(abc::query_size(q) >= 257);
+    abc::dealloc(q);
+
+    // 256 -> 257 leaves the slab, 257 -> 256 shrinks where it is, the bytes follow
+    byte *r = reinterpret_cast<byte *>(abc::realloc(p, 257));
+    require_true(r != nullptr and tag_of(r) != abc::__sheet_tier_precise);
+    require_true(reads(r, 256, 0x5A));
+    r[256] = 0x11;
+    byte *s = reinterpret_cast<byte *>(abc::realloc(r, 256));
+    require_true(s != nullptr and reads(s, 256, 0x5A));
+    require_true(abc::query_size(s) >= 256);
+
+    // inside the slab: 200 -> 256 changes class (224 -> 256), 256 -> 255 stays in place
+    byte *t = abc::alloc(200);
+    require_true(size_is(abc::query_size(t), 224));
+    require_true(fill_check(t, 200, 0x3C));
+    byte *u = reinterpret_cast<byte *>(abc::realloc(t, 256));
+    require_true(u != nullptr and reads(u, 200, 0x3C));
+    require_true(tag_of(u) == abc::__sheet_tier_precise and size_is(abc::query_size(u), 256));
+    byte *v = reinterpret_cast<byte *>(abc::realloc(u, 255));
+    require_true(v == u);
+
+    abc::dealloc(s);
+    abc::dealloc(v, 255);
+    abc::free(abc::malloc(256));
+  }
+  end_test_case();
+
+  test_case("an oversized sized free does not relabel a slot");
+  {
+    byte *p = abc::alloc(48);
+    byte *q = abc::alloc(48);
+    require_true(p != nullptr and q != nullptr and tag_of(p) == abc::__sheet_tier_precise);
+    require_true(fill_check(q, 48, 0x77));
+    abc::dealloc(p, 250);      // names the 256 B class, the slot is 48 B
+    for ( u32 i = 0; i < 8; ++i ) {
+      byte *r = abc::alloc(256);
+      require_true(r != nullptr and r != p);
+      require_true(fill_check(r, 256, 0x99));
+      require_true(reads(q, 48, 0x77));
+      abc::dealloc(r);
+    }
+    byte *s = abc::alloc(48);
+    require_true(s != nullptr and size_is(abc::query_size(s), 48));
+    abc::dealloc(s);
+    abc::dealloc(q);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC SLAB TESTS PASSED ===\n");
+  return 1;
+}
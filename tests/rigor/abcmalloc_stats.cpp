@@ -0,0 +1,252 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// sharded statistics (stats.hpp): abc::stats_snapshot() and musage().
+//
+// every check is a delta between two snapshots, so whatever the runtime allocated before main doesn't matter; the
+// committed-bytes gauges behind musage() are kept even when the hot counters are compiled out. the remote-drain counters
+// are checked by freeing a set of blocks from a second thread and draining it on the owner's next alloc. in-place growth
+// and reset_page run on an arena of the test's own, where nothing else lives in the sheets, so bytes_live must come
+// back exactly to where it started.
+
+#include <micron/io/console.hpp>
+#include <micron/thread/thread.hpp>
+#include <micron/thread/thread_types/auto_thread.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/arena.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+const abc::tier_stats &
+tier(const abc::stats_t &s, abc::stat_tier t)
+{
+  return s.tiers[static_cast<usize>(t)];
+}
+
+// large-tier blocks skip the thread-local batches, so every remote free is a single push onto the owner's channel
+constexpr usize kRemoteBlocks = 256;
+constexpr usize kRemoteSize = 48 * 1024;
+
+struct remote_set {
+  byte *ptrs[kRemoteBlocks];
+};
+
+void
+remote_freer(remote_set *r)
+{
+  for ( usize i = 0; i < kRemoteBlocks; ++i ) abc::dealloc(r->ptrs[i]);
+}
+
+// allocs a set here, frees it from another thread, and drains it back on the next alloc
+void
+free_remotely(remote_set &r)
+{
+  for ( usize i = 0; i < kRemoteBlocks; ++i ) {
+    r.ptrs[i] = abc::alloc(kRemoteSize);
+    require_true(r.ptrs[i] != nullptr);
+  }
+  {
+    micron::auto_thread<> t(remote_freer, &r);
+    t.join();
+  }
+  abc::dealloc(abc::alloc(48));
+}
+
+// a few hot-tier frees are parked, not published, until the thread has made __remote_batch_age more calls
+struct aging_set {
+  byte *ptrs[4];
+  u64 before;
+  u64 parked;
+  u64 aged;
+};
+
+void
+aging_freer(aging_set *a)
+{
+  a->before = abc::remote_stats().publishes;
+  for ( byte *p : a->ptrs ) abc::dealloc(p);
+  a->parked = abc::remote_stats().publishes;
+  for ( u32 i = 0; i < abc::__remote_batch_age; ++i ) abc::dealloc(abc::alloc(32));
+  a->aged = abc::remote_stats().publishes;
+}
+
+};      // namespace
+
+int
+main()
+{
+  test_case("musage follows the committed sheets, O(arenas)");
+  {
+    const usize m0 = abc::musage();
+    const usize big = 8u << 20;
+    byte *p = abc::alloc(big);
+    require_true(p != nullptr);
+    const usize m1 = abc::musage();
+    require_true(m1 >= m0 + big);
+    const abc::stats_t s = abc::stats_snapshot();
+    require_true(tier(s, abc::stat_tier::mapped).sheets >= 1);
+    require_true(tier(s, abc::stat_tier::mapped).bytes_committed >= big);
+    require_true(s.arenas >= 1);
+    abc::dealloc(p);
+    require_true(abc::musage() < m1);
+  }
+  end_test_case();
+
+  if constexpr ( !abc::__default_collect_stats ) {
+    micron::console("=== stat collection disabled (MICRON_ABC_COLLECT_STATS), gauges only ===\n");
+    return 1;
+  }
+
+  test_case("alloc and free counters move per tier");
+  {
+    constexpr u32 N = 1000;
+    static byte *held[N];
+    const abc::stats_t s0 = abc::stats_snapshot();
+    for ( u32 i = 0; i < N; ++i ) {
+      held[i] = abc::alloc(48);
+      require_true(held[i] != nullptr);
+    }
+    const abc::stats_t s1 = abc::stats_snapshot();
+    require_true(s1.alloc_requests - s0.alloc_requests >= N);
+    require_true(tier(s1, abc::stat_tier::precise).allocs - tier(s0, abc::stat_tier::precise).allocs >= N);
+    require_true(tier(s1, abc::stat_tier::precise).bytes_live > tier(s0, abc::stat_tier::precise).bytes_live);
+    for ( u32 i = 0; i < N; ++i ) abc::dealloc(held[i]);
+    const abc::stats_t s2 = abc::stats_snapshot();
+    require_true(s2.dealloc_requests - s1.dealloc_requests >= N);
+    require_true(tier(s2, abc::stat_tier::precise).frees - tier(s1, abc::stat_tier::precise).frees >= N);
+  }
+  end_test_case();
+
+  test_case("a page-run block is charged and released in whole pages");
+  if constexpr ( abc::__default_page_runs ) {
+    const abc::stats_t s0 = abc::stats_snapshot();
+    byte *p = abc::alloc(3 * abc::__system_pagesize);
+    require_true(p != nullptr);
+    const abc::stats_t s1 = abc::stats_snapshot();
+    const u64 l0 = tier(s0, abc::stat_tier::medium).bytes_live;
+    const u64 l1 = tier(s1, abc::stat_tier::medium).bytes_live;
+    require_true(l1 - l0 >= 3 * abc::__system_pagesize);
+    abc::dealloc(p);
+    const abc::stats_t s2 = abc::stats_snapshot();
+    // the block may sit in the free cache, which keeps it marked; either way nothing grows
+    require_true(tier(s2, abc::stat_tier::medium).bytes_live <= l1);
+  }
+  end_test_case();
+
+  test_case("a freed block found again is a cache hit");
+  {
+    if constexpr ( abc::__default_per_class_free_cache ) {
+      byte *p = abc::alloc(300);
+      abc::dealloc(p);
+      const abc::stats_t s0 = abc::stats_snapshot();
+      byte *q = abc::alloc(300);
+      const abc::stats_t s1 = abc::stats_snapshot();
+      require_true(tier(s1, abc::stat_tier::small).cache_hits > tier(s0, abc::stat_tier::small).cache_hits);
+      abc::dealloc(q);
+    }
+  }
+  end_test_case();
+
+  test_case("remote drains are counted and a spilling arena grows its ring");
+  // per-CPU arenas may put both threads on one arena, and then nothing is remote
+  if constexpr ( abc::__default_multithread_safe and !abc::__default_percpu_arenas ) {
+    static remote_set r;
+    const abc::stats_t s0 = abc::stats_snapshot();
+    free_remotely(r);
+    const abc::stats_t s1 = abc::stats_snapshot();
+    require_true(s1.remote_drain.drains > s0.remote_drain.drains);
+    require_true(s1.remote_drain.from_ring + s1.remote_drain.from_chain - s0.remote_drain.from_ring - s0.remote_drain.from_chain
+                 >= kRemoteBlocks);
+    require_true(s1.remote_drain.max_drain >= kRemoteBlocks / 2);
+    require_true(s1.remote_drain.spills > s0.remote_drain.spills);
+    require_true(s1.remote_drain.grows > s0.remote_drain.grows);
+    require_true(s1.remote_drain.ring_cells >= abc::__remote_ring_min);
+    require_true(s1.remote_drain.ring_bytes > s0.remote_drain.ring_bytes);
+    // with a ring in place, part of the next round lands in it
+    free_remotely(r);
+    const abc::stats_t s2 = abc::stats_snapshot();
+    require_true(s2.remote_drain.from_ring > s1.remote_drain.from_ring);
+  }
+  end_test_case();
+
+  test_case("a partial remote batch is published once it ages out");
+  if constexpr ( abc::__default_multithread_safe and !abc::__default_percpu_arenas and abc::__remote_batch_depth > 4
+                 and abc::__remote_batch_age > 0 ) {
+    aging_set a{};
+    for ( byte *&p : a.ptrs ) p = abc::alloc(64);
+    {
+      micron::auto_thread<> t(aging_freer, &a);
+      t.join();
+    }
+    require_true(a.parked == a.before);
+    require_true(a.aged > a.parked);
+  }
+  end_test_case();
+
+  test_case("bytes_live follows an in-place grow and a sheet reset");
+  if constexpr ( abc::__default_page_runs and !abc::__default_persistent_mode ) {
+    constexpr usize PG = abc::__system_pagesize;
+    abc::__arena arena;
+    const u64 l0 = tier(arena.stats(), abc::stat_tier::medium).bytes_live;
+    const micron::__chunk<byte> c = arena.push(3 * PG);
+    require_true(c.ptr != nullptr and c.ptr != reinterpret_cast<byte *>(-1));
+    require_true(tier(arena.stats(), abc::stat_tier::medium).bytes_live - l0 == 3 * PG);
+    byte *g = arena.resize(c.ptr, 6 * PG);
+    require_true(g == c.ptr);      // a fresh sheet: the pages after it are free
+    require_true(tier(arena.stats(), abc::stat_tier::medium).bytes_live - l0 == 6 * PG);
+    arena.reset_page(g);
+    require_true(tier(arena.stats(), abc::stat_tier::medium).bytes_live == l0);
+  }
+  end_test_case();
+
+  test_case("a reset sheet takes its live and cached blocks off bytes_live");
+  if constexpr ( !abc::__default_persistent_mode ) {
+    constexpr u32 N = 64;
+    abc::__arena arena;
+    const u64 l0 = tier(arena.stats(), abc::stat_tier::precise).bytes_live;
+    byte *held[N];
+    for ( u32 i = 0; i < N; ++i ) {
+      held[i] = arena.push(48).ptr;
+      require_true(held[i] != nullptr and held[i] != reinterpret_cast<byte *>(-1));
+    }
+    for ( u32 i = 0; i < N; i += 2 ) require_true(arena.pop(held[i]));      // some of these park in the free cache
+    require_true(tier(arena.stats(), abc::stat_tier::precise).bytes_live > l0);
+    arena.reset_page(held[1]);
+    require_true(tier(arena.stats(), abc::stat_tier::precise).bytes_live == l0);
+  }
+  end_test_case();
+
+  test_case("derived totals agree with the tiers");
+  {
+    const abc::stats_t s = abc::stats_snapshot();
+    u64 live = 0, committed = 0;
+    for ( usize i = 0; i < abc::__stat_tiers; ++i ) {
+      live += s.tiers[i].bytes_live;
+      committed += s.tiers[i].bytes_committed;
+    }
+    require_true(s.current_memory_usage == live);
+    require_true(s.current_page_usage == committed / abc::__system_pagesize);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC STATS TESTS PASSED ===\n");
+  return 1;
+}
@@ -292,7 +292,7 @@ main(int, char **)
 
   // ─────────────────────────────────────────────────────────────────────────
   // 4. multi-word bitmap saturation per tier — push each hot tier deep into
-  //    the second / third / etc. word of __space_mask. fingerprinted so
+  //    the second / third / etc. word of the tier availability bitmap. fingerprinted so
   //    even silent bit confusion in the bitmap is caught.
   // ─────────────────────────────────────────────────────────────────────────
 
@@ -534,17 +534,14 @@ main(int, char **)
   end_test_case();
 
   // ─────────────────────────────────────────────────────────────────────────
-  // 8. aligned_alloc alignment matrix. exercises both the "alignment <= header
-  //    offset" fast path and the "alignment > header offset" overhead path
-  //    (which stashes the raw pointer).
+  // 8. aligned_alloc alignment matrix. every alignment is served natively
+  //    (slab class, aligned tlsf split, or a buddy block of order >= alignment).
   // ─────────────────────────────────────────────────────────────────────────
 
   test_case("aligned_alloc: power-of-two matrix (alignment × size multiple)");
   {
-    // contract: when alignment <= __hdr_offset (32), the returned pointer is
-    // the regular allocation pointer and must be released with abc::dealloc;
-    // for alignment > __hdr_offset, the pointer is offset and aligned_free
-    // is required. exercise both paths.
+    // contract: the returned pointer is a regular block start at every
+    // alignment and is released with abc::dealloc.
     const usize aligns[] = { 16u, 32u, 64u, 128u, 256u, 512u, 1024u, 2048u, 4096u };
     constexpr usize NA = sizeof(aligns) / sizeof(aligns[0]);
     for ( usize ai = 0; ai < NA; ++ai ) {
@@ -558,11 +555,8 @@ main(int, char **)
         static_cast<byte *>(p)[sz - 1u] = 0xA5u;
         require(static_cast<unsigned>(static_cast<byte *>(p)[0]), 0x5Au);
         require(static_cast<unsigned>(static_cast<byte *>(p)[sz - 1u]), 0xA5u);
-        if ( a <= 32u ) {
-          abc::dealloc(static_cast<byte *>(p));
-        } else {
-          abc::aligned_free(p);
-        }
+        require(abc::is_present(static_cast<byte *>(p)), true);
+        abc::dealloc(static_cast<byte *>(p));
       }
     }
   }
@@ -0,0 +1,189 @@
+// the recorder is compiled out by default; this test is its capture build
+#define MICRON_ABC_TRACE true
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// allocation trace recorder (trace.hpp): trace_start / trace_stop and the file they leave behind.
+//
+// every API alloc/free/realloc lands in the file once, tickets are unique and follow program order, a realloc is a
+// resize_from / resize_to pair, a ring that fills up is flushed rather than dropped, and nothing is recorded after stop.
+
+#include <micron/io/console.hpp>
+#include <micron/syscall.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr const char *PATH = "/tmp/abcmalloc_trace_test.trc";
+
+// the records of the file at PATH, read into an anonymous mapping; n == 0 if the header is wrong
+struct trace_file {
+  abc::trace_record *rec = nullptr;
+  usize n = 0;
+  usize cap = 0;
+
+  bool
+  read(void)
+  {
+    const int fd = static_cast<int>(micron::syscall(SYS_open, PATH, 0, 0));
+    if ( fd < 0 ) return false;
+    const long len = static_cast<long>(micron::syscall(SYS_lseek, fd, 0, 2 /*SEEK_END*/));
+    micron::syscall(SYS_lseek, fd, 0, 0 /*SEEK_SET*/);
+    abc::trace_header h{};
+    if ( len < static_cast<long>(sizeof(h))
+         or static_cast<long>(micron::syscall(SYS_read, fd, &h, sizeof(h))) != static_cast<long>(sizeof(h)) ) {
+      micron::syscall(SYS_close, fd);
+      return false;
+    }
+    cap = static_cast<usize>(len) - sizeof(h);
+    rec = reinterpret_cast<abc::trace_record *>(micron::map_normal(nullptr, cap ? cap : 1));
+    usize got = 0;
+    while ( got < cap ) {
+      const long r = static_cast<long>(micron::syscall(SYS_read, fd, reinterpret_cast<byte *>(rec) + got, cap - got));
+      if ( r <= 0 ) break;
+      got += static_cast<usize>(r);
+    }
+    micron::syscall(SYS_close, fd);
+    const bool ok = h.magic[0] == 'A' and h.magic[7] == 'E' and h.version == abc::__trace_version
+                    and h.record_size == sizeof(abc::trace_record) and got == cap and cap % sizeof(abc::trace_record) == 0;
+    n = ok ? cap / sizeof(abc::trace_record) : 0;
+    return ok;
+  }
+
+  ~trace_file()
+  {
+    if ( rec ) micron::munmap(reinterpret_cast<addr_t *>(rec), cap ? cap : 1);
+  }
+
+  // index of the first record of kind op for ptr, n if none
+  usize
+  find(abc::trace_op op, const void *ptr) const
+  {
+    for ( usize i = 0; i < n; ++i )
+      if ( rec[i].op == static_cast<u32>(op) and rec[i].ptr == reinterpret_cast<uintptr_t>(ptr) ) return i;
+    return n;
+  }
+};
+
+};      // namespace
+
+int
+main()
+{
+  if constexpr ( !abc::__default_trace ) {
+    micron::console("=== trace recorder compiled out (MICRON_ABC_TRACE), nothing to test ===\n");
+    return 1;
+  }
+
+  test_case("one trace at a time");
+  {
+    require_true(abc::trace_start(PATH));
+    require_true(!abc::trace_start(PATH));
+    const abc::trace_stats s = abc::trace_stop();
+    require_true(s.lost == 0);
+    trace_file f;
+    require_true(f.read());
+  }
+  end_test_case();
+
+  test_case("alloc, free and realloc are each recorded once, in order");
+  {
+    require_true(abc::trace_start(PATH));
+    byte *p = abc::alloc(100);
+    void *q = abc::malloc(64);
+    void *r = abc::realloc(q, 64 * 1024);
+    abc::dealloc(p, 100);
+    abc::free(r);
+    const abc::trace_stats s = abc::trace_stop();
+    require_true(s.records >= 6);
+    require_true(s.lost == 0);
+
+    trace_file f;
+    require_true(f.read());
+    const usize pa = f.find(abc::trace_op::alloc, p);
+    const usize pf = f.find(abc::trace_op::free, p);
+    require_true(pa < f.n and pf < f.n);
+    require_true(f.rec[pa].size == 100 and f.rec[pf].size == 100);
+    require_true(f.rec[pa].ts < f.rec[pf].ts);
+    const usize from = f.find(abc::trace_op::resize_from, q);
+    require_true(from + 1 < f.n);
+    require_true(f.rec[from + 1].op == static_cast<u32>(abc::trace_op::resize_to));
+    require_true(f.rec[from + 1].ptr == reinterpret_cast<uintptr_t>(r) and f.rec[from + 1].size == 64 * 1024);
+    require_true(f.rec[from].ts < f.rec[from + 1].ts);
+    require_true(f.find(abc::trace_op::free, r) < f.n);
+    const u32 tid = static_cast<u32>(micron::syscall(SYS_gettid));
+    for ( usize i = 0; i < f.n; ++i ) {
+      require_true(f.rec[i].tid == tid);
+      if ( i ) require_true(f.rec[i].ts > f.rec[i - 1].ts);      // one thread: file order is ticket order
+    }
+  }
+  end_test_case();
+
+  test_case("batches and calloc go through the recorder too");
+  {
+    constexpr usize B = 16;
+    byte *out[B];
+    require_true(abc::trace_start(PATH));
+    const usize got = abc::alloc_batch(48, B, out);
+    void *z = abc::calloc(8, 32);
+    abc::dealloc_batch(out, got);
+    abc::free(z);
+    abc::trace_stop();
+    trace_file f;
+    require_true(f.read());
+    usize allocs = 0, frees = 0;
+    for ( usize i = 0; i < f.n; ++i ) {
+      if ( f.rec[i].op == static_cast<u32>(abc::trace_op::alloc) ) ++allocs;
+      if ( f.rec[i].op == static_cast<u32>(abc::trace_op::free) ) ++frees;
+    }
+    require_true(allocs >= got + 1 and frees >= got + 1);
+    require_true(f.find(abc::trace_op::alloc, z) < f.n and f.rec[f.find(abc::trace_op::alloc, z)].size == 256);
+  }
+  end_test_case();
+
+  test_case("a full ring is flushed, not dropped");
+  {
+    const usize ops = 3 * static_cast<usize>(abc::__trace_ring_records);
+    require_true(abc::trace_start(PATH));
+    for ( usize i = 0; i < ops / 2; ++i ) abc::dealloc(abc::alloc(32));
+    const abc::trace_stats s = abc::trace_stop();
+    require_true(s.records >= ops);
+    require_true(s.lost == 0);
+    trace_file f;
+    require_true(f.read());
+    require_true(f.n == s.records);
+  }
+  end_test_case();
+
+  test_case("nothing is recorded once stopped");
+  {
+    require_true(abc::trace_start(PATH));
+    abc::trace_stop();
+    abc::dealloc(abc::alloc(32));
+    trace_file f;
+    require_true(f.read());
+    require_true(f.n == 0);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC TRACE TESTS PASSED ===\n");
+  return 1;
+}
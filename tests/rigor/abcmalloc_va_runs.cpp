@@ -0,0 +1,139 @@
+// [abcmalloc mirror] canonical umbrella first: cmalloc.hpp #defines
+// MICRON_ABCMALLOC_DISABLE_STD so micron-core headers use THIS standalone
+// allocator instead of pulling their own in-tree copy.
+#include "../../src/cmalloc.hpp"
+//  Copyright (c) 2025 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// VA run index (va_reserve.hpp): retained runs, coalescing, best fit.
+//
+// drives __va_carve / __va_release directly; nothing here goes through an arena, so the
+// granule arithmetic below is exact as long as no sheet is carved in between.
+
+#include <micron/io/console.hpp>
+
+#include "../../src/__abc.hpp"
+#include "../../src/config.hpp"
+#include "../../src/va_reserve.hpp"
+#include <micron/std.hpp>
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require_true;
+using sb::test_case;
+
+namespace
+{
+
+constexpr usize G = abc::__sheet_align;
+
+u32
+granule_of(const void *p)
+{
+  return abc::__va_granule(p);
+}
+
+u8
+kind_of(u32 g)
+{
+  return abc::__va_tag(g).run_kind;
+}
+
+u32
+len_of(u32 g)
+{
+  return abc::__va_tag(g).run_len;
+}
+
+u64
+retained(void)
+{
+  return abc::__va_bins[abc::__va_run_retained].granules;
+}
+
+bool
+all_zero(const byte *p, usize n)
+{
+  for ( usize i = 0; i < n; i += 512 )
+    if ( p[i] != 0 ) return false;
+  return true;
+}
+
+};      // namespace
+
+int
+main()
+{
+  if constexpr ( abc::__va_retain_granules < 8 ) {
+    micron::console("retained-run cache disabled or too small in this build, nothing to test\n");
+    return 1;
+  }
+
+  test_case("released runs are retained and coalesce in any order");
+  {
+    byte *x = reinterpret_cast<byte *>(abc::__va_carve(3 * G));
+    require_true(x != nullptr);
+    micron::memset(x, 0x5A, 3 * G);
+    const u64 r0 = retained();
+    abc::__va_release(reinterpret_cast<addr_t *>(x), G);
+    abc::__va_release(reinterpret_cast<addr_t *>(x + 2 * G), G);
+    require_true(retained() == r0 + 2);
+    abc::__va_release(reinterpret_cast<addr_t *>(x + G), G);      // joins both neighbours
+    require_true(retained() == r0 + 3);
+    const u32 g = granule_of(x);
+    require_true(kind_of(g) == abc::__va_run_retained);
+    require_true(len_of(g) == 3u);
+    require_true(len_of(g + 2) == 3u);
+    require_true(kind_of(g + 1) == abc::__va_run_none);      // no stale interior tags
+
+    // the whole run comes back without a remap, zeroed and writable
+    byte *y = reinterpret_cast<byte *>(abc::__va_carve(3 * G));
+    require_true(y == x);
+    require_true(retained() == r0);
+    require_true(all_zero(y, 3 * G));
+    micron::memset(y, 0x11, 3 * G);      // held on purpose: it fences the next case off from anything older
+  }
+  end_test_case();
+
+  test_case("best fit prefers the tightest run");
+  {
+    // [4 | hold | 2 | hold] so the two released runs can't merge
+    byte *x = reinterpret_cast<byte *>(abc::__va_carve(8 * G));
+    require_true(x != nullptr);
+    abc::__va_release(reinterpret_cast<addr_t *>(x), 4 * G);
+    abc::__va_release(reinterpret_cast<addr_t *>(x + 5 * G), 2 * G);
+    byte *y = reinterpret_cast<byte *>(abc::__va_carve(2 * G));
+    require_true(y == x + 5 * G);
+    byte *z = reinterpret_cast<byte *>(abc::__va_carve(G));      // split off the head of the 4-run
+    require_true(z == x);
+    require_true(len_of(granule_of(x + G)) == 3u);
+    abc::__va_release(reinterpret_cast<addr_t *>(z), G);
+    abc::__va_release(reinterpret_cast<addr_t *>(x + 4 * G), G);
+    abc::__va_release(reinterpret_cast<addr_t *>(y), 2 * G);
+    abc::__va_release(reinterpret_cast<addr_t *>(x + 7 * G), G);
+    require_true(len_of(granule_of(x)) >= 8u);
+  }
+  end_test_case();
+
+  test_case("a guard page is reopened before the run is retained");
+  {
+    byte *x = reinterpret_cast<byte *>(abc::__va_carve(G));
+    require_true(x != nullptr);
+    require_true(micron::mprotect(x + G - abc::__system_pagesize, abc::__system_pagesize, micron::prot_none) == 0);
+    abc::__va_release(reinterpret_cast<addr_t *>(x), G, abc::__system_pagesize);
+    byte *y = reinterpret_cast<byte *>(abc::__va_carve(G));
+    require_true(y == x);
+    y[G - 1] = 1;      // faults if the guard survived
+    require_true(y[G - 1] == 1);
+    abc::__va_release(reinterpret_cast<addr_t *>(y), G);
+  }
+  end_test_case();
+
+  micron::console("=== ALL ABCMALLOC VA RUN INDEX TESTS PASSED ===\n");
+  return 1;
+}
@@ -0,0 +1,30 @@
+//  Copyright (c) 2026 David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+// A sheet-level list (__slab_list, __run_list, ...) over a private anonymous
+// mapping of Bytes, for tests that drive a list directly instead of going
+// through an arena. The mapping lives exactly as long as the list does.
+
+#include <micron/types.hpp>
+
+namespace abctest
+{
+
+template<typename List, usize Bytes>
+struct mapped {
+  byte *mem;
+  List list;
+
+  mapped() : mem(reinterpret_cast<byte *>(micron::map_normal(nullptr, Bytes))), list(micron::__chunk<byte>{ mem, Bytes }) {}
+
+  ~mapped() { micron::munmap(reinterpret_cast<addr_t *>(mem), Bytes); }
+
+  mapped(const mapped &) = delete;
+  mapped &operator=(const mapped &) = delete;
+};
+
+};      // namespace abctest